@@ -0,0 +1,80 @@
+﻿#include "CameraCache.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// kCullGrainSize ごとに分けて並列にカリングし、結果を前に詰める
+template<class Bounds, class Cull>
+uint32_t CullParallel(const Bounds& bounds, std::span<uint32_t> visibleIndices, const Cull& cull) {
+	assert(visibleIndices.size() >= bounds.size());
+	const uint32_t count = static_cast<uint32_t>(bounds.size());
+	const uint32_t grain = CameraCache::kCullGrainSize;
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	if (count <= grain || jobSystem->IsSingleThreaded()) {
+		return cull(bounds, visibleIndices, 0);
+	}
+
+	// 各ジョブは自分の範囲と同じ位置に書き込むので、書き込み先が重ならない
+	const uint32_t chunkCount = (count + grain - 1) / grain;
+	std::vector<uint32_t> chunkVisible(chunkCount);
+	jobSystem->ParallelFor(0, chunkCount, 1, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t chunk = begin; chunk < end; chunk++) {
+			uint32_t offset = chunk * grain;
+			uint32_t size = (std::min)(grain, count - offset);
+			chunkVisible[chunk] =
+			  cull(bounds.subspan(offset, size), visibleIndices.subspan(offset, size), offset);
+		}
+	});
+
+	uint32_t visible = chunkVisible[0];
+	for (uint32_t chunk = 1; chunk < chunkCount; chunk++) {
+		std::copy_n(
+		  visibleIndices.begin() + chunk * grain, chunkVisible[chunk],
+		  visibleIndices.begin() + visible);
+		visible += chunkVisible[chunk];
+	}
+	return visible;
+}
+
+} // namespace
+
+bool CameraCache::Update(const Matrix4& matView, const Matrix4& matProjection) {
+	// 行列が変わっていなければ前回の結果をそのまま使う
+	if (valid_ && std::memcmp(&matView_, &matView, sizeof(Matrix4)) == 0 &&
+	    std::memcmp(&matProjection_, &matProjection, sizeof(Matrix4)) == 0) {
+		return false;
+	}
+	matView_ = matView;
+	matProjection_ = matProjection;
+	valid_ = true;
+
+	// ビュー行列は回転と平行移動のみなので転置で求まる
+	matViewInverse_ = MathUtility::Matrix4InverseRigid(matView);
+	matViewProjection_ = MathUtility::operator*(matView, matProjection);
+	matViewProjectionInverse_ = MathUtility::Matrix4Inverse(matViewProjection_);
+	frustum_ = MathUtility::FrustumFromMatrix(matViewProjection_);
+	return true;
+}
+
+uint32_t CameraCache::CullSpheres(
+  const MathUtility::SphereSoAConstSpan& spheres, std::span<uint32_t> visibleIndices) const {
+	return CullParallel(
+	  spheres, visibleIndices,
+	  [this](
+	    const MathUtility::SphereSoAConstSpan& range, std::span<uint32_t> out, uint32_t offset) {
+		  return MathUtility::FrustumCullSpheres(frustum_, range, out, offset);
+	  });
+}
+
+uint32_t CameraCache::CullAABBs(
+  const MathUtility::AABBSoAConstSpan& boxes, std::span<uint32_t> visibleIndices) const {
+	return CullParallel(
+	  boxes, visibleIndices,
+	  [this](const MathUtility::AABBSoAConstSpan& range, std::span<uint32_t> out, uint32_t offset) {
+		  return MathUtility::FrustumCullAABBs(frustum_, range, out, offset);
+	  });
+}
@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include "FrustumCulling.h"
+#include "MathUtility.h"
+#include <cstdint>
+#include <span>
+
+/// <summary>
+/// カメラの行列から求める値のキャッシュ（逆行列・ビュープロジェクション行列・視錐台）
+/// ViewProjection はライブラリ側のクラスが値で持つため構造体を大きくできないので、
+/// ゲーム側でこのクラスを持ち、ビュー行列か射影行列が変わったときだけ計算し直す
+/// </summary>
+class CameraCache {
+  public: // 定数
+	// 並列カリングで1ジョブが受け持つ要素数
+	static const uint32_t kCullGrainSize = 16 * 1024;
+
+  public: // メンバ関数
+	/// <summary>
+	/// 行列を更新する（前回と同じ行列なら何もしない）
+	/// </summary>
+	/// <param name="matView">ビュー行列</param>
+	/// <param name="matProjection">射影行列</param>
+	/// <returns>計算し直したか</returns>
+	bool Update(const Matrix4& matView, const Matrix4& matProjection);
+
+	// ビュー行列の逆行列（カメラのワールド行列）
+	const Matrix4& GetViewInverse() const { return matViewInverse_; }
+	// ビュープロジェクション行列
+	const Matrix4& GetViewProjection() const { return matViewProjection_; }
+	// ビュープロジェクション行列の逆行列（スクリーン → ワールド変換用）
+	const Matrix4& GetViewProjectionInverse() const { return matViewProjectionInverse_; }
+	// 視錐台（ワールド座標）
+	const Frustum& GetFrustum() const { return frustum_; }
+
+	/// <summary>
+	/// 視錐台カリング（要素数が多ければ JobSystem で分割して並列に処理する）
+	/// </summary>
+	/// <param name="spheres">ワールド座標の境界球</param>
+	/// <param name="visibleIndices">見えている要素の番号の書き込み先（要素数は入力と同じ以上）</param>
+	/// <returns>見えている要素の数</returns>
+	uint32_t CullSpheres(
+	  const MathUtility::SphereSoAConstSpan& spheres, std::span<uint32_t> visibleIndices) const;
+	/// <summary>
+	/// 視錐台カリング（ワールド座標の軸平行境界ボックス）
+	/// </summary>
+	uint32_t CullAABBs(
+	  const MathUtility::AABBSoAConstSpan& boxes, std::span<uint32_t> visibleIndices) const;
+
+  private: // メンバ変数
+	// 計算に使った行列
+	Matrix4 matView_;
+	Matrix4 matProjection_;
+	bool valid_ = false;
+
+	Matrix4 matViewInverse_;
+	Matrix4 matViewProjection_;
+	Matrix4 matViewProjectionInverse_;
+	Frustum frustum_;
+};
@@ -0,0 +1,383 @@
+﻿#include "CookedMesh.h"
+#include "Hash.h"
+#include "MeshOptimizer.h"
+#include "VertexWelder.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+std::string DirectoryOf(const std::string& path) {
+	size_t slash = path.find_last_of("/\\");
+	return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+// 最終更新時刻（取れなければ0）
+int64_t LastWriteTime(const std::string& path) {
+	std::error_code error;
+	std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+	return error ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+// MTL で定義されているマテリアル名（newmtl の行）
+std::vector<std::string> ReadMaterialNames(const std::string& path) {
+	std::vector<std::string> names;
+	MappedFile file;
+	if (!file.Open(path)) {
+		return names;
+	}
+	std::string_view text = file.GetText();
+	size_t begin = 0;
+	while (begin < text.size()) {
+		size_t end = text.find('\n', begin);
+		if (end == std::string_view::npos) {
+			end = text.size();
+		}
+		std::string_view line = text.substr(begin, end - begin);
+		size_t keyBegin = line.find_first_not_of(" \t");
+		if (keyBegin != std::string_view::npos && line.substr(keyBegin, 7) == "newmtl ") {
+			std::string_view rest = line.substr(keyBegin + 7);
+			size_t nameBegin = rest.find_first_not_of(" \t");
+			if (nameBegin != std::string_view::npos) {
+				size_t nameEnd = rest.find_first_of(" \t\r", nameBegin);
+				names.emplace_back(rest.substr(nameBegin, nameEnd - nameBegin));
+			}
+		}
+		begin = end + 1;
+	}
+	return names;
+}
+
+// 書き出す内容をためておく
+class Writer {
+  public:
+	// 領域をそろえてからデータを足し、その位置を返す
+	uint64_t Append(const void* data, size_t size) {
+		bytes_.resize(AlignUp(bytes_.size(), CookedMesh::kAlignment), 0);
+		uint64_t offset = bytes_.size();
+		if (size > 0) {
+			bytes_.insert(bytes_.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+		}
+		return offset;
+	}
+	std::vector<uint8_t>& GetBytes() { return bytes_; }
+
+  private:
+	std::vector<uint8_t> bytes_;
+};
+
+} // namespace
+
+bool CookedMesh::Cook(const std::string& objPath, const std::string& meshPath, bool smoothing) {
+	ObjModelData data;
+	if (!ObjLoader::LoadFile(objPath, smoothing, data)) {
+		return false;
+	}
+	VertexWelder::Weld(data);
+	MeshOptimizer::Optimize(data);
+	return Cook(data, objPath, meshPath, smoothing);
+}
+
+bool CookedMesh::Cook(
+  const ObjModelData& data, const std::string& objPath, const std::string& meshPath,
+  bool smoothing) {
+	MappedFile source;
+	if (!source.Open(objPath)) {
+		return false;
+	}
+	const std::string directoryPath = DirectoryOf(objPath);
+
+	Header header = {};
+	header.magic = kMagic;
+	header.version = kVersion;
+	header.flags = smoothing ? kFlagSmoothing : 0;
+	header.vertexStride = sizeof(ObjVertex);
+	header.sourceSize = source.GetSize();
+	header.sourceTime = LastWriteTime(objPath);
+	header.sourceHash = Hash64(source.GetData(), source.GetSize());
+	header.libraryHash = HashLibraries(directoryPath, data.materialLibraries);
+
+	// 文字列はすべて1つの領域に詰める
+	std::string strings;
+	auto addString = [&](std::string_view text) {
+		String string = {static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(text.size())};
+		strings.append(text);
+		return string;
+	};
+
+	// 各マテリアル名が何個目のライブラリで使えるようになるか（ModelLoader と同じ規則で割り当てる）
+	std::unordered_map<std::string, uint32_t> libraryCountOf;
+	std::vector<String> libraries;
+	for (uint32_t i = 0; i < data.materialLibraries.size(); i++) {
+		libraries.push_back(addString(data.materialLibraries[i]));
+		for (std::string& name : ReadMaterialNames(directoryPath + data.materialLibraries[i])) {
+			libraryCountOf.emplace(std::move(name), i + 1);
+		}
+	}
+
+	// 頂点番号が16ビットに収まるならインデックスも16ビットで持つ
+	size_t maxVertexCount = 0;
+	for (const ObjMesh& mesh : data.meshes) {
+		maxVertexCount = (std::max)(maxVertexCount, mesh.vertices.size());
+	}
+	header.indexSize = ObjLoader::GetIndexSize(maxVertexCount);
+
+	std::vector<ObjVertex> vertices;
+	std::vector<uint8_t> indices;
+	std::vector<Submesh> submeshes;
+	std::vector<String> materials;
+	std::unordered_map<std::string, uint32_t> materialIndexOf;
+	for (int i = 0; i < 3; i++) {
+		header.boundsMin[i] = FLT_MAX;
+		header.boundsMax[i] = -FLT_MAX;
+	}
+	for (const ObjMesh& mesh : data.meshes) {
+		Submesh submesh = {};
+		submesh.name = addString(mesh.name);
+		submesh.material = kNoMaterial;
+		for (const ObjMaterialUse& use : mesh.materialUses) {
+			auto itr = libraryCountOf.find(use.name);
+			if (itr != libraryCountOf.end() && itr->second <= use.libraryCount) {
+				auto [material, inserted] =
+				  materialIndexOf.emplace(use.name, static_cast<uint32_t>(materials.size()));
+				if (inserted) {
+					materials.push_back(addString(use.name));
+				}
+				submesh.material = material->second;
+				break;
+			}
+		}
+		submesh.vertexOffset = static_cast<uint32_t>(vertices.size());
+		submesh.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+		submesh.indexOffset = static_cast<uint32_t>(indices.size() / header.indexSize);
+		submesh.indexCount = static_cast<uint32_t>(mesh.indices.size());
+
+		float* boundsMin = submesh.boundsMin;
+		float* boundsMax = submesh.boundsMax;
+		for (int i = 0; i < 3; i++) {
+			boundsMin[i] = mesh.vertices.empty() ? 0.0f : FLT_MAX;
+			boundsMax[i] = mesh.vertices.empty() ? 0.0f : -FLT_MAX;
+		}
+		for (const ObjVertex& vertex : mesh.vertices) {
+			const float position[3] = {vertex.pos.x, vertex.pos.y, vertex.pos.z};
+			for (int i = 0; i < 3; i++) {
+				boundsMin[i] = (std::min)(boundsMin[i], position[i]);
+				boundsMax[i] = (std::max)(boundsMax[i], position[i]);
+				header.boundsMin[i] = (std::min)(header.boundsMin[i], position[i]);
+				header.boundsMax[i] = (std::max)(header.boundsMax[i], position[i]);
+			}
+		}
+		vertices.insert(vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+
+		size_t indexBegin = indices.size();
+		indices.resize(indexBegin + mesh.indices.size() * header.indexSize);
+		if (header.indexSize == 2) {
+			uint16_t* out = reinterpret_cast<uint16_t*>(indices.data() + indexBegin);
+			for (uint32_t index : mesh.indices) {
+				*out++ = static_cast<uint16_t>(index);
+			}
+		} else if (!mesh.indices.empty()) {
+			std::memcpy(
+			  indices.data() + indexBegin, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+		}
+		submeshes.push_back(submesh);
+	}
+	if (vertices.empty()) {
+		for (int i = 0; i < 3; i++) {
+			header.boundsMin[i] = 0.0f;
+			header.boundsMax[i] = 0.0f;
+		}
+	}
+
+	header.submeshCount = static_cast<uint32_t>(submeshes.size());
+	header.materialCount = static_cast<uint32_t>(materials.size());
+	header.libraryCount = static_cast<uint32_t>(libraries.size());
+	header.vertexCount = vertices.size();
+	header.indexCount = indices.size() / header.indexSize;
+
+	Writer writer;
+	writer.Append(&header, sizeof(header));
+	header.vertexOffset = writer.Append(vertices.data(), vertices.size() * sizeof(ObjVertex));
+	header.indexOffset = writer.Append(indices.data(), indices.size());
+	header.submeshOffset = writer.Append(submeshes.data(), submeshes.size() * sizeof(Submesh));
+	header.materialOffset = writer.Append(materials.data(), materials.size() * sizeof(String));
+	header.libraryOffset = writer.Append(libraries.data(), libraries.size() * sizeof(String));
+	header.stringOffset = writer.Append(strings.data(), strings.size());
+	header.stringSize = strings.size();
+	std::memcpy(writer.GetBytes().data(), &header, sizeof(header));
+
+	// 途中で失敗しても古いファイルを壊さないよう、書き終えてから置き換える
+	const std::string temporaryPath = meshPath + ".tmp";
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (file.fail()) {
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(writer.GetBytes().data()), writer.GetBytes().size());
+		if (file.fail()) {
+			return false;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, meshPath, error);
+	return !error;
+}
+
+bool CookedMesh::IsUpToDate(
+  const std::string& meshPath, const std::string& objPath, bool smoothing) {
+	CookedMesh cooked;
+	if (!cooked.Open(meshPath)) {
+		return false;
+	}
+	const Header& header = cooked.GetHeader();
+	if ((header.flags & kFlagSmoothing) != (smoothing ? kFlagSmoothing : 0)) {
+		return false;
+	}
+
+	// MTL は小さいので毎回中身を比べる
+	std::vector<std::string> libraries;
+	for (const String& library : cooked.GetLibraries()) {
+		libraries.emplace_back(cooked.GetString(library));
+	}
+	if (HashLibraries(DirectoryOf(objPath), libraries) != header.libraryHash) {
+		return false;
+	}
+
+	// OBJ は大きさと更新時刻が同じなら中身も同じとみなす
+	std::error_code error;
+	uint64_t size = std::filesystem::file_size(objPath, error);
+	if (error || size != header.sourceSize) {
+		return false;
+	}
+	int64_t sourceTime = LastWriteTime(objPath);
+	if (sourceTime == header.sourceTime) {
+		return true;
+	}
+	MappedFile source;
+	if (!source.Open(objPath)) {
+		return false;
+	}
+	if (Hash64(source.GetData(), source.GetSize()) != header.sourceHash) {
+		return false;
+	}
+
+	// 中身は同じで更新時刻だけが変わった（チェックアウトし直したなど）。
+	// 次からハッシュ値を計算しなくて済むよう、割り当てを解除してから記録した時刻を書き直す
+	// （書き直せなくても使えることに変わりはない）
+	source.Close();
+	cooked.Close();
+	std::fstream file(meshPath, std::ios::binary | std::ios::in | std::ios::out);
+	if (!file.fail()) {
+		file.seekp(offsetof(Header, sourceTime));
+		file.write(reinterpret_cast<const char*>(&sourceTime), sizeof(sourceTime));
+	}
+	return true;
+}
+
+bool CookedMesh::Open(const std::string& meshPath) {
+	Close();
+	if (!file_.Open(meshPath) || file_.GetSize() < sizeof(Header)) {
+		Close();
+		return false;
+	}
+	const Header* header = reinterpret_cast<const Header*>(file_.GetData());
+	uint64_t fileSize = file_.GetSize();
+	// 領域がファイルの中に収まっているか
+	auto inside = [&](uint64_t offset, uint64_t count, uint64_t stride) {
+		return offset <= fileSize && count <= (fileSize - offset) / stride;
+	};
+	bool valid = header->magic == kMagic && header->version == kVersion &&
+	             header->vertexStride == sizeof(ObjVertex) &&
+	             (header->indexSize == 2 || header->indexSize == 4) &&
+	             inside(header->vertexOffset, header->vertexCount, sizeof(ObjVertex)) &&
+	             inside(header->indexOffset, header->indexCount, header->indexSize) &&
+	             inside(header->submeshOffset, header->submeshCount, sizeof(Submesh)) &&
+	             inside(header->materialOffset, header->materialCount, sizeof(String)) &&
+	             inside(header->libraryOffset, header->libraryCount, sizeof(String)) &&
+	             inside(header->stringOffset, header->stringSize, 1);
+	if (!valid) {
+		Close();
+		return false;
+	}
+	header_ = header;
+
+	// メッシュと文字列の範囲
+	for (const Submesh& submesh : GetSubmeshes()) {
+		valid &= submesh.vertexOffset + uint64_t(submesh.vertexCount) <= header->vertexCount;
+		valid &= submesh.indexOffset + uint64_t(submesh.indexCount) <= header->indexCount;
+		valid &= submesh.material == kNoMaterial || submesh.material < header->materialCount;
+		valid &= submesh.name.offset + uint64_t(submesh.name.length) <= header->stringSize;
+	}
+	for (const String& string : GetMaterials()) {
+		valid &= string.offset + uint64_t(string.length) <= header->stringSize;
+	}
+	for (const String& string : GetLibraries()) {
+		valid &= string.offset + uint64_t(string.length) <= header->stringSize;
+	}
+	if (!valid) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void CookedMesh::Close() {
+	file_.Close();
+	header_ = nullptr;
+}
+
+std::span<const ObjVertex> CookedMesh::GetVertices() const {
+	return {
+	  reinterpret_cast<const ObjVertex*>(file_.GetData() + header_->vertexOffset),
+	  static_cast<size_t>(header_->vertexCount)};
+}
+
+const void* CookedMesh::GetIndexData() const { return file_.GetData() + header_->indexOffset; }
+
+std::span<const CookedMesh::Submesh> CookedMesh::GetSubmeshes() const {
+	return {
+	  reinterpret_cast<const Submesh*>(file_.GetData() + header_->submeshOffset),
+	  header_->submeshCount};
+}
+
+std::span<const CookedMesh::String> CookedMesh::GetMaterials() const {
+	return {
+	  reinterpret_cast<const String*>(file_.GetData() + header_->materialOffset),
+	  header_->materialCount};
+}
+
+std::span<const CookedMesh::String> CookedMesh::GetLibraries() const {
+	return {
+	  reinterpret_cast<const String*>(file_.GetData() + header_->libraryOffset),
+	  header_->libraryCount};
+}
+
+std::string_view CookedMesh::GetString(const String& string) const {
+	return {
+	  reinterpret_cast<const char*>(file_.GetData() + header_->stringOffset) + string.offset,
+	  string.length};
+}
+
+uint64_t CookedMesh::HashLibraries(
+  const std::string& directoryPath, std::span<const std::string> libraries) {
+	uint64_t hash = 0;
+	for (const std::string& library : libraries) {
+		MappedFile file;
+		if (file.Open(directoryPath + library)) {
+			hash = Hash64(file.GetData(), file.GetSize(), hash);
+		} else {
+			hash = Hash64(nullptr, 0, hash);
+		}
+	}
+	return hash;
+}
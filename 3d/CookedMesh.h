@@ -0,0 +1,127 @@
+﻿#pragma once
+
+#include "MappedFile.h"
+#include "ObjLoader.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+/// <summary>
+/// 変換済みのメッシュファイル（.mesh）
+/// OBJ を読み込んだ結果を、頂点・インデックスの塊、メッシュごとの範囲と境界、マテリアル名の表として
+/// そのまま書き出しておく。読み込みはファイルをメモリに割り当てるだけで、解析もコピーもしない。
+/// 元の OBJ と MTL のハッシュ値を持ち、変わっていれば作り直す
+/// </summary>
+class CookedMesh {
+  public: // 定数
+	// ファイルの識別子と版（形式を変えたら版を上げる）
+	static const uint32_t kMagic = 0x4853454D; // "MESH"
+	static const uint32_t kVersion = 3;
+	// 各領域の先頭のそろえ方（バイト）
+	static const uint32_t kAlignment = 64;
+	// マテリアルなし
+	static const uint32_t kNoMaterial = UINT32_MAX;
+	// 作成時の設定
+	static const uint32_t kFlagSmoothing = 1 << 0;
+
+  public: // サブクラス
+	// ファイル中の文字列（文字列領域の中の位置と長さ）
+	struct String {
+		uint32_t offset;
+		uint32_t length;
+	};
+
+	// ファイルの先頭
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t flags;
+		uint32_t vertexStride; // sizeof(ObjVertex)
+		uint32_t indexSize;    // 2 なら uint16_t、4 なら uint32_t
+		uint32_t submeshCount;
+		uint32_t materialCount;
+		uint32_t libraryCount;
+		// 元の OBJ（大きさと更新時刻が同じならハッシュ値の計算を省く）
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		uint64_t sourceHash;
+		// mtllib で参照する MTL の中身をつなげたハッシュ値
+		uint64_t libraryHash;
+		// 各領域の位置（ファイル先頭から）と要素数
+		uint64_t vertexOffset;
+		uint64_t vertexCount;
+		uint64_t indexOffset;
+		uint64_t indexCount;
+		uint64_t submeshOffset;
+		uint64_t materialOffset;
+		uint64_t libraryOffset;
+		uint64_t stringOffset;
+		uint64_t stringSize;
+		// 全体の軸平行境界ボックス
+		float boundsMin[3];
+		float boundsMax[3];
+	};
+
+	// メッシュ1つ分の範囲（インデックスはメッシュの先頭の頂点からの番号）
+	struct Submesh {
+		String name;
+		uint32_t material; // マテリアル表の番号（kNoMaterial ならなし）
+		uint32_t vertexOffset;
+		uint32_t vertexCount;
+		uint32_t indexOffset;
+		uint32_t indexCount;
+		float boundsMin[3];
+		float boundsMax[3];
+	};
+
+  public: // 静的メンバ関数
+	/// <summary>
+	/// OBJ から .mesh を作る（同じ頂点は VertexWelder でまとめ、MeshOptimizer で並べ替える）
+	/// </summary>
+	/// <param name="objPath">OBJ ファイルのパス（MTL は同じディレクトリから探す）</param>
+	/// <param name="meshPath">書き出すパス（一時ファイルに書いてから置き換える）</param>
+	/// <param name="smoothing">エッジ平滑化フラグ</param>
+	/// <returns>成功したか</returns>
+	static bool Cook(const std::string& objPath, const std::string& meshPath, bool smoothing);
+
+	/// <summary>
+	/// 読み込み済みの OBJ から .mesh を作る（data はそのまま書き出す）
+	/// </summary>
+	static bool Cook(
+	  const ObjModelData& data, const std::string& objPath, const std::string& meshPath,
+	  bool smoothing);
+
+	/// <summary>
+	/// .mesh が OBJ・MTL・設定と一致していて、そのまま使えるか
+	/// （OBJ の更新時刻だけが変わっていて中身が同じなら、.mesh に記録した時刻を書き直す）
+	/// </summary>
+	static bool IsUpToDate(const std::string& meshPath, const std::string& objPath, bool smoothing);
+
+  public: // メンバ関数
+	/// <summary>
+	/// ファイルを開く（形式と各領域の範囲を確かめる）
+	/// </summary>
+	bool Open(const std::string& meshPath);
+	void Close();
+
+	const Header& GetHeader() const { return *header_; }
+	// 全メッシュの頂点（Mesh::VertexPosNormalUv と同じ並び）
+	std::span<const ObjVertex> GetVertices() const;
+	// 全メッシュのインデックスの塊（要素の大きさは GetHeader().indexSize）
+	const void* GetIndexData() const;
+	std::span<const Submesh> GetSubmeshes() const;
+	// マテリアル名の表
+	std::span<const String> GetMaterials() const;
+	// mtllib のファイル名
+	std::span<const String> GetLibraries() const;
+	std::string_view GetString(const String& string) const;
+
+  private: // 静的メンバ関数
+	// MTL の中身をつなげたハッシュ値（読めないファイルは空として扱う）
+	static uint64_t HashLibraries(const std::string& directoryPath, std::span<const std::string> libraries);
+
+  private: // メンバ変数
+	MappedFile file_;
+	const Header* header_ = nullptr;
+};
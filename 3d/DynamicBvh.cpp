@@ -0,0 +1,479 @@
+﻿#include "DynamicBvh.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+using namespace MathUtility;
+
+namespace {
+
+// 再構築中の葉（並べ替えで一緒に動くよう、ボックスをノードから写しておく）
+struct BuildItem {
+	int32_t leaf;
+	AABB box;
+};
+
+// axis 番目の成分
+float Axis(const Vector3& v, int axis) { return axis == 0 ? v.x : (axis == 1 ? v.y : v.z); }
+// 重心の axis 番目の成分の2倍（比較にしか使わないので半分にしない）
+float Centroid2(const BuildItem& item, int axis) {
+	return Axis(item.box.min, axis) + Axis(item.box.max, axis);
+}
+
+} // namespace
+
+DynamicBvh::ProxyId DynamicBvh::CreateProxy(const AABB& box, uint32_t userData) {
+	int32_t leaf = AllocateNode();
+	nodes_[leaf].box = Fatten(box);
+	nodes_[leaf].userData = userData;
+	nodes_[leaf].height = 0;
+	InsertLeaf(leaf);
+	proxyCount_++;
+	return leaf;
+}
+
+void DynamicBvh::DestroyProxy(ProxyId proxy) {
+	// 削除済みのノードも子を持たないので、高さで登録中の葉かを見分ける（二重削除の検出）
+	assert(0 <= proxy && proxy < static_cast<int32_t>(nodes_.size()) && nodes_[proxy].height == 0);
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	proxyCount_--;
+}
+
+bool DynamicBvh::MoveProxy(ProxyId proxy, const AABB& box, const Vector3& displacement) {
+	assert(nodes_[proxy].height == 0);
+	if (AABBContains(nodes_[proxy].box, box)) {
+		return false;
+	}
+
+	// 移動方向に先回りして広げ、毎フレーム挿入し直すのを避ける
+	AABB fat = Fatten(box);
+	Vector3 d = displacement * kDisplacementMultiplier;
+	fat.min = fat.min + Vector3Min(d, Vector3Zero());
+	fat.max = fat.max + Vector3Max(d, Vector3Zero());
+
+	RemoveLeaf(proxy);
+	nodes_[proxy].box = fat;
+	InsertLeaf(proxy);
+	return true;
+}
+
+void DynamicBvh::RefitProxy(ProxyId proxy, const AABB& box) {
+	assert(nodes_[proxy].height == 0);
+	if (AABBContains(nodes_[proxy].box, box)) {
+		return;
+	}
+	nodes_[proxy].box = Fatten(box);
+	// 祖先を合わせ直す（形は変えない）
+	for (int32_t index = nodes_[proxy].parent; index != kNullProxy; index = nodes_[index].parent) {
+		Node& node = nodes_[index];
+		AABB merged = AABBMerge(nodes_[node.child1].box, nodes_[node.child2].box);
+		if (AABBContains(node.box, merged)) {
+			break;
+		}
+		node.box = merged;
+	}
+}
+
+void DynamicBvh::Clear() {
+	nodes_.clear();
+	root_ = kNullProxy;
+	freeList_ = kNullProxy;
+	proxyCount_ = 0;
+	rebuildCost_ = 0.0f;
+}
+
+void DynamicBvh::Rebuild() {
+	// 葉を集め、内部ノードはすべて解放する
+	std::vector<BuildItem> items;
+	items.reserve(proxyCount_);
+	for (int32_t i = 0; i < static_cast<int32_t>(nodes_.size()); i++) {
+		Node& node = nodes_[i];
+		if (node.height < 0) {
+			continue;
+		}
+		if (node.IsLeaf()) {
+			items.push_back({i, node.box});
+		} else {
+			FreeNode(i);
+		}
+	}
+	root_ = kNullProxy;
+	if (items.empty()) {
+		rebuildCost_ = 0.0f;
+		return;
+	}
+
+	// 上から分割していく（深くなっても再帰しないよう明示的なスタックを使う）
+	struct Task {
+		uint32_t begin;
+		uint32_t end;
+		int32_t parent;
+		bool isChild2;
+	};
+	std::vector<Task> tasks = {{0, static_cast<uint32_t>(items.size()), kNullProxy, false}};
+	std::vector<int32_t> created;
+	while (!tasks.empty()) {
+		Task task = tasks.back();
+		tasks.pop_back();
+
+		int32_t index;
+		if (task.end - task.begin == 1) {
+			index = items[task.begin].leaf;
+		} else {
+			// 重心の範囲が一番広い軸で区間に振り分け、表面積×個数の和が最小になる位置で分ける
+			Vector3 centroid = items[task.begin].box.min + items[task.begin].box.max;
+			AABB centroidBounds = {centroid, centroid};
+			for (uint32_t i = task.begin + 1; i < task.end; i++) {
+				centroid = items[i].box.min + items[i].box.max;
+				centroidBounds.min = Vector3Min(centroidBounds.min, centroid);
+				centroidBounds.max = Vector3Max(centroidBounds.max, centroid);
+			}
+			Vector3 size = centroidBounds.max - centroidBounds.min;
+			int axis = size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+			float axisMin = Axis(centroidBounds.min, axis);
+			float axisSize = Axis(size, axis);
+
+			uint32_t mid = task.begin + (task.end - task.begin) / 2;
+			if (axisSize > 0.0f) {
+				AABB binBoxes[kBinCount];
+				uint32_t binCounts[kBinCount] = {};
+				const float scale = kBinCount / axisSize;
+				auto binOf = [&](const BuildItem& item) {
+					uint32_t bin = static_cast<uint32_t>((Centroid2(item, axis) - axisMin) * scale);
+					return (std::min)(bin, kBinCount - 1);
+				};
+				for (uint32_t i = task.begin; i < task.end; i++) {
+					uint32_t bin = binOf(items[i]);
+					const AABB& box = items[i].box;
+					binBoxes[bin] = binCounts[bin]++ == 0 ? box : AABBMerge(binBoxes[bin], box);
+				}
+
+				// 右側の累積を先に求め、左から走査して最良の分割位置を探す
+				float rightCost[kBinCount] = {};
+				AABB accumulated;
+				uint32_t count = 0;
+				for (uint32_t bin = kBinCount - 1; bin > 0; bin--) {
+					if (binCounts[bin] > 0) {
+						accumulated = count == 0 ? binBoxes[bin] : AABBMerge(accumulated, binBoxes[bin]);
+						count += binCounts[bin];
+					}
+					rightCost[bin] = count == 0 ? 0.0f : AABBSurfaceArea(accumulated) * count;
+				}
+				float bestCost = 0.0f;
+				uint32_t bestSplit = 0;
+				count = 0;
+				for (uint32_t bin = 0; bin < kBinCount - 1; bin++) {
+					if (binCounts[bin] > 0) {
+						accumulated = count == 0 ? binBoxes[bin] : AABBMerge(accumulated, binBoxes[bin]);
+						count += binCounts[bin];
+					}
+					if (count == 0 || count == task.end - task.begin) {
+						continue;
+					}
+					float cost = AABBSurfaceArea(accumulated) * count + rightCost[bin + 1];
+					if (bestSplit == 0 || cost < bestCost) {
+						bestCost = cost;
+						bestSplit = bin + 1;
+					}
+				}
+				if (bestSplit != 0) {
+					auto middle = std::partition(
+					  items.begin() + task.begin, items.begin() + task.end,
+					  [&](const BuildItem& item) { return binOf(item) < bestSplit; });
+					mid = static_cast<uint32_t>(middle - items.begin());
+				}
+			}
+			if (mid == task.begin || mid == task.end) {
+				// 重心が重なっていて分けられなければ半分に分ける
+				mid = task.begin + (task.end - task.begin) / 2;
+			}
+
+			index = AllocateNode();
+			nodes_[index].height = 1;
+			created.push_back(index);
+			tasks.push_back({task.begin, mid, index, false});
+			tasks.push_back({mid, task.end, index, true});
+		}
+
+		nodes_[index].parent = task.parent;
+		if (task.parent == kNullProxy) {
+			root_ = index;
+		} else if (task.isChild2) {
+			nodes_[task.parent].child2 = index;
+		} else {
+			nodes_[task.parent].child1 = index;
+		}
+	}
+
+	// 子は親より後に作られるので、逆順にたどれば下から高さとボックスが決まる
+	for (auto it = created.rbegin(); it != created.rend(); ++it) {
+		Node& node = nodes_[*it];
+		const Node& child1 = nodes_[node.child1];
+		const Node& child2 = nodes_[node.child2];
+		node.box = AABBMerge(child1.box, child2.box);
+		node.height = 1 + (std::max)(child1.height, child2.height);
+	}
+
+	rebuildCost_ = ComputeCost();
+}
+
+bool DynamicBvh::RebuildIfDegraded(float maxCostRatio) {
+	if (proxyCount_ < 2) {
+		return false;
+	}
+	float cost = ComputeCost();
+	if (rebuildCost_ == 0.0f) {
+		// 基準がまだなければ今の木を基準にする
+		rebuildCost_ = cost;
+		return false;
+	}
+	if (cost <= rebuildCost_ * maxCostRatio) {
+		return false;
+	}
+	Rebuild();
+	return true;
+}
+
+float DynamicBvh::ComputeCost() const {
+	if (root_ == kNullProxy) {
+		return 0.0f;
+	}
+	float rootArea = AABBSurfaceArea(nodes_[root_].box);
+	if (rootArea <= 0.0f) {
+		return 0.0f;
+	}
+	float totalArea = 0.0f;
+	for (const Node& node : nodes_) {
+		if (node.height > 0) {
+			totalArea += AABBSurfaceArea(node.box);
+		}
+	}
+	return totalArea / rootArea;
+}
+
+int32_t DynamicBvh::GetMaxBalance() const {
+	int32_t maxBalance = 0;
+	for (const Node& node : nodes_) {
+		if (node.height > 0) {
+			int32_t balance = std::abs(nodes_[node.child2].height - nodes_[node.child1].height);
+			maxBalance = (std::max)(maxBalance, balance);
+		}
+	}
+	return maxBalance;
+}
+
+void DynamicBvh::Validate() const {
+	// 根からたどれるノード
+	uint32_t reachable = 0;
+	uint32_t leafCount = 0;
+	if (root_ != kNullProxy) {
+		assert(nodes_[root_].parent == kNullProxy);
+		std::vector<int32_t> stack = {root_};
+		while (!stack.empty()) {
+			int32_t index = stack.back();
+			stack.pop_back();
+			const Node& node = nodes_[index];
+			reachable++;
+			if (node.IsLeaf()) {
+				assert(node.height == 0 && node.child2 == kNullProxy);
+				leafCount++;
+				continue;
+			}
+			for (int32_t child : {node.child1, node.child2}) {
+				assert(nodes_[child].parent == index && nodes_[child].height < node.height);
+				assert(AABBContains(node.box, nodes_[child].box));
+				stack.push_back(child);
+			}
+			assert(
+			  node.height == 1 + (std::max)(nodes_[node.child1].height, nodes_[node.child2].height));
+		}
+	}
+	assert(leafCount == proxyCount_);
+
+	// 残りはすべて空きノード
+	uint32_t freeCount = 0;
+	for (int32_t index = freeList_; index != kNullProxy; index = nodes_[index].parent) {
+		assert(nodes_[index].height == -1);
+		freeCount++;
+	}
+	assert(reachable + freeCount == nodes_.size());
+}
+
+int32_t DynamicBvh::AllocateNode() {
+	int32_t index;
+	if (freeList_ == kNullProxy) {
+		index = static_cast<int32_t>(nodes_.size());
+		nodes_.emplace_back();
+	} else {
+		index = freeList_;
+		freeList_ = nodes_[index].parent;
+	}
+	nodes_[index] = Node();
+	return index;
+}
+
+void DynamicBvh::FreeNode(int32_t index) {
+	nodes_[index].parent = freeList_;
+	nodes_[index].height = -1;
+	freeList_ = index;
+}
+
+void DynamicBvh::InsertLeaf(int32_t leaf) {
+	if (root_ == kNullProxy) {
+		root_ = leaf;
+		nodes_[leaf].parent = kNullProxy;
+		return;
+	}
+
+	// 兄弟にすると表面積の増加が最も小さくなるノードを、根から下りながら探す
+	const AABB leafBox = nodes_[leaf].box;
+	int32_t index = root_;
+	while (!nodes_[index].IsLeaf()) {
+		const Node& node = nodes_[index];
+		float area = AABBSurfaceArea(node.box);
+		float combinedArea = AABBSurfaceArea(AABBMerge(node.box, leafBox));
+		// ここで兄弟にするコストと、下に降りる場合に祖先が負担する増加分
+		float cost = 2.0f * combinedArea;
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto descendCost = [&](int32_t child) {
+			const Node& childNode = nodes_[child];
+			float mergedArea = AABBSurfaceArea(AABBMerge(leafBox, childNode.box));
+			if (childNode.IsLeaf()) {
+				return mergedArea + inheritanceCost;
+			}
+			return mergedArea - AABBSurfaceArea(childNode.box) + inheritanceCost;
+		};
+		float cost1 = descendCost(node.child1);
+		float cost2 = descendCost(node.child2);
+		if (cost < cost1 && cost < cost2) {
+			break;
+		}
+		index = cost1 < cost2 ? node.child1 : node.child2;
+	}
+
+	// 兄弟と新しい親でまとめる
+	int32_t sibling = index;
+	int32_t oldParent = nodes_[sibling].parent;
+	int32_t newParent = AllocateNode();
+	nodes_[newParent].parent = oldParent;
+	nodes_[newParent].box = AABBMerge(leafBox, nodes_[sibling].box);
+	nodes_[newParent].height = nodes_[sibling].height + 1;
+	nodes_[newParent].child1 = sibling;
+	nodes_[newParent].child2 = leaf;
+	nodes_[sibling].parent = newParent;
+	nodes_[leaf].parent = newParent;
+
+	if (oldParent == kNullProxy) {
+		root_ = newParent;
+	} else if (nodes_[oldParent].child1 == sibling) {
+		nodes_[oldParent].child1 = newParent;
+	} else {
+		nodes_[oldParent].child2 = newParent;
+	}
+
+	FixUpwards(nodes_[leaf].parent);
+}
+
+void DynamicBvh::RemoveLeaf(int32_t leaf) {
+	if (leaf == root_) {
+		root_ = kNullProxy;
+		return;
+	}
+
+	// 親を取り除き、兄弟を祖父に直接つなぐ
+	int32_t parent = nodes_[leaf].parent;
+	int32_t grandParent = nodes_[parent].parent;
+	int32_t sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+	if (grandParent == kNullProxy) {
+		root_ = sibling;
+		nodes_[sibling].parent = kNullProxy;
+		FreeNode(parent);
+		return;
+	}
+
+	if (nodes_[grandParent].child1 == parent) {
+		nodes_[grandParent].child1 = sibling;
+	} else {
+		nodes_[grandParent].child2 = sibling;
+	}
+	nodes_[sibling].parent = grandParent;
+	FreeNode(parent);
+
+	FixUpwards(grandParent);
+}
+
+void DynamicBvh::FixUpwards(int32_t index) {
+	while (index != kNullProxy) {
+		index = Balance(index);
+		Node& node = nodes_[index];
+		const Node& child1 = nodes_[node.child1];
+		const Node& child2 = nodes_[node.child2];
+		node.height = 1 + (std::max)(child1.height, child2.height);
+		node.box = AABBMerge(child1.box, child2.box);
+		index = node.parent;
+	}
+}
+
+int32_t DynamicBvh::Balance(int32_t iA) {
+	// A の子 B, C のうち高い方を持ち上げ、その子の高い方を A 側に残す
+	Node& a = nodes_[iA];
+	if (a.IsLeaf() || a.height < 2) {
+		return iA;
+	}
+
+	int32_t iB = a.child1;
+	int32_t iC = a.child2;
+	int32_t balance = nodes_[iC].height - nodes_[iB].height;
+	if (balance >= -1 && balance <= 1) {
+		return iA;
+	}
+
+	// 持ち上げる子を iUp、もう一方を iStay とする
+	bool raiseC = balance > 1;
+	int32_t iUp = raiseC ? iC : iB;
+	int32_t iStay = raiseC ? iB : iC;
+	Node& up = nodes_[iUp];
+	int32_t iF = up.child1;
+	int32_t iG = up.child2;
+	Node& f = nodes_[iF];
+	Node& g = nodes_[iG];
+
+	// up を A の位置に置く
+	up.child1 = iA;
+	up.parent = a.parent;
+	a.parent = iUp;
+	if (up.parent == kNullProxy) {
+		root_ = iUp;
+	} else if (nodes_[up.parent].child1 == iA) {
+		nodes_[up.parent].child1 = iUp;
+	} else {
+		nodes_[up.parent].child2 = iUp;
+	}
+
+	// up の子のうち高い方を up に残し、低い方を A に渡す
+	int32_t iKeep = f.height > g.height ? iF : iG;
+	int32_t iGive = f.height > g.height ? iG : iF;
+	Node& give = nodes_[iGive];
+	const Node& keep = nodes_[iKeep];
+	const Node& stay = nodes_[iStay];
+	up.child2 = iKeep;
+	if (raiseC) {
+		a.child2 = iGive;
+	} else {
+		a.child1 = iGive;
+	}
+	give.parent = iA;
+
+	a.box = AABBMerge(stay.box, give.box);
+	a.height = 1 + (std::max)(stay.height, give.height);
+
+	// 内部ノードを兄弟にして葉を挿入したときは stay が葉で give が高いことがあり、
+	// 1回の回転では A の左右の差が残るので A も釣り合わせる（A の位置には新しい根が入る）
+	const Node& lower = nodes_[Balance(iA)];
+	up.box = AABBMerge(lower.box, keep.box);
+	up.height = 1 + (std::max)(lower.height, keep.height);
+	return iUp;
+}
@@ -0,0 +1,296 @@
+﻿#pragma once
+
+#include "Geometry.h"
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 動的な境界ボリューム階層（AABB の二分木）
+/// オブジェクトの境界を少し広げた「太らせたボックス」で登録し、
+/// 移動してもボックスからはみ出さない限り木を組み替えない
+/// </summary>
+class DynamicBvh {
+  public:
+	// 登録したオブジェクトの識別子（削除するまで変わらない）
+	using ProxyId = int32_t;
+	static const ProxyId kNullProxy = -1;
+
+	// ボックスを太らせる量の既定値
+	static constexpr float kDefaultMargin = 0.1f;
+	// 移動量の何倍だけ移動方向に先回りして広げるか
+	static constexpr float kDisplacementMultiplier = 2.0f;
+	// 再構築で表面積の見積もりに使う区間の数
+	static const uint32_t kBinCount = 12;
+
+  public: // 登録
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="margin">ボックスを太らせる量</param>
+	explicit DynamicBvh(float margin = kDefaultMargin) : margin_(margin) {}
+
+	/// <summary>
+	/// オブジェクトの登録
+	/// </summary>
+	/// <param name="box">オブジェクトの境界</param>
+	/// <param name="userData">利用側のデータ（エンティティ番号など）</param>
+	ProxyId CreateProxy(const AABB& box, uint32_t userData);
+	/// <summary>
+	/// オブジェクトの削除
+	/// </summary>
+	void DestroyProxy(ProxyId proxy);
+	/// <summary>
+	/// オブジェクトの移動
+	/// 太らせたボックスに収まっていれば何もしない。はみ出したら挿入し直す
+	/// </summary>
+	/// <param name="displacement">前回からの移動量（この方向にボックスを広げておく）</param>
+	/// <returns>木を組み替えたか</returns>
+	bool MoveProxy(ProxyId proxy, const AABB& box, const Vector3& displacement = {0, 0, 0});
+	/// <summary>
+	/// 木の形を変えずにボックスを更新し、祖先のボックスを合わせ直す
+	/// 挿入し直すより安いが木の質が下がるので、RebuildIfDegraded と組み合わせて使う
+	/// </summary>
+	void RefitProxy(ProxyId proxy, const AABB& box);
+	/// <summary>
+	/// 全削除
+	/// </summary>
+	void Clear();
+
+  public: // 再構築
+	/// <summary>
+	/// 表面積ヒューリスティック（SAH）で木全体を作り直す（識別子は変わらない）
+	/// </summary>
+	void Rebuild();
+	/// <summary>
+	/// 前回の再構築時より木の質が一定以上下がっていれば作り直す（毎フレーム呼んでよい）
+	/// </summary>
+	/// <param name="maxCostRatio">前回の再構築直後のコストに対する許容倍率</param>
+	/// <returns>作り直したか</returns>
+	bool RebuildIfDegraded(float maxCostRatio = 1.5f);
+	/// <summary>
+	/// 木のコスト（内部ノードの表面積の和をルートの表面積で割ったもの）
+	/// </summary>
+	float ComputeCost() const;
+
+  public: // 取得
+	uint32_t GetUserData(ProxyId proxy) const { return nodes_[proxy].userData; }
+	// 太らせたボックス
+	const AABB& GetFatAABB(ProxyId proxy) const { return nodes_[proxy].box; }
+	uint32_t GetProxyCount() const { return proxyCount_; }
+	// 木の高さ（葉だけなら0）
+	int32_t GetHeight() const { return root_ == kNullProxy ? 0 : nodes_[root_].height; }
+	// 内部ノードの左右の子の高さの差の最大値（挿入・削除だけなら回転で1以下に保たれる）
+	int32_t GetMaxBalance() const;
+	/// <summary>
+	/// 親子のつながり、高さ、ボックスの包含、葉と空きノードの数を assert で確かめる（テスト用）
+	/// </summary>
+	void Validate() const;
+
+  public: // 問い合わせ（callback は ProxyId を受け取り、false を返すと打ち切る）
+	/// <summary>
+	/// ボックスと重なるオブジェクト
+	/// </summary>
+	template<class Callback> void QueryAABB(const AABB& box, Callback&& callback) const {
+		Query(
+		  [&box](const AABB& nodeBox) { return MathUtility::AABBIntersects(nodeBox, box); }, callback);
+	}
+	/// <summary>
+	/// 球と重なるオブジェクト
+	/// </summary>
+	template<class Callback> void QuerySphere(const Sphere& sphere, Callback&& callback) const {
+		Query(
+		  [&sphere](const AABB& nodeBox) { return MathUtility::AABBIntersectsSphere(nodeBox, sphere); },
+		  callback);
+	}
+	/// <summary>
+	/// 視錐台と重なるオブジェクト
+	/// 完全に内側にある部分木は、それ以上判定せずにすべて列挙する
+	/// </summary>
+	template<class Callback> void QueryFrustum(const Frustum& frustum, Callback&& callback) const {
+		if (root_ == kNullProxy) {
+			return;
+		}
+		NodeStack stack;
+		stack.Push(root_, (1u << Frustum::kPlaneCount) - 1);
+		while (!stack.IsEmpty()) {
+			auto [index, planeMask] = stack.Pop();
+			const Node& node = nodes_[index];
+			MathUtility::Containment containment =
+			  MathUtility::FrustumClassifyAABB(frustum, node.box, planeMask);
+			if (containment == MathUtility::Containment::kOutside) {
+				continue;
+			}
+			if (node.IsLeaf()) {
+				if (!callback(static_cast<ProxyId>(index))) {
+					return;
+				}
+			} else if (containment == MathUtility::Containment::kInside) {
+				if (!EnumerateLeaves(index, callback)) {
+					return;
+				}
+			} else {
+				stack.Push(node.child2, planeMask);
+				stack.Push(node.child1, planeMask);
+			}
+		}
+	}
+	/// <summary>
+	/// 半直線と重なるオブジェクトを近い順に近似的に調べる
+	/// callback(proxy, maxT) は、オブジェクトと交差すればその位置（以降はそれより遠いものを無視する）を、
+	/// しなければ maxT をそのまま返す。負の値を返すと打ち切る（0 は始点での交差として扱う）
+	/// </summary>
+	template<class Callback> void RayCast(const Ray& ray, float maxT, Callback&& callback) const {
+		if (root_ == kNullProxy) {
+			return;
+		}
+		const Vector3 inverseDirection = MathUtility::RayInverseDirection(ray);
+		float t;
+		if (!MathUtility::RayIntersectsAABB(ray, inverseDirection, nodes_[root_].box, maxT, t)) {
+			return;
+		}
+		NodeStack stack;
+		stack.Push(root_, std::bit_cast<uint32_t>(t));
+		while (!stack.IsEmpty()) {
+			auto [index, enterBits] = stack.Pop();
+			// 積んだ後で maxT が縮んでいれば飛ばす
+			if (std::bit_cast<float>(enterBits) > maxT) {
+				continue;
+			}
+			const Node& node = nodes_[index];
+			if (node.IsLeaf()) {
+				maxT = callback(static_cast<ProxyId>(index), maxT);
+				if (maxT < 0.0f) {
+					return;
+				}
+				continue;
+			}
+			float t1, t2;
+			bool hit1 = MathUtility::RayIntersectsAABB(
+			  ray, inverseDirection, nodes_[node.child1].box, maxT, t1);
+			bool hit2 = MathUtility::RayIntersectsAABB(
+			  ray, inverseDirection, nodes_[node.child2].box, maxT, t2);
+			// 近い方を後に積んで先に調べる
+			if (hit1 && hit2 && t1 < t2) {
+				stack.Push(node.child2, std::bit_cast<uint32_t>(t2));
+				stack.Push(node.child1, std::bit_cast<uint32_t>(t1));
+			} else {
+				if (hit1) {
+					stack.Push(node.child1, std::bit_cast<uint32_t>(t1));
+				}
+				if (hit2) {
+					stack.Push(node.child2, std::bit_cast<uint32_t>(t2));
+				}
+			}
+		}
+	}
+
+  private: // メンバ関数
+	struct Node {
+		AABB box;
+		// 親（未使用のノードでは次の空きノード）
+		int32_t parent = kNullProxy;
+		int32_t child1 = kNullProxy;
+		int32_t child2 = kNullProxy;
+		// 葉は0、未使用は-1
+		int32_t height = -1;
+		uint32_t userData = 0;
+
+		bool IsLeaf() const { return child1 == kNullProxy; }
+	};
+
+	// 走査用のスタック（浅いうちは確保しない）
+	class NodeStack {
+	  public:
+		struct Entry {
+			int32_t index;
+			uint32_t value;
+		};
+		void Push(int32_t index, uint32_t value) {
+			if (size_ < kLocalSize) {
+				local_[size_] = {index, value};
+			} else {
+				overflow_.push_back({index, value});
+			}
+			size_++;
+		}
+		Entry Pop() {
+			size_--;
+			if (size_ < kLocalSize) {
+				return local_[size_];
+			}
+			Entry entry = overflow_.back();
+			overflow_.pop_back();
+			return entry;
+		}
+		bool IsEmpty() const { return size_ == 0; }
+
+	  private:
+		static const uint32_t kLocalSize = 128;
+		Entry local_[kLocalSize];
+		std::vector<Entry> overflow_;
+		uint32_t size_ = 0;
+	};
+
+	template<class Overlaps, class Callback>
+	void Query(const Overlaps& overlaps, Callback& callback) const {
+		if (root_ == kNullProxy) {
+			return;
+		}
+		NodeStack stack;
+		stack.Push(root_, 0);
+		while (!stack.IsEmpty()) {
+			int32_t index = stack.Pop().index;
+			const Node& node = nodes_[index];
+			if (!overlaps(node.box)) {
+				continue;
+			}
+			if (node.IsLeaf()) {
+				if (!callback(static_cast<ProxyId>(index))) {
+					return;
+				}
+			} else {
+				stack.Push(node.child2, 0);
+				stack.Push(node.child1, 0);
+			}
+		}
+	}
+
+	// 部分木の葉をすべて列挙する（打ち切られたら false）
+	template<class Callback> bool EnumerateLeaves(int32_t root, Callback& callback) const {
+		NodeStack stack;
+		stack.Push(root, 0);
+		while (!stack.IsEmpty()) {
+			int32_t index = stack.Pop().index;
+			const Node& node = nodes_[index];
+			if (node.IsLeaf()) {
+				if (!callback(static_cast<ProxyId>(index))) {
+					return false;
+				}
+			} else {
+				stack.Push(node.child2, 0);
+				stack.Push(node.child1, 0);
+			}
+		}
+		return true;
+	}
+
+	int32_t AllocateNode();
+	void FreeNode(int32_t index);
+	void InsertLeaf(int32_t leaf);
+	void RemoveLeaf(int32_t leaf);
+	// index から根まで、回転で釣り合いを取りながら高さとボックスを直す
+	void FixUpwards(int32_t index);
+	// 左右の高さの差が2以上なら回転する（新しい部分木の根を返す）
+	int32_t Balance(int32_t index);
+	AABB Fatten(const AABB& box) const { return MathUtility::AABBExpand(box, margin_); }
+
+  private: // メンバ変数
+	std::vector<Node> nodes_;
+	int32_t root_ = kNullProxy;
+	int32_t freeList_ = kNullProxy;
+	uint32_t proxyCount_ = 0;
+	float margin_;
+	// 直前の再構築直後のコスト（まだなら0）
+	float rebuildCost_ = 0.0f;
+};
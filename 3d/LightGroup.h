@@ -72,6 +72,11 @@ public: // メンバ関数
 	/// </summary>
 	void Draw(ID3D12GraphicsCommandList* cmdList, UINT rootParameterIndex);
 
+	/// <summary>
+	/// 定数バッファの取得
+	/// </summary>
+	ID3D12Resource* GetConstBuffer() { return constBuff_.Get(); }
+
 	/// <summary>
 	/// 定数バッファ転送
 	/// </summary>
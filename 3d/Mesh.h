@@ -4,6 +4,7 @@
 #include "Vector2.h"
 #include "Vector3.h"
 #include <Windows.h>
+#include <cassert>
 #include <d3d12.h>
 #include <d3dx12.h>
 #include <unordered_map>
@@ -14,6 +15,9 @@
 /// 形状データ
 /// </summary>
 class Mesh {
+	// 読み込み済みの頂点とインデックスを直接渡す
+	friend class ModelLoader;
+
   private: // エイリアス
 	// Microsoft::WRL::を省略
 	template<class T> using ComPtr = Microsoft::WRL::ComPtr<T>;
@@ -98,6 +102,22 @@ class Mesh {
 	/// <returns>インデックスバッファ</returns>
 	const D3D12_INDEX_BUFFER_VIEW& GetIBView() { return ibView_; }
 
+	/// <summary>
+	/// インデックスの数を取得
+	/// 頂点が 65536 個を超えるメッシュは32ビットのインデックスバッファだけを持ち、indices_ は空のままなので
+	/// バッファの大きさと形式から求める
+	/// </summary>
+	/// <returns>インデックスの数</returns>
+	UINT GetIndexCount() {
+		return ibView_.SizeInBytes / (HasWideIndices() ? 4 : 2);
+	}
+
+	/// <summary>
+	/// 32ビットのインデックスバッファを持つか
+	/// 持つメッシュは ModelRenderQueue でだけ描画する（Draw は indices_ の数で描画するので何も描かない）
+	/// </summary>
+	bool HasWideIndices() const { return ibView_.Format == DXGI_FORMAT_R32_UINT; }
+
 	/// <summary>
 	/// 描画
 	/// </summary>
@@ -126,10 +146,13 @@ class Mesh {
 	inline const std::vector<VertexPosNormalUv>& GetVertices() { return vertices_; }
 
 	/// <summary>
-	/// インデックス配列を取得
+	/// インデックス配列を取得（32ビットのインデックスバッファを持つメッシュでは使えない）
 	/// </summary>
 	/// <returns>インデックス配列</returns>
-	inline const std::vector<unsigned short>& GetIndices() { return indices_; }
+	inline const std::vector<unsigned short>& GetIndices() {
+		assert(!HasWideIndices());
+		return indices_;
+	}
 
   private: // メンバ変数
 	// 名前
@@ -0,0 +1,336 @@
+﻿#include "MeshOptimizer.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// FIFO の頂点キャッシュ（頂点ごとに入った時刻を持ち、cacheSize 回より前なら追い出されたとみなす）
+class FifoCache {
+  public:
+	FifoCache(size_t vertexCount, uint32_t cacheSize)
+	    : timestamps_(vertexCount, 0), cacheSize_(cacheSize), time_(cacheSize + 1) {}
+
+	// 頂点を使い、キャッシュに無かったら true
+	bool Access(uint32_t vertex) {
+		if (time_ - timestamps_[vertex] > cacheSize_) {
+			timestamps_[vertex] = time_++;
+			return true;
+		}
+		return false;
+	}
+
+	// 空にする
+	void Reset() { time_ += cacheSize_ + 1; }
+
+  private:
+	std::vector<uint32_t> timestamps_;
+	uint32_t cacheSize_;
+	uint32_t time_;
+};
+
+// 頂点から、その頂点を使う三角形への対応
+struct Adjacency {
+	std::vector<uint32_t> offsets; // 頂点ごとの先頭（末尾に合計を置く）
+	std::vector<uint32_t> triangles;
+
+	Adjacency(const std::vector<uint32_t>& indices, size_t vertexCount) {
+		offsets.assign(vertexCount + 1, 0);
+		for (uint32_t index : indices) {
+			offsets[index + 1]++;
+		}
+		std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+		triangles.resize(indices.size());
+		std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+		for (uint32_t i = 0; i < indices.size(); i++) {
+			triangles[cursor[indices[i]]++] = i / 3;
+		}
+	}
+};
+
+} // namespace
+
+double MeshOptimizer::CacheStats::GetAcmr() const {
+	return triangleCount == 0 ? 0.0 : static_cast<double>(transformedCount) / triangleCount;
+}
+
+double MeshOptimizer::CacheStats::GetAtvr() const {
+	return vertexCount == 0 ? 0.0 : static_cast<double>(transformedCount) / vertexCount;
+}
+
+MeshOptimizer::CacheStats& MeshOptimizer::CacheStats::operator+=(const CacheStats& other) {
+	triangleCount += other.triangleCount;
+	vertexCount += other.vertexCount;
+	transformedCount += other.transformedCount;
+	return *this;
+}
+
+MeshOptimizer::Stats& MeshOptimizer::Stats::operator+=(const Stats& other) {
+	before += other.before;
+	after += other.after;
+	return *this;
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::AnalyzeVertexCache(
+  const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize) {
+	CacheStats stats;
+	stats.triangleCount = indices.size() / 3;
+
+	FifoCache cache(vertexCount, cacheSize);
+	std::vector<bool> used(vertexCount, false);
+	for (uint32_t index : indices) {
+		if (cache.Access(index)) {
+			stats.transformedCount++;
+		}
+		if (!used[index]) {
+			used[index] = true;
+			stats.vertexCount++;
+		}
+	}
+	return stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(
+  std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize) {
+	const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+	if (triangleCount == 0) {
+		return;
+	}
+	Adjacency adjacency(indices, vertexCount);
+
+	// 頂点ごとの、まだ出力していない三角形の数
+	std::vector<uint32_t> liveCount(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++) {
+		liveCount[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+	}
+	// 頂点がキャッシュに入った時刻
+	std::vector<uint32_t> timestamps(vertexCount, 0);
+	uint32_t time = cacheSize + 1;
+	std::vector<bool> emitted(triangleCount, false);
+	// 行き止まりで戻る先の候補（最近出力した頂点）
+	std::vector<uint32_t> deadEnd;
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	uint32_t cursor = 0;
+
+	// 行き止まりのとき、まだ三角形が残っている頂点を探す
+	auto skipDeadEnd = [&]() -> int64_t {
+		while (!deadEnd.empty()) {
+			uint32_t vertex = deadEnd.back();
+			deadEnd.pop_back();
+			if (liveCount[vertex] > 0) {
+				return vertex;
+			}
+		}
+		for (; cursor < vertexCount; cursor++) {
+			if (liveCount[cursor] > 0) {
+				return cursor;
+			}
+		}
+		return -1;
+	};
+
+	int64_t fan = skipDeadEnd();
+	while (fan >= 0) {
+		// 中心の頂点を使う三角形をすべて出力する
+		candidates.clear();
+		for (uint32_t k = adjacency.offsets[fan]; k < adjacency.offsets[fan + 1]; k++) {
+			uint32_t triangle = adjacency.triangles[k];
+			if (emitted[triangle]) {
+				continue;
+			}
+			emitted[triangle] = true;
+			for (int c = 0; c < 3; c++) {
+				uint32_t vertex = indices[triangle * 3 + c];
+				result.push_back(vertex);
+				deadEnd.push_back(vertex);
+				candidates.push_back(vertex);
+				liveCount[vertex]--;
+				if (time - timestamps[vertex] > cacheSize) {
+					timestamps[vertex] = time++;
+				}
+			}
+		}
+
+		// 次の中心は、残りの三角形を出力してもキャッシュに残っている頂点のうち最も古いもの
+		int64_t next = -1;
+		uint32_t best = 0;
+		for (uint32_t vertex : candidates) {
+			if (liveCount[vertex] == 0) {
+				continue;
+			}
+			uint32_t priority = 0;
+			uint32_t age = time - timestamps[vertex];
+			if (age + 2 * liveCount[vertex] <= cacheSize) {
+				priority = age;
+			}
+			if (next < 0 || priority > best) {
+				best = priority;
+				next = vertex;
+			}
+		}
+		fan = next >= 0 ? next : skipDeadEnd();
+	}
+	indices.swap(result);
+}
+
+void MeshOptimizer::OptimizeOverdraw(
+  std::vector<uint32_t>& indices, const std::vector<ObjVertex>& vertices, float threshold,
+  uint32_t cacheSize) {
+	const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+	if (triangleCount == 0) {
+		return;
+	}
+
+	// 3頂点とも変換が必要な三角形（キャッシュが入れ替わった所）でかたまりを区切る
+	std::vector<uint32_t> clusters;
+	{
+		FifoCache cache(vertices.size(), cacheSize);
+		for (uint32_t t = 0; t < triangleCount; t++) {
+			uint32_t misses = 0;
+			for (int c = 0; c < 3; c++) {
+				misses += cache.Access(indices[t * 3 + c]);
+			}
+			if (t == 0 || misses == 3) {
+				clusters.push_back(t);
+			}
+		}
+		clusters.push_back(triangleCount);
+	}
+
+	// 大きなかたまりは、そこまでの ACMR がかたまり全体の threshold 倍以内に収まる所でさらに分ける
+	std::vector<uint32_t> splits;
+	{
+		FifoCache cache(vertices.size(), cacheSize);
+		for (size_t i = 0; i + 1 < clusters.size(); i++) {
+			uint32_t begin = clusters[i];
+			uint32_t end = clusters[i + 1];
+			// かたまりだけを描いたときの ACMR
+			cache.Reset();
+			uint32_t clusterMisses = 0;
+			for (uint32_t t = begin * 3; t < end * 3; t++) {
+				clusterMisses += cache.Access(indices[t]);
+			}
+			double clusterAcmr = static_cast<double>(clusterMisses) / (end - begin);
+
+			cache.Reset();
+			splits.push_back(begin);
+			uint32_t start = begin;
+			uint32_t misses = 0;
+			for (uint32_t t = begin; t < end; t++) {
+				for (int c = 0; c < 3; c++) {
+					misses += cache.Access(indices[t * 3 + c]);
+				}
+				uint32_t count = t - start + 1;
+				if (t + 1 < end && static_cast<double>(misses) / count <= clusterAcmr * threshold) {
+					splits.push_back(t + 1);
+					start = t + 1;
+					misses = 0;
+					cache.Reset();
+				}
+			}
+		}
+		splits.push_back(triangleCount);
+	}
+
+	// 全体の中心
+	Vector3 meshCenter;
+	for (const ObjVertex& vertex : vertices) {
+		meshCenter += vertex.pos;
+	}
+	if (!vertices.empty()) {
+		meshCenter = meshCenter / static_cast<float>(vertices.size());
+	}
+
+	// かたまりの面積で重みを付けた中心と法線から、中心から外を向いている度合いを求める
+	const size_t clusterCount = splits.size() - 1;
+	std::vector<float> sortKeys(clusterCount);
+	for (size_t i = 0; i < clusterCount; i++) {
+		Vector3 center;
+		Vector3 normal;
+		float area = 0.0f;
+		for (uint32_t t = splits[i]; t < splits[i + 1]; t++) {
+			const Vector3& p0 = vertices[indices[t * 3 + 0]].pos;
+			const Vector3& p1 = vertices[indices[t * 3 + 1]].pos;
+			const Vector3& p2 = vertices[indices[t * 3 + 2]].pos;
+			Vector3 cross = (p1 - p0).Cross(p2 - p0);
+			float triangleArea = cross.Magnitude();
+			center += (p0 + p1 + p2) * (triangleArea / 3.0f);
+			normal += cross;
+			area += triangleArea;
+		}
+		if (area > 0.0f) {
+			center = center / area;
+		}
+		normal.Normalize();
+		sortKeys[i] = (center - meshCenter).Dot(normal);
+	}
+
+	// 外を向いているかたまりほど手前にあることが多いので先に描く
+	std::vector<uint32_t> order(clusterCount);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+		return sortKeys[a] > sortKeys[b];
+	});
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	for (uint32_t cluster : order) {
+		result.insert(
+		  result.end(), indices.begin() + splits[cluster] * 3,
+		  indices.begin() + splits[cluster + 1] * 3);
+	}
+	indices.swap(result);
+}
+
+size_t MeshOptimizer::OptimizeVertexFetch(
+  std::vector<ObjVertex>& vertices, std::vector<uint32_t>& indices) {
+	const uint32_t kUnused = UINT32_MAX;
+	std::vector<uint32_t> remap(vertices.size(), kUnused);
+	std::vector<ObjVertex> result;
+	result.reserve(vertices.size());
+	for (uint32_t& index : indices) {
+		if (remap[index] == kUnused) {
+			remap[index] = static_cast<uint32_t>(result.size());
+			result.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+	vertices.swap(result);
+	return vertices.size();
+}
+
+MeshOptimizer::Stats MeshOptimizer::Optimize(ObjMesh& mesh, bool overdraw) {
+	Stats stats;
+	stats.before = AnalyzeVertexCache(mesh.indices, mesh.vertices.size());
+	if (mesh.indices.size() % 3 != 0) {
+		stats.after = stats.before;
+		return stats;
+	}
+
+	OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+	if (overdraw) {
+		OptimizeOverdraw(mesh.indices, mesh.vertices);
+	}
+	OptimizeVertexFetch(mesh.vertices, mesh.indices);
+
+	stats.after = AnalyzeVertexCache(mesh.indices, mesh.vertices.size());
+	return stats;
+}
+
+MeshOptimizer::Stats MeshOptimizer::Optimize(ObjModelData& data, bool overdraw) {
+	std::vector<Stats> meshStats(data.meshes.size());
+	JobSystem::GetInstance()->ParallelFor(
+	  0, static_cast<uint32_t>(data.meshes.size()), 1, [&](uint32_t first, uint32_t last) {
+		  for (uint32_t i = first; i < last; i++) {
+			  meshStats[i] = Optimize(data.meshes[i], overdraw);
+		  }
+	  });
+
+	Stats stats;
+	for (const Stats& s : meshStats) {
+		stats += s;
+	}
+	return stats;
+}
@@ -0,0 +1,88 @@
+﻿#pragma once
+
+#include "ObjLoader.h"
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 描画向けのインデックスと頂点の並べ替え（CPU だけで動き、Direct3D 12 に依存しない）
+/// 1. 頂点キャッシュ: 三角形を Tipsify（Sander ほか 2007）で並べ替え、変換済み頂点の再利用を増やす
+/// 2. オーバードロー: キャッシュの切れ目で三角形をかたまりに分け、外側を向いたかたまりから描く
+/// 3. 頂点フェッチ: 頂点をインデックスで最初に使われる順に並べ替える（使われない頂点は除く）
+/// 効果は FIFO の頂点キャッシュを模擬した ACMR（三角形あたりの変換回数）と
+/// ATVR（頂点あたりの変換回数。1 が最良）で測る
+/// </summary>
+class MeshOptimizer {
+  public: // 定数
+	// 模擬する頂点キャッシュの大きさ
+	static const uint32_t kCacheSize = 16;
+	// オーバードローの並べ替えで許す ACMR の悪化の割合
+	static constexpr float kOverdrawThreshold = 1.05f;
+
+  public: // サブクラス
+	// 頂点キャッシュの模擬結果
+	struct CacheStats {
+		uint64_t triangleCount = 0;
+		uint64_t vertexCount = 0;      // インデックスで使われている頂点の数
+		uint64_t transformedCount = 0; // キャッシュに無く変換した回数
+
+		double GetAcmr() const;
+		double GetAtvr() const;
+		CacheStats& operator+=(const CacheStats& other);
+	};
+
+	// 最適化の前後
+	struct Stats {
+		CacheStats before;
+		CacheStats after;
+
+		Stats& operator+=(const Stats& other);
+	};
+
+  public: // 静的メンバ関数
+	/// <summary>
+	/// FIFO の頂点キャッシュを模擬する
+	/// </summary>
+	/// <param name="indices">三角形リストのインデックス</param>
+	/// <param name="vertexCount">頂点の数</param>
+	/// <param name="cacheSize">キャッシュの大きさ</param>
+	static CacheStats AnalyzeVertexCache(
+	  const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = kCacheSize);
+
+	/// <summary>
+	/// 頂点キャッシュに合わせて三角形を並べ替える（Tipsify）
+	/// </summary>
+	static void OptimizeVertexCache(
+	  std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = kCacheSize);
+
+	/// <summary>
+	/// オーバードローが減るよう、かたまりごとに三角形を並べ替える
+	/// OptimizeVertexCache の後に呼ぶ。かたまりの中の順番は変えない
+	/// </summary>
+	/// <param name="indices">三角形リストのインデックス</param>
+	/// <param name="vertices">頂点（座標だけを使う）</param>
+	/// <param name="threshold">かたまりを細かく分けるときに許す ACMR の悪化の割合</param>
+	/// <param name="cacheSize">キャッシュの大きさ</param>
+	static void OptimizeOverdraw(
+	  std::vector<uint32_t>& indices, const std::vector<ObjVertex>& vertices,
+	  float threshold = kOverdrawThreshold, uint32_t cacheSize = kCacheSize);
+
+	/// <summary>
+	/// 頂点をインデックスで最初に使われる順に並べ替え、インデックスを付け替える
+	/// </summary>
+	/// <returns>残った頂点の数</returns>
+	static size_t OptimizeVertexFetch(std::vector<ObjVertex>& vertices, std::vector<uint32_t>& indices);
+
+	/// <summary>
+	/// 1つのメッシュに3つの最適化を順にかける
+	/// インデックスの数が3の倍数でない（点や線の面を含む）メッシュはそのままにする
+	/// </summary>
+	/// <param name="mesh">メッシュ</param>
+	/// <param name="overdraw">オーバードローの並べ替えもするか</param>
+	static Stats Optimize(ObjMesh& mesh, bool overdraw = true);
+
+	/// <summary>
+	/// すべてのメッシュを最適化する（メッシュごとに JobSystem で並列に処理する）
+	/// </summary>
+	static Stats Optimize(ObjModelData& data, bool overdraw = true);
+};
@@ -13,6 +13,11 @@
 /// モデルデータ
 /// </summary>
 class Model {
+	// 描画キューはパイプラインとライトを直接設定する
+	friend class ModelRenderQueue;
+	// 読み込み済みのデータからメッシュとマテリアルを組み立てる
+	friend class ModelLoader;
+
   private: // エイリアス
 	// Microsoft::WRL::を省略
 	template<class T> using ComPtr = Microsoft::WRL::ComPtr<T>;
@@ -0,0 +1,241 @@
+﻿#include "ModelLoader.h"
+#include "CookedMesh.h"
+#include "DirectXCommon.h"
+#include "MeshOptimizer.h"
+#include "VertexWelder.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+// アップロードヒープにバッファを作り、中身を書き込む
+Microsoft::WRL::ComPtr<ID3D12Resource> CreateUploadBuffer(const void* data, size_t size) {
+	HRESULT result;
+	Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+
+	// ヒーププロパティ
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	// リソース設定
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer((std::max)(size, size_t(1)));
+
+	// バッファの生成
+	result = DirectXCommon::GetInstance()->GetDevice()->CreateCommittedResource(
+	  &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	  IID_PPV_ARGS(&buffer));
+	assert(SUCCEEDED(result));
+
+	// 割り当てたファイルの中身をそのまま転送
+	void* map = nullptr;
+	result = buffer->Map(0, nullptr, &map);
+	assert(SUCCEEDED(result));
+	if (size > 0) {
+		std::memcpy(map, data, size);
+	}
+	buffer->Unmap(0, nullptr);
+
+	return buffer;
+}
+
+} // namespace
+
+Model* ModelLoader::CreateFromOBJ(const std::string& modelname, bool smoothing) {
+	const std::string directoryPath = Model::kBaseDirectory + modelname + "/";
+
+	ObjModelData data;
+	bool result = ObjLoader::LoadFile(directoryPath + modelname + ".obj", smoothing, data);
+	assert(result);
+
+	// 同じ頂点をまとめ、頂点キャッシュに合わせて並べ替える
+	VertexWelder::Stats stats = VertexWelder::Weld(data);
+	MeshOptimizer::Stats optimizerStats = MeshOptimizer::Optimize(data);
+	char message[256];
+	std::snprintf(
+	  message, sizeof(message), "%s: vertices %llu -> %llu (%.2fx), %llu -> %llu bytes\n",
+	  modelname.c_str(), static_cast<unsigned long long>(stats.vertexCountBefore),
+	  static_cast<unsigned long long>(stats.vertexCountAfter), stats.GetVertexRatio(),
+	  static_cast<unsigned long long>(stats.GetBytesBefore()),
+	  static_cast<unsigned long long>(stats.GetBytesAfter()));
+	OutputDebugStringA(message);
+	std::snprintf(
+	  message, sizeof(message), "%s: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", modelname.c_str(),
+	  optimizerStats.before.GetAcmr(), optimizerStats.after.GetAcmr(),
+	  optimizerStats.before.GetAtvr(), optimizerStats.after.GetAtvr());
+	OutputDebugStringA(message);
+
+	return CreateFromData(modelname, data);
+}
+
+Model* ModelLoader::CreateFromData(const std::string& modelname, const ObjModelData& data) {
+	const std::string directoryPath = Model::kBaseDirectory + modelname + "/";
+
+	Model* model = new Model;
+	model->name_ = modelname;
+
+	// マテリアルライブラリを順に読み、各マテリアルが何個目のライブラリで使えるようになったかを記録する
+	std::unordered_map<std::string, uint32_t> libraryCountOf;
+	for (uint32_t i = 0; i < data.materialLibraries.size(); i++) {
+		model->LoadMaterial(directoryPath, data.materialLibraries[i]);
+		for (const auto& material : model->materials_) {
+			libraryCountOf.emplace(material.first, i + 1);
+		}
+	}
+
+	static_assert(
+	  sizeof(ObjVertex) == sizeof(Mesh::VertexPosNormalUv), "頂点データの並びをそろえること");
+	for (const ObjMesh& objMesh : data.meshes) {
+		Mesh* mesh = new Mesh;
+		model->meshes_.emplace_back(mesh);
+		mesh->SetName(objMesh.name);
+
+		mesh->vertices_.resize(objMesh.vertices.size());
+		if (!objMesh.vertices.empty()) {
+			std::memcpy(
+			  mesh->vertices_.data(), objMesh.vertices.data(),
+			  objMesh.vertices.size() * sizeof(ObjVertex));
+		}
+		if (ObjLoader::GetIndexSize(objMesh.vertices.size()) == sizeof(unsigned short)) {
+			// 16ビットで足りるものは Model::CreateFromOBJ と同じバッファにする
+			mesh->indices_.resize(objMesh.indices.size());
+			std::transform(
+			  objMesh.indices.begin(), objMesh.indices.end(), mesh->indices_.begin(),
+			  [](uint32_t index) { return static_cast<unsigned short>(index); });
+			mesh->CreateBuffers();
+		} else {
+			// 32ビットのインデックスバッファだけを作る（indices_ は空のまま。ModelRenderQueue で描画する）
+			CreateBuffers(
+			  mesh, objMesh.vertices.data(), objMesh.vertices.size(), objMesh.indices.data(),
+			  objMesh.indices.size(), DXGI_FORMAT_R32_UINT);
+		}
+
+		// その行の時点で読み込まれていたマテリアルのうち、最初に見つかったものを使う
+		for (const ObjMaterialUse& use : objMesh.materialUses) {
+			auto itr = libraryCountOf.find(use.name);
+			if (itr != libraryCountOf.end() && itr->second <= use.libraryCount) {
+				mesh->SetMaterial(model->materials_[use.name]);
+				break;
+			}
+		}
+	}
+
+	FinishModel(model);
+
+	return model;
+}
+
+Model* ModelLoader::CreateFromMesh(const std::string& modelname, bool smoothing) {
+	const std::string directoryPath = Model::kBaseDirectory + modelname + "/";
+	const std::string objPath = directoryPath + modelname + ".obj";
+	const std::string meshPath = directoryPath + modelname + ".mesh";
+
+	// 元の OBJ・MTL が変わっていれば作り直す
+	if (!CookedMesh::IsUpToDate(meshPath, objPath, smoothing)) {
+		bool result = CookedMesh::Cook(objPath, meshPath, smoothing);
+		assert(result);
+	}
+	CookedMesh cooked;
+	bool result = cooked.Open(meshPath);
+	assert(result);
+	const CookedMesh::Header& header = cooked.GetHeader();
+
+	Model* model = new Model;
+	model->name_ = modelname;
+
+	for (const CookedMesh::String& library : cooked.GetLibraries()) {
+		model->LoadMaterial(directoryPath, std::string(cooked.GetString(library)));
+	}
+
+	const uint8_t* indexData = static_cast<const uint8_t*>(cooked.GetIndexData());
+	for (const CookedMesh::Submesh& submesh : cooked.GetSubmeshes()) {
+		Mesh* mesh = new Mesh;
+		model->meshes_.emplace_back(mesh);
+		mesh->SetName(std::string(cooked.GetString(submesh.name)));
+
+		// 変換時に使えると確かめたマテリアル
+		if (submesh.material != CookedMesh::kNoMaterial) {
+			std::string name(cooked.GetString(cooked.GetMaterials()[submesh.material]));
+			auto itr = model->materials_.find(name);
+			if (itr != model->materials_.end()) {
+				mesh->SetMaterial(itr->second);
+			}
+		}
+
+		// 頂点とインデックスは割り当てたファイルから GPU バッファへ直接書き込む
+		// （vertices_ は空のまま。16ビットのメッシュは Model::Draw でも描けるよう indices_ に写す）
+		const ObjVertex* vertices = cooked.GetVertices().data() + submesh.vertexOffset;
+		const uint8_t* indices =
+		  indexData + static_cast<size_t>(submesh.indexOffset) * header.indexSize;
+		if (header.indexSize == sizeof(uint32_t) &&
+		    ObjLoader::GetIndexSize(submesh.vertexCount) == sizeof(unsigned short)) {
+			// ファイルは32ビットでも、このメッシュは16ビットで足りる
+			mesh->indices_.resize(submesh.indexCount);
+			const uint32_t* wideIndices = reinterpret_cast<const uint32_t*>(indices);
+			std::transform(
+			  wideIndices, wideIndices + submesh.indexCount, mesh->indices_.begin(),
+			  [](uint32_t index) { return static_cast<unsigned short>(index); });
+			CreateBuffers(
+			  mesh, vertices, submesh.vertexCount, mesh->indices_.data(), submesh.indexCount,
+			  DXGI_FORMAT_R16_UINT);
+		} else if (header.indexSize == sizeof(uint32_t)) {
+			CreateBuffers(
+			  mesh, vertices, submesh.vertexCount, indices, submesh.indexCount,
+			  DXGI_FORMAT_R32_UINT);
+		} else {
+			const unsigned short* shortIndices = reinterpret_cast<const unsigned short*>(indices);
+			mesh->indices_.assign(shortIndices, shortIndices + submesh.indexCount);
+			CreateBuffers(
+			  mesh, vertices, submesh.vertexCount, indices, submesh.indexCount,
+			  DXGI_FORMAT_R16_UINT);
+		}
+	}
+
+	FinishModel(model);
+
+	return model;
+}
+
+void ModelLoader::CreateBuffers(
+  Mesh* mesh, const ObjVertex* vertices, size_t vertexCount, const void* indices,
+  size_t indexCount, DXGI_FORMAT indexFormat) {
+	const size_t vertexSize = vertexCount * sizeof(Mesh::VertexPosNormalUv);
+	const size_t indexSize = indexCount * (indexFormat == DXGI_FORMAT_R32_UINT ? 4 : 2);
+	mesh->vertBuff_ = CreateUploadBuffer(vertices, vertexSize);
+	mesh->indexBuff_ = CreateUploadBuffer(indices, indexSize);
+
+	// 頂点バッファビューの作成
+	mesh->vbView_.BufferLocation = mesh->vertBuff_->GetGPUVirtualAddress();
+	mesh->vbView_.SizeInBytes = static_cast<UINT>(vertexSize);
+	mesh->vbView_.StrideInBytes = sizeof(Mesh::VertexPosNormalUv);
+
+	// インデックスバッファビューの作成
+	mesh->ibView_.BufferLocation = mesh->indexBuff_->GetGPUVirtualAddress();
+	mesh->ibView_.Format = indexFormat;
+	mesh->ibView_.SizeInBytes = static_cast<UINT>(indexSize);
+}
+
+void ModelLoader::FinishModel(Model* model) {
+	// メッシュのマテリアルチェック
+	for (Mesh* mesh : model->meshes_) {
+		// マテリアルの割り当てがない
+		if (mesh->GetMaterial() == nullptr) {
+			if (model->defaultMaterial_ == nullptr) {
+				// デフォルトマテリアルを生成
+				model->defaultMaterial_ = Material::Create();
+				model->defaultMaterial_->name_ = "no material";
+				model->materials_.emplace(model->defaultMaterial_->name_, model->defaultMaterial_);
+			}
+			// デフォルトマテリアルをセット
+			mesh->SetMaterial(model->defaultMaterial_);
+		}
+	}
+
+	// マテリアルの数値を定数バッファに反映
+	for (auto& material : model->materials_) {
+		material.second->Update();
+	}
+
+	// テクスチャの読み込み
+	model->LoadTextures();
+}
@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include "Model.h"
+#include "ObjLoader.h"
+#include <string>
+
+/// <summary>
+/// モデルの読み込み
+/// OBJ の解析は ObjLoader で並列に行い、結果を Mesh の頂点・インデックス配列にそのまま移す。
+/// マテリアルの読み込みとバッファの生成は Model::CreateFromOBJ と同じ手順で行う。
+/// CreateFromMesh は変換済みの .mesh（CookedMesh）を割り当て、頂点・インデックスの塊から直接 GPU バッファを作る。
+/// インデックスはメッシュごとに、頂点が 65536 個までなら16ビット、超えれば32ビットにする。
+/// 32ビットのメッシュは GPU バッファだけを持つので、そのモデルは Model::Draw ではなく ModelRenderQueue で描画する
+/// </summary>
+class ModelLoader {
+  public: // 静的メンバ関数
+	/// <summary>
+	/// OBJファイルからモデル生成（Model::CreateFromOBJ と同じ見た目になる）
+	/// 同じ頂点は VertexWelder でまとめて MeshOptimizer で並べ替え、その効果をデバッグ出力に書く
+	/// </summary>
+	/// <param name="modelname">モデル名</param>
+	/// <param name="smoothing">エッジ平滑化フラグ</param>
+	/// <returns>生成されたモデル</returns>
+	static Model* CreateFromOBJ(const std::string& modelname, bool smoothing = false);
+
+	/// <summary>
+	/// 解析済みのデータからモデル生成
+	/// </summary>
+	/// <param name="modelname">モデル名（マテリアルとテクスチャは Resources/モデル名/ から読む）</param>
+	/// <param name="data">OBJ の解析結果</param>
+	/// <returns>生成されたモデル</returns>
+	static Model* CreateFromData(const std::string& modelname, const ObjModelData& data);
+
+	/// <summary>
+	/// 変換済みのメッシュファイルからモデル生成
+	/// Resources/モデル名/モデル名.mesh が無いか、OBJ・MTL が変わっていれば先に作り直す
+	/// </summary>
+	/// <param name="modelname">モデル名</param>
+	/// <param name="smoothing">エッジ平滑化フラグ</param>
+	/// <returns>生成されたモデル</returns>
+	static Model* CreateFromMesh(const std::string& modelname, bool smoothing = false);
+
+  private: // 静的メンバ関数
+	/// <summary>
+	/// 頂点・インデックスバッファの生成（Mesh::CreateBuffers の、配列とインデックス形式を指定する版）
+	/// </summary>
+	/// <param name="mesh">メッシュ</param>
+	/// <param name="vertices">頂点</param>
+	/// <param name="vertexCount">頂点の数</param>
+	/// <param name="indices">インデックス</param>
+	/// <param name="indexCount">インデックスの数</param>
+	/// <param name="indexFormat">DXGI_FORMAT_R16_UINT か DXGI_FORMAT_R32_UINT</param>
+	static void CreateBuffers(
+	  Mesh* mesh, const ObjVertex* vertices, size_t vertexCount, const void* indices,
+	  size_t indexCount, DXGI_FORMAT indexFormat);
+
+	/// <summary>
+	/// マテリアルの無いメッシュへの既定値の割り当てと、定数バッファ・テクスチャの準備
+	/// </summary>
+	/// <param name="model">モデル</param>
+	static void FinishModel(Model* model);
+};
@@ -0,0 +1,370 @@
+﻿#include "ModelRenderQueue.h"
+#include "DirectXCommon.h"
+#include <algorithm>
+#include <cassert>
+#include <d3dcompiler.h>
+#include <d3dx12.h>
+#include <string>
+
+#pragma comment(lib, "d3dcompiler.lib")
+
+Microsoft::WRL::ComPtr<ID3D12PipelineState> ModelRenderQueue::sInstancedPipelineState_;
+
+namespace {
+
+// 頂点バッファビューとインデックスバッファビューの変換
+RenderVertexBufferView ToRenderView(const D3D12_VERTEX_BUFFER_VIEW& view) {
+	return {view.BufferLocation, view.SizeInBytes, view.StrideInBytes};
+}
+RenderIndexBufferView ToRenderView(const D3D12_INDEX_BUFFER_VIEW& view) {
+	return {
+	  view.BufferLocation, view.SizeInBytes,
+	  view.Format == DXGI_FORMAT_R32_UINT ? RenderIndexFormat::kUInt32 : RenderIndexFormat::kUInt16};
+}
+
+// ワールド行列の平行移動成分をビュー空間に移したときの z
+float ViewDepth(const Matrix4& world, const Matrix4& view) {
+	return world.m[3][0] * view.m[0][2] + world.m[3][1] * view.m[1][2] +
+	       world.m[3][2] * view.m[2][2] + view.m[3][2];
+}
+
+// シェーダーの読み込みとコンパイル（失敗したらエラー内容を出力する）
+Microsoft::WRL::ComPtr<ID3DBlob> CompileShader(const wchar_t* filePath, const char* target) {
+	Microsoft::WRL::ComPtr<ID3DBlob> blob;
+	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob;
+	HRESULT result = D3DCompileFromFile(
+	  filePath, nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE, "main", target,
+	  D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION, 0, &blob, &errorBlob);
+	if (FAILED(result)) {
+		if (errorBlob) {
+			std::string errstr(
+			  static_cast<const char*>(errorBlob->GetBufferPointer()), errorBlob->GetBufferSize());
+			OutputDebugStringA(errstr.c_str());
+		}
+		assert(false);
+	}
+	return blob;
+}
+
+} // namespace
+
+/// <summary>
+/// ソート済みの要素を描画コマンドに変換する
+/// RenderQueue が省かなかった状態だけが届く。メッシュとワールド変換もここで直前と比べて省く
+/// </summary>
+class ModelRenderQueue::Backend {
+  public:
+	Backend(
+	  RenderCommandList& commandList, D3D12_GPU_VIRTUAL_ADDRESS viewProjectionAddress,
+	  UploadAllocator& allocator, const ModelRenderQueue& queue)
+	    : commandList_(commandList), viewProjectionAddress_(viewProjectionAddress),
+	      allocator_(allocator), queue_(queue) {}
+
+	/// <summary>
+	/// 発行の前に1回だけ、全パイプラインで共通の状態を設定する
+	/// どのパイプラインもルートシグネチャは Model と同じなので、パイプラインを替えてもルート引数は残る
+	/// </summary>
+	void Begin() {
+		// Model::PreDraw と同じ設定に、毎回の描画で設定していた共通の定数を加える
+		commandList_.SetGraphicsRootSignature(Model::sRootSignature_.Get());
+		commandList_.SetPrimitiveTopology(RenderPrimitiveTopology::kTriangleList);
+		commandList_.SetGraphicsRootConstantBufferView(
+		  static_cast<UINT>(Model::RoomParameter::kViewProjection), viewProjectionAddress_);
+		commandList_.SetGraphicsRootConstantBufferView(
+		  static_cast<UINT>(Model::RoomParameter::kLight),
+		  Model::lightGroup->GetConstBuffer()->GetGPUVirtualAddress());
+		// テクスチャはすべて同じヒープにあるので、切り替えのたびにセットし直さない
+		TextureManager::GetInstance()->SetDescriptorHeap(commandList_);
+	}
+
+	void SetPipeline(uint32_t pipeline) {
+		assert(pipeline == kPipelineObj || pipeline == kPipelineObjInstanced);
+		if (pipeline == kPipelineObjInstanced) {
+			commandList_.SetPipelineState(sInstancedPipelineState_.Get());
+			// 行列の配列全体を2番目のスロットに設定し、描画ごとに開始位置で選ぶ
+			commandList_.SetVertexBuffer(1, queue_.instanceView_);
+			// シェーダーは使わないが、ルート引数を未設定のままにしないよう有効なアドレスを入れておく
+			commandList_.SetGraphicsRootConstantBufferView(
+			  static_cast<UINT>(Model::RoomParameter::kWorldTransform),
+			  queue_.instanceAllocation_.gpuAddress);
+			worldTransform_ = nullptr;
+		} else {
+			commandList_.SetPipelineState(Model::sPipelineState_.Get());
+		}
+	}
+
+	void SetMaterial(uint32_t material) {
+		commandList_.SetGraphicsRootConstantBufferView(
+		  static_cast<UINT>(Model::RoomParameter::kMaterial),
+		  queue_.materials_[material]->GetConstantBuffer()->GetGPUVirtualAddress());
+	}
+
+	void SetTexture(uint32_t textureHandle) {
+		TextureManager::GetInstance()->SetGraphicsRootDescriptorTable(
+		  commandList_, static_cast<UINT>(Model::RoomParameter::kTexture), textureHandle, false);
+	}
+
+	void Draw(uint32_t payload) {
+		const DrawItem& item = queue_.drawItems_[payload];
+		if (item.mesh != mesh_) {
+			commandList_.SetVertexBuffer(0, ToRenderView(item.mesh->GetVBView()));
+			commandList_.SetIndexBuffer(ToRenderView(item.mesh->GetIBView()));
+			mesh_ = item.mesh;
+		}
+		UINT indexCount = item.mesh->GetIndexCount();
+		if (!item.worldTransform) {
+			commandList_.DrawIndexedInstanced(
+			  indexCount, item.instanceCount, 0, 0, item.firstInstance);
+			return;
+		}
+		if (item.worldTransform != worldTransform_) {
+			// 定数バッファを持たないものはこのフレーム用の領域に書き込む
+			const WorldTransform& worldTransform = *item.worldTransform;
+			D3D12_GPU_VIRTUAL_ADDRESS address = worldTransform.constBuff_
+			                                      ? worldTransform.constBuff_->GetGPUVirtualAddress()
+			                                      : worldTransform.TransferMatrix(allocator_);
+			commandList_.SetGraphicsRootConstantBufferView(
+			  static_cast<UINT>(Model::RoomParameter::kWorldTransform), address);
+			worldTransform_ = item.worldTransform;
+		}
+		commandList_.DrawIndexedInstanced(indexCount, 1, 0, 0, 0);
+	}
+
+  private:
+	RenderCommandList& commandList_;
+	D3D12_GPU_VIRTUAL_ADDRESS viewProjectionAddress_;
+	UploadAllocator& allocator_;
+	const ModelRenderQueue& queue_;
+	Mesh* mesh_ = nullptr;
+	const WorldTransform* worldTransform_ = nullptr;
+};
+
+void ModelRenderQueue::StaticInitialize() {
+	assert(Model::sRootSignature_);
+
+	// 頂点シェーダはインスタンス描画用、ピクセルシェーダは通常の描画と共通
+	Microsoft::WRL::ComPtr<ID3DBlob> vsBlob =
+	  CompileShader(L"Resources/shaders/ObjInstancedVS.hlsl", "vs_5_0");
+	Microsoft::WRL::ComPtr<ID3DBlob> psBlob = CompileShader(L"Resources/shaders/ObjPS.hlsl", "ps_5_0");
+
+	// 頂点レイアウト（スロット0は頂点ごと、スロット1はインスタンスごとのワールド行列の4行）
+	D3D12_INPUT_ELEMENT_DESC inputLayout[] = {
+	  {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	   D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	  {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	   D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	  {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	   D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	  {"WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0,
+	   D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+	  {"WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16,
+	   D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+	  {"WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32,
+	   D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+	  {"WORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48,
+	   D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+	};
+
+	// グラフィックスパイプラインの流れを設定（頂点レイアウト以外は Model のパイプラインと同じ）
+	// Model.cpp はビルド済みのライブラリ側にあり設定を取り出す関数もないため、ここに写してある。
+	// ピクセルシェーダ・ラスタライザ・深度・ブレンド・出力の形式が Model と食い違うと、
+	// インスタンス描画したものだけ見た目が変わるので、Model 側を変えたら必ず合わせる。
+	// ルートシグネチャは Model のものをそのまま使う（描画時にパイプラインを替えても
+	// ルート引数を設定し直さないのはこのため）
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline{};
+	gpipeline.VS = CD3DX12_SHADER_BYTECODE(vsBlob.Get());
+	gpipeline.PS = CD3DX12_SHADER_BYTECODE(psBlob.Get());
+	gpipeline.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
+	gpipeline.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+	gpipeline.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+
+	// レンダーターゲットのブレンド設定（半透明合成）
+	D3D12_RENDER_TARGET_BLEND_DESC blenddesc{};
+	blenddesc.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+	blenddesc.BlendEnable = true;
+	blenddesc.BlendOp = D3D12_BLEND_OP_ADD;
+	blenddesc.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+	blenddesc.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+	blenddesc.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+	blenddesc.SrcBlendAlpha = D3D12_BLEND_ONE;
+	blenddesc.DestBlendAlpha = D3D12_BLEND_ZERO;
+	gpipeline.BlendState.RenderTarget[0] = blenddesc;
+
+	gpipeline.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+	gpipeline.InputLayout.pInputElementDescs = inputLayout;
+	gpipeline.InputLayout.NumElements = _countof(inputLayout);
+	gpipeline.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	gpipeline.NumRenderTargets = 1;
+	gpipeline.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+	gpipeline.SampleDesc.Count = 1;
+	gpipeline.pRootSignature = Model::sRootSignature_.Get();
+
+	HRESULT result = DirectXCommon::GetInstance()->GetDevice()->CreateGraphicsPipelineState(
+	  &gpipeline, IID_PPV_ARGS(&sInstancedPipelineState_));
+	assert(SUCCEEDED(result));
+}
+
+void ModelRenderQueue::Clear() {
+	drawItems_.clear();
+	materials_.clear();
+	materialIds_.clear();
+	queue_.Clear();
+	batches_.clear();
+	instances_.clear();
+	batchIds_.clear();
+	lastBatch_ = UINT32_MAX;
+}
+
+void ModelRenderQueue::Add(Model* model, const WorldTransform& worldTransform, uint32_t layer) {
+	AddMeshes(model, worldTransform, nullptr, layer);
+}
+
+void ModelRenderQueue::Add(
+  Model* model, const WorldTransform& worldTransform, uint32_t textureHandle, uint32_t layer) {
+	AddMeshes(model, worldTransform, &textureHandle, layer);
+}
+
+void ModelRenderQueue::AddInstance(Model* model, const Matrix4& matWorld, uint32_t layer) {
+	AddInstanceToBatch(model, matWorld, kNoTextureOverride, layer);
+}
+
+void ModelRenderQueue::AddInstance(
+  Model* model, const Matrix4& matWorld, uint32_t textureHandle, uint32_t layer) {
+	assert(textureHandle <= RenderQueue::kMaxTexture);
+	AddInstanceToBatch(model, matWorld, textureHandle, layer);
+}
+
+void ModelRenderQueue::AddMeshes(
+  Model* model, const WorldTransform& worldTransform, const uint32_t* textureHandle,
+  uint32_t layer) {
+	assert(model);
+	assert(layer <= RenderQueue::kMaxLayer);
+	for (Mesh* mesh : model->GetMeshes()) {
+		Material* material = mesh->GetMaterial();
+		DrawItem item{};
+		item.mesh = mesh;
+		item.worldTransform = &worldTransform;
+		item.material = GetMaterialId(material);
+		item.textureHandle = textureHandle ? *textureHandle : material->GetTextureHadle();
+		item.layer = layer;
+		assert(item.textureHandle <= RenderQueue::kMaxTexture);
+		drawItems_.push_back(item);
+	}
+}
+
+void ModelRenderQueue::AddInstanceToBatch(
+  Model* model, const Matrix4& matWorld, uint32_t textureHandle, uint32_t layer) {
+	assert(model);
+	assert(layer <= RenderQueue::kMaxLayer);
+	BatchKey key = {model, textureHandle, layer};
+	if (lastBatch_ == UINT32_MAX || !(batches_[lastBatch_].key == key)) {
+		auto [it, inserted] = batchIds_.try_emplace(key, static_cast<uint32_t>(batches_.size()));
+		if (inserted) {
+			batches_.push_back({key, 0, 0, 0.0f});
+		}
+		lastBatch_ = it->second;
+	}
+	batches_[lastBatch_].instanceCount++;
+	instances_.push_back({matWorld, lastBatch_});
+}
+
+uint32_t ModelRenderQueue::GetMaterialId(Material* material) {
+	auto [it, inserted] =
+	  materialIds_.try_emplace(material, static_cast<uint32_t>(materials_.size()));
+	if (inserted) {
+		// キーに入りきらない番号を作ると別のマテリアルと区別できなくなる
+		assert(it->second <= RenderQueue::kMaxMaterial);
+		materials_.push_back(material);
+	}
+	return it->second;
+}
+
+void ModelRenderQueue::BuildInstanceDrawItems(const ViewProjection& viewProjection) {
+	if (instances_.empty()) {
+		return;
+	}
+	// このフレームだけ使う領域に書き込む
+	instanceAllocation_ = DirectXCommon::GetInstance()->GetUploadAllocator()->Allocate(
+	  static_cast<uint32_t>(sizeof(Matrix4) * instances_.size()));
+	instanceView_.bufferLocation = instanceAllocation_.gpuAddress;
+	instanceView_.sizeInBytes = instanceAllocation_.size;
+	instanceView_.strideInBytes = sizeof(Matrix4);
+	Matrix4* instanceMap = instanceAllocation_.As<Matrix4>();
+
+	// まとまりごとの書き込み先を決め、行列をまとまり順に詰める（計数ソート）
+	uint32_t offset = 0;
+	for (InstanceBatch& batch : batches_) {
+		batch.firstInstance = offset;
+		batch.nearestViewZ = viewProjection.farZ;
+		offset += batch.instanceCount;
+	}
+	std::vector<uint32_t> cursors(batches_.size());
+	for (size_t i = 0; i < batches_.size(); i++) {
+		cursors[i] = batches_[i].firstInstance;
+	}
+	for (const Instance& instance : instances_) {
+		InstanceBatch& batch = batches_[instance.batch];
+		instanceMap[cursors[instance.batch]++] = instance.matWorld;
+		batch.nearestViewZ =
+		  (std::min)(batch.nearestViewZ, ViewDepth(instance.matWorld, viewProjection.matView));
+	}
+
+	// メッシュごとに1つの描画要素にする
+	for (const InstanceBatch& batch : batches_) {
+		for (Mesh* mesh : batch.key.model->GetMeshes()) {
+			Material* material = mesh->GetMaterial();
+			DrawItem item{};
+			item.mesh = mesh;
+			item.worldTransform = nullptr;
+			item.material = GetMaterialId(material);
+			item.textureHandle = batch.key.textureHandle == kNoTextureOverride
+			                       ? material->GetTextureHadle()
+			                       : batch.key.textureHandle;
+			item.layer = batch.key.layer;
+			item.firstInstance = batch.firstInstance;
+			item.instanceCount = batch.instanceCount;
+			item.instanceViewZ = batch.nearestViewZ;
+			assert(item.textureHandle <= RenderQueue::kMaxTexture);
+			drawItems_.push_back(item);
+		}
+	}
+}
+
+void ModelRenderQueue::Draw(
+  RenderCommandList& commandList, const ViewProjection& viewProjection) {
+	// 毎回の描画で更新していたライトは1フレームに1回だけ更新する
+	Model::lightGroup->Update();
+
+	BuildInstanceDrawItems(viewProjection);
+
+	// 深度はビュー空間の z を近・遠クリップ面で正規化する
+	// インスタンス描画はまとまりの中で最も手前のもので代表する
+	const float inverseRange = 1.0f / (viewProjection.farZ - viewProjection.nearZ);
+	queue_.Clear();
+	for (uint32_t i = 0; i < static_cast<uint32_t>(drawItems_.size()); i++) {
+		const DrawItem& item = drawItems_[i];
+		uint32_t pipeline = kPipelineObj;
+		float viewZ;
+		if (item.worldTransform) {
+			viewZ = ViewDepth(item.worldTransform->matWorld_, viewProjection.matView);
+		} else {
+			pipeline = kPipelineObjInstanced;
+			viewZ = item.instanceViewZ;
+		}
+		float depth = (viewZ - viewProjection.nearZ) * inverseRange;
+		queue_.Push(
+		  RenderQueue::MakeKey(item.layer, pipeline, item.material, item.textureHandle, depth), i);
+	}
+	queue_.Sort();
+
+	// ビュープロジェクションも定数バッファを持たなければこのフレーム用の領域に書き込む
+	UploadAllocator& allocator = *DirectXCommon::GetInstance()->GetUploadAllocator();
+	D3D12_GPU_VIRTUAL_ADDRESS viewProjectionAddress =
+	  viewProjection.constBuff_ ? viewProjection.constBuff_->GetGPUVirtualAddress()
+	                            : viewProjection.TransferMatrix(allocator);
+	Backend backend(commandList, viewProjectionAddress, allocator, *this);
+	if (queue_.GetItemCount() > 0) {
+		backend.Begin();
+	}
+	queue_.Submit(backend);
+}
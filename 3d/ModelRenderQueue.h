@@ -0,0 +1,162 @@
+﻿#pragma once
+
+#include "Model.h"
+#include "RenderDevice.h"
+#include "RenderQueue.h"
+#include "UploadAllocator.h"
+#include <d3d12.h>
+#include <unordered_map>
+#include <vector>
+#include <wrl.h>
+
+/// <summary>
+/// モデルの描画キュー
+/// Model::Draw の代わりにメッシュ単位の描画要素を集め、
+/// パイプライン → マテリアル → テクスチャ → 深度の順に並べてまとめて描画する
+/// AddInstance で追加したものは、モデル・テクスチャ・描画階層が同じものをまとめてインスタンス描画する
+/// </summary>
+class ModelRenderQueue {
+  public: // 定数
+	// パイプラインの番号（ソートキーに入れる）
+	static const uint32_t kPipelineObj = 0;
+	static const uint32_t kPipelineObjInstanced = 1;
+
+  public: // 静的メンバ関数
+	/// <summary>
+	/// 静的初期化（インスタンス描画用のパイプラインを生成する。Model::StaticInitialize の後に呼ぶ）
+	/// 頂点レイアウトと頂点シェーダ以外は Model::InitializeGraphicsPipeline の設定を写したもので、
+	/// Model 側を変えたときはこちらも合わせる
+	/// </summary>
+	static void StaticInitialize();
+
+  public: // メンバ関数
+	/// <summary>
+	/// 描画要素を空にする（毎フレームの先頭で呼ぶ）
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 描画要素の追加（モデルのメッシュごとに1要素）
+	/// worldTransform は Draw まで生きていること。定数バッファを生成していなければ
+	/// 描画時に matWorld_ をフレームごとのアップロード領域に書き込む
+	/// </summary>
+	/// <param name="model">モデル</param>
+	/// <param name="worldTransform">ワールドトランスフォーム</param>
+	/// <param name="layer">描画階層（小さいほど先に描く）</param>
+	void Add(Model* model, const WorldTransform& worldTransform, uint32_t layer = 0);
+
+	/// <summary>
+	/// 描画要素の追加（テクスチャ差し替え）
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	void Add(
+	  Model* model, const WorldTransform& worldTransform, uint32_t textureHandle, uint32_t layer);
+
+	/// <summary>
+	/// インスタンス描画の追加（ワールド変換ごとの定数バッファは使わない）
+	/// 行列はフレームごとのアップロード領域にまとめて書き込み、メッシュごとに1回だけ描画する
+	/// </summary>
+	/// <param name="model">モデル</param>
+	/// <param name="matWorld">ワールド行列</param>
+	/// <param name="layer">描画階層（小さいほど先に描く）</param>
+	void AddInstance(Model* model, const Matrix4& matWorld, uint32_t layer = 0);
+
+	/// <summary>
+	/// インスタンス描画の追加（テクスチャ差し替え）
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	void AddInstance(Model* model, const Matrix4& matWorld, uint32_t textureHandle, uint32_t layer);
+
+	/// <summary>
+	/// 並べ替えて描画する（Model::PreDraw / PostDraw は不要）
+	/// インスタンスの行列は DirectXCommon のアップロード領域に書き込む
+	/// </summary>
+	/// <param name="commandList">描画コマンドの記録先</param>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	void Draw(RenderCommandList& commandList, const ViewProjection& viewProjection);
+
+	// 直前の Draw での状態設定の回数
+	const RenderQueue::Stats& GetStats() const { return queue_.GetStats(); }
+
+	// 直前の Draw で描いたインスタンスの数
+	uint32_t GetInstanceCount() const { return static_cast<uint32_t>(instances_.size()); }
+
+  private: // サブクラス
+	struct DrawItem {
+		Mesh* mesh;
+		// インスタンス描画では nullptr
+		const WorldTransform* worldTransform;
+		uint32_t material;      // マテリアルの番号
+		uint32_t textureHandle; // 実際に使うテクスチャハンドル
+		uint32_t layer;
+		// インスタンス描画の範囲（インスタンスバッファ内の位置と数）
+		uint32_t firstInstance;
+		uint32_t instanceCount;
+		// インスタンス描画で深度の代わりに使う、最も手前のインスタンスのビュー空間での z
+		float instanceViewZ;
+	};
+	struct Instance {
+		Matrix4 matWorld;
+		uint32_t batch;
+	};
+	// インスタンス描画のまとまりの識別（モデル・テクスチャ・描画階層が同じもの）
+	struct BatchKey {
+		Model* model;
+		uint32_t textureHandle; // kNoTextureOverride ならマテリアルのテクスチャ
+		uint32_t layer;
+
+		bool operator==(const BatchKey& other) const = default;
+	};
+	struct BatchKeyHash {
+		size_t operator()(const BatchKey& key) const {
+			size_t h = std::hash<Model*>()(key.model);
+			h ^= (static_cast<size_t>(key.textureHandle) << 4 | key.layer) + 0x9e3779b9 + (h << 6) +
+			     (h >> 2);
+			return h;
+		}
+	};
+	struct InstanceBatch {
+		BatchKey key;
+		uint32_t instanceCount;
+		// インスタンスバッファ内の先頭（Draw で決める）
+		uint32_t firstInstance;
+		// 最も手前のインスタンスのビュー空間での z（Draw で決める）
+		float nearestViewZ;
+	};
+	class Backend;
+
+	// テクスチャを差し替えない印
+	static const uint32_t kNoTextureOverride = UINT32_MAX;
+
+  private: // メンバ関数
+	void AddMeshes(
+	  Model* model, const WorldTransform& worldTransform, const uint32_t* textureHandle,
+	  uint32_t layer);
+	void AddInstanceToBatch(
+	  Model* model, const Matrix4& matWorld, uint32_t textureHandle, uint32_t layer);
+	// フレーム内でのマテリアルの番号
+	uint32_t GetMaterialId(Material* material);
+	// まとまりごとに行列をアップロード領域へ詰め、メッシュごとの描画要素を作る
+	void BuildInstanceDrawItems(const ViewProjection& viewProjection);
+
+  private: // メンバ変数
+	std::vector<DrawItem> drawItems_;
+	// 番号 → マテリアル
+	std::vector<Material*> materials_;
+	std::unordered_map<Material*, uint32_t> materialIds_;
+	RenderQueue queue_;
+
+	// インスタンス描画
+	std::vector<InstanceBatch> batches_;
+	std::vector<Instance> instances_;
+	// (モデル, テクスチャ, 描画階層) → まとまりの番号
+	std::unordered_map<BatchKey, uint32_t, BatchKeyHash> batchIds_;
+	// 直前に追加したまとまり（同じものを続けて追加する場合は探さない）
+	uint32_t lastBatch_ = UINT32_MAX;
+	// このフレームの行列の配列（GPU からは頂点バッファの2番目のスロットとして読む）
+	UploadAllocation instanceAllocation_;
+	RenderVertexBufferView instanceView_;
+
+	// インスタンス描画用のパイプライン（ルートシグネチャは Model と共有する）
+	static Microsoft::WRL::ComPtr<ID3D12PipelineState> sInstancedPipelineState_;
+};
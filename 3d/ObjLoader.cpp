@@ -0,0 +1,350 @@
+﻿#include "ObjLoader.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace {
+
+// 面の頂点（番号は1始まり。0 なら指定なし）
+struct Corner {
+	uint32_t position;
+	uint32_t texcoord;
+	uint32_t normal;
+};
+
+// 面の並びの途中に挟まる行
+enum class EventType {
+	kGroup,           // g
+	kUseMaterial,     // usemtl
+	kMaterialLibrary, // mtllib
+};
+
+struct Event {
+	EventType type;
+	uint32_t face;         // この行より前にある、塊の中の面の数
+	std::string_view text; // 引数（最初の語）
+};
+
+// 行の境目でそろえたテキストの塊と、その解析結果
+struct Chunk {
+	std::string_view text;
+	std::vector<Vector3> positions;
+	std::vector<Vector3> normals;
+	std::vector<Vector2> texcoords;
+	std::vector<Corner> corners;
+	// 面ごとの先頭の頂点（corners の添字）とインデックス数の累積（末尾に合計を置く）
+	std::vector<uint32_t> faceCorners;
+	std::vector<uint32_t> faceIndices;
+	std::vector<Event> events;
+};
+
+// 同じメッシュに続けて入る面の範囲
+struct Segment {
+	uint32_t chunk;
+	uint32_t faceBegin;
+	uint32_t faceEnd;
+	uint32_t mesh;
+	uint32_t vertexOffset; // メッシュの中での最初の頂点番号
+	uint32_t indexOffset;  // メッシュの中での最初のインデックスの位置
+};
+
+// 面の頂点数から、三角形に分けたときのインデックス数
+// （3頂点までは頂点ごとに1つ、4頂点目からは頂点ごとに三角形を1つ足す）
+uint32_t IndexCountOf(uint32_t cornerCount) {
+	return cornerCount <= 3 ? cornerCount : (cornerCount - 2) * 3;
+}
+
+bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+const char* SkipSpace(const char* p, const char* end) {
+	while (p < end && IsSpace(*p)) {
+		p++;
+	}
+	return p;
+}
+
+const char* SkipToken(const char* p, const char* end) {
+	while (p < end && !IsSpace(*p)) {
+		p++;
+	}
+	return p;
+}
+
+// 空白区切りの実数を順に読む（読めなくなったら残りは0のまま）
+void ParseFloats(const char* p, const char* end, float* values, int count) {
+	for (int i = 0; i < count; i++) {
+		p = SkipSpace(p, end);
+		std::from_chars_result result = std::from_chars(p, end, values[i]);
+		if (result.ec != std::errc()) {
+			return;
+		}
+		p = result.ptr;
+	}
+}
+
+// v / v/vt / v//vn / v/vt/vn
+Corner ParseCorner(const char* p, const char* end) {
+	Corner corner = {};
+	std::from_chars_result result = std::from_chars(p, end, corner.position);
+	if (result.ec != std::errc()) {
+		corner.position = 0;
+		return corner;
+	}
+	p = result.ptr;
+	if (p < end && *p == '/') {
+		p++;
+		if (p < end && *p != '/') {
+			result = std::from_chars(p, end, corner.texcoord);
+			p = result.ptr;
+		}
+		if (p < end && *p == '/') {
+			p++;
+			std::from_chars(p, end, corner.normal);
+		}
+	}
+	return corner;
+}
+
+void ParseChunk(Chunk& chunk) {
+	const char* p = chunk.text.data();
+	const char* end = p + chunk.text.size();
+	chunk.faceIndices.push_back(0);
+	while (p < end) {
+		const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+		if (!lineEnd) {
+			lineEnd = end;
+		}
+		const char* keyBegin = SkipSpace(p, lineEnd);
+		const char* keyEnd = SkipToken(keyBegin, lineEnd);
+		std::string_view key(keyBegin, keyEnd - keyBegin);
+
+		if (key == "v") {
+			float v[3] = {};
+			ParseFloats(keyEnd, lineEnd, v, 3);
+			chunk.positions.emplace_back(v[0], v[1], v[2]);
+		} else if (key == "vt") {
+			float t[2] = {};
+			ParseFloats(keyEnd, lineEnd, t, 2);
+			// v 方向は上下を反転する
+			chunk.texcoords.emplace_back(t[0], 1.0f - t[1]);
+		} else if (key == "vn") {
+			float n[3] = {};
+			ParseFloats(keyEnd, lineEnd, n, 3);
+			chunk.normals.emplace_back(n[0], n[1], n[2]);
+		} else if (key == "f") {
+			uint32_t cornerBegin = static_cast<uint32_t>(chunk.corners.size());
+			chunk.faceCorners.push_back(cornerBegin);
+			const char* q = SkipSpace(keyEnd, lineEnd);
+			while (q < lineEnd) {
+				const char* tokenEnd = SkipToken(q, lineEnd);
+				chunk.corners.push_back(ParseCorner(q, tokenEnd));
+				q = SkipSpace(tokenEnd, lineEnd);
+			}
+			chunk.faceIndices.push_back(
+			  chunk.faceIndices.back() +
+			  IndexCountOf(static_cast<uint32_t>(chunk.corners.size()) - cornerBegin));
+		} else if (key == "g" || key == "usemtl" || key == "mtllib") {
+			EventType type = key == "g"        ? EventType::kGroup
+			                 : key == "usemtl" ? EventType::kUseMaterial
+			                                   : EventType::kMaterialLibrary;
+			const char* textBegin = SkipSpace(keyEnd, lineEnd);
+			const char* textEnd = SkipToken(textBegin, lineEnd);
+			chunk.events.push_back(
+			  {type, static_cast<uint32_t>(chunk.faceCorners.size()),
+			   std::string_view(textBegin, textEnd - textBegin)});
+		}
+		p = lineEnd + 1;
+	}
+
+	// 末尾に合計を置く
+	chunk.faceCorners.push_back(static_cast<uint32_t>(chunk.corners.size()));
+}
+
+// 同じ座標を共有する頂点の法線を平均する（Mesh::CalculateSmoothedVertexNormals と同じ計算）
+void SmoothNormals(ObjMesh& mesh, const std::vector<uint32_t>& vertexPositions) {
+	// 座標ごとに、頂点を追加した順に並べる
+	std::vector<uint32_t> order(mesh.vertices.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+		return vertexPositions[a] < vertexPositions[b];
+	});
+
+	size_t begin = 0;
+	while (begin < order.size()) {
+		size_t end = begin + 1;
+		while (end < order.size() && vertexPositions[order[end]] == vertexPositions[order[begin]]) {
+			end++;
+		}
+		Vector3 normal;
+		for (size_t i = begin; i < end; i++) {
+			normal += mesh.vertices[order[i]].normal;
+		}
+		normal = normal / static_cast<float>(end - begin);
+		float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		normal = length > 0.0f ? normal / length : Vector3();
+		for (size_t i = begin; i < end; i++) {
+			mesh.vertices[order[i]].normal = normal;
+		}
+		begin = end;
+	}
+}
+
+} // namespace
+
+bool ObjLoader::LoadFile(
+  const std::string& path, bool smoothing, ObjModelData& out, size_t chunkSize) {
+	MappedFile file;
+	if (!file.Open(path)) {
+		return false;
+	}
+	return Parse(file.GetText(), smoothing, out, chunkSize);
+}
+
+bool ObjLoader::Parse(std::string_view text, bool smoothing, ObjModelData& out, size_t chunkSize) {
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	if (chunkSize == 0) {
+		chunkSize = kDefaultChunkSize;
+	}
+
+	// 行の境目で塊に分ける
+	std::vector<Chunk> chunks;
+	size_t begin = 0;
+	while (begin < text.size()) {
+		size_t end = (std::min)(begin + chunkSize, text.size());
+		if (end < text.size()) {
+			size_t newline = text.find('\n', end);
+			end = newline == std::string_view::npos ? text.size() : newline + 1;
+		}
+		chunks.emplace_back().text = text.substr(begin, end - begin);
+		begin = end;
+	}
+
+	// 塊ごとに並列に解析する
+	jobSystem->ParallelFor(
+	  0, static_cast<uint32_t>(chunks.size()), 1, [&](uint32_t first, uint32_t last) {
+		  for (uint32_t i = first; i < last; i++) {
+			  ParseChunk(chunks[i]);
+		  }
+	  });
+
+	// 座標・法線・uv は番号がファイル全体の通し番号なので、塊の順につなぐ
+	std::vector<Vector3> positions;
+	std::vector<Vector3> normals;
+	std::vector<Vector2> texcoords;
+	for (const Chunk& chunk : chunks) {
+		positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+		normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+		texcoords.insert(texcoords.end(), chunk.texcoords.begin(), chunk.texcoords.end());
+	}
+
+	// 行の順に g / usemtl / mtllib をたどり、面の範囲をメッシュに割り当てる
+	out.materialLibraries.clear();
+	out.meshes.clear();
+	out.meshes.emplace_back();
+	std::vector<uint32_t> vertexCounts(1, 0);
+	std::vector<uint32_t> indexCounts(1, 0);
+	std::vector<Segment> segments;
+	for (uint32_t c = 0; c < chunks.size(); c++) {
+		const Chunk& chunk = chunks[c];
+		uint32_t face = 0;
+		auto flush = [&](uint32_t faceEnd) {
+			if (faceEnd > face) {
+				uint32_t mesh = static_cast<uint32_t>(out.meshes.size() - 1);
+				segments.push_back({c, face, faceEnd, mesh, vertexCounts[mesh], indexCounts[mesh]});
+				vertexCounts[mesh] += chunk.faceCorners[faceEnd] - chunk.faceCorners[face];
+				indexCounts[mesh] += chunk.faceIndices[faceEnd] - chunk.faceIndices[face];
+			}
+			face = faceEnd;
+		};
+		for (const Event& event : chunk.events) {
+			flush(event.face);
+			switch (event.type) {
+			case EventType::kGroup:
+				// 今のメッシュに名前と頂点がそろっていれば、次のメッシュに移る
+				if (!out.meshes.back().name.empty() && vertexCounts.back() > 0) {
+					out.meshes.emplace_back();
+					vertexCounts.push_back(0);
+					indexCounts.push_back(0);
+				}
+				out.meshes.back().name = event.text;
+				break;
+			case EventType::kUseMaterial:
+				out.meshes.back().materialUses.push_back(
+				  {std::string(event.text), static_cast<uint32_t>(out.materialLibraries.size())});
+				break;
+			case EventType::kMaterialLibrary:
+				out.materialLibraries.emplace_back(event.text);
+				break;
+			}
+		}
+		flush(static_cast<uint32_t>(chunk.faceCorners.size() - 1));
+	}
+
+	std::vector<std::vector<uint32_t>> vertexPositions(smoothing ? out.meshes.size() : 0);
+	for (size_t i = 0; i < out.meshes.size(); i++) {
+		out.meshes[i].vertices.resize(vertexCounts[i]);
+		out.meshes[i].indices.resize(indexCounts[i]);
+		if (smoothing) {
+			vertexPositions[i].resize(vertexCounts[i]);
+		}
+	}
+
+	// 範囲ごとに並列に頂点とインデックスを書き込む
+	std::atomic<bool> failed = false;
+	jobSystem->ParallelFor(
+	  0, static_cast<uint32_t>(segments.size()), 1, [&](uint32_t first, uint32_t last) {
+		  for (uint32_t s = first; s < last; s++) {
+			  const Segment& segment = segments[s];
+			  const Chunk& chunk = chunks[segment.chunk];
+			  ObjMesh& mesh = out.meshes[segment.mesh];
+			  uint32_t vertex = segment.vertexOffset;
+			  uint32_t* index = mesh.indices.data() + segment.indexOffset;
+			  for (uint32_t f = segment.faceBegin; f < segment.faceEnd; f++) {
+				  uint32_t cornerBegin = chunk.faceCorners[f];
+				  uint32_t cornerEnd = chunk.faceCorners[f + 1];
+				  for (uint32_t k = cornerBegin; k < cornerEnd; k++) {
+					  const Corner& corner = chunk.corners[k];
+					  if (corner.position == 0 || corner.position > positions.size() ||
+					      corner.texcoord > texcoords.size() || corner.normal > normals.size()) {
+						  failed.store(true, std::memory_order_relaxed);
+						  return;
+					  }
+					  ObjVertex& v = mesh.vertices[vertex];
+					  v.pos = positions[corner.position - 1];
+					  v.normal = corner.normal ? normals[corner.normal - 1] : Vector3();
+					  v.uv = corner.texcoord ? texcoords[corner.texcoord - 1] : Vector2();
+					  if (smoothing) {
+						  vertexPositions[segment.mesh][vertex] = corner.position;
+					  }
+					  // 四角形以上の面は、4点目から (1つ前, 自分, 3つ前) で三角形を作る
+					  if (k - cornerBegin >= 3) {
+						  *index++ = vertex - 1;
+						  *index++ = vertex;
+						  *index++ = vertex - 3;
+					  } else {
+						  *index++ = vertex;
+					  }
+					  vertex++;
+				  }
+			  }
+		  }
+	  });
+	if (failed) {
+		return false;
+	}
+
+	if (smoothing) {
+		jobSystem->ParallelFor(
+		  0, static_cast<uint32_t>(out.meshes.size()), 1, [&](uint32_t first, uint32_t last) {
+			  for (uint32_t i = first; i < last; i++) {
+				  SmoothNormals(out.meshes[i], vertexPositions[i]);
+			  }
+		  });
+	}
+	return true;
+}
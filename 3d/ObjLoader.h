@@ -0,0 +1,81 @@
+﻿#pragma once
+
+#include "Vector2.h"
+#include "Vector3.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 頂点データ（Mesh::VertexPosNormalUv と同じ並び）
+struct ObjVertex {
+	Vector3 pos;    // xyz座標
+	Vector3 normal; // 法線ベクトル
+	Vector2 uv;     // uv座標
+};
+
+// usemtl の指定
+struct ObjMaterialUse {
+	std::string name;      // マテリアル名
+	uint32_t libraryCount; // この行より前にある mtllib の数
+};
+
+// g で区切られた1つのメッシュ
+struct ObjMesh {
+	std::string name;
+	std::vector<ObjVertex> vertices;
+	std::vector<uint32_t> indices;
+	// usemtl の指定（出現順。最初に見つかったマテリアルを使う）
+	std::vector<ObjMaterialUse> materialUses;
+};
+
+// OBJ ファイル1つ分
+struct ObjModelData {
+	// mtllib のファイル名（出現順）
+	std::vector<std::string> materialLibraries;
+	// メッシュ（最低1つ）
+	std::vector<ObjMesh> meshes;
+};
+
+/// <summary>
+/// OBJ ファイルの読み込み
+/// ファイルをメモリに割り当て、行の境目でそろえた塊ごとに JobSystem で並列に解析してから、
+/// 塊の順につなぎ合わせる。結果は Model::LoadModel と同じになる
+/// （g でメッシュを分ける条件、面の頂点を1つずつ頂点にする規則、四角形以上の面の分け方、
+///   vt の v 成分の反転、平滑化の計算）。
+/// 面の頂点は v / v/vt / v//vn / v/vt/vn のいずれでもよい（無い成分は0）
+/// </summary>
+class ObjLoader {
+  public: // 定数
+	// 1つの塊の目安の大きさ（バイト）
+	static const size_t kDefaultChunkSize = 1 << 20;
+	// 16ビットのインデックスで表せる頂点の数
+	static const size_t kMaxShortIndexVertexCount = 0x10000;
+
+  public: // 静的メンバ関数
+	/// <summary>
+	/// ファイルから読み込む
+	/// </summary>
+	/// <param name="path">OBJ ファイルのパス</param>
+	/// <param name="smoothing">同じ座標を共有する頂点の法線を平均するか</param>
+	/// <param name="out">読み込み結果</param>
+	/// <param name="chunkSize">1つの塊の目安の大きさ</param>
+	/// <returns>成功したか（ファイルが開けない、範囲外の頂点番号があると失敗）</returns>
+	static bool LoadFile(
+	  const std::string& path, bool smoothing, ObjModelData& out,
+	  size_t chunkSize = kDefaultChunkSize);
+
+	/// <summary>
+	/// メモリ上の OBJ テキストを解析する
+	/// </summary>
+	static bool Parse(
+	  std::string_view text, bool smoothing, ObjModelData& out,
+	  size_t chunkSize = kDefaultChunkSize);
+
+	/// <summary>
+	/// 頂点の数から、インデックス1つに必要なバイト数を求める（2 か 4）
+	/// </summary>
+	static uint32_t GetIndexSize(size_t vertexCount) {
+		return vertexCount <= kMaxShortIndexVertexCount ? 2 : 4;
+	}
+};
@@ -0,0 +1,83 @@
+﻿#include "RenderQueue.h"
+#include <algorithm>
+
+namespace {
+
+// 範囲外の値を最大値に丸める
+uint64_t Saturate(uint32_t value, uint32_t maxValue) {
+	return static_cast<uint64_t>(value < maxValue ? value : maxValue);
+}
+
+} // namespace
+
+uint64_t RenderQueue::MakeKey(
+  uint32_t layer, uint32_t pipeline, uint32_t material, uint32_t texture, float depth,
+  DepthOrder depthOrder) {
+	// NaN も 0 に寄せる
+	float clamped = depth > 0.0f ? (depth < 1.0f ? depth : 1.0f) : 0.0f;
+	uint32_t quantized = static_cast<uint32_t>(clamped * static_cast<float>(kMaxDepth));
+	if (depthOrder == DepthOrder::kBackToFront) {
+		quantized = kMaxDepth - quantized;
+	}
+	return (Saturate(layer, kMaxLayer) << kLayerShift) |
+	       (Saturate(pipeline, kMaxPipeline) << kPipelineShift) |
+	       (Saturate(material, kMaxMaterial) << kMaterialShift) |
+	       (Saturate(texture, kMaxTexture) << kTextureShift) |
+	       (Saturate(quantized, kMaxDepth) << kDepthShift);
+}
+
+void RenderQueue::Sort() {
+	const size_t count = items_.size();
+	if (count < kRadixSortThreshold) {
+		// 少なければ挿入ソート（安定）
+		for (size_t i = 1; i < count; i++) {
+			Item item = items_[i];
+			size_t j = i;
+			for (; j > 0 && items_[j - 1].key > item.key; j--) {
+				items_[j] = items_[j - 1];
+			}
+			items_[j] = item;
+		}
+		return;
+	}
+
+	// 8ビットずつ8パスの LSD 基数ソート
+	// ヒストグラムは1回の走査で全パス分を数える
+	static const uint32_t kPassCount = 8;
+	static const uint32_t kBucketCount = 256;
+	histograms_.assign(kPassCount * kBucketCount, 0);
+	for (const Item& item : items_) {
+		for (uint32_t pass = 0; pass < kPassCount; pass++) {
+			histograms_[pass * kBucketCount + ((item.key >> (pass * 8)) & 0xff)]++;
+		}
+	}
+
+	scratch_.resize(count);
+	Item* source = items_.data();
+	Item* destination = scratch_.data();
+	for (uint32_t pass = 0; pass < kPassCount; pass++) {
+		uint32_t* histogram = &histograms_[pass * kBucketCount];
+		// 全要素がこの桁で同じ値なら並べ替える必要がない（未使用のフィールドや
+		// 値の種類が少ないフィールドでは多くのパスを省ける）
+		uint32_t firstByte = static_cast<uint32_t>((source[0].key >> (pass * 8)) & 0xff);
+		if (histogram[firstByte] == count) {
+			continue;
+		}
+		// 各バケットの書き込み開始位置
+		uint32_t offset = 0;
+		for (uint32_t bucket = 0; bucket < kBucketCount; bucket++) {
+			uint32_t bucketCount = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketCount;
+		}
+		for (size_t i = 0; i < count; i++) {
+			const Item& item = source[i];
+			destination[histogram[(item.key >> (pass * 8)) & 0xff]++] = item;
+		}
+		std::swap(source, destination);
+	}
+	// 奇数回入れ替えた場合は作業領域に結果がある
+	if (source != items_.data()) {
+		items_.swap(scratch_);
+	}
+}
@@ -0,0 +1,156 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// 描画キュー
+/// 描画要素を64ビットのソートキーと一緒に集め、基数ソートしてから
+/// 直前と同じ状態の設定を省きながら発行する
+/// </summary>
+class RenderQueue {
+  public: // ソートキー
+	// キーの各フィールドのビット数（上位から 階層 | パイプライン | マテリアル | テクスチャ | 深度）
+	static const uint32_t kDepthBits = 24;
+	static const uint32_t kTextureBits = 16;
+	static const uint32_t kMaterialBits = 14;
+	static const uint32_t kPipelineBits = 6;
+	static const uint32_t kLayerBits = 4;
+
+	static const uint32_t kDepthShift = 0;
+	static const uint32_t kTextureShift = kDepthShift + kDepthBits;
+	static const uint32_t kMaterialShift = kTextureShift + kTextureBits;
+	static const uint32_t kPipelineShift = kMaterialShift + kMaterialBits;
+	static const uint32_t kLayerShift = kPipelineShift + kPipelineBits;
+	static_assert(kLayerShift + kLayerBits == 64, "ソートキーは64ビットちょうどに詰める");
+
+	static const uint32_t kMaxLayer = (1u << kLayerBits) - 1;
+	static const uint32_t kMaxPipeline = (1u << kPipelineBits) - 1;
+	static const uint32_t kMaxMaterial = (1u << kMaterialBits) - 1;
+	static const uint32_t kMaxTexture = (1u << kTextureBits) - 1;
+	static const uint32_t kMaxDepth = (1u << kDepthBits) - 1;
+
+	// 同じ状態の中での深度の並べ方
+	enum class DepthOrder {
+		kFrontToBack, // 手前から（不透明物。早期深度テストで塗りつぶしを減らす）
+		kBackToFront, // 奥から（半透明物。正しく重ねるため）
+	};
+
+	/// <summary>
+	/// ソートキーを作る（各値は範囲外なら最大値に丸める）
+	/// </summary>
+	/// <param name="layer">描画階層（小さいほど先に描く）</param>
+	/// <param name="pipeline">パイプラインの番号</param>
+	/// <param name="material">マテリアルの番号</param>
+	/// <param name="texture">テクスチャハンドル</param>
+	/// <param name="depth">正規化した深度 [0, 1]</param>
+	static uint64_t MakeKey(
+	  uint32_t layer, uint32_t pipeline, uint32_t material, uint32_t texture, float depth,
+	  DepthOrder depthOrder = DepthOrder::kFrontToBack);
+
+	// キーからフィールドを取り出す
+	static uint32_t GetLayer(uint64_t key) { return Field(key, kLayerShift, kLayerBits); }
+	static uint32_t GetPipeline(uint64_t key) { return Field(key, kPipelineShift, kPipelineBits); }
+	static uint32_t GetMaterial(uint64_t key) { return Field(key, kMaterialShift, kMaterialBits); }
+	static uint32_t GetTexture(uint64_t key) { return Field(key, kTextureShift, kTextureBits); }
+	static uint32_t GetDepth(uint64_t key) { return Field(key, kDepthShift, kDepthBits); }
+
+  public: // サブクラス
+	// 描画要素（payload は利用側の配列の添字など）
+	struct Item {
+		uint64_t key;
+		uint32_t payload;
+	};
+
+	// 1回の発行の統計
+	struct Stats {
+		uint32_t drawCount = 0;       // 描画要素の数
+		uint32_t pipelineChanges = 0; // パイプラインを設定した回数
+		uint32_t materialChanges = 0; // マテリアルを設定した回数
+		uint32_t textureChanges = 0;  // テクスチャを設定した回数
+		uint32_t skippedChanges = 0;  // 直前と同じなので省いた設定の数
+
+		uint32_t GetStateChanges() const {
+			return pipelineChanges + materialChanges + textureChanges;
+		}
+	};
+
+	// これより少なければ基数ソートではなく挿入ソートで並べる
+	static const uint32_t kRadixSortThreshold = 64;
+
+  public: // メンバ関数
+	/// <summary>
+	/// 描画要素を空にする（毎フレームの先頭で呼ぶ）
+	/// </summary>
+	void Clear() { items_.clear(); }
+	/// <summary>
+	/// 描画要素の追加
+	/// </summary>
+	void Push(uint64_t key, uint32_t payload) { items_.push_back({key, payload}); }
+	/// <summary>
+	/// キーの昇順に並べる（同じキーの要素は追加した順を保つ）
+	/// </summary>
+	void Sort();
+
+	/// <summary>
+	/// 並べた順に発行する
+	/// backend には SetPipeline(pipeline), SetMaterial(material), SetTexture(texture), Draw(payload) を用意する
+	/// 状態は直前と変わったときだけ設定し、パイプラインを替えたらマテリアルとテクスチャも設定し直す
+	/// </summary>
+	template<class Backend> const Stats& Submit(Backend& backend) {
+		stats_ = {};
+		bool hasState = false;
+		uint32_t pipeline = 0;
+		uint32_t material = 0;
+		uint32_t texture = 0;
+		for (const Item& item : items_) {
+			uint32_t itemPipeline = GetPipeline(item.key);
+			uint32_t itemMaterial = GetMaterial(item.key);
+			uint32_t itemTexture = GetTexture(item.key);
+			bool pipelineChanged = !hasState || itemPipeline != pipeline;
+			if (pipelineChanged) {
+				backend.SetPipeline(itemPipeline);
+				pipeline = itemPipeline;
+				stats_.pipelineChanges++;
+			} else {
+				stats_.skippedChanges++;
+			}
+			if (pipelineChanged || itemMaterial != material) {
+				backend.SetMaterial(itemMaterial);
+				material = itemMaterial;
+				stats_.materialChanges++;
+			} else {
+				stats_.skippedChanges++;
+			}
+			if (pipelineChanged || itemTexture != texture) {
+				backend.SetTexture(itemTexture);
+				texture = itemTexture;
+				stats_.textureChanges++;
+			} else {
+				stats_.skippedChanges++;
+			}
+			hasState = true;
+			backend.Draw(item.payload);
+			stats_.drawCount++;
+		}
+		return stats_;
+	}
+
+	std::span<const Item> GetItems() const { return items_; }
+	size_t GetItemCount() const { return items_.size(); }
+	// 直前の Submit の統計
+	const Stats& GetStats() const { return stats_; }
+
+  private: // メンバ関数
+	static uint32_t Field(uint64_t key, uint32_t shift, uint32_t bits) {
+		return static_cast<uint32_t>((key >> shift) & ((uint64_t(1) << bits) - 1));
+	}
+
+  private: // メンバ変数
+	std::vector<Item> items_;
+	// 基数ソートの作業領域とヒストグラム（フレームをまたいで使い回す）
+	std::vector<Item> scratch_;
+	std::vector<uint32_t> histograms_;
+	Stats stats_;
+};
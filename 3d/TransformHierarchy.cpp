@@ -0,0 +1,348 @@
+﻿#include "TransformHierarchy.h"
+#include "Matrix4Multiply.h"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+// order の順に並べ替える
+template<class T> void Gather(std::vector<T>& values, const std::vector<uint32_t>& order) {
+	std::vector<T> result;
+	result.reserve(order.size());
+	for (uint32_t index : order) {
+		result.push_back(values[index]);
+	}
+	values.swap(result);
+}
+
+} // namespace
+
+TransformHierarchy::NodeId TransformHierarchy::Create(NodeId parent) {
+	assert(parent == kInvalidNode || IsValid(parent));
+
+	NodeId node;
+	if (freeNodes_.empty()) {
+		node = static_cast<NodeId>(indexOf_.size());
+		indexOf_.push_back(0);
+	} else {
+		node = freeNodes_.back();
+		freeNodes_.pop_back();
+	}
+
+	// 末尾に追加する。ルートなら深さ優先順は崩れない
+	uint32_t index = static_cast<uint32_t>(nodeOf_.size());
+	indexOf_[node] = index;
+	nodeOf_.push_back(node);
+	parentNode_.push_back(parent);
+	parent_.push_back(parent == kInvalidNode ? kInvalidNode : IndexOf(parent));
+	subtreeSize_.push_back(1);
+	scale_.push_back({1, 1, 1});
+	rotation_.push_back({0, 0, 0});
+	quaternion_.push_back(Quaternion::Identity());
+	translation_.push_back({0, 0, 0});
+	useQuaternion_.push_back(0);
+	localDirty_.push_back(0);
+	alive_.push_back(1);
+	local_.emplace_back();
+	world_.emplace_back();
+	aliveCount_++;
+
+	if (parent != kInvalidNode) {
+		structureDirty_ = true;
+	}
+	MarkDirty(index);
+	return node;
+}
+
+void TransformHierarchy::Destroy(NodeId node) {
+	assert(IsValid(node));
+	// 子孫が連続した範囲になるよう並び順を確定させる
+	if (structureDirty_) {
+		Rebuild();
+	}
+
+	uint32_t index = IndexOf(node);
+	for (uint32_t i = index; i < index + subtreeSize_[index]; i++) {
+		alive_[i] = 0;
+		aliveCount_--;
+	}
+	structureDirty_ = true;
+}
+
+void TransformHierarchy::SetParent(NodeId node, NodeId parent) {
+	assert(IsValid(node));
+	assert(parent == kInvalidNode || IsValid(parent));
+
+	// 自分の子孫を親にすると循環するので禁止
+	for (NodeId ancestor = parent; ancestor != kInvalidNode; ancestor = GetParent(ancestor)) {
+		assert(ancestor != node);
+		if (ancestor == node) {
+			return;
+		}
+	}
+
+	uint32_t index = IndexOf(node);
+	parentNode_[index] = parent;
+	structureDirty_ = true;
+	MarkDirty(index);
+}
+
+void TransformHierarchy::Clear() { *this = TransformHierarchy(); }
+
+bool TransformHierarchy::IsValid(NodeId node) const {
+	if (node >= indexOf_.size()) {
+		return false;
+	}
+	uint32_t index = indexOf_[node];
+	return index < nodeOf_.size() && nodeOf_[index] == node && alive_[index];
+}
+
+TransformHierarchy::NodeId TransformHierarchy::GetParent(NodeId node) const {
+	return parentNode_[IndexOf(node)];
+}
+
+void TransformHierarchy::SetScale(NodeId node, const Vector3& scale) {
+	uint32_t index = IndexOf(node);
+	scale_[index] = scale;
+	MarkDirty(index);
+}
+
+void TransformHierarchy::SetRotation(NodeId node, const Vector3& rotation) {
+	uint32_t index = IndexOf(node);
+	rotation_[index] = rotation;
+	useQuaternion_[index] = 0;
+	MarkDirty(index);
+}
+
+void TransformHierarchy::SetQuaternion(NodeId node, const Quaternion& quaternion) {
+	uint32_t index = IndexOf(node);
+	quaternion_[index] = quaternion;
+	useQuaternion_[index] = 1;
+	MarkDirty(index);
+}
+
+void TransformHierarchy::SetTranslation(NodeId node, const Vector3& translation) {
+	uint32_t index = IndexOf(node);
+	translation_[index] = translation;
+	MarkDirty(index);
+}
+
+void TransformHierarchy::Update() {
+	for (const Range& range : PrepareUpdate()) {
+		UpdateRange(range);
+	}
+	FinishUpdate();
+}
+
+std::span<const TransformHierarchy::Range> TransformHierarchy::PrepareUpdate(uint32_t grainSize) {
+	assert(grainSize > 0);
+	if (structureDirty_) {
+		Rebuild();
+	}
+
+	ranges_.clear();
+	preparedIndices_.clear();
+
+	// 変更されたノードを並び順に整列する
+	std::vector<uint32_t> dirtyIndices;
+	dirtyIndices.reserve(dirtyNodes_.size());
+	for (NodeId node : dirtyNodes_) {
+		if (IsValid(node)) {
+			dirtyIndices.push_back(indexOf_[node]);
+		}
+	}
+	dirtyNodes_.clear();
+	std::sort(dirtyIndices.begin(), dirtyIndices.end());
+
+	// 深さ優先順では部分木が連続するので、先に現れた部分木に含まれるノードは飛ばせる
+	uint32_t coveredEnd = 0;
+	for (uint32_t index : dirtyIndices) {
+		if (index < coveredEnd) {
+			continue;
+		}
+		coveredEnd = index + subtreeSize_[index];
+		SplitRange(index, grainSize);
+	}
+
+	// 小さな部分木が1つずつ別のジョブにならないよう、並び順で隣り合う範囲を grainSize までまとめる
+	// （隣り合う範囲の間には他のノードがないので、つなげても1つの範囲として先頭から順に更新できる）
+	std::sort(ranges_.begin(), ranges_.end(), [](const Range& a, const Range& b) {
+		return a.begin < b.begin;
+	});
+	size_t mergedCount = 0;
+	uint32_t nodeCount = 0;
+	for (size_t i = 0; i < ranges_.size(); i++) {
+		const Range range = ranges_[i];
+		nodeCount += range.end - range.begin;
+		if (mergedCount > 0 && ranges_[mergedCount - 1].end == range.begin &&
+		    range.end - ranges_[mergedCount - 1].begin <= grainSize) {
+			ranges_[mergedCount - 1].end = range.end;
+		} else {
+			ranges_[mergedCount++] = range;
+		}
+	}
+	ranges_.resize(mergedCount);
+
+	// 離れた範囲は1ジョブにいくつかずつ渡し、1ジョブが grainSize 程度のノードを受け持つようにする
+	rangeGrainSize_ = 1;
+	if (nodeCount > 0) {
+		rangeGrainSize_ = static_cast<uint32_t>(
+		  (std::max)(uint64_t(1), uint64_t(grainSize) * mergedCount / nodeCount));
+	}
+	return ranges_;
+}
+
+void TransformHierarchy::UpdateRange(const Range& range) {
+	for (uint32_t i = range.begin; i < range.end; i++) {
+		UpdateNode(i);
+	}
+}
+
+void TransformHierarchy::FinishUpdate() {
+	updatedNodes_.clear();
+	for (uint32_t index : preparedIndices_) {
+		updatedNodes_.push_back(nodeOf_[index]);
+	}
+	for (const Range& range : ranges_) {
+		for (uint32_t i = range.begin; i < range.end; i++) {
+			updatedNodes_.push_back(nodeOf_[i]);
+		}
+	}
+	ranges_.clear();
+	preparedIndices_.clear();
+}
+
+uint32_t TransformHierarchy::IndexOf(NodeId node) const {
+	assert(IsValid(node));
+	return indexOf_[node];
+}
+
+void TransformHierarchy::MarkDirty(uint32_t index) {
+	if (!localDirty_[index]) {
+		localDirty_[index] = 1;
+		dirtyNodes_.push_back(nodeOf_[index]);
+	}
+}
+
+void TransformHierarchy::Rebuild() {
+	const uint32_t count = static_cast<uint32_t>(nodeOf_.size());
+
+	// 子の一覧を現在の並び順のまま作る（親ごとに連続させる）
+	std::vector<uint32_t> childBegin(count + 1, 0);
+	std::vector<uint32_t> roots;
+	for (uint32_t i = 0; i < count; i++) {
+		if (!alive_[i]) {
+			continue;
+		}
+		if (parentNode_[i] == kInvalidNode) {
+			roots.push_back(i);
+		} else {
+			childBegin[indexOf_[parentNode_[i]] + 1]++;
+		}
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		childBegin[i + 1] += childBegin[i];
+	}
+	std::vector<uint32_t> children(childBegin[count]);
+	std::vector<uint32_t> cursor(childBegin.begin(), childBegin.end() - 1);
+	for (uint32_t i = 0; i < count; i++) {
+		if (alive_[i] && parentNode_[i] != kInvalidNode) {
+			children[cursor[indexOf_[parentNode_[i]]]++] = i;
+		}
+	}
+
+	// 深さ優先順に並べる（兄弟の順序は保つ）
+	std::vector<uint32_t> order;
+	order.reserve(aliveCount_);
+	std::vector<uint32_t> stack;
+	for (uint32_t root : roots) {
+		stack.push_back(root);
+		while (!stack.empty()) {
+			uint32_t index = stack.back();
+			stack.pop_back();
+			order.push_back(index);
+			for (uint32_t c = childBegin[index + 1]; c > childBegin[index]; c--) {
+				stack.push_back(children[c - 1]);
+			}
+		}
+	}
+	assert(order.size() == aliveCount_);
+
+	// 削除されたノードの識別子を再利用できるようにする
+	for (uint32_t i = 0; i < count; i++) {
+		if (!alive_[i]) {
+			freeNodes_.push_back(nodeOf_[i]);
+		}
+	}
+
+	Gather(nodeOf_, order);
+	Gather(parentNode_, order);
+	Gather(scale_, order);
+	Gather(rotation_, order);
+	Gather(quaternion_, order);
+	Gather(translation_, order);
+	Gather(useQuaternion_, order);
+	Gather(localDirty_, order);
+	Gather(alive_, order);
+	Gather(local_, order);
+	Gather(world_, order);
+
+	const uint32_t newCount = static_cast<uint32_t>(order.size());
+	for (uint32_t i = 0; i < newCount; i++) {
+		indexOf_[nodeOf_[i]] = i;
+	}
+	parent_.resize(newCount);
+	subtreeSize_.assign(newCount, 1);
+	for (uint32_t i = 0; i < newCount; i++) {
+		parent_[i] = parentNode_[i] == kInvalidNode ? kInvalidNode : indexOf_[parentNode_[i]];
+	}
+	// 子は親より後ろにあるので、後ろから足し込めば部分木の大きさが求まる
+	for (uint32_t i = newCount; i-- > 0;) {
+		if (parent_[i] != kInvalidNode) {
+			subtreeSize_[parent_[i]] += subtreeSize_[i];
+		}
+	}
+
+	structureDirty_ = false;
+}
+
+void TransformHierarchy::UpdateNode(uint32_t index) {
+	// ローカル行列は自分が変更されたときだけ作り直す
+	if (localDirty_[index]) {
+		if (useQuaternion_[index]) {
+			local_[index] =
+			  Matrix4::MakeAffine(scale_[index], quaternion_[index], translation_[index]);
+		} else {
+			local_[index] = Matrix4::MakeAffine(scale_[index], rotation_[index], translation_[index]);
+		}
+		localDirty_[index] = 0;
+	}
+
+	uint32_t parent = parent_[index];
+	if (parent == kInvalidNode) {
+		world_[index] = local_[index];
+	} else {
+		MathUtility::Matrix4Multiply(local_[index], world_[parent], world_[index]);
+	}
+}
+
+void TransformHierarchy::SplitRange(uint32_t root, uint32_t grainSize) {
+	// 深い階層でも再帰しないよう明示的なスタックで分割する
+	std::vector<uint32_t> stack = {root};
+	while (!stack.empty()) {
+		uint32_t index = stack.back();
+		stack.pop_back();
+		uint32_t end = index + subtreeSize_[index];
+		if (subtreeSize_[index] <= grainSize) {
+			ranges_.push_back({index, end});
+			continue;
+		}
+
+		// 根だけ先に計算すれば、子の部分木どうしは独立に更新できる
+		UpdateNode(index);
+		preparedIndices_.push_back(index);
+		for (uint32_t child = index + 1; child < end; child += subtreeSize_[child]) {
+			stack.push_back(child);
+		}
+	}
+}
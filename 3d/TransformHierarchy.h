@@ -0,0 +1,144 @@
+﻿#pragma once
+
+#include "Matrix4.h"
+#include "Quaternion.h"
+#include "Vector3.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// 親子関係を持つ変換の集合
+/// ノードを親が必ず子より前に来る深さ優先順で連続した配列に並べ、
+/// 変更されたノードの部分木だけを線形に走査してワールド行列を更新する
+/// </summary>
+class TransformHierarchy {
+  public:
+	// ノードの識別子（構造を変更しても変わらない）
+	using NodeId = uint32_t;
+	static const NodeId kInvalidNode = UINT32_MAX;
+
+	// 部分木の大きさがこれ以下になるまで更新範囲を分割する
+	static const uint32_t kDefaultGrainSize = 256;
+
+	// 更新範囲 [begin, end)（並び順の添字。別々の範囲は互いに独立）
+	struct Range {
+		uint32_t begin;
+		uint32_t end;
+	};
+
+  public: // 構造の変更
+	/// <summary>
+	/// ノードの生成
+	/// </summary>
+	/// <param name="parent">親ノード（kInvalidNode ならルート）</param>
+	/// <returns>ノード</returns>
+	NodeId Create(NodeId parent = kInvalidNode);
+	/// <summary>
+	/// ノードを子孫ごと削除する
+	/// </summary>
+	void Destroy(NodeId node);
+	/// <summary>
+	/// 親の付け替え（自分の子孫を親にすることはできない）
+	/// </summary>
+	void SetParent(NodeId node, NodeId parent);
+	/// <summary>
+	/// 全ノードの削除
+	/// </summary>
+	void Clear();
+
+	// 有効なノードか
+	bool IsValid(NodeId node) const;
+	// 親ノード
+	NodeId GetParent(NodeId node) const;
+	// 生きているノードの数
+	uint32_t GetNodeCount() const { return aliveCount_; }
+
+  public: // ローカル変換（変更したノードの部分木が次回の更新対象になる）
+	void SetScale(NodeId node, const Vector3& scale);
+	void SetRotation(NodeId node, const Vector3& rotation);
+	void SetQuaternion(NodeId node, const Quaternion& quaternion);
+	void SetTranslation(NodeId node, const Vector3& translation);
+
+	const Vector3& GetScale(NodeId node) const { return scale_[IndexOf(node)]; }
+	const Vector3& GetRotation(NodeId node) const { return rotation_[IndexOf(node)]; }
+	const Quaternion& GetQuaternion(NodeId node) const { return quaternion_[IndexOf(node)]; }
+	const Vector3& GetTranslation(NodeId node) const { return translation_[IndexOf(node)]; }
+	// 回転を SetQuaternion で指定しているか（false なら GetRotation のオイラー角を使う）
+	bool UsesQuaternion(NodeId node) const { return useQuaternion_[IndexOf(node)] != 0; }
+
+	// ワールド行列（最後の更新時点の値）
+	const Matrix4& GetWorldMatrix(NodeId node) const { return world_[IndexOf(node)]; }
+
+  public: // 更新
+	/// <summary>
+	/// 1スレッドでワールド行列を更新する（PrepareUpdate → UpdateRange → FinishUpdate）
+	/// </summary>
+	void Update();
+
+	/// <summary>
+	/// 更新の準備
+	/// 構造の変更を反映し、再計算が必要なノードを互いに独立な範囲に分割する
+	/// grainSize を超える部分木は、根のノードだけをここで計算して子の部分木に分け、
+	/// 並び順で隣り合う小さな範囲は grainSize までまとめる
+	/// </summary>
+	/// <param name="grainSize">1範囲の目安のノード数</param>
+	/// <returns>更新範囲（並び順に整列済み。FinishUpdate まで有効）</returns>
+	std::span<const Range> PrepareUpdate(uint32_t grainSize = kDefaultGrainSize);
+	/// <summary>
+	/// 直前の PrepareUpdate の範囲を並列に処理するときに、1ジョブへまとめる範囲の数
+	/// （離れていてまとめられなかった小さな範囲も、1ジョブが grainSize 程度のノードになるようにする）
+	/// </summary>
+	uint32_t GetRangeGrainSize() const { return rangeGrainSize_; }
+	/// <summary>
+	/// 範囲内のワールド行列を更新する（異なる範囲は別スレッドから同時に呼んでよい）
+	/// </summary>
+	void UpdateRange(const Range& range);
+	/// <summary>
+	/// 更新の完了（更新されたノードの一覧を確定する）
+	/// </summary>
+	void FinishUpdate();
+
+	// 直前の更新でワールド行列が変わったノード
+	std::span<const NodeId> GetUpdatedNodes() const { return updatedNodes_; }
+
+  private: // メンバ関数
+	uint32_t IndexOf(NodeId node) const;
+	void MarkDirty(uint32_t index);
+	// 並び順を深さ優先順に作り直し、削除済みノードを詰める
+	void Rebuild();
+	// 1ノードのワールド行列を計算する
+	void UpdateNode(uint32_t index);
+	// 大きな部分木を分割して ranges_ に積む
+	void SplitRange(uint32_t root, uint32_t grainSize);
+
+  private: // メンバ変数（並び順の添字でアクセスする）
+	std::vector<NodeId> nodeOf_;
+	std::vector<NodeId> parentNode_;
+	std::vector<uint32_t> parent_;
+	std::vector<uint32_t> subtreeSize_;
+	std::vector<Vector3> scale_;
+	std::vector<Vector3> rotation_;
+	std::vector<Quaternion> quaternion_;
+	std::vector<Vector3> translation_;
+	std::vector<uint8_t> useQuaternion_;
+	std::vector<uint8_t> localDirty_;
+	std::vector<uint8_t> alive_;
+	std::vector<Matrix4> local_;
+	std::vector<Matrix4> world_;
+
+	// ノード → 並び順の添字
+	std::vector<uint32_t> indexOf_;
+	std::vector<NodeId> freeNodes_;
+	uint32_t aliveCount_ = 0;
+	// 並び順が深さ優先順になっていない
+	bool structureDirty_ = false;
+
+	// 前回の更新以降に変更されたノード
+	std::vector<NodeId> dirtyNodes_;
+	// 今回の更新範囲と、PrepareUpdate で計算済みのノード
+	std::vector<Range> ranges_;
+	uint32_t rangeGrainSize_ = 1;
+	std::vector<uint32_t> preparedIndices_;
+	std::vector<NodeId> updatedNodes_;
+};
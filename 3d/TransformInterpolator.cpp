@@ -0,0 +1,75 @@
+﻿#include "TransformInterpolator.h"
+#include "MathUtility.h"
+#include <cassert>
+
+void TransformInterpolator::Initialize(const TransformHierarchy* hierarchy) {
+	assert(hierarchy);
+	hierarchy_ = hierarchy;
+	Clear();
+}
+
+void TransformInterpolator::Add(TransformHierarchy::NodeId node, WorldTransform* worldTransform) {
+	assert(hierarchy_ && hierarchy_->IsValid(node));
+	assert(worldTransform);
+	assert(indexOf_.find(node) == indexOf_.end());
+	indexOf_[node] = nodes_.size();
+	nodes_.push_back(node);
+	transforms_.push_back(worldTransform);
+	State state = GetState(nodes_.size() - 1);
+	previous_.push_back(state);
+	current_.push_back(state);
+}
+
+void TransformInterpolator::Clear() {
+	nodes_.clear();
+	transforms_.clear();
+	indexOf_.clear();
+	previous_.clear();
+	current_.clear();
+}
+
+void TransformInterpolator::Capture() {
+	previous_.swap(current_);
+	for (size_t i = 0; i < nodes_.size(); i++) {
+		current_[i] = GetState(i);
+	}
+}
+
+void TransformInterpolator::Reset() { previous_ = current_; }
+
+void TransformInterpolator::Apply(float alpha) {
+	for (size_t i = 0; i < nodes_.size(); i++) {
+		WorldTransform& worldTransform = *transforms_[i];
+		const State& previous = previous_[i];
+		const State& current = current_[i];
+		worldTransform.matWorld_ = Matrix4::MakeAffine(
+		  MathUtility::Vector3Lerp(previous.scale, current.scale, alpha),
+		  Quaternion::Slerp(previous.rotation, current.rotation, alpha),
+		  MathUtility::Vector3Lerp(previous.translation, current.translation, alpha));
+
+		TransformHierarchy::NodeId parent = hierarchy_->GetParent(nodes_[i]);
+		if (parent != TransformHierarchy::kInvalidNode) {
+			auto it = indexOf_.find(parent);
+			if (it != indexOf_.end()) {
+				// 親は先に補間済み
+				assert(it->second < i);
+				worldTransform.matWorld_ *= transforms_[it->second]->matWorld_;
+			} else {
+				worldTransform.matWorld_ *= hierarchy_->GetWorldMatrix(parent);
+			}
+		}
+		if (worldTransform.constMap) {
+			worldTransform.TransferMatrix();
+		}
+	}
+}
+
+TransformInterpolator::State TransformInterpolator::GetState(size_t index) const {
+	TransformHierarchy::NodeId node = nodes_[index];
+	// オイラー角はクォータニオンにしてから補間する（角度の折り返しで逆回りしないため）
+	return {
+	  hierarchy_->GetScale(node),
+	  hierarchy_->UsesQuaternion(node) ? hierarchy_->GetQuaternion(node)
+	                                   : Quaternion::MakeFromEuler(hierarchy_->GetRotation(node)),
+	  hierarchy_->GetTranslation(node)};
+}
@@ -0,0 +1,73 @@
+﻿#pragma once
+
+#include "Matrix4.h"
+#include "Quaternion.h"
+#include "TransformHierarchy.h"
+#include "Vector3.h"
+#include "WorldTransform.h"
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// 固定ステップで更新する TransformHierarchy のノードを描画時に補間する
+/// ステップごとに Capture でノードのローカルのスケール・回転・平行移動を記録し、描画前に Apply で
+/// 直前2ステップの間を補間した行列を、ノードに対応する WorldTransform の matWorld_ と定数バッファに書き込む。
+/// 変換の値は TransformHierarchy だけが持ち、WorldTransform の scale_ などは参照しない
+/// </summary>
+class TransformInterpolator {
+  public: // メンバ関数
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="hierarchy">補間するノードを持つ親子関係（この補間器より長く生きること）</param>
+	void Initialize(const TransformHierarchy* hierarchy);
+
+	/// <summary>
+	/// 補間するノードの登録（親は子より先に登録する）
+	/// 登録時の状態を前後両方のステップの状態とする
+	/// </summary>
+	/// <param name="node">ノード</param>
+	/// <param name="worldTransform">補間した行列の書き込み先（この補間器より長く生きること）</param>
+	void Add(TransformHierarchy::NodeId node, WorldTransform* worldTransform);
+	/// <summary>
+	/// 登録の全解除
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// ステップの終わりの状態を記録する（それまでの状態は1つ前のステップの状態になる）
+	/// </summary>
+	void Capture();
+	/// <summary>
+	/// 瞬間移動などで補間させたくないとき、前のステップの状態を現在の状態にそろえる
+	/// </summary>
+	void Reset();
+	/// <summary>
+	/// 補間した行列を書き込む
+	/// 親が登録されていればその補間結果に、登録されていなければ親の最新のワールド行列に掛ける
+	/// </summary>
+	/// <param name="alpha">補間係数（0 で1つ前のステップ、1 で直前のステップ）</param>
+	void Apply(float alpha);
+
+	size_t GetCount() const { return nodes_.size(); }
+
+  private: // サブクラス
+	// 1ステップ分の状態
+	struct State {
+		Vector3 scale;
+		Quaternion rotation;
+		Vector3 translation;
+	};
+
+  private: // メンバ関数
+	State GetState(size_t index) const;
+
+  private: // メンバ変数
+	const TransformHierarchy* hierarchy_ = nullptr;
+	std::vector<TransformHierarchy::NodeId> nodes_;
+	std::vector<WorldTransform*> transforms_;
+	// ノード → 登録順の添字
+	std::unordered_map<TransformHierarchy::NodeId, size_t> indexOf_;
+	std::vector<State> previous_;
+	std::vector<State> current_;
+};
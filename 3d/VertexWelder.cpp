@@ -0,0 +1,104 @@
+﻿#include "VertexWelder.h"
+#include "Hash.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+uint64_t VertexWelder::Stats::GetBytesBefore() const {
+	return vertexCountBefore * sizeof(ObjVertex) + indexBytesBefore;
+}
+
+uint64_t VertexWelder::Stats::GetBytesAfter() const {
+	return vertexCountAfter * sizeof(ObjVertex) + indexBytesAfter;
+}
+
+double VertexWelder::Stats::GetVertexRatio() const {
+	return vertexCountAfter == 0 ? 1.0
+	                             : static_cast<double>(vertexCountBefore) / vertexCountAfter;
+}
+
+VertexWelder::Stats& VertexWelder::Stats::operator+=(const Stats& other) {
+	vertexCountBefore += other.vertexCountBefore;
+	vertexCountAfter += other.vertexCountAfter;
+	indexCount += other.indexCount;
+	indexBytesBefore += other.indexBytesBefore;
+	indexBytesAfter += other.indexBytesAfter;
+	return *this;
+}
+
+uint32_t VertexWelder::BuildRemap(
+  const std::vector<ObjVertex>& vertices, std::vector<uint32_t>& remap) {
+	const uint32_t kEmpty = UINT32_MAX;
+	const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+	remap.resize(vertexCount);
+
+	// 使用率が半分以下になる2のべき乗の大きさにして、線形探査する
+	const size_t capacity = std::bit_ceil((std::max)(size_t(vertexCount) * 2, size_t(16)));
+	const size_t mask = capacity - 1;
+	// 残す頂点の、元の頂点番号
+	std::vector<uint32_t> table(capacity, kEmpty);
+
+	uint32_t uniqueCount = 0;
+	for (uint32_t i = 0; i < vertexCount; i++) {
+		const ObjVertex& vertex = vertices[i];
+		size_t slot = Hash64(&vertex, sizeof(ObjVertex)) & mask;
+		while (true) {
+			uint32_t found = table[slot];
+			if (found == kEmpty) {
+				// 初めて現れた頂点
+				table[slot] = i;
+				remap[i] = uniqueCount++;
+				break;
+			}
+			if (std::memcmp(&vertices[found], &vertex, sizeof(ObjVertex)) == 0) {
+				remap[i] = remap[found];
+				break;
+			}
+			slot = (slot + 1) & mask;
+		}
+	}
+	return uniqueCount;
+}
+
+VertexWelder::Stats VertexWelder::Weld(ObjMesh& mesh) {
+	Stats stats;
+	stats.vertexCountBefore = mesh.vertices.size();
+	stats.indexCount = mesh.indices.size();
+
+	std::vector<uint32_t> remap;
+	uint32_t uniqueCount = BuildRemap(mesh.vertices, remap);
+	stats.vertexCountAfter = uniqueCount;
+	// まとめた結果 16ビットに収まるようになることもある
+	stats.indexBytesBefore = stats.indexCount * ObjLoader::GetIndexSize(mesh.vertices.size());
+	stats.indexBytesAfter = stats.indexCount * ObjLoader::GetIndexSize(uniqueCount);
+	if (uniqueCount == mesh.vertices.size()) {
+		return stats;
+	}
+
+	// 新しい番号は最初に現れた順なので、前から詰めれば上書きしない
+	for (uint32_t i = 0; i < mesh.vertices.size(); i++) {
+		mesh.vertices[remap[i]] = mesh.vertices[i];
+	}
+	mesh.vertices.resize(uniqueCount);
+	for (uint32_t& index : mesh.indices) {
+		index = remap[index];
+	}
+	return stats;
+}
+
+VertexWelder::Stats VertexWelder::Weld(ObjModelData& data) {
+	std::vector<Stats> meshStats(data.meshes.size());
+	JobSystem::GetInstance()->ParallelFor(
+	  0, static_cast<uint32_t>(data.meshes.size()), 1, [&](uint32_t first, uint32_t last) {
+		  for (uint32_t i = first; i < last; i++) {
+			  meshStats[i] = Weld(data.meshes[i]);
+		  }
+	  });
+
+	Stats stats;
+	for (const Stats& s : meshStats) {
+		stats += s;
+	}
+	return stats;
+}
@@ -0,0 +1,55 @@
+﻿#pragma once
+
+#include "ObjLoader.h"
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 頂点の重複の除去
+/// OBJ は面の頂点を1つずつ頂点にするため、座標・法線・uv がすべて同じ頂点が何度も現れる。
+/// 頂点全体のハッシュ値でオープンアドレス法の表を引き、同じ頂点は最初に現れたものだけを残して
+/// インデックスをそちらに付け替える（比較はビット単位で、-0 と 0 は別の頂点として扱う）
+/// </summary>
+class VertexWelder {
+  public: // サブクラス
+	// 除去の結果
+	struct Stats {
+		uint64_t vertexCountBefore = 0;
+		uint64_t vertexCountAfter = 0;
+		uint64_t indexCount = 0;
+		// インデックスの大きさ（メッシュごとに頂点の数で16ビットか32ビットかが決まる）
+		uint64_t indexBytesBefore = 0;
+		uint64_t indexBytesAfter = 0;
+
+		// 頂点・インデックスの合計の大きさ
+		uint64_t GetBytesBefore() const;
+		uint64_t GetBytesAfter() const;
+		// 頂点数が何分の1になったか
+		double GetVertexRatio() const;
+
+		Stats& operator+=(const Stats& other);
+	};
+
+  public: // 静的メンバ関数
+	/// <summary>
+	/// 1つのメッシュの重複を除く（頂点は最初に現れた順に詰める）
+	/// </summary>
+	/// <param name="mesh">メッシュ</param>
+	/// <returns>除去の結果</returns>
+	static Stats Weld(ObjMesh& mesh);
+
+	/// <summary>
+	/// すべてのメッシュの重複を除く（メッシュごとに JobSystem で並列に処理する）
+	/// </summary>
+	/// <param name="data">OBJ の読み込み結果</param>
+	/// <returns>全メッシュの合計</returns>
+	static Stats Weld(ObjModelData& data);
+
+	/// <summary>
+	/// 頂点の重複を除いたときの、元の頂点から残す頂点への対応を作る
+	/// </summary>
+	/// <param name="vertices">頂点</param>
+	/// <param name="remap">元の頂点ごとの新しい番号</param>
+	/// <returns>残る頂点の数</returns>
+	static uint32_t BuildRemap(const std::vector<ObjVertex>& vertices, std::vector<uint32_t>& remap);
+};
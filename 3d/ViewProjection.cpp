@@ -0,0 +1,58 @@
+﻿#include "ViewProjection.h"
+#include "DirectXCommon.h"
+#include <cassert>
+#include <d3dx12.h>
+
+void ViewProjection::Initialize() {
+	CreateConstBuffer();
+	Map();
+	UpdateMatrix();
+}
+
+void ViewProjection::CreateConstBuffer() {
+	HRESULT result;
+
+	// ヒーププロパティ
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	// リソース設定
+	CD3DX12_RESOURCE_DESC resourceDesc =
+	  CD3DX12_RESOURCE_DESC::Buffer((sizeof(ConstBufferDataViewProjection) + 0xff) & ~0xff);
+
+	// 定数バッファの生成
+	result = DirectXCommon::GetInstance()->GetDevice()->CreateCommittedResource(
+	  &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	  IID_PPV_ARGS(&constBuff_));
+	assert(SUCCEEDED(result));
+}
+
+void ViewProjection::Map() {
+	// 定数バッファとのデータリンク
+	HRESULT result = constBuff_->Map(0, nullptr, (void**)&constMap);
+	assert(SUCCEEDED(result));
+}
+
+void ViewProjection::UpdateMatrix() {
+	// ビュー行列の生成
+	matView = MathUtility::Matrix4LookAtLH(eye, target, up);
+	// 透視投影による射影行列の生成
+	matProjection = MathUtility::Matrix4Perspective(fovAngleY, aspectRatio, nearZ, farZ);
+
+	// 定数バッファへの書き込み
+	TransferMatrix();
+}
+
+void ViewProjection::TransferMatrix() {
+	// 定数バッファに書き込み
+	constMap->view = matView;
+	constMap->projection = matProjection;
+	constMap->cameraPos = eye;
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS ViewProjection::TransferMatrix(UploadAllocator& allocator) const {
+	// このフレーム用の領域に書き込み
+	ConstBufferDataViewProjection data;
+	data.view = matView;
+	data.projection = matProjection;
+	data.cameraPos = eye;
+	return allocator.AllocateConstantBuffer(data).gpuAddress;
+}
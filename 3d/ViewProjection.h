@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "MathUtility.h"
+#include "UploadAllocator.h"
 #include <d3d12.h>
 #include <wrl.h>
 
@@ -58,11 +59,16 @@ struct ViewProjection {
 	/// </summary>
 	void Map();
 	/// <summary>
-	/// 行列を更新する
+	/// 行列を更新する（逆行列や視錐台が必要なら CameraCache を使う）
 	/// </summary>
 	void UpdateMatrix();
 	/// <summary>
 	/// 行列を転送する
 	/// </summary>
 	void TransferMatrix();
+	/// <summary>
+	/// 行列をフレームごとのアップロード領域に転送する（定数バッファを使わずに描画する場合）
+	/// </summary>
+	/// <returns>書き込んだ定数バッファの GPU アドレス（そのフレームの間だけ有効）</returns>
+	D3D12_GPU_VIRTUAL_ADDRESS TransferMatrix(UploadAllocator& allocator) const;
 };
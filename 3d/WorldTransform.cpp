@@ -0,0 +1,70 @@
+﻿#include "WorldTransform.h"
+#include "DirectXCommon.h"
+#include <cassert>
+#include <d3dx12.h>
+
+void WorldTransform::Initialize() {
+	CreateConstBuffer();
+	Map();
+	TransferMatrix();
+}
+
+void WorldTransform::CreateConstBuffer() {
+	HRESULT result;
+
+	// ヒーププロパティ
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	// リソース設定
+	CD3DX12_RESOURCE_DESC resourceDesc =
+	  CD3DX12_RESOURCE_DESC::Buffer((sizeof(ConstBufferDataWorldTransform) + 0xff) & ~0xff);
+
+	// 定数バッファの生成
+	result = DirectXCommon::GetInstance()->GetDevice()->CreateCommittedResource(
+	  &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	  IID_PPV_ARGS(&constBuff_));
+	assert(SUCCEEDED(result));
+}
+
+void WorldTransform::Map() {
+	// 定数バッファとのデータリンク
+	HRESULT result = constBuff_->Map(0, nullptr, (void**)&constMap);
+	assert(SUCCEEDED(result));
+}
+
+void WorldTransform::UpdateMatrix() {
+	// スケール、回転、平行移動を合成して行列を計算する
+	matWorld_ = Matrix4::MakeAffine(scale_, rotation_, translation_);
+
+	// 親行列を掛ける
+	if (parent_) {
+		matWorld_ *= parent_->matWorld_;
+	}
+
+	// 定数バッファに転送する
+	TransferMatrix();
+}
+
+void WorldTransform::UpdateMatrix(const Quaternion& rotation) {
+	// スケール、回転、平行移動を合成して行列を計算する
+	matWorld_ = Matrix4::MakeAffine(scale_, rotation, translation_);
+
+	// 親行列を掛ける
+	if (parent_) {
+		matWorld_ *= parent_->matWorld_;
+	}
+
+	// 定数バッファに転送する
+	TransferMatrix();
+}
+
+void WorldTransform::TransferMatrix() {
+	// 定数バッファに書き込み
+	constMap->matWorld = matWorld_;
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS WorldTransform::TransferMatrix(UploadAllocator& allocator) const {
+	// このフレーム用の領域に書き込み
+	ConstBufferDataWorldTransform data;
+	data.matWorld = matWorld_;
+	return allocator.AllocateConstantBuffer(data).gpuAddress;
+}
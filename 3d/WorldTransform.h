@@ -2,6 +2,8 @@
 
 #include "Vector3.h"
 #include "Matrix4.h"
+#include "Quaternion.h"
+#include "UploadAllocator.h"
 #include <d3d12.h>
 #include <wrl.h>
 
@@ -42,7 +44,22 @@ struct WorldTransform {
 	/// </summary>
 	void Map();
 	/// <summary>
+	/// 行列を更新する（スケール・回転・平行移動と親から行列を計算して転送）
+	/// </summary>
+	void UpdateMatrix();
+	/// <summary>
+	/// 回転に rotation_ ではなくクォータニオンを使って行列を更新する
+	/// （ライブラリ側のクラスが値で持つため、構造体にメンバは増やさない）
+	/// </summary>
+	/// <param name="rotation">ローカル回転</param>
+	void UpdateMatrix(const Quaternion& rotation);
+	/// <summary>
 	/// 行列を転送する
 	/// </summary>
 	void TransferMatrix();
+	/// <summary>
+	/// 行列をフレームごとのアップロード領域に転送する（定数バッファを使わずに描画する場合）
+	/// </summary>
+	/// <returns>書き込んだ定数バッファの GPU アドレス（そのフレームの間だけ有効）</returns>
+	D3D12_GPU_VIRTUAL_ADDRESS TransferMatrix(UploadAllocator& allocator) const;
 };
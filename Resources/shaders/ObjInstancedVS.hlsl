@@ -0,0 +1,24 @@
+#include "Obj.hlsli"
+
+// インスタンス描画用（ワールド行列は定数バッファではなく、インスタンスごとの頂点データで受け取る）
+// 行列は C++ 側の Matrix4 の各行をそのまま並べたもの
+VSOutput main(
+	float4 pos : POSITION, float3 normal : NORMAL, float2 uv : TEXCOORD,
+	float4 world0 : WORLD0, float4 world1 : WORLD1, float4 world2 : WORLD2, float4 world3 : WORLD3)
+{
+	float4x4 instanceWorld = float4x4(world0, world1, world2, world3);
+
+	// 法線にワールド行列によるスケーリング・回転を適用
+	// ※スケーリングが一様な場合のみ正しい
+	float4 worldNormal = normalize(mul(float4(normal, 0), instanceWorld));
+	float4 worldPos = mul(pos, instanceWorld);
+
+	VSOutput output; // ピクセルシェーダーに渡す値
+	output.svpos = mul(mul(projection, view), worldPos);
+
+	output.worldpos = worldPos;
+	output.normal = worldNormal.xyz;
+	output.uv = uv;
+
+	return output;
+}
@@ -0,0 +1,30 @@
+﻿#include "D3D12FrameFence.h"
+#include <cassert>
+
+D3D12FrameFence::D3D12FrameFence(ID3D12Device* device, ID3D12CommandQueue* commandQueue)
+    : commandQueue_(commandQueue) {
+	HRESULT result = S_FALSE;
+
+	// フェンスの生成
+	result = device->CreateFence(fenceVal_, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
+	assert(SUCCEEDED(result));
+
+	event_ = CreateEvent(nullptr, false, false, nullptr);
+	assert(event_);
+}
+
+D3D12FrameFence::~D3D12FrameFence() { CloseHandle(event_); }
+
+uint64_t D3D12FrameFence::Signal() {
+	HRESULT result = commandQueue_->Signal(fence_.Get(), ++fenceVal_);
+	assert(SUCCEEDED(result));
+	return fenceVal_;
+}
+
+void D3D12FrameFence::Wait(uint64_t value) {
+	if (fence_->GetCompletedValue() >= value) {
+		return;
+	}
+	fence_->SetEventOnCompletion(value, event_);
+	WaitForSingleObject(event_, INFINITE);
+}
@@ -0,0 +1,26 @@
+﻿#pragma once
+
+#include "FrameScheduler.h"
+#include <Windows.h>
+#include <d3d12.h>
+#include <wrl.h>
+
+/// <summary>
+/// コマンドキューに通知を積む ID3D12Fence のフェンス
+/// </summary>
+class D3D12FrameFence : public FrameFence {
+  public:
+	D3D12FrameFence(ID3D12Device* device, ID3D12CommandQueue* commandQueue);
+	~D3D12FrameFence() override;
+
+	uint64_t Signal() override;
+	uint64_t GetCompletedValue() const override { return fence_->GetCompletedValue(); }
+	void Wait(uint64_t value) override;
+
+  private:
+	ID3D12CommandQueue* commandQueue_;
+	Microsoft::WRL::ComPtr<ID3D12Fence> fence_;
+	uint64_t fenceVal_ = 0;
+	// 待機用のイベント（毎回作らずに使い回す）
+	HANDLE event_ = nullptr;
+};
@@ -0,0 +1,51 @@
+﻿#include "D3D12RenderDevice.h"
+
+void D3D12CommandList::SetPipelineState(void* pipelineState) {
+	commandList_->SetPipelineState(static_cast<ID3D12PipelineState*>(pipelineState));
+}
+
+void D3D12CommandList::SetGraphicsRootSignature(void* rootSignature) {
+	commandList_->SetGraphicsRootSignature(static_cast<ID3D12RootSignature*>(rootSignature));
+}
+
+void D3D12CommandList::SetPrimitiveTopology(RenderPrimitiveTopology topology) {
+	commandList_->IASetPrimitiveTopology(
+	  topology == RenderPrimitiveTopology::kLineList ? D3D_PRIMITIVE_TOPOLOGY_LINELIST
+	                                                 : D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+void D3D12CommandList::SetDescriptorHeap(void* descriptorHeap) {
+	ID3D12DescriptorHeap* ppHeaps[] = {static_cast<ID3D12DescriptorHeap*>(descriptorHeap)};
+	commandList_->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
+}
+
+void D3D12CommandList::SetGraphicsRootConstantBufferView(
+  uint32_t rootParameterIndex, GpuAddress address) {
+	commandList_->SetGraphicsRootConstantBufferView(rootParameterIndex, address);
+}
+
+void D3D12CommandList::SetGraphicsRootDescriptorTable(
+  uint32_t rootParameterIndex, GpuDescriptorHandle handle) {
+	commandList_->SetGraphicsRootDescriptorTable(
+	  rootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE{handle});
+}
+
+void D3D12CommandList::SetVertexBuffer(uint32_t slot, const RenderVertexBufferView& view) {
+	D3D12_VERTEX_BUFFER_VIEW vbView = {view.bufferLocation, view.sizeInBytes, view.strideInBytes};
+	commandList_->IASetVertexBuffers(slot, 1, &vbView);
+}
+
+void D3D12CommandList::SetIndexBuffer(const RenderIndexBufferView& view) {
+	D3D12_INDEX_BUFFER_VIEW ibView = {
+	  view.bufferLocation, view.sizeInBytes,
+	  view.format == RenderIndexFormat::kUInt32 ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT};
+	commandList_->IASetIndexBuffer(&ibView);
+}
+
+void D3D12CommandList::DrawIndexedInstanced(
+  uint32_t indexCountPerInstance, uint32_t instanceCount, uint32_t startIndexLocation,
+  int32_t baseVertexLocation, uint32_t startInstanceLocation) {
+	commandList_->DrawIndexedInstanced(
+	  indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation,
+	  startInstanceLocation);
+}
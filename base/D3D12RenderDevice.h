@@ -0,0 +1,53 @@
+﻿#pragma once
+
+#include "D3D12FrameFence.h"
+#include "D3D12UploadPageBackend.h"
+#include "RenderDevice.h"
+#include <d3d12.h>
+
+/// <summary>
+/// ID3D12GraphicsCommandList へそのまま記録するコマンドの記録先
+/// </summary>
+class D3D12CommandList : public RenderCommandList {
+  public:
+	explicit D3D12CommandList(ID3D12GraphicsCommandList* commandList) : commandList_(commandList) {}
+
+	void SetPipelineState(void* pipelineState) override;
+	void SetGraphicsRootSignature(void* rootSignature) override;
+	void SetPrimitiveTopology(RenderPrimitiveTopology topology) override;
+	void SetDescriptorHeap(void* descriptorHeap) override;
+	void SetGraphicsRootConstantBufferView(uint32_t rootParameterIndex, GpuAddress address) override;
+	void SetGraphicsRootDescriptorTable(
+	  uint32_t rootParameterIndex, GpuDescriptorHandle handle) override;
+	void SetVertexBuffer(uint32_t slot, const RenderVertexBufferView& view) override;
+	void SetIndexBuffer(const RenderIndexBufferView& view) override;
+	void DrawIndexedInstanced(
+	  uint32_t indexCountPerInstance, uint32_t instanceCount, uint32_t startIndexLocation,
+	  int32_t baseVertexLocation, uint32_t startInstanceLocation) override;
+
+	// 記録先のコマンドリスト
+	ID3D12GraphicsCommandList* GetNative() const { return commandList_; }
+
+  private:
+	ID3D12GraphicsCommandList* commandList_;
+};
+
+/// <summary>
+/// Direct3D 12 の描画デバイス（デバイス・キュー・コマンドリストは DirectXCommon が持つ）
+/// </summary>
+class D3D12RenderDevice : public RenderDevice {
+  public:
+	D3D12RenderDevice(
+	  ID3D12Device* device, ID3D12CommandQueue* commandQueue,
+	  ID3D12GraphicsCommandList* commandList)
+	    : commandList_(commandList), uploadPageBackend_(device), frameFence_(device, commandQueue) {}
+
+	D3D12CommandList& GetCommandList() override { return commandList_; }
+	D3D12UploadPageBackend& GetUploadPageBackend() override { return uploadPageBackend_; }
+	D3D12FrameFence& GetFrameFence() override { return frameFence_; }
+
+  private:
+	D3D12CommandList commandList_;
+	D3D12UploadPageBackend uploadPageBackend_;
+	D3D12FrameFence frameFence_;
+};
@@ -0,0 +1,31 @@
+﻿#include "D3D12UploadPageBackend.h"
+#include <cassert>
+#include <d3dx12.h>
+
+UploadPage D3D12UploadPageBackend::CreatePage(uint64_t size) {
+	HRESULT result;
+
+	// ヒーププロパティ
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	// リソース設定
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+
+	ID3D12Resource* resource = nullptr;
+	result = device_->CreateCommittedResource(
+	  &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	  IID_PPV_ARGS(&resource));
+	assert(SUCCEEDED(result));
+
+	UploadPage page;
+	page.size = size;
+	page.gpuAddress = resource->GetGPUVirtualAddress();
+	page.handle = resource;
+	// 書き込み専用なので Unmap せずに使い続ける
+	result = resource->Map(0, nullptr, reinterpret_cast<void**>(&page.cpuAddress));
+	assert(SUCCEEDED(result));
+	return page;
+}
+
+void D3D12UploadPageBackend::DestroyPage(const UploadPage& page) {
+	static_cast<ID3D12Resource*>(page.handle)->Release();
+}
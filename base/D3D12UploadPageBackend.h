@@ -0,0 +1,19 @@
+﻿#pragma once
+
+#include "UploadAllocator.h"
+#include <d3d12.h>
+
+/// <summary>
+/// アップロードヒープにページを作るバックエンド
+/// ページごとに1つのコミット済みリソースを作り、破棄するまでマップしたままにする
+/// </summary>
+class D3D12UploadPageBackend : public UploadPageBackend {
+  public:
+	explicit D3D12UploadPageBackend(ID3D12Device* device) : device_(device) {}
+
+	UploadPage CreatePage(uint64_t size) override;
+	void DestroyPage(const UploadPage& page) override;
+
+  private:
+	ID3D12Device* device_;
+};
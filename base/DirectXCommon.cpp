@@ -40,8 +40,12 @@ void DirectXCommon::Initialize(WinApp* winApp, int32_t backBufferWidth, int32_t
 	// 深度バッファ生成
 	CreateDepthBuffer();
 
-	// フェンス生成
-	CreateFence();
+	// 描画デバイス（フェンスを含む）生成
+	CreateRenderDevice();
+
+	// 定数バッファなどを毎フレーム切り出すアップロード領域（同時に処理させるフレームの数だけ枠を持つ）
+	uploadAllocator_ =
+	  std::make_unique<UploadAllocator>(&renderDevice_->GetUploadPageBackend(), kFrameCount);
 }
 
 void DirectXCommon::PreDraw() {
@@ -111,18 +115,27 @@ void DirectXCommon::PostDraw() {
 	}
 #endif
 
-	// コマンドリストの実行完了を待つ
-	commandQueue_->Signal(fence_.Get(), ++fenceVal_);
-	if (fence_->GetCompletedValue() != fenceVal_) {
-		HANDLE event = CreateEvent(nullptr, false, false, nullptr);
-		fence_->SetEventOnCompletion(fenceVal_, event);
-		WaitForSingleObject(event, INFINITE);
-		CloseHandle(event);
-	}
+	// このフレームの完了の通知を積み、次のフレームへ進む
+	// 次のフレームの組を GPU がまだ使っているとき（一周追いついたとき）だけ完了を待つ
+	frameScheduler_->EndFrame();
+	uint32_t frameIndex = frameScheduler_->BeginFrame();
 
-	commandAllocator_->Reset(); // キューをクリア
-	commandList_->Reset(commandAllocator_.Get(),
+	commandAllocators_[frameIndex]->Reset(); // キューをクリア
+	commandList_->Reset(commandAllocators_[frameIndex].Get(),
 	                    nullptr); // 再びコマンドリストを貯める準備
+	// この組で前回切り出したアップロード領域を回収
+	uploadAllocator_->BeginFrame(frameIndex);
+}
+
+void DirectXCommon::WaitForGpuIdle() {
+	if (frameScheduler_) {
+		frameScheduler_->WaitIdle();
+	}
+}
+
+DirectXCommon::~DirectXCommon() {
+	// GPU が使っている資源を解放しないよう、完了を待ってから破棄する
+	WaitForGpuIdle();
 }
 
 void DirectXCommon::ClearRenderTarget() {
@@ -283,14 +296,16 @@ void DirectXCommon::CreateSwapChain() {
 void DirectXCommon::InitializeCommand() {
 	HRESULT result = S_FALSE;
 
-	// コマンドアロケータを生成
-	result = device_->CreateCommandAllocator(
-	  D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator_));
-	assert(SUCCEEDED(result));
+	// コマンドアロケータをフレームごとに生成
+	for (ComPtr<ID3D12CommandAllocator>& commandAllocator : commandAllocators_) {
+		result = device_->CreateCommandAllocator(
+		  D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator));
+		assert(SUCCEEDED(result));
+	}
 
-	// コマンドリストを生成
+	// コマンドリストを生成（最初のフレームは0番のアロケータを使う）
 	result = device_->CreateCommandList(
-	  0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator_.Get(), nullptr,
+	  0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocators_[0].Get(), nullptr,
 	  IID_PPV_ARGS(&commandList_));
 	assert(SUCCEEDED(result));
 
@@ -367,10 +382,11 @@ void DirectXCommon::CreateDepthBuffer() {
 	  depthBuffer_.Get(), &dsvDesc, dsvHeap_->GetCPUDescriptorHandleForHeapStart());
 }
 
-void DirectXCommon::CreateFence() {
-	HRESULT result = S_FALSE;
-
-	// フェンスの生成
-	result = device_->CreateFence(fenceVal_, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
-	assert(SUCCEEDED(result));
+void DirectXCommon::CreateRenderDevice() {
+	// 描画デバイスの生成（フェンスもここで作る）
+	renderDevice_ = std::make_unique<D3D12RenderDevice>(
+	  device_.Get(), commandQueue_.Get(), commandList_.Get());
+	// 最初のフレームは0番の組を使う
+	frameScheduler_ =
+	  std::make_unique<FrameScheduler>(&renderDevice_->GetFrameFence(), kFrameCount);
 }
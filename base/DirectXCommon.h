@@ -5,14 +5,29 @@
 #include <d3d12.h>
 #include <d3dx12.h>
 #include <dxgi1_6.h>
+#include <memory>
+#include <vector>
 #include <wrl.h>
 
+#include "D3D12RenderDevice.h"
+#include "FrameScheduler.h"
+#include "UploadAllocator.h"
 #include "WinApp.h"
 
 /// <summary>
 /// DirectX汎用
 /// </summary>
 class DirectXCommon {
+  public: // 定数
+	// 同時に処理させるフレームの数
+	// CPU は GPU より最大でこのフレーム数だけ先行する。フレームごとに書き換える資源は
+	// アップロードアロケータから切り出すこと（作りっぱなしの定数バッファを毎フレーム
+	// 書き換えると、GPU が読んでいる前のフレームの内容も書き換わる）
+	// ライブラリ側の Sprite・DebugText・PrimitiveDrawer の頂点バッファ、DebugCamera の
+	// ビュープロジェクション、Model のライトの定数バッファは作りっぱなしのバッファに毎フレーム
+	// 書き込むので、それらをすべてアップロードアロケータ経由にするまでは 1 にしておく
+	static const uint32_t kFrameCount = 1;
+
   public: // メンバ関数
 
 	/// <summary>
@@ -38,6 +53,11 @@ class DirectXCommon {
 	/// </summary>
 	void PostDraw();
 
+	/// <summary>
+	/// 提出済みのすべての描画の完了を待つ（GPU が使う資源を破棄する前に呼ぶ）
+	/// </summary>
+	void WaitForGpuIdle();
+
 	/// <summary>
 	/// レンダーターゲットのクリア
 	/// </summary>
@@ -60,6 +80,25 @@ class DirectXCommon {
 	/// <returns>描画コマンドリスト</returns>
 	ID3D12GraphicsCommandList* GetCommandList() { return commandList_.Get(); }
 
+	/// <summary>
+	/// 描画デバイスの取得（GetCommandList と同じコマンドリストに記録する）
+	/// </summary>
+	/// <returns>描画デバイス</returns>
+	D3D12RenderDevice* GetRenderDevice() { return renderDevice_.get(); }
+
+	/// <summary>
+	/// フレームごとのアップロード領域の取得
+	/// 切り出した定数バッファはそのフレームの描画が終わるまで有効
+	/// </summary>
+	/// <returns>アップロードアロケータ</returns>
+	UploadAllocator* GetUploadAllocator() { return uploadAllocator_.get(); }
+
+	/// <summary>
+	/// フレームの予定管理の取得
+	/// </summary>
+	/// <returns>フレームの予定管理</returns>
+	const FrameScheduler* GetFrameScheduler() const { return frameScheduler_.get(); }
+
 	/// <summary>
 	/// バックバッファの幅取得
 	/// </summary>
@@ -80,21 +119,25 @@ class DirectXCommon {
 	Microsoft::WRL::ComPtr<IDXGIFactory7> dxgiFactory_;
 	Microsoft::WRL::ComPtr<ID3D12Device> device_;
 	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList_;
-	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator_;
+	// フレームごとのコマンドアロケータ
+	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocators_[kFrameCount];
 	Microsoft::WRL::ComPtr<ID3D12CommandQueue> commandQueue_;
 	Microsoft::WRL::ComPtr<IDXGISwapChain4> swapChain_;
 	std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> backBuffers_;
 	Microsoft::WRL::ComPtr<ID3D12Resource> depthBuffer_;
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> rtvHeap_;
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> dsvHeap_;
-	Microsoft::WRL::ComPtr<ID3D12Fence> fence_;
-	UINT64 fenceVal_ = 0;
+	// 描画デバイス（フェンスとアップロード領域のページを持つ）とフレームの予定管理
+	std::unique_ptr<D3D12RenderDevice> renderDevice_;
+	std::unique_ptr<FrameScheduler> frameScheduler_;
 	int32_t backBufferWidth_ = 0;
 	int32_t backBufferHeight_ = 0;
+	// フレームごとのアップロード領域（ページは描画デバイスより先に破棄する）
+	std::unique_ptr<UploadAllocator> uploadAllocator_;
 
   private: // メンバ関数
 	DirectXCommon() = default;
-	~DirectXCommon() = default;
+	~DirectXCommon();
 	DirectXCommon(const DirectXCommon&) = delete;
 	const DirectXCommon& operator=(const DirectXCommon&) = delete;
 		   
@@ -124,7 +167,7 @@ class DirectXCommon {
 	void CreateDepthBuffer();
 
 	/// <summary>
-	/// フェンス生成
+	/// 描画デバイス（フェンスを含む）生成
 	/// </summary>
-	void CreateFence();
+	void CreateRenderDevice();
 };
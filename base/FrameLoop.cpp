@@ -0,0 +1,57 @@
+﻿#include "FrameLoop.h"
+#include <cassert>
+#include <cmath>
+
+FrameLoop::FrameLoop(double stepSeconds, uint32_t maxStepsPerFrame)
+    : stepSeconds_(stepSeconds), maxStepsPerFrame_(maxStepsPerFrame) {
+	assert(stepSeconds_ > 0.0);
+	assert(maxStepsPerFrame_ > 0);
+}
+
+uint32_t FrameLoop::BeginFrame() {
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	// 最初のフレームは1ステップぶん経過したものとする
+	double elapsedSeconds = stepSeconds_;
+	if (hasLastTime_) {
+		elapsedSeconds = std::chrono::duration<double>(now - lastTime_).count();
+	}
+	lastTime_ = now;
+	hasLastTime_ = true;
+	return BeginFrame(elapsedSeconds);
+}
+
+uint32_t FrameLoop::BeginFrame(double elapsedSeconds) {
+	frameCount_++;
+
+	if (mode_ == Mode::kUncapped) {
+		// 実時間は見ず、常に最新のステップの状態を描く
+		stepCount_ += uncappedStepsPerFrame_;
+		alpha_ = 1.0f;
+		return uncappedStepsPerFrame_;
+	}
+
+	if (elapsedSeconds > 0.0) {
+		accumulator_ += elapsedSeconds;
+	}
+	uint64_t steps = static_cast<uint64_t>(accumulator_ / stepSeconds_);
+	accumulator_ -= steps * stepSeconds_;
+	if (steps > maxStepsPerFrame_) {
+		// 取り戻しきれない遅れは捨てる（端数は残す）
+		droppedStepCount_ += steps - maxStepsPerFrame_;
+		steps = maxStepsPerFrame_;
+	}
+	// 浮動小数点の誤差で端数がステップ幅を超えないようにする
+	accumulator_ = std::fmin(std::fmax(accumulator_, 0.0), stepSeconds_);
+
+	stepCount_ += steps;
+	alpha_ = static_cast<float>(accumulator_ / stepSeconds_);
+	return static_cast<uint32_t>(steps);
+}
+
+void FrameLoop::SetMode(Mode mode, uint32_t stepsPerFrame) {
+	assert(stepsPerFrame > 0);
+	mode_ = mode;
+	uncappedStepsPerFrame_ = stepsPerFrame;
+	accumulator_ = 0.0;
+	hasLastTime_ = false;
+}
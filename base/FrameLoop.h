@@ -0,0 +1,83 @@
+﻿#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/// <summary>
+/// 固定ステップのシミュレーションと描画を分けるフレームループ
+/// 経過時間をためておき、ステップ幅ぶんたまるごとにシミュレーションを1回進める。
+/// 描画は残りの端数（GetAlpha）で前後のステップの状態を補間する。
+/// 遅れを取り戻すステップ数には上限を設け、超えた分は捨てる（処理落ちで破綻しないため）
+/// </summary>
+class FrameLoop {
+  public: // サブクラス
+	// 時間の進め方
+	enum class Mode {
+		kRealTime, // 実時間に合わせる
+		kUncapped, // 実時間を見ずに、1フレームごとに決まった数だけ全速で進める（計測・ヘッドレス用）
+	};
+
+  public: // 定数
+	// 既定のステップ幅（秒）
+	static constexpr double kDefaultStepSeconds = 1.0 / 60.0;
+	// 既定の1フレームで進める最大ステップ数
+	static const uint32_t kDefaultMaxStepsPerFrame = 5;
+
+  public: // メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="stepSeconds">ステップ幅（秒）</param>
+	/// <param name="maxStepsPerFrame">1フレームで進める最大ステップ数</param>
+	FrameLoop(
+	  double stepSeconds = kDefaultStepSeconds, uint32_t maxStepsPerFrame = kDefaultMaxStepsPerFrame);
+
+	/// <summary>
+	/// フレームの開始（前回からの実時間を時計で測る）
+	/// </summary>
+	/// <returns>このフレームで進めるステップ数</returns>
+	uint32_t BeginFrame();
+	/// <summary>
+	/// フレームの開始（経過時間を指定する）
+	/// </summary>
+	/// <param name="elapsedSeconds">前のフレームからの経過時間（秒）</param>
+	/// <returns>このフレームで進めるステップ数</returns>
+	uint32_t BeginFrame(double elapsedSeconds);
+
+	/// <summary>
+	/// 時間の進め方の設定（kUncapped では 1フレームに stepsPerFrame ステップ進める）
+	/// </summary>
+	void SetMode(Mode mode, uint32_t stepsPerFrame = 1);
+	Mode GetMode() const { return mode_; }
+
+	// ステップ幅（秒）
+	double GetStepSeconds() const { return stepSeconds_; }
+	float GetStepSecondsF() const { return static_cast<float>(stepSeconds_); }
+	// 描画の補間係数 [0, 1]（直前のステップの状態を 1、その前を 0 とする）
+	float GetAlpha() const { return alpha_; }
+	// 進めたステップの総数
+	uint64_t GetStepCount() const { return stepCount_; }
+	// シミュレーション内の経過時間（秒）
+	double GetSimulatedSeconds() const { return stepCount_ * stepSeconds_; }
+	// 開始したフレームの数
+	uint64_t GetFrameCount() const { return frameCount_; }
+	// 上限を超えたために捨てたステップの総数
+	uint64_t GetDroppedStepCount() const { return droppedStepCount_; }
+
+  private: // メンバ変数
+	double stepSeconds_;
+	uint32_t maxStepsPerFrame_;
+	Mode mode_ = Mode::kRealTime;
+	uint32_t uncappedStepsPerFrame_ = 1;
+
+	// まだステップに使っていない経過時間
+	double accumulator_ = 0.0;
+	float alpha_ = 1.0f;
+	uint64_t stepCount_ = 0;
+	uint64_t frameCount_ = 0;
+	uint64_t droppedStepCount_ = 0;
+
+	// 前のフレームの開始時刻（最初のフレームの前は未設定）
+	std::chrono::steady_clock::time_point lastTime_;
+	bool hasLastTime_ = false;
+};
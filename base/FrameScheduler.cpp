@@ -0,0 +1,34 @@
+﻿#include "FrameScheduler.h"
+#include <cassert>
+
+FrameScheduler::FrameScheduler(FrameFence* fence, uint32_t frameCount)
+    : fence_(fence), frameFenceValues_(frameCount, 0) {
+	assert(fence_);
+	assert(frameCount > 0);
+}
+
+void FrameScheduler::EndFrame() {
+	assert(!frameEnded_);
+	lastSignaledValue_ = fence_->Signal();
+	frameFenceValues_[frameIndex_] = lastSignaledValue_;
+	frameEnded_ = true;
+}
+
+uint32_t FrameScheduler::BeginFrame() {
+	assert(frameEnded_);
+	frameEnded_ = false;
+	frameNumber_++;
+	frameIndex_ = static_cast<uint32_t>(frameNumber_ % frameFenceValues_.size());
+	// GPU に一周追いついたときだけ待つ
+	if (!IsFrameComplete(frameIndex_)) {
+		fence_->Wait(frameFenceValues_[frameIndex_]);
+		waitCount_++;
+	}
+	return frameIndex_;
+}
+
+void FrameScheduler::WaitIdle() {
+	if (fence_->GetCompletedValue() < lastSignaledValue_) {
+		fence_->Wait(lastSignaledValue_);
+	}
+}
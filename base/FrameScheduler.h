@@ -0,0 +1,108 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// フレームの完了を知らせるフェンス
+/// 値は Signal のたびに1ずつ増え、GPU がそこまで処理すると GetCompletedValue がその値になる
+/// </summary>
+class FrameFence {
+  public:
+	virtual ~FrameFence() = default;
+	/// <summary>
+	/// ここまでに提出した処理の後に通知を積む
+	/// </summary>
+	/// <returns>通知の値</returns>
+	virtual uint64_t Signal() = 0;
+	/// <summary>
+	/// 完了した通知の値
+	/// </summary>
+	virtual uint64_t GetCompletedValue() const = 0;
+	/// <summary>
+	/// value の通知が完了するまで CPU を止める
+	/// </summary>
+	virtual void Wait(uint64_t value) = 0;
+};
+
+/// <summary>
+/// GPU なしで動かすフェンス
+/// Complete で GPU の進みを再現する。Wait はその値まで完了したことにして戻る
+/// </summary>
+class ManualFrameFence : public FrameFence {
+  public:
+	uint64_t Signal() override { return ++signaledValue_; }
+	uint64_t GetCompletedValue() const override { return completedValue_; }
+	void Wait(uint64_t value) override { Complete(value); }
+
+	/// <summary>
+	/// value の通知まで完了させる（通知していない値までは進めない）
+	/// </summary>
+	void Complete(uint64_t value) {
+		if (value > signaledValue_) {
+			value = signaledValue_;
+		}
+		if (value > completedValue_) {
+			completedValue_ = value;
+		}
+	}
+	uint64_t GetSignaledValue() const { return signaledValue_; }
+
+  private:
+	uint64_t signaledValue_ = 0;
+	uint64_t completedValue_ = 0;
+};
+
+/// <summary>
+/// 複数フレームを同時に処理させるための予定管理
+/// フレームごとの資源（コマンドアロケータ、アップロード領域など）を frameCount 組用意し、
+/// フレーム番号を順に回して使う。ある組を使い回す前に、その組で前回提出した処理の完了を待つ。
+/// CPU が待つのは GPU に frameCount フレーム分先行したときだけになる
+/// </summary>
+class FrameScheduler {
+  public: // メンバ関数
+	/// <summary>
+	/// コンストラクタ（フレーム番号0の組を使うフレームを開始した状態になる）
+	/// </summary>
+	/// <param name="fence">フェンス（スケジューラより長く生きること）</param>
+	/// <param name="frameCount">同時に処理させるフレームの数</param>
+	FrameScheduler(FrameFence* fence, uint32_t frameCount);
+
+	/// <summary>
+	/// フレームの終了（このフレームの処理を提出した後に呼ぶ）
+	/// </summary>
+	void EndFrame();
+	/// <summary>
+	/// 次のフレームの開始（次の組が前回のフレームで使用中なら完了を待つ）
+	/// </summary>
+	/// <returns>使う組の番号</returns>
+	uint32_t BeginFrame();
+	/// <summary>
+	/// 提出済みのすべての処理の完了を待つ（資源を破棄する前に呼ぶ）
+	/// </summary>
+	void WaitIdle();
+
+	uint32_t GetFrameCount() const { return static_cast<uint32_t>(frameFenceValues_.size()); }
+	// 現在のフレームが使う組の番号
+	uint32_t GetFrameIndex() const { return frameIndex_; }
+	// 開始したフレームの通し番号（0 から）
+	uint64_t GetFrameNumber() const { return frameNumber_; }
+	// CPU が GPU を待った回数
+	uint64_t GetWaitCount() const { return waitCount_; }
+	// 組の使い回しが安全か（その組で前回提出した処理が完了しているか）
+	bool IsFrameComplete(uint32_t frameIndex) const {
+		return fence_->GetCompletedValue() >= frameFenceValues_[frameIndex];
+	}
+
+  private: // メンバ変数
+	FrameFence* fence_;
+	// 組ごとの、最後に提出したフレームの通知の値（0 なら未使用）
+	std::vector<uint64_t> frameFenceValues_;
+	uint32_t frameIndex_ = 0;
+	uint64_t frameNumber_ = 0;
+	uint64_t waitCount_ = 0;
+	// 最後に通知した値
+	uint64_t lastSignaledValue_ = 0;
+	// EndFrame の後で BeginFrame をまだ呼んでいない
+	bool frameEnded_ = false;
+};
@@ -0,0 +1,13 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// 64ビットのハッシュ値（xxHash64 と同じ計算）
+/// ファイルの中身が変わったかの判定など、暗号用途でない比較に使う
+/// </summary>
+/// <param name="data">データの先頭</param>
+/// <param name="size">バイト数</param>
+/// <param name="seed">初期値（別のハッシュ値を渡すとつなげて計算できる）</param>
+uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0);
@@ -0,0 +1,220 @@
+﻿#include "JobSystem.h"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+// 実行中のスレッドが使うキューの番号（メインスレッドなどワーカー以外は0）
+thread_local uint32_t sQueueIndex = 0;
+
+} // namespace
+
+JobSystem* JobSystem::GetInstance() {
+	static JobSystem instance;
+	return &instance;
+}
+
+JobSystem::~JobSystem() { Finalize(); }
+
+void JobSystem::Initialize(uint32_t threadCount) {
+	assert(queues_.empty());
+	if (threadCount == 0) {
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	quit_ = false;
+	for (uint32_t i = 0; i < threadCount; i++) {
+		queues_.push_back(std::make_unique<WorkQueue>());
+	}
+	// キュー0は呼び出し元スレッドが使う
+	for (uint32_t i = 1; i < threadCount; i++) {
+		workers_.emplace_back(&JobSystem::WorkerMain, this, i);
+	}
+}
+
+void JobSystem::Finalize() {
+	// 残っているジョブを片付けてから止める
+	while (RunOne()) {
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		quit_ = true;
+	}
+	sleepCondition_.notify_all();
+	for (std::thread& worker : workers_) {
+		worker.join();
+	}
+	workers_.clear();
+	queues_.clear();
+}
+
+void JobSystem::Run(JobFunction function, Counter* counter, Counter* dependency) {
+	if (counter) {
+		counter->value_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	if (dependency) {
+		// 依存先が未完了なら、完了時に積まれるよう預けておく
+		std::lock_guard<std::mutex> lock(dependency->mutex_);
+		if (!dependency->IsDone()) {
+			dependency->continuations_.push_back({std::move(function), counter});
+			return;
+		}
+	}
+
+	Schedule({std::move(function), counter});
+}
+
+void JobSystem::Schedule(Job job) {
+	if (IsSingleThreaded()) {
+		// 決定的モードでは積んだ順にその場で実行する
+		Execute(job);
+		return;
+	}
+	Push(std::move(job));
+}
+
+void JobSystem::Wait(Counter& counter) {
+	while (!counter.IsDone()) {
+		if (RunOne()) {
+			continue;
+		}
+
+		// 盗めるジョブもなければ、ジョブが積まれるかカウンタが0になるまで眠る
+		std::unique_lock<std::mutex> lock(sleepMutex_);
+		sleepingWaiters_++;
+		sleepCondition_.wait(lock, [this, &counter] {
+			return counter.IsDone() || pendingJobs_.load(std::memory_order_acquire) > 0;
+		});
+		sleepingWaiters_--;
+	}
+	// 最後のジョブを終えたスレッドが counter の後始末を終えるまで待つ
+	std::lock_guard<std::mutex> lock(counter.mutex_);
+}
+
+void JobSystem::ParallelFor(
+  uint32_t begin, uint32_t end, uint32_t grainSize, const RangeFunction& function) {
+	assert(grainSize > 0);
+	if (begin >= end) {
+		return;
+	}
+	// 1回分に収まるなら分割しない
+	if (IsSingleThreaded() || end - begin <= grainSize) {
+		for (uint32_t i = begin; i < end; i += grainSize) {
+			function(i, std::min(end, i + grainSize));
+		}
+		return;
+	}
+
+	Counter counter;
+	for (uint32_t i = begin; i < end; i += grainSize) {
+		uint32_t chunkEnd = std::min(end, i + grainSize);
+		Run([&function, i, chunkEnd]() { function(i, chunkEnd); }, &counter);
+	}
+	Wait(counter);
+}
+
+void JobSystem::Push(Job job) {
+	// 積んだ直後に盗まれて減らされても0を下回らないよう、先に増やしておく
+	pendingJobs_.fetch_add(1, std::memory_order_release);
+	WorkQueue& queue = *queues_[sQueueIndex];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(std::move(job));
+	}
+
+	// 眠りに入る直前のワーカーが通知を取りこぼさないよう、一度ロックを取ってから起こす
+	{ std::lock_guard<std::mutex> lock(sleepMutex_); }
+	sleepCondition_.notify_one();
+}
+
+bool JobSystem::TryPop(Job& job) {
+	WorkQueue& queue = *queues_[sQueueIndex];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.jobs.empty()) {
+		return false;
+	}
+	// 直前に積んだジョブから処理する（キャッシュに残っているデータを使える）
+	job = std::move(queue.jobs.back());
+	queue.jobs.pop_back();
+	pendingJobs_.fetch_sub(1, std::memory_order_relaxed);
+	return true;
+}
+
+bool JobSystem::TrySteal(Job& job) {
+	const uint32_t count = static_cast<uint32_t>(queues_.size());
+	for (uint32_t offset = 1; offset < count; offset++) {
+		WorkQueue& queue = *queues_[(sQueueIndex + offset) % count];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty()) {
+			continue;
+		}
+		// 他のスレッドからは古いジョブ（大きな仕事であることが多い）を盗む
+		job = std::move(queue.jobs.front());
+		queue.jobs.pop_front();
+		pendingJobs_.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+	return false;
+}
+
+bool JobSystem::RunOne() {
+	if (queues_.empty()) {
+		return false;
+	}
+	Job job;
+	if (TryPop(job) || TrySteal(job)) {
+		Execute(job);
+		return true;
+	}
+	return false;
+}
+
+void JobSystem::Execute(Job& job) {
+	job.function();
+
+	Counter* counter = job.counter;
+	if (!counter) {
+		return;
+	}
+
+	// カウンタが0になったら、預けられていたジョブを積む
+	std::vector<Counter::Continuation> continuations;
+	bool done = false;
+	{
+		std::lock_guard<std::mutex> lock(counter->mutex_);
+		if (counter->value_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			continuations.swap(counter->continuations_);
+			done = true;
+		}
+	}
+	if (done) {
+		// Wait で眠っているスレッドがいれば起こす（どのカウンタを待っているかは区別しない）
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		if (sleepingWaiters_ > 0) {
+			sleepCondition_.notify_all();
+		}
+	}
+	for (Counter::Continuation& continuation : continuations) {
+		// カウンタは Run の時点で加算済みなのでそのまま積む
+		Schedule({std::move(continuation.function), continuation.counter});
+	}
+}
+
+void JobSystem::WorkerMain(uint32_t index) {
+	sQueueIndex = index;
+	while (true) {
+		if (RunOne()) {
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex_);
+		sleepCondition_.wait(lock, [this] {
+			return quit_ || pendingJobs_.load(std::memory_order_acquire) > 0;
+		});
+		if (quit_ && pendingJobs_.load(std::memory_order_acquire) == 0) {
+			break;
+		}
+	}
+}
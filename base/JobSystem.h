@@ -0,0 +1,138 @@
+﻿#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// ジョブシステム
+/// スレッドごとのキューにジョブを積み、手が空いたスレッドは他のキューから盗んで実行する
+/// </summary>
+class JobSystem {
+  public:
+	// ジョブの本体
+	using JobFunction = std::function<void()>;
+	// 範囲処理の本体 [begin, end)
+	using RangeFunction = std::function<void(uint32_t begin, uint32_t end)>;
+
+	/// <summary>
+	/// ジョブの完了待ち用カウンタ
+	/// Run に渡したジョブの数だけ増え、ジョブが終わるたびに減る
+	/// </summary>
+	class Counter {
+	  public:
+		Counter() = default;
+		Counter(const Counter&) = delete;
+		Counter& operator=(const Counter&) = delete;
+
+		// 関連付けたジョブがすべて終わったか
+		bool IsDone() const { return value_.load(std::memory_order_acquire) == 0; }
+
+	  private:
+		friend class JobSystem;
+		struct Continuation {
+			JobFunction function;
+			Counter* counter;
+		};
+
+		std::atomic<uint32_t> value_ = 0;
+		// 完了時に実行するジョブ（Run の dependency に指定されたもの）
+		std::mutex mutex_;
+		std::vector<Continuation> continuations_;
+	};
+
+  public: // 静的メンバ関数
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	/// <returns></returns>
+	static JobSystem* GetInstance();
+
+  public: // メンバ関数
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="threadCount">
+	/// 呼び出し元を含むスレッド数（0 ならハードウェアスレッド数）。
+	/// 1 のときはワーカーを作らず、すべてのジョブを Run の中で即座に順番どおり実行する（デバッグ用の決定的モード）
+	/// </param>
+	void Initialize(uint32_t threadCount = 0);
+
+	/// <summary>
+	/// 終了処理（積まれているジョブをすべて実行してからワーカーを止める）
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// ジョブを積む
+	/// </summary>
+	/// <param name="function">ジョブ</param>
+	/// <param name="counter">完了待ち用カウンタ（不要なら nullptr）</param>
+	/// <param name="dependency">このカウンタが完了してから実行する（不要なら nullptr）</param>
+	void Run(JobFunction function, Counter* counter = nullptr, Counter* dependency = nullptr);
+
+	/// <summary>
+	/// カウンタが完了するまで待つ（待っている間は他のジョブを実行し、実行できるものがなければ眠る）
+	/// </summary>
+	void Wait(Counter& counter);
+
+	/// <summary>
+	/// 範囲 [begin, end) を grainSize ごとに分けて並列に処理し、完了まで待つ
+	/// </summary>
+	/// <param name="begin">開始</param>
+	/// <param name="end">終了</param>
+	/// <param name="grainSize">1ジョブで処理する最大数</param>
+	/// <param name="function">範囲処理</param>
+	void ParallelFor(uint32_t begin, uint32_t end, uint32_t grainSize, const RangeFunction& function);
+
+	// 呼び出し元を含むスレッド数
+	uint32_t GetThreadCount() const { return static_cast<uint32_t>(queues_.size()); }
+	// 決定的モード（1スレッドで即時実行）か
+	bool IsSingleThreaded() const { return queues_.size() <= 1; }
+
+  private: // メンバ関数
+	JobSystem() = default;
+	~JobSystem();
+	JobSystem(const JobSystem&) = delete;
+	const JobSystem& operator=(const JobSystem&) = delete;
+
+	struct Job {
+		JobFunction function;
+		Counter* counter;
+	};
+
+	// スレッドごとのジョブキュー（持ち主は後ろから、他のスレッドは前から取り出す）
+	struct WorkQueue {
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	// 依存関係が解決済みのジョブを実行待ちにする
+	void Schedule(Job job);
+	void Push(Job job);
+	bool TryPop(Job& job);
+	bool TrySteal(Job& job);
+	// 1つ実行できたら true
+	bool RunOne();
+	void Execute(Job& job);
+	void WorkerMain(uint32_t index);
+
+  private: // メンバ変数
+	std::vector<std::unique_ptr<WorkQueue>> queues_;
+	std::vector<std::thread> workers_;
+
+	// 積まれていてまだ取り出されていないジョブの数（キューに入れる前に増やす）
+	std::atomic<uint32_t> pendingJobs_ = 0;
+	std::atomic<bool> quit_ = false;
+	// ジョブが積まれたときと、Wait 中のカウンタが0になったときに眠っているスレッドを起こす
+	std::mutex sleepMutex_;
+	std::condition_variable sleepCondition_;
+	// Wait の中で眠っているスレッドの数（sleepMutex_ で保護）
+	uint32_t sleepingWaiters_ = 0;
+};
@@ -0,0 +1,135 @@
+﻿#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() { Close(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept { MoveFrom(other); }
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this != &other) {
+		Close();
+		MoveFrom(other);
+	}
+	return *this;
+}
+
+void MappedFile::MoveFrom(MappedFile& other) {
+	data_ = other.data_;
+	size_ = other.size_;
+	isOpen_ = other.isOpen_;
+	other.data_ = nullptr;
+	other.size_ = 0;
+	other.isOpen_ = false;
+#ifdef _WIN32
+	file_ = other.file_;
+	mapping_ = other.mapping_;
+	other.file_ = nullptr;
+	other.mapping_ = nullptr;
+#endif
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& path) {
+	Close();
+
+	HANDLE file = CreateFileA(
+	  path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+	  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		return false;
+	}
+	file_ = file;
+	isOpen_ = true;
+	// 大きさ0のファイルは割り当てられない
+	if (size.QuadPart == 0) {
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		Close();
+		return false;
+	}
+	mapping_ = mapping;
+	data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!data_) {
+		Close();
+		return false;
+	}
+	size_ = static_cast<size_t>(size.QuadPart);
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data_) {
+		UnmapViewOfFile(data_);
+	}
+	if (mapping_) {
+		CloseHandle(mapping_);
+	}
+	if (file_) {
+		CloseHandle(file_);
+	}
+	data_ = nullptr;
+	size_ = 0;
+	mapping_ = nullptr;
+	file_ = nullptr;
+	isOpen_ = false;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path) {
+	Close();
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0) {
+		close(fd);
+		return false;
+	}
+	isOpen_ = true;
+	if (status.st_size > 0) {
+		void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED) {
+			close(fd);
+			isOpen_ = false;
+			return false;
+		}
+		// 先頭から順に読むことを伝えて先読みさせる
+		madvise(data, static_cast<size_t>(status.st_size), MADV_SEQUENTIAL);
+		data_ = static_cast<const uint8_t*>(data);
+		size_ = static_cast<size_t>(status.st_size);
+	}
+	// 割り当てはファイルを閉じても残る
+	close(fd);
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data_) {
+		munmap(const_cast<uint8_t*>(data_), size_);
+	}
+	data_ = nullptr;
+	size_ = 0;
+	isOpen_ = false;
+}
+
+#endif
@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/// <summary>
+/// 読み取り専用でメモリに割り当てたファイル
+/// 中身はコピーせず、必要になったページから OS が読み込む
+/// </summary>
+class MappedFile {
+  public: // メンバ関数
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	/// <summary>
+	/// ファイルを開いて割り当てる（開いていたファイルは閉じる）
+	/// </summary>
+	/// <param name="path">ファイルパス</param>
+	/// <returns>成功したか（空のファイルは成功で、GetData は nullptr）</returns>
+	bool Open(const std::string& path);
+	/// <summary>
+	/// 割り当ての解除
+	/// </summary>
+	void Close();
+
+	bool IsOpen() const { return isOpen_; }
+	const uint8_t* GetData() const { return data_; }
+	size_t GetSize() const { return size_; }
+	// 中身を文字列として見る
+	std::string_view GetText() const {
+		return {reinterpret_cast<const char*>(data_), size_};
+	}
+
+  private: // メンバ関数
+	void MoveFrom(MappedFile& other);
+
+  private: // メンバ変数
+	const uint8_t* data_ = nullptr;
+	size_t size_ = 0;
+	bool isOpen_ = false;
+#ifdef _WIN32
+	// ファイルとマッピングオブジェクトのハンドル
+	void* file_ = nullptr;
+	void* mapping_ = nullptr;
+#endif
+};
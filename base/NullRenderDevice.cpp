@@ -0,0 +1,71 @@
+﻿#include "NullRenderDevice.h"
+
+uint64_t NullCommandList::Counts::GetStateChangeCount() const {
+	uint64_t total = 0;
+	for (size_t i = 0; i < static_cast<size_t>(CommandType::kCount); i++) {
+		if (i != static_cast<size_t>(CommandType::kDrawIndexedInstanced)) {
+			total += commands[i];
+		}
+	}
+	return total;
+}
+
+void NullCommandList::SetPipelineState(void* pipelineState) {
+	Record(CommandType::kSetPipelineState, 0, reinterpret_cast<uintptr_t>(pipelineState));
+}
+
+void NullCommandList::SetGraphicsRootSignature(void* rootSignature) {
+	Record(CommandType::kSetGraphicsRootSignature, 0, reinterpret_cast<uintptr_t>(rootSignature));
+}
+
+void NullCommandList::SetPrimitiveTopology(RenderPrimitiveTopology topology) {
+	Record(CommandType::kSetPrimitiveTopology, 0, static_cast<uint64_t>(topology));
+}
+
+void NullCommandList::SetDescriptorHeap(void* descriptorHeap) {
+	Record(CommandType::kSetDescriptorHeap, 0, reinterpret_cast<uintptr_t>(descriptorHeap));
+}
+
+void NullCommandList::SetGraphicsRootConstantBufferView(
+  uint32_t rootParameterIndex, GpuAddress address) {
+	Record(CommandType::kSetGraphicsRootConstantBufferView, rootParameterIndex, address);
+}
+
+void NullCommandList::SetGraphicsRootDescriptorTable(
+  uint32_t rootParameterIndex, GpuDescriptorHandle handle) {
+	Record(CommandType::kSetGraphicsRootDescriptorTable, rootParameterIndex, handle);
+}
+
+void NullCommandList::SetVertexBuffer(uint32_t slot, const RenderVertexBufferView& view) {
+	Record(CommandType::kSetVertexBuffer, slot, view.bufferLocation, view.sizeInBytes);
+}
+
+void NullCommandList::SetIndexBuffer(const RenderIndexBufferView& view) {
+	Record(
+	  CommandType::kSetIndexBuffer, static_cast<uint32_t>(view.format), view.bufferLocation,
+	  view.sizeInBytes);
+}
+
+void NullCommandList::DrawIndexedInstanced(
+  uint32_t indexCountPerInstance, uint32_t instanceCount, uint32_t startIndexLocation,
+  int32_t baseVertexLocation, uint32_t startInstanceLocation) {
+	counts_.indices += static_cast<uint64_t>(indexCountPerInstance) * instanceCount;
+	counts_.instances += instanceCount;
+	Record(
+	  CommandType::kDrawIndexedInstanced, indexCountPerInstance, 0, instanceCount,
+	  startIndexLocation, baseVertexLocation, startInstanceLocation);
+}
+
+void NullCommandList::Reset() {
+	counts_ = {};
+	commands_.clear();
+}
+
+void NullCommandList::Record(
+  CommandType type, uint32_t index, uint64_t value, uint32_t count, uint32_t start,
+  int32_t baseVertex, uint32_t startInstance) {
+	counts_.commands[static_cast<size_t>(type)]++;
+	if (recording_) {
+		commands_.push_back({type, index, value, count, start, baseVertex, startInstance});
+	}
+}
@@ -0,0 +1,98 @@
+﻿#pragma once
+
+#include "RenderDevice.h"
+#include <vector>
+
+/// <summary>
+/// 何も描画しないコマンドの記録先
+/// すべての呼び出しを受け付けて種類ごとに数える。記録を有効にすると引数も残す
+/// </summary>
+class NullCommandList : public RenderCommandList {
+  public: // サブクラス
+	// コマンドの種類
+	enum class CommandType {
+		kSetPipelineState,
+		kSetGraphicsRootSignature,
+		kSetPrimitiveTopology,
+		kSetDescriptorHeap,
+		kSetGraphicsRootConstantBufferView,
+		kSetGraphicsRootDescriptorTable,
+		kSetVertexBuffer,
+		kSetIndexBuffer,
+		kDrawIndexedInstanced,
+
+		kCount,
+	};
+
+	// 記録したコマンド（引数の意味はコマンドの種類ごとに DirectX の同名の関数に合わせる）
+	struct Command {
+		CommandType type;
+		uint32_t index;     // ルートパラメータ番号・スロット・インスタンスあたりのインデックス数
+		uint64_t value;     // アドレス・ハンドル・オブジェクト
+		uint32_t count;     // インスタンス数
+		uint32_t start;     // 開始インデックス
+		int32_t baseVertex; // 頂点番号のずれ
+		uint32_t startInstance;
+	};
+
+	// 数えた結果
+	struct Counts {
+		uint64_t commands[static_cast<size_t>(CommandType::kCount)] = {};
+		uint64_t indices = 0;   // 描画したインデックスの数（インスタンス数を掛けたもの）
+		uint64_t instances = 0; // 描画したインスタンスの数
+
+		uint64_t Get(CommandType type) const { return commands[static_cast<size_t>(type)]; }
+		uint64_t GetDrawCount() const { return Get(CommandType::kDrawIndexedInstanced); }
+		// 描画以外のコマンドの数
+		uint64_t GetStateChangeCount() const;
+	};
+
+  public: // RenderCommandList
+	void SetPipelineState(void* pipelineState) override;
+	void SetGraphicsRootSignature(void* rootSignature) override;
+	void SetPrimitiveTopology(RenderPrimitiveTopology topology) override;
+	void SetDescriptorHeap(void* descriptorHeap) override;
+	void SetGraphicsRootConstantBufferView(uint32_t rootParameterIndex, GpuAddress address) override;
+	void SetGraphicsRootDescriptorTable(
+	  uint32_t rootParameterIndex, GpuDescriptorHandle handle) override;
+	void SetVertexBuffer(uint32_t slot, const RenderVertexBufferView& view) override;
+	void SetIndexBuffer(const RenderIndexBufferView& view) override;
+	void DrawIndexedInstanced(
+	  uint32_t indexCountPerInstance, uint32_t instanceCount, uint32_t startIndexLocation,
+	  int32_t baseVertexLocation, uint32_t startInstanceLocation) override;
+
+  public: // メンバ関数
+	// 引数を記録するか（既定では数えるだけ）
+	void SetRecording(bool recording) { recording_ = recording; }
+	const Counts& GetCounts() const { return counts_; }
+	const std::vector<Command>& GetCommands() const { return commands_; }
+	// 数と記録を消す
+	void Reset();
+
+  private: // メンバ関数
+	void Record(
+	  CommandType type, uint32_t index = 0, uint64_t value = 0, uint32_t count = 0,
+	  uint32_t start = 0, int32_t baseVertex = 0, uint32_t startInstance = 0);
+
+  private: // メンバ変数
+	Counts counts_;
+	std::vector<Command> commands_;
+	bool recording_ = false;
+};
+
+/// <summary>
+/// GPU なしで動かす描画デバイス
+/// バッファは CPU メモリに置き、コマンドは数えるだけで実行しない。
+/// フェンスは待つとすぐに完了するので、CPU 側の更新と描画の発行だけを全速で計測できる
+/// </summary>
+class NullRenderDevice : public RenderDevice {
+  public:
+	NullCommandList& GetCommandList() override { return commandList_; }
+	CpuUploadPageBackend& GetUploadPageBackend() override { return uploadPageBackend_; }
+	ManualFrameFence& GetFrameFence() override { return frameFence_; }
+
+  private:
+	NullCommandList commandList_;
+	CpuUploadPageBackend uploadPageBackend_;
+	ManualFrameFence frameFence_;
+};
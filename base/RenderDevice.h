@@ -0,0 +1,76 @@
+﻿#pragma once
+
+#include "FrameScheduler.h"
+#include "UploadAllocator.h"
+#include <cstdint>
+
+// GPU から見たアドレス
+using GpuAddress = uint64_t;
+// シェーダーから見えるデスクリプタのハンドル
+using GpuDescriptorHandle = uint64_t;
+
+// 頂点バッファビュー
+struct RenderVertexBufferView {
+	GpuAddress bufferLocation = 0;
+	uint32_t sizeInBytes = 0;
+	uint32_t strideInBytes = 0;
+};
+
+// インデックスの形式
+enum class RenderIndexFormat {
+	kUInt16,
+	kUInt32,
+};
+
+// インデックスバッファビュー
+struct RenderIndexBufferView {
+	GpuAddress bufferLocation = 0;
+	uint32_t sizeInBytes = 0;
+	RenderIndexFormat format = RenderIndexFormat::kUInt16;
+};
+
+// プリミティブの形状
+enum class RenderPrimitiveTopology {
+	kTriangleList,
+	kLineList,
+};
+
+/// <summary>
+/// 描画コマンドの記録先
+/// パイプライン・ルートシグネチャ・デスクリプタヒープは、実装ごとのオブジェクト
+/// （Direct3D 12 なら ID3D12PipelineState など）へのポインタをそのまま渡す
+/// </summary>
+class RenderCommandList {
+  public:
+	virtual ~RenderCommandList() = default;
+
+	virtual void SetPipelineState(void* pipelineState) = 0;
+	virtual void SetGraphicsRootSignature(void* rootSignature) = 0;
+	virtual void SetPrimitiveTopology(RenderPrimitiveTopology topology) = 0;
+	virtual void SetDescriptorHeap(void* descriptorHeap) = 0;
+	virtual void SetGraphicsRootConstantBufferView(uint32_t rootParameterIndex, GpuAddress address) = 0;
+	virtual void
+	  SetGraphicsRootDescriptorTable(uint32_t rootParameterIndex, GpuDescriptorHandle handle) = 0;
+	virtual void SetVertexBuffer(uint32_t slot, const RenderVertexBufferView& view) = 0;
+	virtual void SetIndexBuffer(const RenderIndexBufferView& view) = 0;
+	virtual void DrawIndexedInstanced(
+	  uint32_t indexCountPerInstance, uint32_t instanceCount, uint32_t startIndexLocation,
+	  int32_t baseVertexLocation, uint32_t startInstanceLocation) = 0;
+};
+
+/// <summary>
+/// 描画デバイス
+/// コマンドの記録先、フレームごとのアップロード領域のページ、フレームの完了を知らせるフェンスをまとめる。
+/// Direct3D 12 の実装（D3D12RenderDevice）と、GPU なしで動かす実装（NullRenderDevice）がある
+/// </summary>
+class RenderDevice {
+  public:
+	virtual ~RenderDevice() = default;
+
+	// コマンドの記録先
+	virtual RenderCommandList& GetCommandList() = 0;
+	// アップロード領域のページの生成先
+	virtual UploadPageBackend& GetUploadPageBackend() = 0;
+	// フレームの完了を知らせるフェンス
+	virtual FrameFence& GetFrameFence() = 0;
+};
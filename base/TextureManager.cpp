@@ -68,6 +68,21 @@ void TextureManager::SetGraphicsRootDescriptorTable(
 	  rootParamIndex, textures_[textureHandle].gpuDescHandleSRV);
 }
 
+void TextureManager::SetGraphicsRootDescriptorTable(
+  RenderCommandList& commandList, UINT rootParamIndex, uint32_t textureHandle,
+  bool setDescriptorHeap) {
+	assert(textureHandle < textures_.size());
+	if (setDescriptorHeap) {
+		SetDescriptorHeap(commandList);
+	}
+	commandList.SetGraphicsRootDescriptorTable(
+	  rootParamIndex, textures_[textureHandle].gpuDescHandleSRV.ptr);
+}
+
+void TextureManager::SetDescriptorHeap(RenderCommandList& commandList) {
+	commandList.SetDescriptorHeap(descriptorHeap_.Get());
+}
+
 uint32_t TextureManager::LoadInternal(const std::string& fileName) {
 
 	assert(indexNextDescriptorHeap_ < kNumDescriptors);
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include "RenderDevice.h"
 #include <array>
 #include <d3dx12.h>
 #include <string>
@@ -67,6 +68,23 @@ class TextureManager {
 	/// <param name="textureHandle">テクスチャハンドル</param>
 	void SetGraphicsRootDescriptorTable(
 	  ID3D12GraphicsCommandList* commandList, UINT rootParamIndex, uint32_t textureHandle);
+	/// <summary>
+	/// デスクリプタテーブルをセット
+	/// </summary>
+	/// <param name="commandList">描画コマンドの記録先</param>
+	/// <param name="rootParamIndex">ルートパラメータ番号</param>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	/// <param name="setDescriptorHeap">
+	/// デスクリプタヒープもセットするか（SetDescriptorHeap で先にセットしてあれば false にして省く）
+	/// </param>
+	void SetGraphicsRootDescriptorTable(
+	  RenderCommandList& commandList, UINT rootParamIndex, uint32_t textureHandle,
+	  bool setDescriptorHeap = true);
+	/// <summary>
+	/// デスクリプタヒープをセット（テクスチャを何度も切り替えるときは最初に1回だけ呼ぶ）
+	/// </summary>
+	/// <param name="commandList">描画コマンドの記録先</param>
+	void SetDescriptorHeap(RenderCommandList& commandList);
 
   private:
 	TextureManager() = default;
@@ -0,0 +1,109 @@
+﻿#include "UploadAllocator.h"
+#include <cassert>
+#include <new>
+
+namespace {
+
+// value を alignment の倍数に切り上げる
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+CpuUploadPageBackend::~CpuUploadPageBackend() {
+	// 破棄し忘れたページがある
+	assert(livePageCount_ == 0);
+}
+
+UploadPage CpuUploadPageBackend::CreatePage(uint64_t size) {
+	UploadPage page;
+	page.size = size;
+	page.cpuAddress = static_cast<uint8_t*>(::operator new(
+	  static_cast<size_t>(size), std::align_val_t(UploadAllocator::kConstantBufferAlignment)));
+	// 実際の GPU と同じく 64KB 単位で重ならないように振る
+	page.gpuAddress = nextGpuAddress_;
+	nextGpuAddress_ += AlignUp(size, 64 * 1024);
+	livePageCount_++;
+	createdPageCount_++;
+	return page;
+}
+
+void CpuUploadPageBackend::DestroyPage(const UploadPage& page) {
+	assert(livePageCount_ > 0);
+	::operator delete(page.cpuAddress, std::align_val_t(UploadAllocator::kConstantBufferAlignment));
+	livePageCount_--;
+}
+
+UploadAllocator::UploadAllocator(
+  UploadPageBackend* backend, uint32_t frameCount, uint64_t pageSize)
+    : backend_(backend), pageSize_(AlignUp(pageSize, kConstantBufferAlignment)), frames_(frameCount),
+      offset_(pageSize_) {
+	assert(backend_);
+	assert(frameCount > 0);
+}
+
+UploadAllocator::~UploadAllocator() {
+	for (Frame& frame : frames_) {
+		Recycle(frame);
+	}
+	for (const UploadPage& page : freePages_) {
+		backend_->DestroyPage(page);
+	}
+}
+
+void UploadAllocator::BeginFrame(uint32_t frameIndex) {
+	assert(frameIndex < frames_.size());
+	frameIndex_ = frameIndex;
+	Recycle(frames_[frameIndex_]);
+	offset_ = pageSize_;
+	frameUsedBytes_ = 0;
+}
+
+UploadAllocation UploadAllocator::Allocate(uint32_t size, uint32_t alignment) {
+	assert(size > 0);
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+	// ページの先頭は 256 バイト境界なので、それより細かい境界はページ内の位置だけで揃う
+	alignment = alignment < kConstantBufferAlignment ? kConstantBufferAlignment : alignment;
+	Frame& frame = frames_[frameIndex_];
+
+	uint64_t alignedSize = AlignUp(size, kConstantBufferAlignment);
+	if (alignedSize > pageSize_) {
+		// ページに収まらない要求は専用のページを作る
+		UploadPage page = backend_->CreatePage(alignedSize);
+		frame.largePages.push_back(page);
+		frameUsedBytes_ += alignedSize;
+		return {page.cpuAddress, page.gpuAddress, size};
+	}
+
+	uint64_t offset = AlignUp(offset_, alignment);
+	if (offset + alignedSize > pageSize_) {
+		NextPage();
+		offset = 0;
+	}
+	const UploadPage& page = frame.pages.back();
+	frameUsedBytes_ += offset + alignedSize - offset_;
+	offset_ = offset + alignedSize;
+	return {page.cpuAddress + offset, page.gpuAddress + offset, size};
+}
+
+void UploadAllocator::NextPage() {
+	Frame& frame = frames_[frameIndex_];
+	if (freePages_.empty()) {
+		frame.pages.push_back(backend_->CreatePage(pageSize_));
+		pageCount_++;
+	} else {
+		frame.pages.push_back(freePages_.back());
+		freePages_.pop_back();
+	}
+	offset_ = 0;
+}
+
+void UploadAllocator::Recycle(Frame& frame) {
+	freePages_.insert(freePages_.end(), frame.pages.begin(), frame.pages.end());
+	frame.pages.clear();
+	for (const UploadPage& page : frame.largePages) {
+		backend_->DestroyPage(page);
+	}
+	frame.largePages.clear();
+}
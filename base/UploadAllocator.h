@@ -0,0 +1,150 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/// <summary>
+/// アップロード用メモリの1ページ（CPU から書き込み、GPU から読む）
+/// </summary>
+struct UploadPage {
+	uint8_t* cpuAddress = nullptr; // 書き込み先
+	uint64_t gpuAddress = 0;       // GPU から見たアドレス
+	uint64_t size = 0;             // 大きさ（バイト）
+	void* handle = nullptr;        // バックエンド固有のデータ（リソースなど）
+};
+
+/// <summary>
+/// ページの生成と破棄を受け持つバックエンド
+/// </summary>
+class UploadPageBackend {
+  public:
+	virtual ~UploadPageBackend() = default;
+	/// <summary>
+	/// ページの生成（cpuAddress と gpuAddress は 256 バイト境界に揃っていること）
+	/// </summary>
+	virtual UploadPage CreatePage(uint64_t size) = 0;
+	/// <summary>
+	/// ページの破棄
+	/// </summary>
+	virtual void DestroyPage(const UploadPage& page) = 0;
+};
+
+/// <summary>
+/// CPU メモリのバックエンド（GPU なしで割り当て側の動作を確かめる用）
+/// GPU アドレスは実際のメモリとは無関係な、ページごとに重ならない値を振る
+/// </summary>
+class CpuUploadPageBackend : public UploadPageBackend {
+  public:
+	// 仮の GPU アドレスの先頭
+	static const uint64_t kGpuAddressBase = 0x10000;
+
+	~CpuUploadPageBackend() override;
+	UploadPage CreatePage(uint64_t size) override;
+	void DestroyPage(const UploadPage& page) override;
+
+	// 生成済みで未破棄のページの数
+	uint32_t GetLivePageCount() const { return livePageCount_; }
+	// これまでに生成したページの数
+	uint32_t GetCreatedPageCount() const { return createdPageCount_; }
+
+  private:
+	uint64_t nextGpuAddress_ = kGpuAddressBase;
+	uint32_t livePageCount_ = 0;
+	uint32_t createdPageCount_ = 0;
+};
+
+/// <summary>
+/// アップロード領域の切り出し
+/// </summary>
+struct UploadAllocation {
+	void* cpuAddress = nullptr;
+	uint64_t gpuAddress = 0;
+	uint32_t size = 0;
+
+	template<class T> T* As() const { return static_cast<T*>(cpuAddress); }
+};
+
+/// <summary>
+/// フレームごとの線形アップロードアロケータ
+/// 大きなページから定数バッファ用の 256 バイト境界に揃えた領域を切り出す。
+/// 切り出した領域はそのフレームの間だけ有効で、同じフレーム番号の BeginFrame で回収される
+/// （GPU がそのフレームを使い終わってから BeginFrame を呼ぶこと）。
+/// 回収したページは解放せずに次のフレームで使い回す
+/// 描画スレッドからのみ呼ぶ
+/// </summary>
+class UploadAllocator {
+  public: // 定数
+	// 定数バッファの配置境界
+	static const uint32_t kConstantBufferAlignment = 256;
+	// ページの大きさの既定値
+	static const uint64_t kDefaultPageSize = 1024 * 1024;
+
+  public: // メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="backend">ページの生成先（アロケータより長く生きること）</param>
+	/// <param name="frameCount">同時に使われうるフレームの数</param>
+	/// <param name="pageSize">ページの大きさ（これより大きい要求は専用のページを作る）</param>
+	UploadAllocator(
+	  UploadPageBackend* backend, uint32_t frameCount, uint64_t pageSize = kDefaultPageSize);
+	~UploadAllocator();
+	UploadAllocator(const UploadAllocator&) = delete;
+	UploadAllocator& operator=(const UploadAllocator&) = delete;
+
+	/// <summary>
+	/// フレームの開始（frameIndex の枠で前回切り出した領域をすべて回収する）
+	/// </summary>
+	void BeginFrame(uint32_t frameIndex);
+
+	/// <summary>
+	/// 領域の切り出し
+	/// </summary>
+	/// <param name="size">大きさ（バイト）</param>
+	/// <param name="alignment">配置境界（2の累乗）</param>
+	UploadAllocation Allocate(uint32_t size, uint32_t alignment = kConstantBufferAlignment);
+
+	/// <summary>
+	/// 定数バッファの切り出しと書き込み
+	/// </summary>
+	template<class T> UploadAllocation AllocateConstantBuffer(const T& data) {
+		UploadAllocation allocation = Allocate(static_cast<uint32_t>(sizeof(T)));
+		std::memcpy(allocation.cpuAddress, &data, sizeof(T));
+		return allocation;
+	}
+
+	uint32_t GetFrameCount() const { return static_cast<uint32_t>(frames_.size()); }
+	uint32_t GetFrameIndex() const { return frameIndex_; }
+	uint64_t GetPageSize() const { return pageSize_; }
+	// 現在のフレームで切り出した大きさの合計（配置境界の詰め物を含む）
+	uint64_t GetFrameUsedBytes() const { return frameUsedBytes_; }
+	// 保持しているページの数（使用中と回収済みの合計。専用のページを除く）
+	uint32_t GetPageCount() const { return pageCount_; }
+
+  private: // サブクラス
+	struct Frame {
+		// 使用中のページ（先頭から順に埋める）
+		std::vector<UploadPage> pages;
+		// 大きな要求のための専用のページ（回収時に破棄する）
+		std::vector<UploadPage> largePages;
+	};
+
+  private: // メンバ関数
+	// 次のページに移る
+	void NextPage();
+	// フレームの領域を回収する
+	void Recycle(Frame& frame);
+
+  private: // メンバ変数
+	UploadPageBackend* backend_;
+	uint64_t pageSize_;
+	std::vector<Frame> frames_;
+	// 回収済みのページ
+	std::vector<UploadPage> freePages_;
+	uint32_t frameIndex_ = 0;
+	// 現在のページ内の次の書き込み位置（ページがなければ pageSize_）
+	uint64_t offset_;
+	uint64_t frameUsedBytes_ = 0;
+	uint32_t pageCount_ = 0;
+};
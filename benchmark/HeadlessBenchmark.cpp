@@ -0,0 +1,426 @@
+// 描画なしで1フレームの CPU 側の処理を計測する
+//
+// NullRenderDevice を使い、ゲームループのうちリポジトリ内で持っている部分を全速で回す
+// ・TransformHierarchy の更新（JobSystem で並列）
+// ・境界球の視錐台カリング（CameraCache で JobSystem に分割）
+// ・RenderQueue のキー作成・ソート・発行（行列はアップロード領域へ書き込む）
+// ・EntityWorld に置いた大量の小物のインスタンス描画（DynamicBvh の視錐台の問い合わせで見えるものを集め、
+//   行列を1つの領域に詰めて1回で描く）
+// ・FrameScheduler によるフレームの切り替え
+// シミュレーションは FrameLoop の kUncapped で、1フレームに --steps ステップずつ全速で進める
+// Model / Sprite などライブラリ側のクラスは Direct3D 12 を直接呼ぶため含まない
+//
+// 使い方
+//   headless_benchmark [--frames 600] [--objects 20000] [--children 4] [--threads 0] [--steps 1]
+//                      [--props 10000]
+
+#include "CameraCache.h"
+#include "DynamicBvh.h"
+#include "EntityWorld.h"
+#include "FrameLoop.h"
+#include "FrameScheduler.h"
+#include "JobSystem.h"
+#include "MathUtility.h"
+#include "NullRenderDevice.h"
+#include "RenderQueue.h"
+#include "SceneComponents.h"
+#include "TransformHierarchy.h"
+#include "UploadAllocator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace MathUtility;
+
+namespace {
+
+// 実行時の設定
+struct Options {
+	uint32_t frames = 600;
+	uint32_t objects = 20000;
+	uint32_t children = 4;
+	uint32_t threads = 0;
+	uint32_t steps = 1;
+	uint32_t props = 10000;
+};
+
+// 同時に処理させるフレームの数
+// DirectXCommon::kFrameCount はライブラリ側の作りっぱなしのバッファのために今は 1 だが、
+// ここでは CPU が1フレーム先行する 2 の構成を測る（アップロードアロケータとフェンスの待ちを通す）
+const uint32_t kFrameCount = 2;
+// マテリアル・テクスチャの種類
+const uint32_t kMaterialCount = 16;
+const uint32_t kTextureCount = 8;
+// メッシュ1つあたりのインデックス数
+const uint32_t kIndexCount = 36;
+// パイプラインの種類（通常の描画は 0 と 1 を交互に使う）
+const uint32_t kPipelineCount = 2;
+const uint32_t kPipelineInstanced = kPipelineCount;
+// インスタンス描画の要素を表す payload
+const uint32_t kInstancedPayload = UINT32_MAX;
+// ルートパラメータ番号（Model::RoomParameter と同じ並び）
+enum RootParameter { kWorldTransform, kViewProjection, kMaterial, kTexture, kLight };
+
+const float kNearZ = 0.1f;
+const float kFarZ = 1000.0f;
+// 小物のローカル空間の境界（描画する立方体と同じ）
+const AABB kPropBounds = {{-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}};
+
+/// <summary>
+/// RenderQueue の要素を NullCommandList へ発行する
+/// </summary>
+class NullBackend {
+  public:
+	NullBackend(
+	  RenderCommandList& commandList, UploadAllocator& allocator, const TransformHierarchy& hierarchy,
+	  const std::vector<TransformHierarchy::NodeId>& nodes)
+	    : commandList_(commandList), allocator_(allocator), hierarchy_(hierarchy), nodes_(nodes) {}
+
+	// インスタンス描画する行列の配列と数
+	void SetInstances(const UploadAllocation& allocation, uint32_t instanceCount) {
+		instanceView_ = {allocation.gpuAddress, allocation.size, sizeof(Matrix4)};
+		instanceCount_ = instanceCount;
+	}
+
+	// 発行の前に1回だけ、全パイプラインで共通の状態を設定する（ModelRenderQueue と同じ）
+	void Begin(GpuAddress viewProjectionAddress) {
+		commandList_.SetGraphicsRootSignature(reinterpret_cast<void*>(uintptr_t(1)));
+		commandList_.SetPrimitiveTopology(RenderPrimitiveTopology::kTriangleList);
+		commandList_.SetDescriptorHeap(reinterpret_cast<void*>(uintptr_t(1)));
+		commandList_.SetGraphicsRootConstantBufferView(kViewProjection, viewProjectionAddress);
+		commandList_.SetVertexBuffer(0, {0x1000, kIndexCount * 32, 32});
+		commandList_.SetIndexBuffer({0x2000, kIndexCount * 2, RenderIndexFormat::kUInt16});
+	}
+
+	void SetPipeline(uint32_t pipeline) {
+		commandList_.SetPipelineState(reinterpret_cast<void*>(uintptr_t(pipeline) + 1));
+		if (pipeline == kPipelineInstanced) {
+			commandList_.SetVertexBuffer(1, instanceView_);
+		}
+	}
+	void SetMaterial(uint32_t material) {
+		commandList_.SetGraphicsRootConstantBufferView(kMaterial, 0x3000 + material * 256);
+	}
+	void SetTexture(uint32_t texture) {
+		commandList_.SetGraphicsRootDescriptorTable(kTexture, 0x4000 + texture * 32);
+	}
+	void Draw(uint32_t payload) {
+		if (payload == kInstancedPayload) {
+			commandList_.DrawIndexedInstanced(kIndexCount, instanceCount_, 0, 0, 0);
+			return;
+		}
+		UploadAllocation allocation =
+		  allocator_.AllocateConstantBuffer(hierarchy_.GetWorldMatrix(nodes_[payload]));
+		commandList_.SetGraphicsRootConstantBufferView(kWorldTransform, allocation.gpuAddress);
+		commandList_.DrawIndexedInstanced(kIndexCount, 1, 0, 0, 0);
+	}
+
+  private:
+	RenderCommandList& commandList_;
+	UploadAllocator& allocator_;
+	const TransformHierarchy& hierarchy_;
+	const std::vector<TransformHierarchy::NodeId>& nodes_;
+	RenderVertexBufferView instanceView_;
+	uint32_t instanceCount_ = 0;
+};
+
+/// <summary>
+/// 計測する場面（親ノードが回転し、子ノードがその周りを回る）
+/// </summary>
+class Scene {
+  public:
+	explicit Scene(const Options& options) {
+		uint32_t roots = (std::max)(1u, options.objects / (options.children + 1));
+		uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(roots))));
+		for (uint32_t i = 0; i < roots; i++) {
+			TransformHierarchy::NodeId root = hierarchy_.Create();
+			hierarchy_.SetTranslation(
+			  root, Vector3(
+			          (static_cast<float>(i % side) - side * 0.5f) * 4.0f, 0.0f,
+			          static_cast<float>(i / side) * 4.0f));
+			roots_.push_back(root);
+			nodes_.push_back(root);
+			for (uint32_t c = 0; c < options.children; c++) {
+				TransformHierarchy::NodeId child = hierarchy_.Create(root);
+				float angle = 6.2831853f * c / options.children;
+				hierarchy_.SetTranslation(
+				  child, Vector3(std::cos(angle) * 1.5f, 0.5f, std::sin(angle) * 1.5f));
+				hierarchy_.SetScale(child, Vector3(0.3f, 0.3f, 0.3f));
+				nodes_.push_back(child);
+			}
+		}
+		size_t count = nodes_.size();
+		x_.resize(count);
+		y_.resize(count);
+		z_.resize(count);
+		radius_.assign(count, 1.0f);
+		visible_.resize(count);
+
+		// 小物は動かないので、ワールド行列は生成時に1回だけ計算する
+		// 毎回同じ配置になるよう乱数の種は固定する
+		std::mt19937 engine(12345);
+		std::uniform_real_distribution<float> positionRange(-30.0f, 30.0f);
+		std::uniform_real_distribution<float> scaleRange(0.1f, 0.3f);
+		std::uniform_real_distribution<float> rotationRange(0.0f, 6.2831853f);
+		for (uint32_t i = 0; i < options.props; i++) {
+			TransformComponent transform;
+			float scale = scaleRange(engine);
+			transform.scale = {scale, scale, scale};
+			transform.rotation = {rotationRange(engine), rotationRange(engine), rotationRange(engine)};
+			transform.translation = {
+			  positionRange(engine), positionRange(engine) * 0.25f, positionRange(engine)};
+			props_.Create(transform, WorldMatrixComponent{});
+		}
+		props_.ForEach<TransformComponent, WorldMatrixComponent>(
+		  [](TransformComponent& transform, WorldMatrixComponent& world) {
+			  world.matWorld =
+			    Matrix4::MakeAffine(transform.scale, transform.rotation, transform.translation);
+		  });
+
+		// 小物の境界を BVH に登録する（動かないので最後に SAH で組み直す）
+		props_.ForEachChunk<WorldMatrixComponent>(
+		  [&](uint32_t chunkCount, const Entity* entities, const WorldMatrixComponent* worlds) {
+			  for (uint32_t i = 0; i < chunkCount; i++) {
+				  propBvh_.CreateProxy(
+				    AABBTransform(kPropBounds, worlds[i].matWorld),
+				    static_cast<uint32_t>(propEntities_.size()));
+				  propEntities_.push_back(entities[i]);
+			  }
+		  });
+		propBvh_.Rebuild();
+	}
+
+	/// <summary>
+	/// 1ステップ分の更新
+	/// </summary>
+	/// <param name="time">シミュレーション内の時刻（秒）</param>
+	void Step(float time, JobSystem& jobSystem) {
+		// 親だけ回す（子は部分木ごと更新される）
+		for (size_t i = 0; i < roots_.size(); i++) {
+			hierarchy_.SetRotation(roots_[i], Vector3(0.0f, time + i * 0.01f, 0.0f));
+		}
+		std::span<const TransformHierarchy::Range> ranges = hierarchy_.PrepareUpdate();
+		jobSystem.ParallelFor(
+		  0, static_cast<uint32_t>(ranges.size()), hierarchy_.GetRangeGrainSize(),
+		  [&](uint32_t begin, uint32_t end) {
+			  for (uint32_t i = begin; i < end; i++) {
+				  hierarchy_.UpdateRange(ranges[i]);
+			  }
+		  });
+		hierarchy_.FinishUpdate();
+	}
+
+	/// <summary>
+	/// 1フレーム分の描画の発行
+	/// </summary>
+	/// <param name="time">シミュレーション内の時刻（秒）</param>
+	void Render(
+	  float time, JobSystem& jobSystem, RenderQueue& queue, RenderCommandList& commandList,
+	  UploadAllocator& allocator) {
+		// 境界球を SoA に集める
+		uint32_t count = static_cast<uint32_t>(nodes_.size());
+		jobSystem.ParallelFor(0, count, 1024, [&](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; i++) {
+				const Matrix4& world = hierarchy_.GetWorldMatrix(nodes_[i]);
+				x_[i] = world.m[3][0];
+				y_[i] = world.m[3][1];
+				z_[i] = world.m[3][2];
+			}
+		});
+
+		// カメラは場面の上を前後に動く
+		Vector3 eye(0.0f, 20.0f, -30.0f + std::sin(time * 0.5f) * 20.0f);
+		Matrix4 view = Matrix4LookAtLH(eye, Vector3(0.0f, 0.0f, eye.z + 50.0f), Vector3(0, 1, 0));
+		Matrix4 projection = Matrix4Perspective(0.785398f, 16.0f / 9.0f, kNearZ, kFarZ);
+		cameraCache_.Update(view, projection);
+		uint32_t visibleCount =
+		  cameraCache_.CullSpheres({x_, y_, z_, radius_}, std::span<uint32_t>(visible_));
+
+		// 並べ替えて発行する
+		queue.Clear();
+		for (uint32_t v = 0; v < visibleCount; v++) {
+			uint32_t i = visible_[v];
+			float viewZ = x_[i] * view.m[0][2] + y_[i] * view.m[1][2] + z_[i] * view.m[2][2] +
+			              view.m[3][2];
+			queue.Push(
+			  RenderQueue::MakeKey(
+			    0, i % kPipelineCount, i % kMaterialCount, i % kTextureCount, (viewZ - kNearZ) / (kFarZ - kNearZ)),
+			  i);
+		}
+		NullBackend backend(commandList, allocator, hierarchy_, nodes_);
+		// 見えている小物を BVH で集める
+		visibleProps_.clear();
+		propBvh_.QueryFrustum(cameraCache_.GetFrustum(), [&](DynamicBvh::ProxyId proxy) {
+			visibleProps_.push_back(propEntities_[propBvh_.GetUserData(proxy)]);
+			return true;
+		});
+		if (!visibleProps_.empty()) {
+			// 小物の行列を1つの領域へ詰め、全体を1回のインスタンス描画にする
+			// 深度は最も手前の小物で代表する
+			uint32_t propCount = static_cast<uint32_t>(visibleProps_.size());
+			UploadAllocation allocation =
+			  allocator.Allocate(static_cast<uint32_t>(sizeof(Matrix4) * propCount));
+			Matrix4* instanceMap = allocation.As<Matrix4>();
+			float nearestViewZ = kFarZ;
+			for (Entity entity : visibleProps_) {
+				const Matrix4& world = props_.Get<WorldMatrixComponent>(entity)->matWorld;
+				*instanceMap++ = world;
+				float viewZ = world.m[3][0] * view.m[0][2] + world.m[3][1] * view.m[1][2] +
+				              world.m[3][2] * view.m[2][2] + view.m[3][2];
+				nearestViewZ = (std::min)(nearestViewZ, viewZ);
+			}
+			backend.SetInstances(allocation, propCount);
+			queue.Push(
+			  RenderQueue::MakeKey(
+			    0, kPipelineInstanced, 0, 0, (nearestViewZ - kNearZ) / (kFarZ - kNearZ)),
+			  kInstancedPayload);
+		}
+		queue.Sort();
+		backend.Begin(allocator.AllocateConstantBuffer(cameraCache_.GetViewProjection()).gpuAddress);
+		queue.Submit(backend);
+		visibleTotal_ += visibleCount;
+		visiblePropTotal_ += visibleProps_.size();
+	}
+
+	size_t GetNodeCount() const { return nodes_.size(); }
+	uint32_t GetPropCount() const { return props_.GetEntityCount(); }
+	uint64_t GetVisibleTotal() const { return visibleTotal_; }
+	uint64_t GetVisiblePropTotal() const { return visiblePropTotal_; }
+
+  private:
+	TransformHierarchy hierarchy_;
+	std::vector<TransformHierarchy::NodeId> roots_;
+	std::vector<TransformHierarchy::NodeId> nodes_;
+	std::vector<float> x_;
+	std::vector<float> y_;
+	std::vector<float> z_;
+	std::vector<float> radius_;
+	std::vector<uint32_t> visible_;
+	CameraCache cameraCache_;
+	uint64_t visibleTotal_ = 0;
+	// インスタンス描画する小物
+	EntityWorld props_;
+	// 小物の境界（userData は propEntities_ の番号）
+	DynamicBvh propBvh_;
+	std::vector<Entity> propEntities_;
+	std::vector<Entity> visibleProps_;
+	uint64_t visiblePropTotal_ = 0;
+};
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (i + 1 >= argc) {
+			return false;
+		}
+		uint32_t value = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		if (arg == "--frames") {
+			options.frames = value;
+		} else if (arg == "--objects") {
+			options.objects = value;
+		} else if (arg == "--children") {
+			options.children = value;
+		} else if (arg == "--threads") {
+			options.threads = value;
+		} else if (arg == "--steps") {
+			options.steps = value;
+		} else if (arg == "--props") {
+			options.props = value;
+		} else {
+			return false;
+		}
+	}
+	return options.frames > 0 && options.objects > 0 && options.steps > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		std::fprintf(
+		  stderr, "usage: %s [--frames n] [--objects n] [--children n] [--threads n] [--steps n] "
+		  "[--props n]\n",
+		  argv[0]);
+		return 2;
+	}
+
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	jobSystem->Initialize(options.threads);
+	uint32_t threadCount = jobSystem->GetThreadCount();
+
+	double totalMs = 0.0;
+	uint64_t visibleTotal = 0;
+	uint64_t visiblePropTotal = 0;
+	NullCommandList::Counts counts;
+	uint64_t waitCount = 0;
+	uint32_t pageCount = 0;
+	size_t nodeCount = 0;
+	uint32_t propCount = 0;
+	double simulatedSeconds = 0.0;
+	{
+		// アロケータとスケジューラはデバイスより先に破棄する
+		NullRenderDevice device;
+		UploadAllocator allocator(&device.GetUploadPageBackend(), kFrameCount);
+		FrameScheduler scheduler(&device.GetFrameFence(), kFrameCount);
+		RenderQueue queue;
+		Scene scene(options);
+		nodeCount = scene.GetNodeCount();
+		propCount = scene.GetPropCount();
+		FrameLoop frameLoop;
+		frameLoop.SetMode(FrameLoop::Mode::kUncapped, options.steps);
+
+		auto start = std::chrono::steady_clock::now();
+		for (uint32_t frame = 0; frame < options.frames; frame++) {
+			uint32_t stepCount = frameLoop.BeginFrame();
+			for (uint32_t i = 0; i < stepCount; i++) {
+				// GetSimulatedSeconds はこのフレームで進める分を含むので、各ステップの終わりの時刻に戻す
+				double time = frameLoop.GetSimulatedSeconds() -
+				              (stepCount - 1 - i) * frameLoop.GetStepSeconds();
+				scene.Step(static_cast<float>(time), *jobSystem);
+			}
+			scene.Render(
+			  static_cast<float>(frameLoop.GetSimulatedSeconds()), *jobSystem, queue,
+			  device.GetCommandList(), allocator);
+			scheduler.EndFrame();
+			// GPU は1フレーム遅れで追いつくものとする
+			device.GetFrameFence().Complete(device.GetFrameFence().GetSignaledValue() - 1);
+			allocator.BeginFrame(scheduler.BeginFrame());
+		}
+		scheduler.WaitIdle();
+		totalMs =
+		  std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		visibleTotal = scene.GetVisibleTotal();
+		visiblePropTotal = scene.GetVisiblePropTotal();
+		counts = device.GetCommandList().GetCounts();
+		waitCount = scheduler.GetWaitCount();
+		pageCount = allocator.GetPageCount();
+		simulatedSeconds = frameLoop.GetSimulatedSeconds();
+	}
+	jobSystem->Finalize();
+
+	double frames = options.frames;
+	std::printf("threads        %u\n", threadCount);
+	std::printf("nodes          %zu\n", nodeCount);
+	std::printf("props          %u\n", propCount);
+	std::printf("frames         %u\n", options.frames);
+	std::printf("ms/frame       %.3f\n", totalMs / frames);
+	std::printf("simulated      %.1f s\n", simulatedSeconds);
+	std::printf("visible/frame  %.1f\n", visibleTotal / frames);
+	std::printf("props/frame    %.1f\n", visiblePropTotal / frames);
+	std::printf("draws/frame    %.1f\n", counts.GetDrawCount() / frames);
+	std::printf("instances/frame %.1f\n", counts.instances / frames);
+	std::printf("state/frame    %.1f\n", counts.GetStateChangeCount() / frames);
+	std::printf("indices/frame  %.1f\n", counts.indices / frames);
+	std::printf("fence waits    %llu\n", static_cast<unsigned long long>(waitCount));
+	std::printf("upload pages   %u\n", pageCount);
+	return 0;
+}
@@ -0,0 +1,1611 @@
+// math/ のマイクロベンチマーク
+//
+// 各演算について次の2種類を計測し、JSON で出力する
+// ・throughput：独立した入力を batch 個並べて処理したときの1要素あたりの時間
+// ・latency   ：前の結果が次の入力に依存する連鎖で測った1回あたりの時間
+//               （結果の先頭成分を入力の全成分へ戻す整数演算 2〜3 命令分を含む）
+//
+// 使い方
+//   math_benchmark [--output file] [--baseline file] [--threshold 0.1]
+//                  [--filter text] [--batch 64,4096] [--min-time ms] [--quick]
+//   math_benchmark --verify
+// --verify は計測せず、SIMD カーネルの誤差が宣言した許容値に収まっているかだけを確かめ、
+// 収まっていなければ終了コード 1 を返す（ctest から実行する）
+// --baseline を指定すると同じ名前・種類・バッチ数の結果と比べ、
+// threshold を超えて遅くなった項目があれば終了コード 1 を返す
+
+#include "FastMath.h"
+#include "FrustumCulling.h"
+#include "MathSimd.h"
+#include "MathUtility.h"
+#include "Matrix4.h"
+#include "Matrix4Inverse.h"
+#include "Matrix4Multiply.h"
+#include "Quaternion.h"
+#include "Vector2.h"
+#include "Vector3.h"
+#include "Vector3Batch.h"
+#include "Vector3Stream.h"
+#include "Vector4.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace MathUtility;
+
+namespace {
+
+// 計測結果
+struct Result {
+	std::string name;   // 演算名
+	std::string metric; // "throughput" / "latency"
+	size_t batch;       // バッチ数（latency は 1）
+	double nsPerOp;     // 1要素あたりの時間（ナノ秒）
+};
+
+// 実行時の設定
+struct Options {
+	std::string outputPath;
+	std::string baselinePath;
+	std::string filter;
+	double threshold = 0.10;
+	double minSampleSeconds = 0.02;
+	int samples = 5;
+	std::vector<size_t> batches = {64, 4096, 262144};
+	size_t latencyIterations = 1 << 16;
+	bool verify = false;
+};
+
+#pragma region 最適化の抑止
+
+// 値を使ったことにして、計算が消されないようにする
+template<class T> inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile char sink;
+	sink = *reinterpret_cast<const volatile char*>(&value);
+#endif
+}
+
+// 実行時にしか分からない 0（依存関係を作るためのマスク）
+volatile uint32_t gOpaqueZero = 0;
+
+// 結果の先頭成分を取り出す
+inline float FirstFloat(float v) { return v; }
+inline float FirstFloat(const Vector2& v) { return v.x; }
+inline float FirstFloat(const Vector3& v) { return v.x; }
+inline float FirstFloat(const Vector4& v) { return v.x; }
+inline float FirstFloat(const Matrix4& v) { return v.m[0][0]; }
+inline float FirstFloat(const Quaternion& v) { return v.x; }
+
+// 値を変えずに、dst の全成分が src に依存するようにする
+template<class T> inline void Inject(T& dst, float src, uint32_t zeroMask) {
+	static_assert(sizeof(T) % sizeof(uint32_t) == 0);
+	uint32_t words[sizeof(T) / sizeof(uint32_t)];
+	uint32_t s;
+	std::memcpy(words, &dst, sizeof(T));
+	std::memcpy(&s, &src, sizeof(s));
+	s &= zeroMask;
+	for (uint32_t& w : words) {
+		w ^= s;
+	}
+	std::memcpy(&dst, words, sizeof(T));
+}
+
+#pragma endregion
+
+#pragma region 入力データ
+
+std::mt19937& Random() {
+	static std::mt19937 engine(12345);
+	return engine;
+}
+
+float RandomFloat(float min = -1.0f, float max = 1.0f) {
+	return std::uniform_real_distribution<float>(min, max)(Random());
+}
+
+template<class T> T MakeRandom();
+template<> float MakeRandom<float>() { return RandomFloat(0.1f, 2.0f); }
+template<> Vector2 MakeRandom<Vector2>() { return {RandomFloat(), RandomFloat()}; }
+template<> Vector3 MakeRandom<Vector3>() { return {RandomFloat(), RandomFloat(), RandomFloat()}; }
+template<> Vector4 MakeRandom<Vector4>() {
+	return {RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat()};
+}
+template<> Matrix4 MakeRandom<Matrix4>() {
+	// 逆行列が存在するようアフィン行列にする
+	return Matrix4::MakeAffine(
+	  {RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f)},
+	  MakeRandom<Vector3>(), MakeRandom<Vector3>());
+}
+template<> Quaternion MakeRandom<Quaternion>() {
+	return Quaternion::MakeFromEuler(MakeRandom<Vector3>());
+}
+
+template<class T> std::vector<T> MakeRandomArray(size_t count) {
+	std::vector<T> result(count);
+	for (auto& value : result) {
+		value = MakeRandom<T>();
+	}
+	return result;
+}
+
+#pragma endregion
+
+#pragma region 計測
+
+using Clock = std::chrono::steady_clock;
+
+/// <summary>
+/// pass を繰り返し実行し、1要素あたりの時間の中央値を求める
+/// </summary>
+/// <param name="options">設定</param>
+/// <param name="opsPerPass">pass 1回で処理する要素数</param>
+/// <param name="pass">計測する処理</param>
+/// <returns>1要素あたりの時間（ナノ秒）</returns>
+double Measure(const Options& options, size_t opsPerPass, const std::function<void()>& pass) {
+	// ウォームアップと、1サンプルの繰り返し回数の決定
+	pass();
+	size_t repeats = 1;
+	while (true) {
+		auto start = Clock::now();
+		for (size_t i = 0; i < repeats; i++) {
+			pass();
+		}
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		if (seconds >= options.minSampleSeconds || repeats >= (size_t(1) << 30)) {
+			break;
+		}
+		repeats *= 2;
+	}
+
+	std::vector<double> samples;
+	for (int s = 0; s < options.samples; s++) {
+		auto start = Clock::now();
+		for (size_t i = 0; i < repeats; i++) {
+			pass();
+		}
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		samples.push_back(seconds * 1e9 / (double(repeats) * double(opsPerPass)));
+	}
+	std::sort(samples.begin(), samples.end());
+	return samples[samples.size() / 2];
+}
+
+/// <summary>
+/// ベンチマークの登録と実行
+/// </summary>
+class Suite {
+  public:
+	explicit Suite(const Options& options) : options_(options) {}
+
+	const std::vector<Result>& GetResults() const { return results_; }
+
+	// 1要素ずつの演算 out[i] = op(a[i], b[i]) を登録する
+	template<class A, class B, class Op> void Binary(const char* name, Op op) {
+		if (!Enabled(name)) {
+			return;
+		}
+		using R = decltype(op(std::declval<const A&>(), std::declval<const B&>()));
+		// latency の連鎖は先頭 64 要素を使い回すので、それより少なくしない
+		size_t maxBatch = std::max<size_t>(
+		  *std::max_element(options_.batches.begin(), options_.batches.end()), 64);
+		std::vector<A> a = MakeRandomArray<A>(maxBatch);
+		std::vector<B> b = MakeRandomArray<B>(maxBatch);
+		std::vector<R> out(maxBatch);
+
+		for (size_t batch : options_.batches) {
+			double ns = Measure(options_, batch, [&] {
+				for (size_t i = 0; i < batch; i++) {
+					out[i] = op(a[i], b[i]);
+				}
+				DoNotOptimize(out[0]);
+			});
+			Add(name, "throughput", batch, ns);
+		}
+
+		// 次の入力の全成分を結果の先頭成分に依存させて連鎖させる
+		const size_t mask = 63;
+		const uint32_t zero = gOpaqueZero;
+		const size_t iterations = options_.latencyIterations;
+		double ns = Measure(options_, iterations, [&] {
+			A x = a[0];
+			for (size_t i = 0; i < iterations; i++) {
+				R r = op(x, b[i & mask]);
+				x = a[(i + 1) & mask];
+				Inject(x, FirstFloat(r), zero);
+			}
+			DoNotOptimize(x);
+		});
+		Add(name, "latency", 1, ns);
+	}
+
+	// 単項演算 out[i] = op(a[i]) を登録する
+	template<class A, class Op> void Unary(const char* name, Op op) {
+		Binary<A, float>(name, [op](const A& a, float) { return op(a); });
+	}
+
+	// 配列をまとめて処理する演算を登録する（setup(batch) が pass を返す）
+	void Batch(const char* name, const std::function<std::function<void()>(size_t)>& setup) {
+		if (!Enabled(name)) {
+			return;
+		}
+		for (size_t batch : options_.batches) {
+			std::function<void()> pass = setup(batch);
+			Add(name, "throughput", batch, Measure(options_, batch, pass));
+		}
+	}
+
+  private:
+	bool Enabled(const char* name) const {
+		return options_.filter.empty() || std::strstr(name, options_.filter.c_str()) != nullptr;
+	}
+
+	void Add(const char* name, const char* metric, size_t batch, double ns) {
+		results_.push_back({name, metric, batch, ns});
+		std::fprintf(stderr, "%-40s %-10s %8zu %10.3f ns\n", name, metric, batch, ns);
+	}
+
+	const Options& options_;
+	std::vector<Result> results_;
+};
+
+#pragma endregion
+
+#pragma region ベンチマーク項目
+
+void RegisterVector(Suite& suite) {
+	suite.Binary<Vector2, Vector2>("Vector2::operator+", [](const Vector2& a, const Vector2& b) { return a + b; });
+	suite.Binary<Vector2, Vector2>("Vector2::operator-", [](const Vector2& a, const Vector2& b) { return a - b; });
+	suite.Binary<Vector2, float>("Vector2::operator*", [](const Vector2& a, float s) { return a * s; });
+	suite.Binary<Vector2, float>("Vector2::operator/", [](const Vector2& a, float s) { return a / s; });
+	suite.Binary<Vector2, Vector2>("Vector2::Dot", [](const Vector2& a, const Vector2& b) { return a.Dot(b); });
+	suite.Binary<Vector2, Vector2>("Vector2::Cross", [](const Vector2& a, const Vector2& b) { return a.Cross(b); });
+	suite.Unary<Vector2>("Vector2::Magnitude", [](const Vector2& a) { return a.Magnitude(); });
+	suite.Unary<Vector2>("Vector2::Norm", [](const Vector2& a) { Vector2 v(a); return v.Norm(); });
+
+	suite.Binary<Vector3, Vector3>("Vector3::operator+", [](const Vector3& a, const Vector3& b) { return a + b; });
+	suite.Binary<Vector3, Vector3>("Vector3::operator-", [](const Vector3& a, const Vector3& b) { return a - b; });
+	suite.Binary<Vector3, float>("Vector3::operator*", [](const Vector3& a, float s) { return a * s; });
+	suite.Binary<Vector3, float>("Vector3::operator/", [](const Vector3& a, float s) { return a / s; });
+	suite.Unary<Vector3>("Vector3::operator-(unary)", [](const Vector3& a) { return -a; });
+	suite.Binary<Vector3, Vector3>("Vector3::Dot", [](const Vector3& a, const Vector3& b) { return a.Dot(b); });
+	suite.Binary<Vector3, Vector3>("Vector3::Cross", [](const Vector3& a, const Vector3& b) { return a.Cross(b); });
+	suite.Unary<Vector3>("Vector3::Magnitude", [](const Vector3& a) { return a.Magnitude(); });
+	suite.Unary<Vector3>("Vector3::Normalize", [](const Vector3& a) { Vector3 v(a); return v.Normalize(); });
+
+	suite.Binary<Vector4, float>("Vector4::Vector4", [](const Vector4& a, float s) {
+		return Vector4(a.x, a.y, a.z, s);
+	});
+}
+
+void RegisterMathUtility(Suite& suite) {
+	suite.Unary<Vector3>("MathUtility::Vector3Length", [](const Vector3& a) { return Vector3Length(a); });
+	suite.Unary<Vector3>("MathUtility::Vector3Normalize", [](const Vector3& a) { Vector3 v(a); return Vector3Normalize(v); });
+	suite.Binary<Vector3, Vector3>("MathUtility::Vector3Cross", [](const Vector3& a, const Vector3& b) { return Vector3Cross(a, b); });
+	suite.Binary<Vector3, Matrix4>("MathUtility::Vector3Transform", [](const Vector3& v, const Matrix4& m) { return Vector3Transform(v, m); });
+	suite.Binary<Vector3, Matrix4>("MathUtility::Vector3TransformCoord", [](const Vector3& v, const Matrix4& m) { return Vector3TransformCoord(v, m); });
+	suite.Binary<Vector3, Matrix4>("MathUtility::Vector3TransformNormal", [](const Vector3& v, const Matrix4& m) { return Vector3TransformNormal(v, m); });
+	suite.Unary<float>("MathUtility::Matrix4RotationX", [](float a) { return Matrix4RotationX(a); });
+	suite.Binary<Vector3, Vector3>("MathUtility::Matrix4LookAtLH", [](const Vector3& eye, const Vector3& target) {
+		return Matrix4LookAtLH(eye, target, {0.0f, 1.0f, 0.0f});
+	});
+	suite.Binary<float, float>("MathUtility::Matrix4Perspective", [](float fov, float aspect) {
+		return Matrix4Perspective(fov, aspect, 0.1f, 1000.0f);
+	});
+}
+
+void RegisterMatrix(Suite& suite) {
+	suite.Binary<Matrix4, Matrix4>("Matrix4::operator*", [](const Matrix4& a, const Matrix4& b) { return a * b; });
+	suite.Binary<Matrix4, Matrix4>("Matrix4::operator*=", [](const Matrix4& a, const Matrix4& b) { Matrix4 m(a); return m *= b; });
+	suite.Binary<Matrix4, Matrix4>("Matrix4MultiplyScalar", [](const Matrix4& a, const Matrix4& b) {
+		Matrix4 r;
+		Matrix4MultiplyScalar(a, b, r);
+		return r;
+	});
+#if MATH_SIMD_X86
+	suite.Binary<Matrix4, Matrix4>("Matrix4MultiplySSE2", [](const Matrix4& a, const Matrix4& b) {
+		Matrix4 r;
+		Matrix4MultiplySSE2(a, b, r);
+		return r;
+	});
+	if (GetSimdLevel() == SimdLevel::kAVX2) {
+		suite.Binary<Matrix4, Matrix4>("Matrix4MultiplyAVX2", [](const Matrix4& a, const Matrix4& b) {
+			Matrix4 r;
+			Matrix4MultiplyAVX2(a, b, r);
+			return r;
+		});
+	}
+#endif
+	suite.Unary<Matrix4>("MathUtility::Matrix4Transpose", [](const Matrix4& m) { return Matrix4Transpose(m); });
+	suite.Unary<Matrix4>("MathUtility::Matrix4Determinant", [](const Matrix4& m) { return Matrix4Determinant(m); });
+	suite.Unary<Matrix4>("MathUtility::Matrix4Inverse", [](const Matrix4& m) { return Matrix4Inverse(m); });
+	suite.Unary<Matrix4>("Matrix4InverseScalar", [](const Matrix4& m) { return Matrix4InverseScalar(m, nullptr); });
+#if MATH_SIMD_X86
+	suite.Unary<Matrix4>("Matrix4InverseSSE2", [](const Matrix4& m) { return Matrix4InverseSSE2(m, nullptr); });
+#endif
+	suite.Unary<Matrix4>("MathUtility::Matrix4InverseAffine", [](const Matrix4& m) { return Matrix4InverseAffine(m); });
+	suite.Unary<Matrix4>("MathUtility::Matrix4InverseRigid", [](const Matrix4& m) { return Matrix4InverseRigid(m); });
+
+	suite.Unary<Vector3>("Matrix4::Rotation", [](const Vector3& rot) {
+		Matrix4 m;
+		m.Identity();
+		m.Rotation(rot);
+		return m;
+	});
+	suite.Binary<Vector3, Vector3>("Matrix4::Identity+Scale+Rotation+Transform", [](const Vector3& s, const Vector3& r) {
+		Matrix4 matScale, matRot, matTrans;
+		matScale.Identity();
+		matScale.Scale(s);
+		matRot.Identity();
+		matRot.Rotation(r);
+		matTrans.Identity();
+		matTrans.Transform(s);
+		Matrix4 m;
+		m.Identity();
+		m *= matScale;
+		m *= matRot;
+		m *= matTrans;
+		return m;
+	});
+	suite.Binary<Vector3, Vector3>("Matrix4::MakeAffine(euler)", [](const Vector3& s, const Vector3& r) {
+		return Matrix4::MakeAffine(s, r, s);
+	});
+	suite.Binary<Vector3, Quaternion>("Matrix4::MakeAffine(quaternion)", [](const Vector3& s, const Quaternion& q) {
+		return Matrix4::MakeAffine(s, q, s);
+	});
+}
+
+void RegisterQuaternion(Suite& suite) {
+	suite.Binary<Quaternion, Quaternion>("Quaternion::operator*", [](const Quaternion& a, const Quaternion& b) { return a * b; });
+	suite.Binary<Quaternion, Quaternion>("Quaternion::Slerp", [](const Quaternion& a, const Quaternion& b) { return Quaternion::Slerp(a, b, 0.3f); });
+	suite.Binary<Quaternion, Quaternion>("Quaternion::Nlerp", [](const Quaternion& a, const Quaternion& b) { return Quaternion::Nlerp(a, b, 0.3f); });
+	suite.Unary<Quaternion>("Quaternion::ToMatrix", [](const Quaternion& q) { return q.ToMatrix(); });
+	suite.Unary<Vector3>("Quaternion::MakeFromEuler", [](const Vector3& r) { return Quaternion::MakeFromEuler(r); });
+	suite.Binary<Quaternion, Vector3>("Quaternion::RotateVector", [](const Quaternion& q, const Vector3& v) { return q.RotateVector(v); });
+}
+
+void RegisterFastMath(Suite& suite) {
+	const MathPrecision kPrecisions[] = {
+	  MathPrecision::kExact, MathPrecision::kFast, MathPrecision::kApprox};
+	const char* kSuffixes[] = {"(exact)", "(fast)", "(approx)"};
+
+	// 名前は登録の呼び出し中だけ使われるので一時文字列でよい
+	auto name = [](const char* base, const char* suffix) { return std::string(base) + suffix; };
+
+	for (int p = 0; p < 3; p++) {
+		const MathPrecision precision = kPrecisions[p];
+		const char* suffix = kSuffixes[p];
+		suite.Unary<float>(name("MathUtility::Rsqrt", suffix).c_str(), [precision](float x) { return Rsqrt(x, precision); });
+		suite.Unary<float>(name("MathUtility::SinCos", suffix).c_str(), [precision](float x) {
+			float s, c;
+			SinCos(x, s, c, precision);
+			return s + c;
+		});
+		suite.Binary<float, float>(name("MathUtility::Atan2", suffix).c_str(), [precision](float y, float x) { return Atan2(y, x, precision); });
+		suite.Unary<float>(name("MathUtility::Acos", suffix).c_str(), [precision](float x) { return Acos(x * 0.45f, precision); });
+		suite.Unary<Vector3>(name("MathUtility::Vector3Normalize", suffix).c_str(), [precision](const Vector3& a) {
+			Vector3 v(a);
+			return Vector3Normalize(v, precision);
+		});
+
+		suite.Batch(name("MathUtility::RsqrtArray", suffix).c_str(), [precision](size_t batch) {
+			auto in = std::make_shared<std::vector<float>>(MakeRandomArray<float>(batch));
+			auto out = std::make_shared<std::vector<float>>(batch);
+			return [=] { RsqrtArray(*in, *out, precision); DoNotOptimize((*out)[0]); };
+		});
+		suite.Batch(name("MathUtility::SinCosArray", suffix).c_str(), [precision](size_t batch) {
+			auto in = std::make_shared<std::vector<float>>(MakeRandomArray<float>(batch));
+			auto s = std::make_shared<std::vector<float>>(batch);
+			auto c = std::make_shared<std::vector<float>>(batch);
+			return [=] { SinCosArray(*in, *s, *c, precision); DoNotOptimize((*s)[0]); };
+		});
+		suite.Batch(name("MathUtility::Atan2Array", suffix).c_str(), [precision](size_t batch) {
+			auto y = std::make_shared<std::vector<float>>(MakeRandomArray<float>(batch));
+			auto x = std::make_shared<std::vector<float>>(MakeRandomArray<float>(batch));
+			auto out = std::make_shared<std::vector<float>>(batch);
+			return [=] { Atan2Array(*y, *x, *out, precision); DoNotOptimize((*out)[0]); };
+		});
+		suite.Batch(name("MathUtility::AcosArray", suffix).c_str(), [precision](size_t batch) {
+			auto in = std::make_shared<std::vector<float>>(batch);
+			for (float& v : *in) {
+				v = RandomFloat();
+			}
+			auto out = std::make_shared<std::vector<float>>(batch);
+			return [=] { AcosArray(*in, *out, precision); DoNotOptimize((*out)[0]); };
+		});
+	}
+}
+
+void RegisterBatch(Suite& suite) {
+	using TransformArrayFunc = void (*)(std::span<const Vector3>, std::span<Vector3>, const Matrix4&, StoreHint);
+	struct ArrayCase {
+		const char* name;
+		TransformArrayFunc func;
+	};
+	const ArrayCase kArrayCases[] = {
+	  {"MathUtility::Vector3TransformArray", Vector3TransformArray},
+	  {"MathUtility::Vector3TransformCoordArray", Vector3TransformCoordArray},
+	  {"MathUtility::Vector3TransformNormalArray", Vector3TransformNormalArray},
+	};
+	for (const ArrayCase& c : kArrayCases) {
+		TransformArrayFunc func = c.func;
+		suite.Batch(c.name, [func](size_t batch) {
+			auto src = std::make_shared<std::vector<Vector3>>(MakeRandomArray<Vector3>(batch));
+			auto dst = std::make_shared<std::vector<Vector3>>(batch);
+			Matrix4 m = MakeRandom<Matrix4>();
+			return [=] { func(*src, *dst, m, StoreHint::kCached); DoNotOptimize((*dst)[0]); };
+		});
+	}
+
+	suite.Batch("MathUtility::Vector3TransformSoA", [](size_t batch) {
+		auto src = std::make_shared<Vector3Stream>(MakeRandomArray<Vector3>(batch));
+		auto dst = std::make_shared<Vector3Stream>(batch);
+		Matrix4 m = MakeRandom<Matrix4>();
+		return [=] {
+			Vector3TransformSoA(std::as_const(*src).GetSpan(), dst->GetSpan(), m);
+			DoNotOptimize(dst->X()[0]);
+		};
+	});
+	suite.Batch("Matrix4::MakeAffine(array)", [](size_t batch) {
+		auto s = std::make_shared<std::vector<Vector3>>(MakeRandomArray<Vector3>(batch));
+		auto r = std::make_shared<std::vector<Vector3>>(MakeRandomArray<Vector3>(batch));
+		auto out = std::make_shared<std::vector<Matrix4>>(batch);
+		return [=] {
+			Matrix4::MakeAffine(s->data(), r->data(), s->data(), out->data(), batch);
+			DoNotOptimize((*out)[0]);
+		};
+	});
+
+	using StreamBinaryFunc = void (*)(const Vector3Stream&, const Vector3Stream&, Vector3Stream&);
+	struct StreamCase {
+		const char* name;
+		StreamBinaryFunc func;
+	};
+	const StreamCase kStreamCases[] = {
+	  {"Vector3Stream::Add", Vector3Stream::Add},
+	  {"Vector3Stream::Subtract", Vector3Stream::Subtract},
+	  {"Vector3Stream::Cross", Vector3Stream::Cross},
+	};
+	for (const StreamCase& c : kStreamCases) {
+		StreamBinaryFunc func = c.func;
+		suite.Batch(c.name, [func](size_t batch) {
+			auto a = std::make_shared<Vector3Stream>(MakeRandomArray<Vector3>(batch));
+			auto b = std::make_shared<Vector3Stream>(MakeRandomArray<Vector3>(batch));
+			auto out = std::make_shared<Vector3Stream>(batch);
+			return [=] { func(*a, *b, *out); DoNotOptimize(out->X()[0]); };
+		});
+	}
+	suite.Batch("Vector3Stream::MultiplyAdd", [](size_t batch) {
+		auto a = std::make_shared<Vector3Stream>(MakeRandomArray<Vector3>(batch));
+		auto b = std::make_shared<Vector3Stream>(MakeRandomArray<Vector3>(batch));
+		auto out = std::make_shared<Vector3Stream>(batch);
+		return [=] { Vector3Stream::MultiplyAdd(*a, *b, 0.016f, *out); DoNotOptimize(out->X()[0]); };
+	});
+	suite.Batch("Vector3Stream::Normalize", [](size_t batch) {
+		auto a = std::make_shared<Vector3Stream>(MakeRandomArray<Vector3>(batch));
+		auto out = std::make_shared<Vector3Stream>(batch);
+		return [=] { Vector3Stream::Normalize(*a, *out); DoNotOptimize(out->X()[0]); };
+	});
+	suite.Batch("Vector3Stream::Dot", [](size_t batch) {
+		auto a = std::make_shared<Vector3Stream>(MakeRandomArray<Vector3>(batch));
+		auto b = std::make_shared<Vector3Stream>(MakeRandomArray<Vector3>(batch));
+		auto out = std::make_shared<std::vector<float>>(batch);
+		return [=] { Vector3Stream::Dot(*a, *b, *out); DoNotOptimize((*out)[0]); };
+	});
+}
+
+// 原点から +z を向くカメラの視錐台（カリングの計測と検証で使う）
+Frustum MakeCullingFrustum() {
+	return FrustumFromMatrix(
+	  Matrix4LookAtLH({0, 0, 0}, {0, 0, 1}, {0, 1, 0}) *
+	  Matrix4Perspective(PI / 4, 16.0f / 9.0f, 0.1f, 1000.0f));
+}
+
+void RegisterCulling(Suite& suite) {
+	// 境界は [-500, 500] の立方体に散らす
+	const Frustum frustum = MakeCullingFrustum();
+	auto makeArray = [](size_t batch, float min, float max) {
+		auto values = std::make_shared<std::vector<float>>(batch);
+		for (float& v : *values) {
+			v = RandomFloat(min, max);
+		}
+		return values;
+	};
+
+	using SphereCullFunc =
+	  uint32_t (*)(const Frustum&, const SphereSoAConstSpan&, std::span<uint32_t>, uint32_t);
+	using AABBCullFunc =
+	  uint32_t (*)(const Frustum&, const AABBSoAConstSpan&, std::span<uint32_t>, uint32_t);
+	struct CullCase {
+		const char* sphereName;
+		SphereCullFunc sphere;
+		const char* aabbName;
+		AABBCullFunc aabb;
+		bool needsAVX2;
+	};
+	const CullCase kCases[] = {
+	  {"FrustumCullSpheresScalar", FrustumCullSpheresScalar, "FrustumCullAABBsScalar", FrustumCullAABBsScalar, false},
+	  {"FrustumCullSpheresSSE2", FrustumCullSpheresSSE2, "FrustumCullAABBsSSE2", FrustumCullAABBsSSE2, false},
+	  {"FrustumCullSpheresAVX2", FrustumCullSpheresAVX2, "FrustumCullAABBsAVX2", FrustumCullAABBsAVX2, true},
+	};
+	for (const CullCase& c : kCases) {
+		if (c.needsAVX2 && GetSimdLevel() != SimdLevel::kAVX2) {
+			continue;
+		}
+		SphereCullFunc sphere = c.sphere;
+		suite.Batch(c.sphereName, [=](size_t batch) {
+			auto x = makeArray(batch, -500, 500);
+			auto y = makeArray(batch, -500, 500);
+			auto z = makeArray(batch, -500, 500);
+			auto r = makeArray(batch, 0.1f, 20);
+			auto out = std::make_shared<std::vector<uint32_t>>(batch);
+			return [=] { DoNotOptimize(sphere(frustum, {*x, *y, *z, *r}, *out, 0)); };
+		});
+		AABBCullFunc aabb = c.aabb;
+		suite.Batch(c.aabbName, [=](size_t batch) {
+			auto cx = makeArray(batch, -500, 500);
+			auto cy = makeArray(batch, -500, 500);
+			auto cz = makeArray(batch, -500, 500);
+			auto e = makeArray(batch, 0.1f, 20);
+			auto out = std::make_shared<std::vector<uint32_t>>(batch);
+			return [=] { DoNotOptimize(aabb(frustum, {*cx, *cy, *cz, *e, *e, *e}, *out, 0)); };
+		});
+	}
+}
+
+#pragma endregion
+
+#pragma region JSON
+
+std::string EscapeJson(const std::string& text) {
+	std::string result;
+	for (char c : text) {
+		if (c == '"' || c == '\\') {
+			result += '\\';
+		}
+		result += c;
+	}
+	return result;
+}
+
+std::string ToJson(const std::vector<Result>& results) {
+	std::ostringstream out;
+	out << "{\n";
+	out << "  \"simd\": \"" << GetSimdLevelName(GetSimdLevel()) << "\",\n";
+	out << "  \"results\": [\n";
+	for (size_t i = 0; i < results.size(); i++) {
+		const Result& r = results[i];
+		char ns[64];
+		std::snprintf(ns, sizeof(ns), "%.4f", r.nsPerOp);
+		out << "    {\"name\": \"" << EscapeJson(r.name) << "\", \"metric\": \"" << r.metric
+		    << "\", \"batch\": " << r.batch << ", \"ns_per_op\": " << ns << "}"
+		    << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	out << "  ]\n}\n";
+	return out.str();
+}
+
+/// <summary>
+/// ToJson が出力した形式の JSON から結果を読み込む
+/// （"results" 配列内のオブジェクトだけを読む簡易パーサ）
+/// </summary>
+bool ParseJson(const std::string& text, std::vector<Result>& results) {
+	size_t pos = text.find("\"results\"");
+	if (pos == std::string::npos) {
+		return false;
+	}
+
+	// "key": 値 を1つ読む
+	auto readString = [&](size_t& p, std::string& value) {
+		p = text.find('"', p);
+		if (p == std::string::npos) {
+			return false;
+		}
+		value.clear();
+		for (p++; p < text.size() && text[p] != '"'; p++) {
+			if (text[p] == '\\' && p + 1 < text.size()) {
+				p++;
+			}
+			value += text[p];
+		}
+		p++;
+		return true;
+	};
+
+	while (true) {
+		size_t begin = text.find('{', pos);
+		if (begin == std::string::npos) {
+			break;
+		}
+		size_t end = text.find('}', begin);
+		if (end == std::string::npos) {
+			return false;
+		}
+
+		Result r{"", "", 0, 0.0};
+		size_t p = begin + 1;
+		while (p < end) {
+			std::string key;
+			if (!readString(p, key) || p > end) {
+				break;
+			}
+			p = text.find(':', p) + 1;
+			while (p < end && text[p] == ' ') {
+				p++;
+			}
+			if (text[p] == '"') {
+				std::string value;
+				readString(p, value);
+				if (key == "name") {
+					r.name = value;
+				} else if (key == "metric") {
+					r.metric = value;
+				}
+			} else {
+				double value = std::strtod(text.c_str() + p, nullptr);
+				if (key == "batch") {
+					r.batch = static_cast<size_t>(value);
+				} else if (key == "ns_per_op") {
+					r.nsPerOp = value;
+				}
+			}
+			p = text.find_first_of(",}", p);
+			if (p == std::string::npos || p >= end) {
+				break;
+			}
+			p++;
+		}
+		if (!r.name.empty()) {
+			results.push_back(r);
+		}
+		pos = end + 1;
+	}
+	return true;
+}
+
+#pragma endregion
+
+/// <summary>
+/// 基準値と比較し、threshold を超えて遅くなった項目の数を返す
+/// </summary>
+int Compare(
+  const std::vector<Result>& baseline, const std::vector<Result>& current, double threshold) {
+	std::map<std::string, double> base;
+	for (const Result& r : baseline) {
+		base[r.name + "|" + r.metric + "|" + std::to_string(r.batch)] = r.nsPerOp;
+	}
+
+	int regressions = 0;
+	for (const Result& r : current) {
+		auto it = base.find(r.name + "|" + r.metric + "|" + std::to_string(r.batch));
+		if (it == base.end() || it->second <= 0.0) {
+			continue;
+		}
+		double ratio = r.nsPerOp / it->second;
+		if (ratio > 1.0 + threshold) {
+			regressions++;
+			std::fprintf(
+			  stderr, "REGRESSION %-40s %-10s %8zu %10.3f -> %10.3f ns (+%.1f%%)\n", r.name.c_str(),
+			  r.metric.c_str(), r.batch, it->second, r.nsPerOp, (ratio - 1.0) * 100.0);
+		}
+	}
+	return regressions;
+}
+
+#pragma region 精度の検証
+
+// 許容値と比べて結果を表示する
+bool ReportError(const char* name, double error, double limit, const char* unit) {
+	bool passed = error <= limit;
+	std::fprintf(
+	  stderr, "%-4s %-40s %12.4g %s (limit %.4g)\n", passed ? "OK" : "FAIL", name, error, unit,
+	  limit);
+	return passed;
+}
+
+// 行列積の各カーネルとスカラー実装の差（Σ|a·b| の ULP 単位）
+bool VerifyMatrix4Multiply() {
+	// アフィン変換どうしに加え、成分が [-1, 1] の一般の行列（桁落ちする成分を多く含む）も使う
+	const int kCount = 200000;
+	std::vector<std::pair<Matrix4, Matrix4>> inputs;
+	inputs.reserve(kCount);
+	for (int n = 0; n < kCount; n++) {
+		if (n % 2 == 0) {
+			inputs.emplace_back(MakeRandom<Matrix4>(), MakeRandom<Matrix4>());
+			continue;
+		}
+		Matrix4 a;
+		Matrix4 b;
+		for (int i = 0; i < 4; i++) {
+			for (int j = 0; j < 4; j++) {
+				a.m[i][j] = RandomFloat();
+				b.m[i][j] = RandomFloat();
+			}
+		}
+		inputs.emplace_back(a, b);
+	}
+
+	using MultiplyFunc = void (*)(const Matrix4&, const Matrix4&, Matrix4&);
+	struct MultiplyCase {
+		const char* name;
+		MultiplyFunc func;
+		double limit;
+		bool needAVX2;
+	};
+	// SSE2 はスカラー実装と同じ順序で積和するので一致する
+	const MultiplyCase kCases[] = {
+	  {"Matrix4MultiplySSE2", Matrix4MultiplySSE2, 0.0, false},
+	  {"Matrix4MultiplyAVX2", Matrix4MultiplyAVX2, kMatrix4MultiplyMaxUlp, true},
+	};
+	bool passed = true;
+	for (const MultiplyCase& c : kCases) {
+		if (c.needAVX2 && GetSimdLevel() != SimdLevel::kAVX2) {
+			std::fprintf(stderr, "SKIP %s (AVX2 not available)\n", c.name);
+			continue;
+		}
+		double maxError = 0.0;
+		for (const auto& [a, b] : inputs) {
+			Matrix4 expected;
+			Matrix4 actual;
+			Matrix4MultiplyScalar(a, b, expected);
+			c.func(a, b, actual);
+			maxError = (std::max)(maxError, Matrix4MultiplyMaxUlpError(a, b, expected, actual));
+		}
+		passed &= ReportError(c.name, maxError, c.limit, "ULP");
+	}
+	return passed;
+}
+
+// M * inv(M) と単位行列の差の最大値（積は double で計算する）
+double InverseResidual(const Matrix4& m, const Matrix4& inverse) {
+	double maxError = 0.0;
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			double sum = 0.0;
+			for (int k = 0; k < 4; k++) {
+				sum += double(m.m[i][k]) * double(inverse.m[k][j]);
+			}
+			maxError = (std::max)(maxError, std::abs(sum - (i == j ? 1.0 : 0.0)));
+		}
+	}
+	return maxError;
+}
+
+// 2つの結果の差の最大値を、期待値の成分の絶対値の最大値で割ったもの
+double MaxRelativeDifference(const Matrix4& expected, const Matrix4& actual) {
+	double scale = 0.0;
+	double maxError = 0.0;
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			scale = (std::max)(scale, double(std::abs(expected.m[i][j])));
+			maxError =
+			  (std::max)(maxError, std::abs(double(expected.m[i][j]) - double(actual.m[i][j])));
+		}
+	}
+	return scale > 0.0 ? maxError / scale : maxError;
+}
+
+// 逆行列の各カーネルについて M * inv(M) ≒ I と SSE2 とスカラー実装の差、
+// および行列式が 0 のときに零行列と行列式 0 を返すことを確かめる
+bool VerifyMatrix4Inverse() {
+	// 一般の行列は成分 [-1, 1] に対角成分 ±2 を足して条件数を抑える
+	const int kCount = 100000;
+	std::vector<Matrix4> affine;
+	std::vector<Matrix4> rigid;
+	std::vector<Matrix4> general;
+	affine.reserve(kCount);
+	rigid.reserve(kCount);
+	general.reserve(kCount);
+	for (int n = 0; n < kCount; n++) {
+		affine.push_back(MakeRandom<Matrix4>());
+		rigid.push_back(
+		  Matrix4::MakeAffine({1.0f, 1.0f, 1.0f}, MakeRandom<Vector3>(), MakeRandom<Vector3>()));
+		Matrix4 m;
+		for (int i = 0; i < 4; i++) {
+			for (int j = 0; j < 4; j++) {
+				m.m[i][j] = RandomFloat();
+			}
+			m.m[i][i] += m.m[i][i] < 0.0f ? -2.0f : 2.0f;
+		}
+		general.push_back(m);
+	}
+
+	using InverseFunc = Matrix4 (*)(const Matrix4&);
+	struct ResidualCase {
+		const char* name;
+		InverseFunc func;
+		const std::vector<Matrix4>* inputs;
+	};
+	const ResidualCase kResidualCases[] = {
+	  {"Matrix4InverseScalar affine (M*inv-I)",
+	   [](const Matrix4& m) { return Matrix4InverseScalar(m, nullptr); }, &affine},
+	  {"Matrix4InverseScalar general (M*inv-I)",
+	   [](const Matrix4& m) { return Matrix4InverseScalar(m, nullptr); }, &general},
+	  {"Matrix4InverseSSE2 affine (M*inv-I)",
+	   [](const Matrix4& m) { return Matrix4InverseSSE2(m, nullptr); }, &affine},
+	  {"Matrix4InverseSSE2 general (M*inv-I)",
+	   [](const Matrix4& m) { return Matrix4InverseSSE2(m, nullptr); }, &general},
+	  {"Matrix4InverseAffine (M*inv-I)", Matrix4InverseAffine, &affine},
+	  {"Matrix4InverseRigid (M*inv-I)", Matrix4InverseRigid, &rigid},
+	};
+	bool passed = true;
+	for (const ResidualCase& c : kResidualCases) {
+		double maxError = 0.0;
+		for (const Matrix4& m : *c.inputs) {
+			maxError = (std::max)(maxError, InverseResidual(m, c.func(m)));
+		}
+		passed &= ReportError(c.name, maxError, kMatrix4InverseMaxResidual, "");
+	}
+
+	// SSE2 とスカラー実装の差
+	double maxInverseError = 0.0;
+	double maxDeterminantError = 0.0;
+	for (const std::vector<Matrix4>* inputs : {&affine, &general}) {
+		for (const Matrix4& m : *inputs) {
+			float expectedDet = 0.0f;
+			float actualDet = 0.0f;
+			Matrix4 expected = Matrix4InverseScalar(m, &expectedDet);
+			Matrix4 actual = Matrix4InverseSSE2(m, &actualDet);
+			maxInverseError = (std::max)(maxInverseError, MaxRelativeDifference(expected, actual));
+			maxDeterminantError = (std::max)(
+			  maxDeterminantError,
+			  std::abs(double(expectedDet) - double(actualDet)) / std::abs(double(expectedDet)));
+		}
+	}
+	passed &= ReportError(
+	  "Matrix4InverseSSE2 vs scalar (relative)", maxInverseError, kMatrix4InverseMaxDifference, "");
+	passed &= ReportError(
+	  "Matrix4InverseSSE2 det vs scalar (relative)", maxDeterminantError,
+	  kMatrix4InverseMaxDifference, "");
+
+	// 浮動小数点でも行列式がちょうど 0 になる行列
+	// （零行列、拡大率の1軸が 0 のアフィン行列、同じ2x2ブロック内で同じ行・2倍の行を含む行列）
+	std::vector<Matrix4> singular(1);
+	std::vector<Matrix4> singularAffine(1);
+	for (int n = 0; n < 1000; n++) {
+		Vector3 scale = {RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f)};
+		(n % 3 == 0 ? scale.x : n % 3 == 1 ? scale.y : scale.z) = 0.0f;
+		Matrix4 zeroScale = Matrix4::MakeAffine(scale, MakeRandom<Vector3>(), MakeRandom<Vector3>());
+		singular.push_back(zeroScale);
+		singularAffine.push_back(zeroScale);
+
+		Matrix4 m = general[n];
+		int from = n % 4;
+		int to = from ^ 1;
+		for (int j = 0; j < 4; j++) {
+			m.m[to][j] = n % 8 < 4 ? m.m[from][j] : m.m[from][j] * 2.0f;
+		}
+		singular.push_back(m);
+	}
+	auto isZero = [](const Matrix4& m) {
+		for (int i = 0; i < 4; i++) {
+			for (int j = 0; j < 4; j++) {
+				if (m.m[i][j] != 0.0f) {
+					return false;
+				}
+			}
+		}
+		return true;
+	};
+	int scalarFailures = 0;
+	int sse2Failures = 0;
+	int affineFailures = 0;
+	for (const Matrix4& m : singular) {
+		float det = 1.0f;
+		scalarFailures += !isZero(Matrix4InverseScalar(m, &det)) || det != 0.0f;
+		det = 1.0f;
+		sse2Failures += !isZero(Matrix4InverseSSE2(m, &det)) || det != 0.0f;
+	}
+	for (const Matrix4& m : singularAffine) {
+		affineFailures += !isZero(Matrix4InverseAffine(m));
+	}
+	passed &= ReportError("Matrix4InverseScalar singular", scalarFailures, 0, "failures");
+	passed &= ReportError("Matrix4InverseSSE2 singular", sse2Failures, 0, "failures");
+	passed &= ReportError("Matrix4InverseAffine singular", affineFailures, 0, "failures");
+	return passed;
+}
+
+// Vector3Batch の一括変換が1要素ずつの MathUtility の関数とビット単位で一致するか
+// AoS は書き込み先の先頭を 16 バイト境界から 0〜3 要素ずらし、kNonTemporal の前後の端数処理も通す
+bool VerifyVector3Batch() {
+	const size_t kCounts[] = {0, 1, 3, 4, 5, 7, 8, 13, 1001};
+	const Matrix4 kMatrices[] = {
+	  MakeRandom<Matrix4>(),
+	  // w除算で値が変わるよう、4列目も埋めた射影行列
+	  Matrix4LookAtLH({1, 2, -3}, {0, 0, 1}, {0, 1, 0}) *
+	    Matrix4Perspective(PI / 3, 4.0f / 3.0f, 0.1f, 100.0f),
+	};
+
+	using ArrayFunc = void (*)(std::span<const Vector3>, std::span<Vector3>, const Matrix4&, StoreHint);
+	using SoAFunc =
+	  void (*)(const Vector3SoAConstSpan&, const Vector3SoASpan&, const Matrix4&, StoreHint);
+	using SingleFunc = Vector3 (*)(const Vector3&, const Matrix4&);
+	struct BatchCase {
+		const char* name;
+		ArrayFunc array;
+		SoAFunc soa;
+		SingleFunc single;
+	};
+	const BatchCase kCases[] = {
+	  {"Vector3Transform", Vector3TransformArray, Vector3TransformSoA, Vector3Transform},
+	  {"Vector3TransformCoord", Vector3TransformCoordArray, Vector3TransformCoordSoA, Vector3TransformCoord},
+	  {"Vector3TransformNormal", Vector3TransformNormalArray, Vector3TransformNormalSoA, Vector3TransformNormal},
+	};
+	auto sameBits = [](const Vector3& a, const Vector3& b) {
+		return std::memcmp(&a, &b, sizeof(Vector3)) == 0;
+	};
+	auto sameBitsFloat = [](float a, float b) { return std::memcmp(&a, &b, sizeof(float)) == 0; };
+
+	bool passed = true;
+	for (const BatchCase& c : kCases) {
+		int arrayFailures = 0;
+		int soaFailures = 0;
+		for (const Matrix4& m : kMatrices) {
+			for (size_t count : kCounts) {
+				std::vector<Vector3> src = MakeRandomArray<Vector3>(count);
+				std::vector<Vector3> expected(count);
+				for (size_t i = 0; i < count; i++) {
+					expected[i] = c.single(src[i], m);
+				}
+
+				// AoS：書き込み先の 16 バイト境界からのずれ × 書き込み方法、および src と dst が同じ配列
+				std::vector<Vector3> buffer(count + 8);
+				size_t aligned = 0;
+				while (reinterpret_cast<uintptr_t>(buffer.data() + aligned) % 16 != 0) {
+					aligned++;
+				}
+				for (size_t shift = 0; shift < 4; shift++) {
+					for (StoreHint hint : {StoreHint::kCached, StoreHint::kNonTemporal}) {
+						std::span<Vector3> dst(buffer.data() + aligned + shift, count);
+						c.array(src, dst, m, hint);
+						arrayFailures += !std::equal(
+						  expected.begin(), expected.end(), dst.begin(), sameBits);
+
+						std::copy(src.begin(), src.end(), dst.begin());
+						c.array(dst, dst, m, hint);
+						arrayFailures += !std::equal(
+						  expected.begin(), expected.end(), dst.begin(), sameBits);
+					}
+				}
+
+				// SoA：出力が 16 バイト境界に揃っている場合（kNonTemporal が有効）とずれている場合
+				std::vector<float> x(count), y(count), z(count);
+				for (size_t i = 0; i < count; i++) {
+					x[i] = src[i].x;
+					y[i] = src[i].y;
+					z[i] = src[i].z;
+				}
+				const size_t stride = (count + 4 + 3) / 4 * 4;
+				std::vector<float> out(stride * 3 + 4);
+				size_t outAligned = 0;
+				while (reinterpret_cast<uintptr_t>(out.data() + outAligned) % 16 != 0) {
+					outAligned++;
+				}
+				for (size_t shift : {size_t(0), size_t(1)}) {
+					for (StoreHint hint : {StoreHint::kCached, StoreHint::kNonTemporal}) {
+						float* base = out.data() + outAligned + shift;
+						Vector3SoASpan dst = {
+						  {base, count}, {base + stride, count}, {base + stride * 2, count}};
+						c.soa({x, y, z}, dst, m, hint);
+						for (size_t i = 0; i < count; i++) {
+							soaFailures += !sameBitsFloat(expected[i].x, dst.x[i]) ||
+							               !sameBitsFloat(expected[i].y, dst.y[i]) ||
+							               !sameBitsFloat(expected[i].z, dst.z[i]);
+						}
+					}
+				}
+			}
+		}
+		std::string arrayName = std::string(c.name) + "Array vs single";
+		std::string soaName = std::string(c.name) + "SoA vs single";
+		passed &= ReportError(arrayName.c_str(), arrayFailures, 0, "failures");
+		passed &= ReportError(soaName.c_str(), soaFailures, 0, "failures");
+	}
+	return passed;
+}
+
+// Vector3Stream の一括演算が1要素ずつの Vector3・MathUtility の関数とビット単位で一致するか
+// 4要素ずつの処理と端数の処理、長さ0の要素、out が入力と同じストリームの場合も通す
+bool VerifyVector3Stream() {
+	const size_t kCounts[] = {0, 1, 3, 4, 5, 7, 8, 13, 1001};
+
+	using StreamFunc = void (*)(const Vector3Stream&, const Vector3Stream&, Vector3Stream&);
+	using SingleFunc = Vector3 (*)(const Vector3&, const Vector3&);
+	struct StreamCase {
+		const char* name;
+		StreamFunc stream;
+		SingleFunc single;
+	};
+	const StreamCase kCases[] = {
+	  {"Vector3Stream::Add", Vector3Stream::Add,
+	   [](const Vector3& a, const Vector3& b) -> Vector3 { return a + b; }},
+	  {"Vector3Stream::Subtract", Vector3Stream::Subtract,
+	   [](const Vector3& a, const Vector3& b) -> Vector3 { return a - b; }},
+	  {"Vector3Stream::Scale",
+	   [](const Vector3Stream& a, const Vector3Stream&, Vector3Stream& out) {
+		   Vector3Stream::Scale(a, 0.3f, out);
+	   },
+	   [](const Vector3& a, const Vector3&) -> Vector3 { return a * 0.3f; }},
+	  {"Vector3Stream::MultiplyAdd",
+	   [](const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& out) {
+		   Vector3Stream::MultiplyAdd(a, b, 0.3f, out);
+	   },
+	   [](const Vector3& a, const Vector3& b) -> Vector3 { return a + b * 0.3f; }},
+	  {"Vector3Stream::Lerp",
+	   [](const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& out) {
+		   Vector3Stream::Lerp(a, b, 0.3f, out);
+	   },
+	   [](const Vector3& a, const Vector3& b) { return Vector3Lerp(a, b, 0.3f); }},
+	  {"Vector3Stream::Cross", Vector3Stream::Cross,
+	   [](const Vector3& a, const Vector3& b) { return Vector3Cross(a, b); }},
+	  {"Vector3Stream::Normalize",
+	   [](const Vector3Stream& a, const Vector3Stream&, Vector3Stream& out) {
+		   Vector3Stream::Normalize(a, out);
+	   },
+	   [](const Vector3& a, const Vector3&) {
+		   Vector3 v(a);
+		   return Vector3Normalize(v);
+	   }},
+	};
+
+	using FloatStreamFunc = void (*)(const Vector3Stream&, const Vector3Stream&, std::span<float>);
+	using FloatSingleFunc = float (*)(const Vector3&, const Vector3&);
+	struct FloatCase {
+		const char* name;
+		FloatStreamFunc stream;
+		FloatSingleFunc single;
+	};
+	const FloatCase kFloatCases[] = {
+	  {"Vector3Stream::Dot", Vector3Stream::Dot,
+	   [](const Vector3& a, const Vector3& b) { return Vector3Dot(a, b); }},
+	  {"Vector3Stream::Length",
+	   [](const Vector3Stream& a, const Vector3Stream&, std::span<float> out) {
+		   Vector3Stream::Length(a, out);
+	   },
+	   [](const Vector3& a, const Vector3&) { return Vector3Length(a); }},
+	};
+
+	auto sameBits = [](const Vector3& a, const Vector3& b) {
+		return std::memcmp(&a, &b, sizeof(Vector3)) == 0;
+	};
+	auto sameBitsFloat = [](float a, float b) { return std::memcmp(&a, &b, sizeof(float)) == 0; };
+
+	// 入力（5つに1つは零ベクトル）
+	std::vector<std::vector<Vector3>> inputsA;
+	std::vector<std::vector<Vector3>> inputsB;
+	for (size_t count : kCounts) {
+		inputsA.push_back(MakeRandomArray<Vector3>(count));
+		inputsB.push_back(MakeRandomArray<Vector3>(count));
+		for (size_t i = 0; i < count; i += 5) {
+			inputsA.back()[i] = {0.0f, 0.0f, 0.0f};
+		}
+	}
+
+	bool passed = true;
+	for (const StreamCase& c : kCases) {
+		int failures = 0;
+		for (size_t n = 0; n < inputsA.size(); n++) {
+			const std::vector<Vector3>& a = inputsA[n];
+			const std::vector<Vector3>& b = inputsB[n];
+			std::vector<Vector3> expected(a.size());
+			for (size_t i = 0; i < a.size(); i++) {
+				expected[i] = c.single(a[i], b[i]);
+			}
+			const Vector3Stream streamA(a);
+			const Vector3Stream streamB(b);
+			Vector3Stream out;
+			c.stream(streamA, streamB, out);
+			std::vector<Vector3> actual = out.ToVector();
+			failures += actual.size() != expected.size() ||
+			            !std::equal(expected.begin(), expected.end(), actual.begin(), sameBits);
+
+			// out が入力と同じストリーム
+			Vector3Stream inPlace(a);
+			c.stream(inPlace, streamB, inPlace);
+			actual = inPlace.ToVector();
+			failures += !std::equal(expected.begin(), expected.end(), actual.begin(), sameBits);
+		}
+		std::string name = std::string(c.name) + " vs single";
+		passed &= ReportError(name.c_str(), failures, 0, "failures");
+	}
+	for (const FloatCase& c : kFloatCases) {
+		int failures = 0;
+		for (size_t n = 0; n < inputsA.size(); n++) {
+			const std::vector<Vector3>& a = inputsA[n];
+			const std::vector<Vector3>& b = inputsB[n];
+			std::vector<float> actual(a.size());
+			c.stream(Vector3Stream(a), Vector3Stream(b), actual);
+			for (size_t i = 0; i < a.size(); i++) {
+				failures += !sameBitsFloat(c.single(a[i], b[i]), actual[i]);
+			}
+		}
+		std::string name = std::string(c.name) + " vs single";
+		passed &= ReportError(name.c_str(), failures, 0, "failures");
+	}
+	return passed;
+}
+
+// 成分ごとの差の絶対値の最大値
+double MaxAbsDifference(const Matrix4& expected, const Matrix4& actual) {
+	double maxError = 0.0;
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			maxError =
+			  (std::max)(maxError, std::abs(double(expected.m[i][j]) - double(actual.m[i][j])));
+		}
+	}
+	return maxError;
+}
+
+// Identity→Scale→Rotation→Transform で作った行列を掛けた、MakeAffine の元の計算
+Matrix4 MakeAffineReference(const Vector3& scale, const Vector3& rotation, const Vector3& translation) {
+	Matrix4 matScale;
+	matScale.Identity();
+	matScale.Scale(scale);
+	Matrix4 matRotation;
+	matRotation.Identity();
+	matRotation.Rotation(rotation);
+	Matrix4 matTransform;
+	matTransform.Identity();
+	matTransform.Transform(translation);
+	return matScale * matRotation * matTransform;
+}
+
+// MakeAffine が Scale * Rotation * Transform と一致するか
+// 拡大率 0.5〜2、回転 ±2π、平行移動 ±100 で、差は成分の絶対値で 1e-6 以内とする
+// （同じ SinCos の値を使い、掛ける順序が違うだけなので数 ULP。実測の最大は 1.2e-7）
+bool VerifyMakeAffine() {
+	const double kMaxError = 1e-6;
+	const int kCount = 100000;
+	double maxError = 0.0;
+	for (int n = 0; n < kCount; n++) {
+		Vector3 scale = {RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f)};
+		Vector3 rotation = {
+		  RandomFloat(-2 * PI, 2 * PI), RandomFloat(-2 * PI, 2 * PI), RandomFloat(-2 * PI, 2 * PI)};
+		Vector3 translation = {
+		  RandomFloat(-100, 100), RandomFloat(-100, 100), RandomFloat(-100, 100)};
+		maxError = (std::max)(
+		  maxError, MaxAbsDifference(
+		              MakeAffineReference(scale, rotation, translation),
+		              Matrix4::MakeAffine(scale, rotation, translation)));
+	}
+	return ReportError("MakeAffine vs Scale*Rotation*Transform", maxError, kMaxError, "");
+}
+
+// 角度の差（2π の周期を除いたもの）
+double AngleDifference(double a, double b) {
+	double d = std::fmod(std::abs(a - b), 2.0 * 3.14159265358979323846);
+	return (std::min)(d, 2.0 * 3.14159265358979323846 - d);
+}
+
+// q と -q は同じ回転なので、符号をそろえて成分の差の最大値を求める
+double QuaternionDifference(const Quaternion& q, const double (&expected)[4]) {
+	const double actual[4] = {q.x, q.y, q.z, q.w};
+	double same = 0.0;
+	double opposite = 0.0;
+	for (int i = 0; i < 4; i++) {
+		same = (std::max)(same, std::abs(actual[i] - expected[i]));
+		opposite = (std::max)(opposite, std::abs(actual[i] + expected[i]));
+	}
+	return (std::min)(same, opposite);
+}
+
+// Quaternion の変換と補間
+// ・MakeFromEuler(e).ToMatrix() と Matrix4::Rotation(e) の差（成分の絶対値で 2e-6 以内。実測 6.6e-7）
+// ・クォータニオン版の MakeAffine と Scale * Rotation * Transform の差
+//   （拡大率 0.5〜2 を掛けるので 4e-6 以内。実測 1.2e-6）
+// ・ToEuler の往復（y が ±(π/2 - 0.1) の範囲、つまりジンバルロックから離れた所で 2e-5 rad 以内。実測 2.7e-6）
+// ・Slerp と double で計算した球面線形補間の差（両端と Nlerp で代用する近い向きを含み、2e-6 以内。実測 3.6e-7）
+bool VerifyQuaternion() {
+	const double kMatrixMaxError = 2e-6;
+	const double kAffineMaxError = 4e-6;
+	const double kEulerMaxError = 2e-5;
+	const double kSlerpMaxError = 2e-6;
+	const int kCount = 100000;
+
+	double matrixError = 0.0;
+	double affineError = 0.0;
+	double eulerError = 0.0;
+	for (int n = 0; n < kCount; n++) {
+		Vector3 euler = {
+		  RandomFloat(-PI, PI), RandomFloat(-(PI / 2 - 0.1f), PI / 2 - 0.1f), RandomFloat(-PI, PI)};
+		Quaternion q = Quaternion::MakeFromEuler(euler);
+
+		Matrix4 rotation;
+		rotation.Identity();
+		rotation.Rotation(euler);
+		matrixError = (std::max)(matrixError, MaxAbsDifference(rotation, q.ToMatrix()));
+
+		Vector3 scale = {RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f)};
+		Vector3 translation = {
+		  RandomFloat(-100, 100), RandomFloat(-100, 100), RandomFloat(-100, 100)};
+		affineError = (std::max)(
+		  affineError, MaxAbsDifference(
+		                 MakeAffineReference(scale, euler, translation),
+		                 Matrix4::MakeAffine(scale, q, translation)));
+
+		Vector3 roundTrip = q.ToEuler();
+		eulerError = (std::max)(
+		  {eulerError, AngleDifference(euler.x, roundTrip.x), AngleDifference(euler.y, roundTrip.y),
+		   AngleDifference(euler.z, roundTrip.z)});
+	}
+
+	double slerpError = 0.0;
+	for (int n = 0; n < kCount; n++) {
+		Quaternion q1 = MakeRandom<Quaternion>();
+		// 一部は Nlerp で代用するほど近い向きにする
+		Quaternion q2 = n % 4 == 0 ? q1 * Quaternion::MakeFromEuler({RandomFloat(-0.02f, 0.02f), 0, 0})
+		                           : MakeRandom<Quaternion>();
+		float t = n % 16 == 0 ? 0.0f : n % 16 == 1 ? 1.0f : RandomFloat(0.0f, 1.0f);
+
+		// 最短経路の球面線形補間を double で計算する
+		double a[4] = {q1.x, q1.y, q1.z, q1.w};
+		double b[4] = {q2.x, q2.y, q2.z, q2.w};
+		double cos = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+		double sign = cos < 0.0 ? -1.0 : 1.0;
+		double theta = std::acos((std::min)(std::abs(cos), 1.0));
+		double scale1 = theta > 1e-12 ? std::sin((1.0 - t) * theta) / std::sin(theta) : 1.0 - t;
+		double scale2 = theta > 1e-12 ? std::sin(t * theta) / std::sin(theta) : t;
+		double expected[4];
+		for (int i = 0; i < 4; i++) {
+			expected[i] = a[i] * scale1 + b[i] * sign * scale2;
+		}
+		slerpError =
+		  (std::max)(slerpError, QuaternionDifference(Quaternion::Slerp(q1, q2, t), expected));
+	}
+
+	bool passed = true;
+	passed &= ReportError("MakeFromEuler.ToMatrix vs Rotation", matrixError, kMatrixMaxError, "");
+	passed &= ReportError(
+	  "MakeAffine(Quaternion) vs Scale*Rotation*Transform", affineError, kAffineMaxError, "");
+	passed &= ReportError("ToEuler round trip (rad)", eulerError, kEulerMaxError, "");
+	passed &= ReportError("Slerp vs double", slerpError, kSlerpMaxError, "");
+	return passed;
+}
+
+// 視錐台カリングの SSE2 / AVX2 カーネルがスカラー実装と同じ番号を同じ順に返すか
+// 4 や 8 の倍数でない要素数（端数の処理）と indexOffset も確かめる
+bool VerifyFrustumCulling() {
+	const Frustum frustum = MakeCullingFrustum();
+	const uint32_t kCounts[] = {0, 1, 3, 4, 5, 7, 8, 9, 12, 15, 16, 17, 31, 33, 1000, 4099};
+	const uint32_t kIndexOffset = 100;
+
+	using SphereCullFunc =
+	  uint32_t (*)(const Frustum&, const SphereSoAConstSpan&, std::span<uint32_t>, uint32_t);
+	using AABBCullFunc =
+	  uint32_t (*)(const Frustum&, const AABBSoAConstSpan&, std::span<uint32_t>, uint32_t);
+	struct CullCase {
+		const char* sphereName;
+		SphereCullFunc sphere;
+		const char* aabbName;
+		AABBCullFunc aabb;
+		bool needsAVX2;
+	};
+	const CullCase kCases[] = {
+	  {"FrustumCullSpheresSSE2 vs scalar", FrustumCullSpheresSSE2, "FrustumCullAABBsSSE2 vs scalar", FrustumCullAABBsSSE2, false},
+	  {"FrustumCullSpheresAVX2 vs scalar", FrustumCullSpheresAVX2, "FrustumCullAABBsAVX2 vs scalar", FrustumCullAABBsAVX2, true},
+	};
+
+	bool passed = true;
+	for (const CullCase& c : kCases) {
+		if (c.needsAVX2 && GetSimdLevel() != SimdLevel::kAVX2) {
+			std::fprintf(stderr, "SKIP %s (AVX2 not available)\n", c.sphereName);
+			std::fprintf(stderr, "SKIP %s (AVX2 not available)\n", c.aabbName);
+			continue;
+		}
+		int sphereFailures = 0;
+		int aabbFailures = 0;
+		for (uint32_t count : kCounts) {
+			// 半分ほどが視錐台に入り、境界をまたぐものも多く含む
+			auto makeArray = [count](float min, float max) {
+				std::vector<float> values(count);
+				for (float& v : values) {
+					v = RandomFloat(min, max);
+				}
+				return values;
+			};
+			std::vector<float> x = makeArray(-500, 500);
+			std::vector<float> y = makeArray(-500, 500);
+			std::vector<float> z = makeArray(-100, 1100);
+			std::vector<float> r = makeArray(0.1f, 50);
+			std::vector<float> ex = makeArray(0.1f, 50);
+			std::vector<float> ey = makeArray(0.1f, 50);
+			std::vector<float> ez = makeArray(0.1f, 50);
+
+			// 書き込み先は未使用の領域が分かるよう埋めておく
+			std::vector<uint32_t> expected(count, UINT32_MAX);
+			std::vector<uint32_t> actual(count, UINT32_MAX);
+			uint32_t expectedVisible =
+			  FrustumCullSpheresScalar(frustum, {x, y, z, r}, expected, kIndexOffset);
+			uint32_t actualVisible = c.sphere(frustum, {x, y, z, r}, actual, kIndexOffset);
+			sphereFailures += actualVisible != expectedVisible ||
+			                  !std::equal(
+			                    expected.begin(), expected.begin() + expectedVisible, actual.begin());
+
+			std::fill(expected.begin(), expected.end(), UINT32_MAX);
+			std::fill(actual.begin(), actual.end(), UINT32_MAX);
+			expectedVisible =
+			  FrustumCullAABBsScalar(frustum, {x, y, z, ex, ey, ez}, expected, kIndexOffset);
+			actualVisible = c.aabb(frustum, {x, y, z, ex, ey, ez}, actual, kIndexOffset);
+			aabbFailures += actualVisible != expectedVisible ||
+			                !std::equal(
+			                  expected.begin(), expected.begin() + expectedVisible, actual.begin());
+		}
+		passed &= ReportError(c.sphereName, sphereFailures, 0, "failures");
+		passed &= ReportError(c.aabbName, aabbFailures, 0, "failures");
+	}
+	return passed;
+}
+
+// FastMath の誤差を測る点の数（関数・精度の段階ごと）
+const uint32_t kFastMathSweepCount = 1u << 24;
+// 一度に一括版へ渡す要素数
+const uint32_t kFastMathSweepChunk = 4096;
+
+// 入力を index = 0..kFastMathSweepCount-1 で等間隔に作り、スカラー版と一括版の両方の誤差の最大値を求める
+// input(index, chunk内の番号) で入力を用意し、evaluate(chunk の要素数) で誤差の最大値を返す
+template<class Input, class Evaluate>
+double SweepMaxError(const Input& input, const Evaluate& evaluate) {
+	double maxError = 0.0;
+	for (uint32_t begin = 0; begin < kFastMathSweepCount; begin += kFastMathSweepChunk) {
+		uint32_t count = (std::min)(kFastMathSweepChunk, kFastMathSweepCount - begin);
+		for (uint32_t i = 0; i < count; i++) {
+			input(begin + i, i);
+		}
+		maxError = (std::max)(maxError, evaluate(count));
+	}
+	return maxError;
+}
+
+// 等間隔の点 index の [min, max] 上の位置
+double SweepPoint(uint32_t index, double min, double max) {
+	return min + (max - min) * index / (kFastMathSweepCount - 1);
+}
+
+// rsqrt の相対誤差（[1e-30, 1e30] の対数一様）
+double MeasureRsqrtError(MathPrecision precision) {
+	std::vector<float> x(kFastMathSweepChunk), out(kFastMathSweepChunk);
+	return SweepMaxError(
+	  [&](uint32_t index, uint32_t i) {
+		  x[i] = static_cast<float>(std::pow(10.0, SweepPoint(index, -30.0, 30.0)));
+	  },
+	  [&](uint32_t count) {
+		  RsqrtArray({x.data(), count}, {out.data(), count}, precision);
+		  double maxError = 0.0;
+		  for (uint32_t i = 0; i < count; i++) {
+			  double expected = 1.0 / std::sqrt(static_cast<double>(x[i]));
+			  double scalar = Rsqrt(x[i], precision);
+			  maxError = (std::max)(maxError, std::fabs(scalar - expected) / expected);
+			  maxError = (std::max)(maxError, std::fabs(out[i] - expected) / expected);
+		  }
+		  return maxError;
+	  });
+}
+
+// sin と cos の絶対誤差（[-kSinCosFastMaxInput, kSinCosFastMaxInput]）
+double MeasureSinCosError(MathPrecision precision) {
+	std::vector<float> x(kFastMathSweepChunk), sin(kFastMathSweepChunk), cos(kFastMathSweepChunk);
+	return SweepMaxError(
+	  [&](uint32_t index, uint32_t i) {
+		  x[i] = static_cast<float>(SweepPoint(index, -kSinCosFastMaxInput, kSinCosFastMaxInput));
+	  },
+	  [&](uint32_t count) {
+		  SinCosArray({x.data(), count}, {sin.data(), count}, {cos.data(), count}, precision);
+		  double maxError = 0.0;
+		  for (uint32_t i = 0; i < count; i++) {
+			  double expectedSin = std::sin(static_cast<double>(x[i]));
+			  double expectedCos = std::cos(static_cast<double>(x[i]));
+			  float scalarSin, scalarCos;
+			  SinCos(x[i], scalarSin, scalarCos, precision);
+			  maxError = (std::max)(
+			    {maxError, std::fabs(scalarSin - expectedSin), std::fabs(scalarCos - expectedCos),
+			     std::fabs(sin[i] - expectedSin), std::fabs(cos[i] - expectedCos)});
+		  }
+		  return maxError;
+	  });
+}
+
+// atan2 の絶対誤差（原点中心の単位円周上の全方向）
+double MeasureAtan2Error(MathPrecision precision) {
+	std::vector<float> y(kFastMathSweepChunk), x(kFastMathSweepChunk), out(kFastMathSweepChunk);
+	const double kPi = 3.14159265358979323846;
+	return SweepMaxError(
+	  [&](uint32_t index, uint32_t i) {
+		  double angle = SweepPoint(index, -kPi, kPi);
+		  y[i] = static_cast<float>(std::sin(angle));
+		  x[i] = static_cast<float>(std::cos(angle));
+	  },
+	  [&](uint32_t count) {
+		  Atan2Array({y.data(), count}, {x.data(), count}, {out.data(), count}, precision);
+		  double maxError = 0.0;
+		  for (uint32_t i = 0; i < count; i++) {
+			  double expected = std::atan2(static_cast<double>(y[i]), static_cast<double>(x[i]));
+			  double scalar = Atan2(y[i], x[i], precision);
+			  // ±π の境目は同じ角度なので、差を (-π, π] に戻してから比べる
+			  double scalarError = std::remainder(scalar - expected, 2.0 * kPi);
+			  double arrayError = std::remainder(out[i] - expected, 2.0 * kPi);
+			  maxError = (std::max)({maxError, std::fabs(scalarError), std::fabs(arrayError)});
+		  }
+		  return maxError;
+	  });
+}
+
+// acos の絶対誤差（[-1, 1]）
+double MeasureAcosError(MathPrecision precision) {
+	std::vector<float> x(kFastMathSweepChunk), out(kFastMathSweepChunk);
+	return SweepMaxError(
+	  [&](uint32_t index, uint32_t i) { x[i] = static_cast<float>(SweepPoint(index, -1.0, 1.0)); },
+	  [&](uint32_t count) {
+		  AcosArray({x.data(), count}, {out.data(), count}, precision);
+		  double maxError = 0.0;
+		  for (uint32_t i = 0; i < count; i++) {
+			  double expected = std::acos(static_cast<double>(x[i]));
+			  double scalar = Acos(x[i], precision);
+			  maxError = (std::max)(
+			    {maxError, std::fabs(scalar - expected), std::fabs(out[i] - expected)});
+		  }
+		  return maxError;
+	  });
+}
+
+// FastMath.h の k*MaxError と、double で計算した値に対する実測の誤差
+bool VerifyFastMath() {
+	struct ErrorCase {
+		const char* name;
+		double (*measure)(MathPrecision);
+		MathPrecision precision;
+		float limit;
+	};
+	const ErrorCase kCases[] = {
+	  {"Rsqrt kFast (relative)", MeasureRsqrtError, MathPrecision::kFast, kRsqrtFastMaxError},
+	  {"Rsqrt kApprox (relative)", MeasureRsqrtError, MathPrecision::kApprox, kRsqrtApproxMaxError},
+	  {"SinCos kFast", MeasureSinCosError, MathPrecision::kFast, kSinCosFastMaxError},
+	  {"SinCos kApprox", MeasureSinCosError, MathPrecision::kApprox, kSinCosApproxMaxError},
+	  {"Atan2 kFast", MeasureAtan2Error, MathPrecision::kFast, kAtan2FastMaxError},
+	  {"Atan2 kApprox", MeasureAtan2Error, MathPrecision::kApprox, kAtan2ApproxMaxError},
+	  {"Acos kFast", MeasureAcosError, MathPrecision::kFast, kAcosFastMaxError},
+	  {"Acos kApprox", MeasureAcosError, MathPrecision::kApprox, kAcosApproxMaxError},
+	};
+	bool passed = true;
+	for (const ErrorCase& c : kCases) {
+		passed &= ReportError(c.name, c.measure(c.precision), c.limit, "");
+	}
+	return passed;
+}
+
+// 宣言している誤差の許容値をすべて確かめる
+bool Verify() {
+	bool passed = true;
+	passed &= VerifyMatrix4Multiply();
+	passed &= VerifyMakeAffine();
+	passed &= VerifyQuaternion();
+	passed &= VerifyMatrix4Inverse();
+	passed &= VerifyFrustumCulling();
+	passed &= VerifyVector3Batch();
+	passed &= VerifyVector3Stream();
+	passed &= VerifyFastMath();
+	return passed;
+}
+
+#pragma endregion
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+		const char* value = nullptr;
+		if (arg == "--verify") {
+			options.verify = true;
+			continue;
+		}
+		if (arg == "--quick") {
+			options.minSampleSeconds = 0.002;
+			options.samples = 3;
+			options.batches = {64, 4096};
+			options.latencyIterations = 1 << 12;
+			continue;
+		}
+		if (arg == "--output" && (value = next())) {
+			options.outputPath = value;
+		} else if (arg == "--baseline" && (value = next())) {
+			options.baselinePath = value;
+		} else if (arg == "--threshold" && (value = next())) {
+			options.threshold = std::atof(value);
+		} else if (arg == "--filter" && (value = next())) {
+			options.filter = value;
+		} else if (arg == "--min-time" && (value = next())) {
+			options.minSampleSeconds = std::atof(value) / 1000.0;
+		} else if (arg == "--batch" && (value = next())) {
+			options.batches.clear();
+			std::stringstream list(value);
+			std::string item;
+			while (std::getline(list, item, ',')) {
+				size_t batch = std::strtoul(item.c_str(), nullptr, 10);
+				if (batch > 0) {
+					options.batches.push_back(batch);
+				}
+			}
+			if (options.batches.empty()) {
+				return false;
+			}
+		} else {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		std::fprintf(
+		  stderr, "usage: %s [--output file] [--baseline file] [--threshold 0.1] [--filter text]\n"
+		          "          [--batch 64,4096,...] [--min-time ms] [--quick]\n"
+		          "       %s --verify\n",
+		  argv[0], argv[0]);
+		return 2;
+	}
+
+	std::fprintf(stderr, "SIMD: %s\n", GetSimdLevelName(GetSimdLevel()));
+	if (options.verify) {
+		return Verify() ? 0 : 1;
+	}
+
+	Suite suite(options);
+	RegisterVector(suite);
+	RegisterMathUtility(suite);
+	RegisterMatrix(suite);
+	RegisterQuaternion(suite);
+	RegisterFastMath(suite);
+	RegisterBatch(suite);
+	RegisterCulling(suite);
+
+	std::string json = ToJson(suite.GetResults());
+	if (options.outputPath.empty()) {
+		std::fputs(json.c_str(), stdout);
+	} else {
+		std::ofstream file(options.outputPath, std::ios::binary);
+		if (!file) {
+			std::fprintf(stderr, "cannot write %s\n", options.outputPath.c_str());
+			return 2;
+		}
+		file << json;
+	}
+
+	if (options.baselinePath.empty()) {
+		return 0;
+	}
+
+	std::ifstream file(options.baselinePath, std::ios::binary);
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	std::vector<Result> baseline;
+	if (!file || !ParseJson(buffer.str(), baseline)) {
+		std::fprintf(stderr, "cannot read baseline %s\n", options.baselinePath.c_str());
+		return 2;
+	}
+
+	int regressions = Compare(baseline, suite.GetResults(), options.threshold);
+	std::fprintf(
+	  stderr, "%d regression(s) over %.1f%% against %s\n", regressions, options.threshold * 100.0,
+	  options.baselinePath.c_str());
+	return regressions > 0 ? 1 : 0;
+}
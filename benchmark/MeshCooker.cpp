@@ -0,0 +1,137 @@
+// OBJ を変換済みのメッシュファイル（.mesh）に書き出す
+//
+// ゲーム本体は ModelLoader::CreateFromMesh で古い .mesh を自動で作り直すが、
+// 配布前にまとめて変換しておくときに使う
+//
+// 使い方
+//   mesh_cooker [--smoothing] [--force] [--no-overdraw] [--threads 0] file.obj ...
+// 出力は同じディレクトリの 拡張子を .mesh にしたファイル（同じ頂点はまとめ、頂点キャッシュと
+// オーバードローに合わせて並べ替えて書き出す。--no-overdraw ではオーバードローの並べ替えをしない）。
+// 元の OBJ・MTL が変わっていなければ作り直さない（--force で必ず作り直す）
+// 変換に失敗したファイルがあれば終了コード 1 を返す
+
+#include "CookedMesh.h"
+#include "JobSystem.h"
+#include "MeshOptimizer.h"
+#include "VertexWelder.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 実行時の設定
+struct Options {
+	uint32_t threads = 0;
+	bool smoothing = false;
+	bool force = false;
+	bool overdraw = true;
+	std::vector<std::string> files;
+};
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--smoothing") {
+			options.smoothing = true;
+		} else if (arg == "--force") {
+			options.force = true;
+		} else if (arg == "--no-overdraw") {
+			options.overdraw = false;
+		} else if (arg == "--threads") {
+			if (i + 1 >= argc) {
+				return false;
+			}
+			options.threads = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		} else if (arg.rfind("--", 0) == 0) {
+			return false;
+		} else {
+			options.files.push_back(arg);
+		}
+	}
+	return !options.files.empty();
+}
+
+// 拡張子を .mesh にしたパス
+std::string MeshPathOf(const std::string& objPath) {
+	size_t dot = objPath.find_last_of('.');
+	size_t slash = objPath.find_last_of("/\\");
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+		return objPath + ".mesh";
+	}
+	return objPath.substr(0, dot) + ".mesh";
+}
+
+double NowMs() {
+	return std::chrono::duration<double, std::milli>(
+	         std::chrono::steady_clock::now().time_since_epoch())
+	  .count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		std::fprintf(
+		  stderr, "usage: %s [--smoothing] [--force] [--no-overdraw] [--threads n] file.obj ...\n", argv[0]);
+		return 2;
+	}
+
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	jobSystem->Initialize(options.threads);
+
+	bool allCooked = true;
+	for (const std::string& path : options.files) {
+		const std::string meshPath = MeshPathOf(path);
+		if (!options.force && CookedMesh::IsUpToDate(meshPath, path, options.smoothing)) {
+			std::printf("%s: up to date\n", meshPath.c_str());
+			continue;
+		}
+
+		double start = NowMs();
+		ObjModelData data;
+		if (!ObjLoader::LoadFile(path, options.smoothing, data)) {
+			std::fprintf(stderr, "%s: cannot load\n", path.c_str());
+			allCooked = false;
+			continue;
+		}
+		VertexWelder::Stats stats = VertexWelder::Weld(data);
+		MeshOptimizer::Stats optimizerStats = MeshOptimizer::Optimize(data, options.overdraw);
+		if (!CookedMesh::Cook(data, path, meshPath, options.smoothing)) {
+			std::fprintf(stderr, "%s: cannot cook\n", path.c_str());
+			allCooked = false;
+			continue;
+		}
+		double cookMs = NowMs() - start;
+
+		CookedMesh cooked;
+		if (!cooked.Open(meshPath)) {
+			std::fprintf(stderr, "%s: cannot open the result\n", meshPath.c_str());
+			allCooked = false;
+			continue;
+		}
+		const CookedMesh::Header& header = cooked.GetHeader();
+		std::printf(
+		  "%s: %llu vertices, %llu indices (%u bytes), %u submeshes, %u materials, %.1fms\n",
+		  meshPath.c_str(), static_cast<unsigned long long>(header.vertexCount),
+		  static_cast<unsigned long long>(header.indexCount), header.indexSize,
+		  header.submeshCount, header.materialCount, cookMs);
+		std::printf(
+		  "  welded %llu -> %llu vertices (%.2fx), %llu -> %llu bytes\n",
+		  static_cast<unsigned long long>(stats.vertexCountBefore),
+		  static_cast<unsigned long long>(stats.vertexCountAfter), stats.GetVertexRatio(),
+		  static_cast<unsigned long long>(stats.GetBytesBefore()),
+		  static_cast<unsigned long long>(stats.GetBytesAfter()));
+		std::printf(
+		  "  ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", optimizerStats.before.GetAcmr(),
+		  optimizerStats.after.GetAcmr(), optimizerStats.before.GetAtvr(),
+		  optimizerStats.after.GetAtvr());
+	}
+
+	jobSystem->Finalize();
+	return allCooked ? 0 : 1;
+}
@@ -0,0 +1,261 @@
+// OBJ 読み込みのベンチマーク
+//
+// ObjLoader（メモリ割り当て + 並列解析）と、Model::LoadModel と同じ手順で
+// istream から1行ずつ読む従来の読み込みを同じファイルで比べ、結果が一致するかも確かめる。
+// 変換済みの .mesh（CookedMesh）を開く時間と、VertexWelder で同じ頂点をまとめる時間・効果、
+// MeshOptimizer で並べ替える時間と ACMR / ATVR の変化も測る
+// （変換結果はファイル名.mesh に書き出す）
+//
+// 使い方
+//   obj_benchmark [--threads 0] [--chunk 1048576] [--repeat 3] [--smoothing] [file.obj ...]
+// ファイルを指定しない場合は、格子状のメッシュを生成して obj_benchmark_generated.obj に書き出して使う
+//   [--generate 1000]  生成する格子の一辺の頂点数
+//   [--single-group]   行をグループに分けず、32ビットのインデックスが必要な1つのメッシュにする
+// 結果が一致しないファイルがあれば終了コード 1 を返す
+
+#include "CookedMesh.h"
+#include "JobSystem.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "ObjReferenceLoader.h"
+#include "VertexWelder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 実行時の設定
+struct Options {
+	uint32_t threads = 0;
+	size_t chunkSize = ObjLoader::kDefaultChunkSize;
+	uint32_t repeat = 3;
+	bool smoothing = false;
+	uint32_t generate = 1000;
+	bool singleGroup = false;
+	std::vector<std::string> files;
+};
+
+// 変換済みのファイルが読み込み結果と同じ内容か
+bool Equals(const CookedMesh& cooked, const ObjModelData& data) {
+	const CookedMesh::Header& header = cooked.GetHeader();
+	std::span<const CookedMesh::Submesh> submeshes = cooked.GetSubmeshes();
+	if (submeshes.size() != data.meshes.size()) {
+		return false;
+	}
+	const uint8_t* indexData = static_cast<const uint8_t*>(cooked.GetIndexData());
+	for (size_t i = 0; i < submeshes.size(); i++) {
+		const CookedMesh::Submesh& submesh = submeshes[i];
+		const ObjMesh& mesh = data.meshes[i];
+		if (cooked.GetString(submesh.name) != mesh.name ||
+		    submesh.vertexCount != mesh.vertices.size() ||
+		    submesh.indexCount != mesh.indices.size()) {
+			return false;
+		}
+		if (!mesh.vertices.empty() &&
+		    std::memcmp(
+		      cooked.GetVertices().data() + submesh.vertexOffset, mesh.vertices.data(),
+		      mesh.vertices.size() * sizeof(ObjVertex)) != 0) {
+			return false;
+		}
+		for (uint32_t j = 0; j < submesh.indexCount; j++) {
+			const uint8_t* p = indexData + (uint64_t(submesh.indexOffset) + j) * header.indexSize;
+			uint32_t index = 0;
+			if (header.indexSize == 2) {
+				uint16_t value;
+				std::memcpy(&value, p, sizeof(value));
+				index = value;
+			} else {
+				std::memcpy(&index, p, sizeof(index));
+			}
+			if (index != mesh.indices[j]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// side x side の格子を、行ごとにグループとマテリアルを切り替えながら四角形で書き出す
+bool Generate(const std::string& path, uint32_t side, bool singleGroup) {
+	std::ofstream file(path);
+	if (file.fail()) {
+		return false;
+	}
+	// 1グループの頂点数が16ビットに収まるよう、行をまとめる
+	const uint32_t rowsPerGroup =
+	  singleGroup ? side : (std::max)(1u, 0x10000 / (side * 4) - 1);
+	file << "# generated by obj_benchmark\nmtllib generated.mtl\n";
+	char buffer[128];
+	for (uint32_t y = 0; y < side; y++) {
+		for (uint32_t x = 0; x < side; x++) {
+			float u = static_cast<float>(x) / (side - 1);
+			float v = static_cast<float>(y) / (side - 1);
+			float height = std::sin(u * 12.0f) * std::cos(v * 9.0f) * 0.25f;
+			std::snprintf(buffer, sizeof(buffer), "v %f %f %f\n", u * 10.0f, height, v * 10.0f);
+			file << buffer;
+			std::snprintf(buffer, sizeof(buffer), "vt %f %f\n", u, v);
+			file << buffer;
+			std::snprintf(buffer, sizeof(buffer), "vn %f %f %f\n", -height, 1.0f, height * 0.5f);
+			file << buffer;
+		}
+	}
+	for (uint32_t y = 0; y + 1 < side; y++) {
+		if (y % rowsPerGroup == 0) {
+			file << "g part" << y / rowsPerGroup << "\nusemtl material" << (y / rowsPerGroup) % 4
+			     << "\n";
+		}
+		for (uint32_t x = 0; x + 1 < side; x++) {
+			uint32_t i0 = y * side + x + 1;
+			uint32_t i1 = i0 + 1;
+			uint32_t i2 = i0 + side + 1;
+			uint32_t i3 = i0 + side;
+			file << "f " << i0 << '/' << i0 << '/' << i0 << ' ' << i1 << '/' << i1 << '/' << i1
+			     << ' ' << i2 << '/' << i2 << '/' << i2 << ' ' << i3 << '/' << i3 << '/' << i3
+			     << '\n';
+		}
+	}
+	return true;
+}
+
+double NowMs() {
+	return std::chrono::duration<double, std::milli>(
+	         std::chrono::steady_clock::now().time_since_epoch())
+	  .count();
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+		if (arg == "--smoothing") {
+			options.smoothing = true;
+		} else if (arg == "--single-group") {
+			options.singleGroup = true;
+		} else if (arg == "--threads" || arg == "--chunk" || arg == "--repeat" || arg == "--generate") {
+			const char* value = next();
+			if (!value) {
+				return false;
+			}
+			unsigned long number = std::strtoul(value, nullptr, 10);
+			if (arg == "--threads") {
+				options.threads = static_cast<uint32_t>(number);
+			} else if (arg == "--chunk") {
+				options.chunkSize = number;
+			} else if (arg == "--repeat") {
+				options.repeat = static_cast<uint32_t>(number);
+			} else {
+				options.generate = static_cast<uint32_t>(number);
+			}
+		} else if (arg.rfind("--", 0) == 0) {
+			return false;
+		} else {
+			options.files.push_back(arg);
+		}
+	}
+	return options.repeat > 0 && options.generate >= 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		std::fprintf(
+		  stderr,
+		  "usage: %s [--threads n] [--chunk bytes] [--repeat n] [--smoothing] [--generate side] "
+		  "[--single-group] "
+		  "[file.obj ...]\n",
+		  argv[0]);
+		return 2;
+	}
+	if (options.files.empty()) {
+		const std::string path = "obj_benchmark_generated.obj";
+		if (!Generate(path, options.generate, options.singleGroup)) {
+			std::fprintf(stderr, "cannot write %s\n", path.c_str());
+			return 2;
+		}
+		options.files.push_back(path);
+	}
+
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	jobSystem->Initialize(options.threads);
+	std::printf("threads %u, chunk %zu bytes\n", jobSystem->GetThreadCount(), options.chunkSize);
+	std::printf(
+	  "%-40s %10s %10s %10s %8s %10s %10s %s\n", "file", "MB", "istream", "ObjLoader", "speedup",
+	  "MB/s", "cooked", "match");
+
+	bool allMatch = true;
+	for (const std::string& path : options.files) {
+		std::ifstream probe(path, std::ios::binary | std::ios::ate);
+		if (probe.fail()) {
+			std::fprintf(stderr, "cannot read %s\n", path.c_str());
+			allMatch = false;
+			continue;
+		}
+		double megabytes = static_cast<double>(probe.tellg()) / (1024.0 * 1024.0);
+
+		// それぞれ最速の回を使う
+		ObjModelData reference;
+		ObjModelData loaded;
+		double referenceMs = 1e30;
+		double loaderMs = 1e30;
+		bool ok = true;
+		for (uint32_t r = 0; r < options.repeat; r++) {
+			double start = NowMs();
+			ok &= ObjReferenceLoader::LoadFile(path, options.smoothing, reference);
+			referenceMs = (std::min)(referenceMs, NowMs() - start);
+
+			start = NowMs();
+			ok &= ObjLoader::LoadFile(path, options.smoothing, loaded, options.chunkSize);
+			loaderMs = (std::min)(loaderMs, NowMs() - start);
+		}
+		// 変換済みのファイルは、古くないかの確認と割り当てまでを測る
+		const std::string meshPath = path + ".mesh";
+		ok &= CookedMesh::Cook(loaded, path, meshPath, options.smoothing);
+		CookedMesh cooked;
+		double cookedMs = 1e30;
+		for (uint32_t r = 0; r < options.repeat; r++) {
+			double start = NowMs();
+			ok &= CookedMesh::IsUpToDate(meshPath, path, options.smoothing);
+			ok &= cooked.Open(meshPath);
+			cookedMs = (std::min)(cookedMs, NowMs() - start);
+		}
+
+		bool match = ok && ObjReferenceLoader::Equals(reference, loaded) && Equals(cooked, loaded);
+		allMatch &= match;
+		std::printf(
+		  "%-40s %10.2f %8.1fms %8.1fms %7.2fx %10.1f %8.2fms %s\n", path.c_str(), megabytes,
+		  referenceMs, loaderMs, referenceMs / loaderMs, megabytes / (loaderMs / 1000.0), cookedMs,
+		  match ? "yes" : "NO");
+
+		double start = NowMs();
+		VertexWelder::Stats stats = VertexWelder::Weld(loaded);
+		double weldMs = NowMs() - start;
+		std::printf(
+		  "  weld %8.1fms  vertices %llu -> %llu (%.2fx)  bytes %.2fMB -> %.2fMB\n", weldMs,
+		  static_cast<unsigned long long>(stats.vertexCountBefore),
+		  static_cast<unsigned long long>(stats.vertexCountAfter), stats.GetVertexRatio(),
+		  stats.GetBytesBefore() / (1024.0 * 1024.0), stats.GetBytesAfter() / (1024.0 * 1024.0));
+
+		start = NowMs();
+		MeshOptimizer::Stats optimizerStats = MeshOptimizer::Optimize(loaded);
+		double optimizeMs = NowMs() - start;
+		std::printf(
+		  "  optimize %8.1fms  ACMR %.3f -> %.3f  ATVR %.3f -> %.3f\n", optimizeMs,
+		  optimizerStats.before.GetAcmr(), optimizerStats.after.GetAcmr(),
+		  optimizerStats.before.GetAtvr(), optimizerStats.after.GetAtvr());
+	}
+
+	jobSystem->Finalize();
+	return allMatch ? 0 : 1;
+}
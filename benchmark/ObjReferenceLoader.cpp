@@ -0,0 +1,165 @@
+// 従来の OBJ 読み込み（ObjReferenceLoader.h を参照）
+
+#include "ObjReferenceLoader.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+bool ObjReferenceLoader::LoadFile(const std::string& path, bool smoothing, ObjModelData& out) {
+	std::ifstream file(path);
+	if (file.fail()) {
+		return false;
+	}
+	Parse(file, smoothing, out);
+	return true;
+}
+
+void ObjReferenceLoader::Parse(std::istream& stream, bool smoothing, ObjModelData& out) {
+	out = {};
+	out.meshes.emplace_back();
+	ObjMesh* mesh = &out.meshes.back();
+	std::unordered_map<uint32_t, std::vector<uint32_t>> smoothData;
+	int indexCountTex = 0;
+
+	auto calculateSmoothedVertexNormals = [&]() {
+		for (auto& [position, vertices] : smoothData) {
+			Vector3 normal;
+			for (uint32_t index : vertices) {
+				normal += mesh->vertices[index].normal;
+			}
+			normal = normal / static_cast<float>(vertices.size());
+			float length =
+			  std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+			normal = length > 0.0f ? normal / length : Vector3();
+			for (uint32_t index : vertices) {
+				mesh->vertices[index].normal = normal;
+			}
+		}
+		smoothData.clear();
+	};
+
+	std::vector<Vector3> positions;
+	std::vector<Vector3> normals;
+	std::vector<Vector2> texcoords;
+	std::string line;
+	while (std::getline(stream, line)) {
+		std::istringstream lineStream(line);
+		std::string key;
+		std::getline(lineStream, key, ' ');
+
+		if (key == "g") {
+			if (mesh->name.size() > 0 && mesh->vertices.size() > 0) {
+				if (smoothing) {
+					calculateSmoothedVertexNormals();
+				}
+				out.meshes.emplace_back();
+				mesh = &out.meshes.back();
+				indexCountTex = 0;
+			}
+			std::string groupName;
+			lineStream >> groupName;
+			mesh->name = groupName;
+		}
+		if (key == "v") {
+			Vector3 position;
+			lineStream >> position.x >> position.y >> position.z;
+			positions.push_back(position);
+		}
+		if (key == "vt") {
+			Vector2 texcoord;
+			lineStream >> texcoord.x >> texcoord.y;
+			texcoord.y = 1.0f - texcoord.y;
+			texcoords.push_back(texcoord);
+		}
+		if (key == "vn") {
+			Vector3 normal;
+			lineStream >> normal.x >> normal.y >> normal.z;
+			normals.push_back(normal);
+		}
+		if (key == "mtllib") {
+			std::string filename;
+			lineStream >> filename;
+			out.materialLibraries.push_back(filename);
+		}
+		if (key == "usemtl") {
+			std::string materialName;
+			lineStream >> materialName;
+			mesh->materialUses.push_back(
+			  {materialName, static_cast<uint32_t>(out.materialLibraries.size())});
+		}
+		if (key == "f") {
+			int faceIndexCount = 0;
+			std::string indexString;
+			while (std::getline(lineStream, indexString, ' ')) {
+				std::istringstream indexStream(indexString);
+				uint32_t indexPosition = 0, indexNormal = 0, indexTexcoord = 0;
+				indexStream >> indexPosition;
+				indexStream.seekg(1, std::ios_base::cur);
+				ObjVertex vertex = {};
+				char c = 0;
+				indexStream >> c;
+				if (c == '/') {
+					indexStream >> indexNormal;
+					vertex.pos = positions[indexPosition - 1];
+					vertex.normal = normals[indexNormal - 1];
+				} else {
+					indexStream.seekg(-1, std::ios_base::cur);
+					indexStream >> indexTexcoord;
+					indexStream.seekg(1, std::ios_base::cur);
+					indexStream >> indexNormal;
+					vertex.pos = positions[indexPosition - 1];
+					vertex.normal = normals[indexNormal - 1];
+					vertex.uv = texcoords[indexTexcoord - 1];
+				}
+				mesh->vertices.push_back(vertex);
+				if (smoothing) {
+					smoothData[indexPosition].push_back(
+					  static_cast<uint32_t>(mesh->vertices.size() - 1));
+				}
+				if (faceIndexCount >= 3) {
+					mesh->indices.push_back(static_cast<uint32_t>(indexCountTex - 1));
+					mesh->indices.push_back(static_cast<uint32_t>(indexCountTex));
+					mesh->indices.push_back(static_cast<uint32_t>(indexCountTex - 3));
+				} else {
+					mesh->indices.push_back(static_cast<uint32_t>(indexCountTex));
+				}
+				indexCountTex++;
+				faceIndexCount++;
+			}
+		}
+	}
+	if (smoothing) {
+		calculateSmoothedVertexNormals();
+	}
+}
+
+bool ObjReferenceLoader::Equals(const ObjModelData& a, const ObjModelData& b) {
+	if (a.materialLibraries != b.materialLibraries || a.meshes.size() != b.meshes.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < a.meshes.size(); i++) {
+		const ObjMesh& ma = a.meshes[i];
+		const ObjMesh& mb = b.meshes[i];
+		if (ma.name != mb.name || ma.indices != mb.indices ||
+		    ma.vertices.size() != mb.vertices.size() ||
+		    ma.materialUses.size() != mb.materialUses.size()) {
+			return false;
+		}
+		if (!ma.vertices.empty() &&
+		    std::memcmp(
+		      ma.vertices.data(), mb.vertices.data(), ma.vertices.size() * sizeof(ObjVertex)) != 0) {
+			return false;
+		}
+		for (size_t j = 0; j < ma.materialUses.size(); j++) {
+			if (ma.materialUses[j].name != mb.materialUses[j].name ||
+			    ma.materialUses[j].libraryCount != mb.materialUses[j].libraryCount) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// 従来の OBJ 読み込み（Model::LoadModel の OBJ 解析部分と同じ手順）
+// ObjLoader の結果が従来と一致するかを obj_benchmark と obj_loader_test で確かめるために使う
+
+#include "ObjLoader.h"
+
+#include <istream>
+#include <string>
+
+/// <summary>
+/// 従来の読み込み
+/// マテリアルにテクスチャがない場合の分岐（v//vn を判定する側）を使う。
+/// 元の実装は座標などの番号と頂点インデックスを unsigned short で持つため 65536 個を超えるファイルでは壊れるが、
+/// 大きなファイルや32ビットのインデックスを使うメッシュで比べられるよう、ここではどちらも uint32_t で持つ
+/// （面の頂点には法線が必要で、番号の範囲は確かめない）
+/// </summary>
+class ObjReferenceLoader {
+  public: // 静的メンバ関数
+	/// <summary>
+	/// ファイルから読み込む
+	/// </summary>
+	/// <returns>ファイルを開けたか</returns>
+	static bool LoadFile(const std::string& path, bool smoothing, ObjModelData& out);
+	/// <summary>
+	/// ストリームから1行ずつ読む
+	/// </summary>
+	static void Parse(std::istream& stream, bool smoothing, ObjModelData& out);
+	/// <summary>
+	/// 2つの読み込み結果が完全に一致するか（頂点はビット単位で比べる）
+	/// </summary>
+	static bool Equals(const ObjModelData& a, const ObjModelData& b);
+};
@@ -0,0 +1,92 @@
+// CameraCache の並列カリングが、分割せずにスカラー実装で求めた結果と同じ番号を同じ順に返すか確かめる
+// （kCullGrainSize を超える要素数で、各ジョブの結果を前に詰める処理を通す）
+
+#include "CameraCache.h"
+#include "JobSystem.h"
+#include "TestCheck.h"
+
+#include <random>
+#include <vector>
+
+using namespace MathUtility;
+
+namespace {
+
+const uint32_t kGrain = CameraCache::kCullGrainSize;
+// 1ジョブ分以下から、端数のある複数ジョブ分まで
+const uint32_t kCounts[] = {kGrain, kGrain + 1, kGrain * 2, kGrain * 3 + 123, kGrain * 7 + 5};
+
+CameraCache MakeCamera() {
+	CameraCache camera;
+	camera.Update(
+	  Matrix4LookAtLH({0, 0, 0}, {0, 0, 1}, {0, 1, 0}),
+	  Matrix4Perspective(PI / 4, 16.0f / 9.0f, 0.1f, 1000.0f));
+	return camera;
+}
+
+std::vector<float> MakeArray(std::mt19937& engine, uint32_t count, float min, float max) {
+	std::uniform_real_distribution<float> distribution(min, max);
+	std::vector<float> values(count);
+	for (float& v : values) {
+		v = distribution(engine);
+	}
+	return values;
+}
+
+void TestCullSpheresMatchesScalar() {
+	CameraCache camera = MakeCamera();
+	std::mt19937 engine(1);
+	for (uint32_t count : kCounts) {
+		std::vector<float> x = MakeArray(engine, count, -500, 500);
+		std::vector<float> y = MakeArray(engine, count, -500, 500);
+		std::vector<float> z = MakeArray(engine, count, -100, 1100);
+		std::vector<float> r = MakeArray(engine, count, 0.1f, 50);
+		SphereSoAConstSpan spheres = {x, y, z, r};
+
+		std::vector<uint32_t> expected(count);
+		std::vector<uint32_t> actual(count);
+		uint32_t expectedVisible =
+		  FrustumCullSpheresScalar(camera.GetFrustum(), spheres, expected, 0);
+		uint32_t actualVisible = camera.CullSpheres(spheres, actual);
+		CHECK(expectedVisible > 0 && expectedVisible < count);
+		CHECK(actualVisible == expectedVisible);
+		expected.resize(expectedVisible);
+		actual.resize(actualVisible);
+		CHECK(actual == expected);
+	}
+}
+
+void TestCullAABBsMatchesScalar() {
+	CameraCache camera = MakeCamera();
+	std::mt19937 engine(2);
+	for (uint32_t count : kCounts) {
+		std::vector<float> x = MakeArray(engine, count, -500, 500);
+		std::vector<float> y = MakeArray(engine, count, -500, 500);
+		std::vector<float> z = MakeArray(engine, count, -100, 1100);
+		std::vector<float> ex = MakeArray(engine, count, 0.1f, 50);
+		std::vector<float> ey = MakeArray(engine, count, 0.1f, 50);
+		std::vector<float> ez = MakeArray(engine, count, 0.1f, 50);
+		AABBSoAConstSpan boxes = {x, y, z, ex, ey, ez};
+
+		std::vector<uint32_t> expected(count);
+		std::vector<uint32_t> actual(count);
+		uint32_t expectedVisible = FrustumCullAABBsScalar(camera.GetFrustum(), boxes, expected, 0);
+		uint32_t actualVisible = camera.CullAABBs(boxes, actual);
+		CHECK(expectedVisible > 0 && expectedVisible < count);
+		CHECK(actualVisible == expectedVisible);
+		expected.resize(expectedVisible);
+		actual.resize(actualVisible);
+		CHECK(actual == expected);
+	}
+}
+
+} // namespace
+
+int main() {
+	// ハードウェアのスレッド数によらず分割して並列に処理させる
+	JobSystem::GetInstance()->Initialize(4);
+	TestCullSpheresMatchesScalar();
+	TestCullAABBsMatchesScalar();
+	JobSystem::GetInstance()->Finalize();
+	return TestResult();
+}
@@ -0,0 +1,218 @@
+// CookedMesh で書き出した .mesh を開き直して、読み込んだ OBJ と同じ内容になっているかと、
+// OBJ・MTL の変更や平滑化の設定の違いを IsUpToDate が見落とさないか、
+// 頂点の数の境目（65536 / 65537）でインデックスの大きさが切り替わるかを確かめる
+
+#include "CookedMesh.h"
+#include "JobSystem.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// 2つのグループ（四角形と三角形）と、定義のある・ないマテリアル
+const char kObjText[] = "mtllib cube.mtl\n"
+                        "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 0 0 1\n"
+                        "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+                        "vn 0 0 1\nvn 1 0 0\n"
+                        "g front\nusemtl red\nf 1/1/1 2/2/1 3/3/1 4/4/1\n"
+                        "g side\nusemtl missing\nf 2//2 5//2 3//2\n";
+const char kMtlText[] = "newmtl red\nKd 1 0 0\n";
+
+void WriteText(const fs::path& path, const std::string& text) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file << text;
+}
+
+// 更新時刻をずらす（同じ秒の中で書き直しても変更として見えるようにする）
+void ShiftWriteTime(const fs::path& path, int seconds) {
+	fs::last_write_time(path, fs::last_write_time(path) + std::chrono::seconds(seconds));
+}
+
+// 読み込んだ OBJ と .mesh の中身が一致するか
+bool Equals(const CookedMesh& cooked, const ObjModelData& data) {
+	const CookedMesh::Header& header = cooked.GetHeader();
+	if (cooked.GetSubmeshes().size() != data.meshes.size() || header.indexSize != 2) {
+		return false;
+	}
+	const uint16_t* indices = static_cast<const uint16_t*>(cooked.GetIndexData());
+	for (size_t i = 0; i < data.meshes.size(); i++) {
+		const CookedMesh::Submesh& submesh = cooked.GetSubmeshes()[i];
+		const ObjMesh& mesh = data.meshes[i];
+		if (
+		  cooked.GetString(submesh.name) != mesh.name ||
+		  submesh.vertexCount != mesh.vertices.size() || submesh.indexCount != mesh.indices.size()) {
+			return false;
+		}
+		if (
+		  std::memcmp(
+		    cooked.GetVertices().data() + submesh.vertexOffset, mesh.vertices.data(),
+		    mesh.vertices.size() * sizeof(ObjVertex)) != 0) {
+			return false;
+		}
+		for (size_t j = 0; j < mesh.indices.size(); j++) {
+			if (indices[submesh.indexOffset + j] != mesh.indices[j]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void TestRoundTrip(const fs::path& directory) {
+	const std::string objPath = (directory / "cube.obj").string();
+	const std::string meshPath = (directory / "cube.mesh").string();
+	ObjModelData data;
+	CHECK(ObjLoader::LoadFile(objPath, false, data));
+	CHECK(CookedMesh::Cook(data, objPath, meshPath, false));
+
+	CookedMesh cooked;
+	CHECK(cooked.Open(meshPath));
+	CHECK(Equals(cooked, data));
+	// 四角形は2つの三角形に分ける
+	CHECK(cooked.GetHeader().indexCount == 6 + 3);
+	CHECK(cooked.GetHeader().boundsMin[2] == 0.0f && cooked.GetHeader().boundsMax[2] == 1.0f);
+
+	// MTL に定義のあるマテリアルだけが表に入る
+	CHECK(cooked.GetLibraries().size() == 1);
+	CHECK(cooked.GetString(cooked.GetLibraries()[0]) == "cube.mtl");
+	CHECK(cooked.GetMaterials().size() == 1);
+	CHECK(cooked.GetString(cooked.GetMaterials()[0]) == "red");
+	CHECK(cooked.GetSubmeshes()[0].material == 0);
+	CHECK(cooked.GetSubmeshes()[1].material == CookedMesh::kNoMaterial);
+	cooked.Close();
+
+	// 同じ頂点をまとめて並べ替えても、三角形の数は変わらない
+	CHECK(CookedMesh::Cook(objPath, meshPath, true));
+	CHECK(cooked.Open(meshPath));
+	CHECK(cooked.GetHeader().indexCount == 6 + 3);
+	CHECK(
+	  cooked.GetHeader().vertexCount <=
+	  data.meshes[0].vertices.size() + data.meshes[1].vertices.size());
+	CHECK((cooked.GetHeader().flags & CookedMesh::kFlagSmoothing) != 0);
+}
+
+void TestStaleness(const fs::path& directory) {
+	const fs::path objPath = directory / "cube.obj";
+	const fs::path mtlPath = directory / "cube.mtl";
+	const std::string obj = objPath.string();
+	const std::string mesh = (directory / "cube.mesh").string();
+	CHECK(CookedMesh::Cook(obj, mesh, false));
+	CHECK(CookedMesh::IsUpToDate(mesh, obj, false));
+
+	// 平滑化の設定が違う
+	CHECK(!CookedMesh::IsUpToDate(mesh, obj, true));
+
+	// MTL の中身が変わった（大きさも時刻も見ずに中身で比べる）
+	WriteText(mtlPath, "newmtl red\nKd 0 1 0\n");
+	CHECK(!CookedMesh::IsUpToDate(mesh, obj, false));
+	CHECK(CookedMesh::Cook(obj, mesh, false));
+	CHECK(CookedMesh::IsUpToDate(mesh, obj, false));
+
+	// OBJ の大きさが変わった
+	WriteText(objPath, std::string(kObjText) + "# comment\n");
+	CHECK(!CookedMesh::IsUpToDate(mesh, obj, false));
+	CHECK(CookedMesh::Cook(obj, mesh, false));
+
+	// 大きさは同じで中身と時刻が変わった
+	std::string edited = std::string(kObjText) + "# commant\n";
+	WriteText(objPath, edited);
+	ShiftWriteTime(objPath, 10);
+	CHECK(!CookedMesh::IsUpToDate(mesh, obj, false));
+	CHECK(CookedMesh::Cook(obj, mesh, false));
+
+	// 時刻だけが変わったときは使えて、記録した時刻が書き直される
+	ShiftWriteTime(objPath, 10);
+	int64_t sourceTime = fs::last_write_time(objPath).time_since_epoch().count();
+	CookedMesh cooked;
+	CHECK(cooked.Open(mesh));
+	CHECK(cooked.GetHeader().sourceTime != sourceTime);
+	cooked.Close();
+	CHECK(CookedMesh::IsUpToDate(mesh, obj, false));
+	CHECK(cooked.Open(mesh));
+	CHECK(cooked.GetHeader().sourceTime == sourceTime);
+	cooked.Close();
+	CHECK(CookedMesh::IsUpToDate(mesh, obj, false));
+
+	// .mesh が壊れている・ない
+	WriteText(mesh, "MESH");
+	CHECK(!CookedMesh::IsUpToDate(mesh, obj, false));
+	fs::remove(mesh);
+	CHECK(!CookedMesh::IsUpToDate(mesh, obj, false));
+}
+
+// vertexCount 個の頂点と、先頭・中央・末尾の頂点をつなぐ三角形1つのメッシュ
+ObjMesh MakeTriangleMesh(const char* name, uint32_t vertexCount) {
+	ObjMesh mesh;
+	mesh.name = name;
+	mesh.vertices.resize(vertexCount, ObjVertex{{0, 0, 0}, {0, 0, 1}, {0, 0}});
+	mesh.indices = {0, vertexCount / 2, vertexCount - 1};
+	return mesh;
+}
+
+uint32_t ReadIndex(const CookedMesh& cooked, uint64_t position) {
+	const uint8_t* data = static_cast<const uint8_t*>(cooked.GetIndexData());
+	if (cooked.GetHeader().indexSize == 2) {
+		return reinterpret_cast<const uint16_t*>(data)[position];
+	}
+	return reinterpret_cast<const uint32_t*>(data)[position];
+}
+
+// 頂点が 65536 個までのメッシュは16ビット、65537 個からは32ビットのインデックスになる
+void TestIndexSize(const fs::path& directory) {
+	const std::string objPath = (directory / "cube.obj").string();
+	const std::string meshPath = (directory / "wide.mesh").string();
+	CHECK(ObjLoader::kMaxShortIndexVertexCount == 65536);
+	CHECK(ObjLoader::GetIndexSize(65536) == 2);
+	CHECK(ObjLoader::GetIndexSize(65537) == 4);
+
+	for (uint32_t vertexCount : {65536u, 65537u}) {
+		ObjModelData data;
+		data.meshes.push_back(MakeTriangleMesh("big", vertexCount));
+		CHECK(CookedMesh::Cook(data, objPath, meshPath, false));
+		CookedMesh cooked;
+		CHECK(cooked.Open(meshPath));
+		CHECK(cooked.GetHeader().indexSize == ObjLoader::GetIndexSize(vertexCount));
+		CHECK(ReadIndex(cooked, 2) == vertexCount - 1);
+	}
+
+	// ファイルは一番大きいメッシュに合わせ、小さいメッシュは ModelLoader が16ビットに詰め直せる
+	ObjModelData data;
+	data.meshes.push_back(MakeTriangleMesh("small", 3));
+	data.meshes.push_back(MakeTriangleMesh("big", 65537));
+	CHECK(CookedMesh::Cook(data, objPath, meshPath, false));
+	CookedMesh cooked;
+	CHECK(cooked.Open(meshPath));
+	CHECK(cooked.GetHeader().indexSize == 4);
+	const CookedMesh::Submesh& small = cooked.GetSubmeshes()[0];
+	const CookedMesh::Submesh& big = cooked.GetSubmeshes()[1];
+	CHECK(ObjLoader::GetIndexSize(small.vertexCount) == 2);
+	CHECK(ObjLoader::GetIndexSize(big.vertexCount) == 4);
+	CHECK(ReadIndex(cooked, small.indexOffset + 2) == 2);
+	CHECK(ReadIndex(cooked, big.indexOffset + 2) == 65536);
+}
+
+} // namespace
+
+int main() {
+	JobSystem::GetInstance()->Initialize(4);
+	const fs::path directory = fs::temp_directory_path() / "cooked_mesh_test";
+	fs::remove_all(directory);
+	fs::create_directories(directory);
+	WriteText(directory / "cube.obj", kObjText);
+	WriteText(directory / "cube.mtl", kMtlText);
+
+	TestRoundTrip(directory);
+	TestStaleness(directory);
+	TestIndexSize(directory);
+
+	fs::remove_all(directory);
+	JobSystem::GetInstance()->Finalize();
+	return TestResult();
+}
@@ -0,0 +1,292 @@
+// DynamicBvh の RayCast の打ち切りと、削除済みの葉を使ったときの assert を確かめる
+// 登録・削除・移動・再構築を乱数で繰り返し、各問い合わせの結果を全オブジェクトを順に判定した結果と比べる
+// （木の高さが釣り合っているかも見る）
+
+#include "DynamicBvh.h"
+#include "FrustumCulling.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace MathUtility;
+
+namespace {
+
+using ProxyId = DynamicBvh::ProxyId;
+
+// 登録中のオブジェクト
+struct Object {
+	ProxyId proxy;
+	AABB box; // 太らせる前の境界
+	uint32_t userData;
+};
+
+float RandomFloat(std::mt19937& engine, float min, float max) {
+	return std::uniform_real_distribution<float>(min, max)(engine);
+}
+
+Vector3 RandomVector(std::mt19937& engine, float min, float max) {
+	return {RandomFloat(engine, min, max), RandomFloat(engine, min, max), RandomFloat(engine, min, max)};
+}
+
+AABB RandomBox(std::mt19937& engine, float range, float maxExtent) {
+	return AABBFromCenterExtents(
+	  RandomVector(engine, -range, range), RandomVector(engine, 0.05f, maxExtent));
+}
+
+AABB Translate(const AABB& box, const Vector3& offset) {
+	return {box.min + offset, box.max + offset};
+}
+
+// 問い合わせの結果を集める
+std::vector<ProxyId> Sorted(std::vector<ProxyId> proxies) {
+	std::sort(proxies.begin(), proxies.end());
+	return proxies;
+}
+
+// 木の高さの上限（左右の高さの差が1以下の二分木は、葉が n 個なら高さ 1.44 log2(n + 2) 以下）
+int32_t MaxBalancedHeight(size_t leafCount) {
+	return static_cast<int32_t>(1.4405f * std::log2(static_cast<float>(leafCount) + 2.0f));
+}
+
+// 各問い合わせの結果が、全オブジェクトの太らせたボックスを順に判定した結果と一致するか
+void CheckQueries(const DynamicBvh& bvh, const std::vector<Object>& objects, std::mt19937& engine) {
+	int mismatches = 0;
+	for (const Object& object : objects) {
+		mismatches += !AABBContains(bvh.GetFatAABB(object.proxy), object.box);
+		mismatches += bvh.GetUserData(object.proxy) != object.userData;
+	}
+	CHECK(mismatches == 0);
+	CHECK(bvh.GetProxyCount() == objects.size());
+
+	auto collect = [&](auto&& query) {
+		std::vector<ProxyId> proxies;
+		query([&](ProxyId proxy) {
+			proxies.push_back(proxy);
+			return true;
+		});
+		return Sorted(proxies);
+	};
+	auto bruteForce = [&](auto&& overlaps) {
+		std::vector<ProxyId> proxies;
+		for (const Object& object : objects) {
+			if (overlaps(bvh.GetFatAABB(object.proxy))) {
+				proxies.push_back(object.proxy);
+			}
+		}
+		return Sorted(proxies);
+	};
+
+	for (int i = 0; i < 4; i++) {
+		AABB box = RandomBox(engine, 60.0f, 20.0f);
+		CHECK(
+		  collect([&](auto&& callback) { bvh.QueryAABB(box, callback); }) ==
+		  bruteForce([&](const AABB& fat) { return AABBIntersects(fat, box); }));
+
+		Sphere sphere = {RandomVector(engine, -60.0f, 60.0f), RandomFloat(engine, 1.0f, 25.0f)};
+		CHECK(
+		  collect([&](auto&& callback) { bvh.QuerySphere(sphere, callback); }) ==
+		  bruteForce([&](const AABB& fat) { return AABBIntersectsSphere(fat, sphere); }));
+
+		Vector3 eye = RandomVector(engine, -80.0f, 80.0f);
+		Vector3 target = RandomVector(engine, -20.0f, 20.0f);
+		Frustum frustum = FrustumFromMatrix(
+		  Matrix4LookAtLH(eye, target, {0, 1, 0}) *
+		  Matrix4Perspective(RandomFloat(engine, 0.3f, 1.5f), 16.0f / 9.0f, 0.1f, 120.0f));
+		CHECK(
+		  collect([&](auto&& callback) { bvh.QueryFrustum(frustum, callback); }) ==
+		  bruteForce([&](const AABB& fat) { return FrustumIntersectsAABB(frustum, fat); }));
+
+		// 交差しないと返し続ければ、半直線と重なるボックスをすべて調べる
+		Ray ray = {eye, target - eye};
+		const float maxT = 2.0f;
+		const Vector3 inverseDirection = RayInverseDirection(ray);
+		std::vector<ProxyId> visited;
+		bvh.RayCast(ray, maxT, [&](ProxyId proxy, float t) {
+			visited.push_back(proxy);
+			return t;
+		});
+		CHECK(Sorted(visited) == bruteForce([&](const AABB& fat) {
+			float t;
+			return RayIntersectsAABB(ray, inverseDirection, fat, maxT, t);
+		}));
+	}
+}
+
+// 登録・削除・移動・合わせ直し・再構築を乱数で混ぜる
+void TestRandomOperations() {
+	std::mt19937 engine(1);
+	DynamicBvh bvh(0.5f);
+	std::vector<Object> objects;
+	uint32_t nextUserData = 0;
+	for (int step = 0; step < 4000; step++) {
+		uint32_t op = engine() % 16;
+		if (op < 5 || objects.empty()) {
+			AABB box = RandomBox(engine, 50.0f, 3.0f);
+			objects.push_back({bvh.CreateProxy(box, nextUserData), box, nextUserData});
+			nextUserData++;
+		} else if (op < 7) {
+			// 末尾と入れ替えて削除する
+			size_t i = engine() % objects.size();
+			bvh.DestroyProxy(objects[i].proxy);
+			objects[i] = objects.back();
+			objects.pop_back();
+		} else if (op < 11) {
+			// 少しずつ動かす（太らせたボックスからはみ出したときだけ挿入し直す）
+			Object& object = objects[engine() % objects.size()];
+			Vector3 displacement = RandomVector(engine, -1.0f, 1.0f);
+			object.box = Translate(object.box, displacement);
+			bvh.MoveProxy(object.proxy, object.box, displacement);
+		} else if (op < 13) {
+			// 遠くへ飛ばす
+			Object& object = objects[engine() % objects.size()];
+			object.box = RandomBox(engine, 50.0f, 3.0f);
+			CHECK(bvh.MoveProxy(object.proxy, object.box));
+		} else if (op < 15) {
+			Object& object = objects[engine() % objects.size()];
+			object.box = Translate(object.box, RandomVector(engine, -2.0f, 2.0f));
+			bvh.RefitProxy(object.proxy, object.box);
+		} else if (engine() % 8 == 0) {
+			bvh.Rebuild();
+		} else {
+			bvh.RebuildIfDegraded();
+		}
+
+		if (step % 50 == 0) {
+			bvh.Validate();
+			CheckQueries(bvh, objects, engine);
+		}
+	}
+
+	// 全部削除すると空の木に戻り、ノードを使い回して登録し直せる
+	for (const Object& object : objects) {
+		bvh.DestroyProxy(object.proxy);
+	}
+	objects.clear();
+	bvh.Validate();
+	CHECK(bvh.GetProxyCount() == 0 && bvh.GetHeight() == 0);
+	CheckQueries(bvh, objects, engine);
+	AABB box = RandomBox(engine, 50.0f, 3.0f);
+	objects.push_back({bvh.CreateProxy(box, 7), box, 7});
+	bvh.Rebuild();
+	bvh.Validate();
+	CheckQueries(bvh, objects, engine);
+}
+
+// 挿入・削除・移動だけなら、一列に並べて挿入しても回転で釣り合いが保たれる
+void TestBalance() {
+	std::mt19937 engine(2);
+	DynamicBvh bvh(0.0f);
+	std::vector<Object> objects;
+	for (uint32_t i = 0; i < 4096; i++) {
+		float x = static_cast<float>(i);
+		AABB box = {{x, 0.0f, 0.0f}, {x + 0.5f, 0.5f, 0.5f}};
+		objects.push_back({bvh.CreateProxy(box, i), box, i});
+	}
+	bvh.Validate();
+	CHECK(bvh.GetMaxBalance() <= 1);
+	CHECK(bvh.GetHeight() <= MaxBalancedHeight(objects.size()));
+
+	for (int round = 0; round < 4; round++) {
+		std::shuffle(objects.begin(), objects.end(), engine);
+		for (size_t i = 0; i < objects.size() / 4; i++) {
+			bvh.DestroyProxy(objects.back().proxy);
+			objects.pop_back();
+		}
+		for (Object& object : objects) {
+			if (engine() % 2 == 0) {
+				object.box = RandomBox(engine, 500.0f, 1.0f);
+				bvh.MoveProxy(object.proxy, object.box);
+			}
+		}
+		bvh.Validate();
+		CHECK(bvh.GetMaxBalance() <= 1);
+		CHECK(bvh.GetHeight() <= MaxBalancedHeight(objects.size()));
+		CheckQueries(bvh, objects, engine);
+	}
+
+	// 再構築は表面積で分けるので釣り合いは保証しないが、一列の配置なら半分ずつに分かれる
+	bvh.Rebuild();
+	bvh.Validate();
+	CHECK(bvh.GetHeight() <= 2 * MaxBalancedHeight(objects.size()));
+	CheckQueries(bvh, objects, engine);
+}
+
+// x 軸上に単位立方体を並べる（i 番目は [i, i + 1]）
+DynamicBvh MakeRow(uint32_t count, std::vector<DynamicBvh::ProxyId>& proxies) {
+	DynamicBvh bvh(0.0f);
+	for (uint32_t i = 0; i < count; i++) {
+		float x = static_cast<float>(i);
+		proxies.push_back(bvh.CreateProxy({{x, -0.5f, -0.5f}, {x + 1.0f, 0.5f, 0.5f}}, i));
+	}
+	return bvh;
+}
+
+// 始点で交差したとき（t = 0）は打ち切らず、t = 0 で重なる他のオブジェクトも調べる
+void TestRayCastHitAtOrigin() {
+	std::vector<DynamicBvh::ProxyId> proxies;
+	DynamicBvh bvh = MakeRow(8, proxies);
+	// 始点は 0 番と 1 番の境界上
+	Ray ray = {{1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}};
+	std::vector<uint32_t> visited;
+	bvh.RayCast(ray, 100.0f, [&](DynamicBvh::ProxyId proxy, float) {
+		visited.push_back(bvh.GetUserData(proxy));
+		return 0.0f;
+	});
+	CHECK(visited.size() == 2);
+	CHECK(std::count(visited.begin(), visited.end(), 0u) == 1);
+	CHECK(std::count(visited.begin(), visited.end(), 1u) == 1);
+}
+
+// 負の値を返すとその場で打ち切る
+void TestRayCastAbort() {
+	std::vector<DynamicBvh::ProxyId> proxies;
+	DynamicBvh bvh = MakeRow(8, proxies);
+	Ray ray = {{-10.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}};
+	int calls = 0;
+	bvh.RayCast(ray, 100.0f, [&](DynamicBvh::ProxyId, float) {
+		calls++;
+		return -1.0f;
+	});
+	CHECK(calls == 1);
+
+	// 交差しなければ maxT を返し続けて、すべて調べる
+	calls = 0;
+	bvh.RayCast(ray, 100.0f, [&](DynamicBvh::ProxyId, float maxT) {
+		calls++;
+		return maxT;
+	});
+	CHECK(calls == 8);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	if (argc > 1) {
+		std::vector<DynamicBvh::ProxyId> proxies;
+		DynamicBvh bvh = MakeRow(4, proxies);
+		if (std::strcmp(argv[1], "destroy-twice") == 0) {
+			return ExpectAbort([&] {
+				bvh.DestroyProxy(proxies[1]);
+				bvh.DestroyProxy(proxies[1]);
+			});
+		}
+		if (std::strcmp(argv[1], "move-destroyed") == 0) {
+			return ExpectAbort([&] {
+				bvh.DestroyProxy(proxies[2]);
+				bvh.MoveProxy(proxies[2], {{10, 10, 10}, {11, 11, 11}});
+			});
+		}
+		return 2;
+	}
+
+	TestRayCastHitAtOrigin();
+	TestRayCastAbort();
+	TestRandomOperations();
+	TestBalance();
+	return TestResult();
+}
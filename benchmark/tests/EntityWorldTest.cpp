@@ -0,0 +1,240 @@
+// EntityWorld のアーキタイプ間の移動、削除で最後の行を詰めたときの記録の付け替え、
+// 古い識別子の世代による無効化、アーキタイプが増えたときのクエリの一覧の更新を確かめる
+// （走査中に構造を変更すると assert で止まることも確かめる）
+
+#include "EntityWorld.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct Position {
+	float x, y, z;
+};
+struct Velocity {
+	float x, y, z;
+};
+struct Id {
+	uint32_t value;
+};
+// 1チャンクに入る数を減らして、複数チャンクにまたがる場合を通す
+struct Payload {
+	uint8_t bytes[200];
+};
+
+uint32_t CountEntities(EntityWorld& world) {
+	uint32_t count = 0;
+	world.ForEachChunk<Id>([&](uint32_t chunkCount, const Entity*, Id*) { count += chunkCount; });
+	return count;
+}
+
+// クエリに該当するアーキタイプの数
+template<class... Ts> size_t ArchetypeCount(EntityWorld& world) {
+	return world.Query<Ts...>().size();
+}
+
+// 末尾以外のチャンクは満杯で、チャンクの中のエンティティと記録が一致する
+bool IsPacked(EntityWorld& world) {
+	bool packed = true;
+	for (EntityArchetype* archetype : world.Query<Id>()) {
+		for (size_t i = 0; i < archetype->chunks.size(); i++) {
+			const EntityArchetype::Chunk& chunk = archetype->chunks[i];
+			packed &= chunk.count > 0;
+			packed &= i + 1 == archetype->chunks.size() || chunk.count == archetype->capacity;
+			const Entity* entities = archetype->GetEntities(chunk);
+			const Id* ids = archetype->GetColumn<Id>(chunk);
+			for (uint32_t row = 0; row < chunk.count; row++) {
+				packed &= world.IsAlive(entities[row]);
+				packed &= world.Get<Id>(entities[row]) == ids + row;
+			}
+		}
+	}
+	return packed;
+}
+
+// コンポーネントを足し引きしても、残る種類の値は引き継がれる
+void TestMigration() {
+	EntityWorld world;
+	Entity entity = world.Create(Position{1, 2, 3}, Id{7});
+	CHECK(world.Has<Position>(entity) && !world.Has<Velocity>(entity));
+
+	world.Add(entity, Velocity{4, 5, 6});
+	CHECK(world.Has<Velocity>(entity));
+	CHECK(world.Get<Position>(entity)->y == 2);
+	CHECK(world.Get<Velocity>(entity)->z == 6);
+	CHECK(world.Get<Id>(entity)->value == 7);
+
+	// 既に持っていれば上書きだけで移動しない
+	Position* position = world.Get<Position>(entity);
+	world.Add(entity, Position{9, 9, 9});
+	CHECK(world.Get<Position>(entity) == position && position->x == 9);
+
+	world.Remove<Position>(entity);
+	CHECK(!world.Has<Position>(entity) && world.Get<Position>(entity) == nullptr);
+	CHECK(world.Get<Velocity>(entity)->x == 4);
+	CHECK(world.Get<Id>(entity)->value == 7);
+	// 持っていない種類を外しても何も起きない
+	world.Remove<Position>(entity);
+	CHECK(world.Get<Id>(entity)->value == 7);
+	CHECK(world.GetEntityCount() == 1);
+}
+
+// 乱数で作成・削除・移動を繰り返し、すべてのエンティティの値と記録が正しいままか
+void TestSwapRemove() {
+	std::mt19937 engine(1);
+	EntityWorld world;
+	std::unordered_map<uint32_t, Entity> alive;
+	uint32_t nextId = 0;
+	for (int step = 0; step < 20000; step++) {
+		uint32_t op = engine() % 8;
+		if (op < 4 || alive.empty()) {
+			Entity entity = engine() % 2 == 0 ? world.Create(Id{nextId}, Payload{})
+			                                  : world.Create(Id{nextId}, Position{1, 2, 3});
+			alive[nextId++] = entity;
+			continue;
+		}
+		auto it = alive.begin();
+		std::advance(it, engine() % std::min<size_t>(alive.size(), 16));
+		Entity entity = it->second;
+		if (op < 6) {
+			world.Destroy(entity);
+			alive.erase(it);
+		} else if (op == 6) {
+			world.Add(entity, Velocity{0, 0, 1});
+		} else {
+			world.Remove<Velocity>(entity);
+		}
+	}
+	CHECK(world.GetEntityCount() == alive.size());
+	CHECK(CountEntities(world) == alive.size());
+	CHECK(IsPacked(world));
+	int mismatches = 0;
+	for (const auto& [id, entity] : alive) {
+		mismatches += !world.IsAlive(entity) || world.Get<Id>(entity)->value != id;
+	}
+	CHECK(mismatches == 0);
+
+	// 複数チャンクにまたがる
+	size_t chunkCount = 0;
+	for (EntityArchetype* archetype : world.Query<Id, Payload>()) {
+		chunkCount += archetype->chunks.size();
+	}
+	CHECK(chunkCount > 2);
+}
+
+// 削除した識別子は、同じ番号が再利用されても無効のまま
+void TestGeneration() {
+	EntityWorld world;
+	Entity first = world.Create(Id{1});
+	world.Destroy(first);
+	CHECK(!world.IsAlive(first));
+	CHECK(world.Get<Id>(first) == nullptr);
+
+	Entity second = world.Create(Id{2});
+	CHECK(second.index == first.index && second.generation == first.generation + 1);
+	CHECK(second != first);
+	CHECK(world.IsAlive(second) && !world.IsAlive(first));
+	CHECK(world.Get<Id>(first) == nullptr);
+	CHECK(world.Get<Id>(second)->value == 2);
+
+	// 範囲外の番号も無効
+	CHECK(!world.IsAlive(Entity{100, 0}));
+	CHECK(!world.IsAlive(Entity{}));
+}
+
+// クエリを作った後にできたアーキタイプも、そのクエリの一覧に加わる
+void TestQueryCache() {
+	EntityWorld world;
+	world.Create(Id{1});
+	CHECK(ArchetypeCount<Id>(world) == 1);
+	CHECK(ArchetypeCount<Id, Velocity>(world) == 0);
+	CHECK(CountEntities(world) == 1);
+
+	Entity entity = world.Create(Id{2}, Velocity{});
+	CHECK(ArchetypeCount<Id>(world) == 2);
+	CHECK(ArchetypeCount<Id, Velocity>(world) == 1);
+	CHECK(CountEntities(world) == 2);
+
+	// 移動で新しくできたアーキタイプも加わる
+	world.Add(entity, Position{});
+	CHECK(ArchetypeCount<Id>(world) == 3);
+	CHECK(ArchetypeCount<Id, Velocity>(world) == 2);
+	CHECK(ArchetypeCount<Position>(world) == 1);
+
+	// 無関係なアーキタイプは加わらない
+	world.Create(Position{});
+	CHECK(ArchetypeCount<Id>(world) == 3);
+	CHECK(ArchetypeCount<Position>(world) == 2);
+
+	// アーキタイプが空になっても一覧には残り、走査では飛ばされる
+	world.Destroy(entity);
+	CHECK(ArchetypeCount<Id, Velocity>(world) == 2);
+	uint32_t visited = 0;
+	world.ForEach<Id, Velocity>([&](Id&, Velocity&) { visited++; });
+	CHECK(visited == 0);
+	CHECK(CountEntities(world) == 1);
+}
+
+// 値の書き換えと入れ子の走査は許される
+void TestIterationWrites() {
+	EntityWorld world;
+	for (uint32_t i = 0; i < 1000; i++) {
+		world.Create(Id{i}, Position{0, 0, 0});
+	}
+	world.ForEach<Id, Position>([&](Id& id, Position& position) {
+		position.x = static_cast<float>(id.value);
+	});
+	uint32_t matches = 0;
+	world.ForEachChunk<Id, Position>(
+	  [&](uint32_t count, const Entity* entities, Id* ids, Position* positions) {
+		  for (uint32_t i = 0; i < count; i++) {
+			  matches += positions[i].x == static_cast<float>(ids[i].value);
+			  // 種類が変わらない Add と入れ子の走査は構造を変えない
+			  world.Add(entities[i], Position{1, 1, 1});
+		  }
+		  CHECK(CountEntities(world) == 1000);
+	  });
+	CHECK(matches == 1000);
+	uint32_t overwritten = 0;
+	world.ForEach<Position>([&](Position& position) { overwritten += position.x == 1; });
+	CHECK(overwritten == 1000);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	if (argc > 1) {
+		EntityWorld world;
+		Entity entity = world.Create(Id{0}, Position{});
+		if (std::strcmp(argv[1], "create-in-foreach") == 0) {
+			return ExpectAbort([&] {
+				world.ForEach<Id>([&](Id&) { world.Create(Id{1}, Velocity{}); });
+			});
+		}
+		if (std::strcmp(argv[1], "add-in-foreach") == 0) {
+			return ExpectAbort([&] {
+				world.ForEach<Id>([&](Id&) { world.Add(entity, Velocity{}); });
+			});
+		}
+		if (std::strcmp(argv[1], "destroy-in-foreach") == 0) {
+			return ExpectAbort([&] {
+				world.ForEachChunk<Id>([&](uint32_t, const Entity* entities, Id*) {
+					world.Destroy(entities[0]);
+				});
+			});
+		}
+		return 2;
+	}
+
+	TestMigration();
+	TestSwapRemove();
+	TestGeneration();
+	TestQueryCache();
+	TestIterationWrites();
+	return TestResult();
+}
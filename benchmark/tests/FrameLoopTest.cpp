@@ -0,0 +1,98 @@
+// FrameLoop に経過時間を渡して、ためた時間から進めるステップ数・補間係数・捨てるステップ数を確かめる
+// （ステップ幅は 2 の累乗の分数にして、端数の計算を誤差なく比べる）
+
+#include "FrameLoop.h"
+#include "TestCheck.h"
+
+#include <cmath>
+
+namespace {
+
+// 経過時間をためて、ステップ幅ぶんたまるごとに1ステップ進め、端数は補間係数になる
+void TestAccumulator() {
+	FrameLoop loop(0.25, 5);
+	CHECK(loop.GetAlpha() == 1.0f);
+
+	CHECK(loop.BeginFrame(0.125) == 0);
+	CHECK(loop.GetAlpha() == 0.5f);
+	CHECK(loop.BeginFrame(0.125) == 1);
+	CHECK(loop.GetAlpha() == 0.0f);
+	CHECK(loop.BeginFrame(0.625) == 2);
+	CHECK(loop.GetAlpha() == 0.5f);
+	// 端数は次のフレームに持ち越す
+	CHECK(loop.BeginFrame(0.1875) == 1);
+	CHECK(loop.GetAlpha() == 0.25f);
+
+	// 0 や負の経過時間では進まない
+	CHECK(loop.BeginFrame(0.0) == 0);
+	CHECK(loop.BeginFrame(-1.0) == 0);
+	CHECK(loop.GetAlpha() == 0.25f);
+
+	CHECK(loop.GetStepCount() == 4);
+	CHECK(loop.GetFrameCount() == 6);
+	CHECK(loop.GetSimulatedSeconds() == 1.0);
+	CHECK(loop.GetDroppedStepCount() == 0);
+}
+
+// 1フレームで進めるステップ数には上限があり、超えた分は捨てて端数だけ残す
+void TestCatchUpCap() {
+	FrameLoop loop(0.25, 3);
+	CHECK(loop.BeginFrame(2.125) == 3);
+	CHECK(loop.GetDroppedStepCount() == 5);
+	CHECK(loop.GetAlpha() == 0.5f);
+	// 捨てた分は取り戻さない
+	CHECK(loop.BeginFrame(0.125) == 1);
+	CHECK(loop.GetAlpha() == 0.0f);
+	CHECK(loop.GetStepCount() == 4);
+
+	// ちょうど上限なら捨てない
+	CHECK(loop.BeginFrame(0.75) == 3);
+	CHECK(loop.GetDroppedStepCount() == 5);
+}
+
+// ステップ幅が 2 の累乗でなくても、長く回して端数がずれたりステップ幅を超えたりしない
+void TestLongRun() {
+	FrameLoop loop;
+	const double stepSeconds = FrameLoop::kDefaultStepSeconds;
+	uint64_t steps = 0;
+	bool alphaInRange = true;
+	for (int frame = 0; frame < 100000; frame++) {
+		// 60Hz と 144Hz の間で揺れる
+		steps += loop.BeginFrame(frame % 2 == 0 ? 1.0 / 60.0 : 1.0 / 144.0);
+		alphaInRange &= loop.GetAlpha() >= 0.0f && loop.GetAlpha() <= 1.0f;
+	}
+	CHECK(alphaInRange);
+	CHECK(loop.GetStepCount() == steps);
+	double elapsed = 50000 * (1.0 / 60.0 + 1.0 / 144.0);
+	CHECK(std::abs(steps * stepSeconds + loop.GetAlpha() * stepSeconds - elapsed) < 1e-6);
+	CHECK(loop.GetDroppedStepCount() == 0);
+}
+
+// 全速モードでは経過時間を見ずに決まった数だけ進め、常に最新のステップを描く
+void TestUncapped() {
+	FrameLoop loop(0.25, 5);
+	CHECK(loop.BeginFrame(0.125) == 0);
+	loop.SetMode(FrameLoop::Mode::kUncapped, 3);
+	CHECK(loop.GetMode() == FrameLoop::Mode::kUncapped);
+	CHECK(loop.BeginFrame(0.0) == 3);
+	CHECK(loop.GetAlpha() == 1.0f);
+	CHECK(loop.BeginFrame(100.0) == 3);
+	CHECK(loop.GetDroppedStepCount() == 0);
+	CHECK(loop.GetStepCount() == 6);
+
+	// 実時間に戻すと、全速モードの前にためた端数は捨てる
+	loop.SetMode(FrameLoop::Mode::kRealTime);
+	CHECK(loop.BeginFrame(0.125) == 0);
+	CHECK(loop.GetAlpha() == 0.5f);
+	CHECK(loop.GetFrameCount() == 4);
+}
+
+} // namespace
+
+int main() {
+	TestAccumulator();
+	TestCatchUpCap();
+	TestLongRun();
+	TestUncapped();
+	return TestResult();
+}
@@ -0,0 +1,130 @@
+// FrameScheduler を ManualFrameFence で動かして、待つ時期と完了の判定を確かめる
+//
+// 使い方
+//   frame_scheduler_test                   通常のテスト
+//   frame_scheduler_test end-twice         EndFrame を続けて呼ぶと assert で止まるか
+//   frame_scheduler_test begin-without-end EndFrame の前に BeginFrame を呼ぶと assert で止まるか
+
+#include "FrameScheduler.h"
+#include "TestCheck.h"
+
+#include <cstring>
+
+namespace {
+
+// GPU が止まっているとき、一周追いついたフレームでだけ待ち、待つのは一周前のフレームまで
+void TestWaitOnlyOnLap() {
+	const uint32_t kFrameCount = 3;
+	ManualFrameFence fence;
+	FrameScheduler scheduler(&fence, kFrameCount);
+	CHECK(scheduler.GetFrameCount() == kFrameCount);
+	CHECK(scheduler.GetFrameIndex() == 0);
+
+	for (uint64_t frame = 1; frame <= 10; frame++) {
+		scheduler.EndFrame();
+		uint32_t frameIndex = scheduler.BeginFrame();
+		CHECK(frameIndex == frame % kFrameCount);
+		CHECK(scheduler.GetFrameNumber() == frame);
+		if (frame < kFrameCount) {
+			// まだ使っていない組なので待たない
+			CHECK(scheduler.GetWaitCount() == 0);
+			CHECK(fence.GetCompletedValue() == 0);
+		} else {
+			// フレーム n の通知の値は n + 1。この組を前回使ったフレームまで完了させる
+			CHECK(scheduler.GetWaitCount() == frame - kFrameCount + 1);
+			CHECK(fence.GetCompletedValue() == frame - kFrameCount + 1);
+		}
+		CHECK(fence.GetSignaledValue() == frame);
+	}
+}
+
+// GPU が追いついていれば待たない
+void TestNoWaitWhenGpuKeepsUp() {
+	ManualFrameFence fence;
+	FrameScheduler scheduler(&fence, 2);
+	for (int frame = 0; frame < 10; frame++) {
+		scheduler.EndFrame();
+		fence.Complete(fence.GetSignaledValue());
+		scheduler.BeginFrame();
+	}
+	CHECK(scheduler.GetWaitCount() == 0);
+}
+
+// 組ごとの完了の判定
+void TestIsFrameComplete() {
+	ManualFrameFence fence;
+	FrameScheduler scheduler(&fence, 2);
+	// 使っていない組は完了している
+	CHECK(scheduler.IsFrameComplete(0));
+	CHECK(scheduler.IsFrameComplete(1));
+
+	scheduler.EndFrame(); // 組0 に通知1
+	CHECK(!scheduler.IsFrameComplete(0));
+	CHECK(scheduler.IsFrameComplete(1));
+	scheduler.BeginFrame();
+	scheduler.EndFrame(); // 組1 に通知2
+	CHECK(!scheduler.IsFrameComplete(1));
+
+	fence.Complete(1);
+	CHECK(scheduler.IsFrameComplete(0));
+	CHECK(!scheduler.IsFrameComplete(1));
+	fence.Complete(2);
+	CHECK(scheduler.IsFrameComplete(1));
+}
+
+// WaitIdle は提出済みのすべてを完了させ、何もなければ待たない
+void TestWaitIdle() {
+	ManualFrameFence fence;
+	FrameScheduler scheduler(&fence, 2);
+	scheduler.WaitIdle();
+	CHECK(fence.GetCompletedValue() == 0);
+
+	scheduler.EndFrame();
+	scheduler.BeginFrame();
+	scheduler.EndFrame();
+	CHECK(fence.GetCompletedValue() == 0);
+	scheduler.WaitIdle();
+	CHECK(fence.GetCompletedValue() == fence.GetSignaledValue());
+	CHECK(scheduler.IsFrameComplete(0));
+	CHECK(scheduler.IsFrameComplete(1));
+	// BeginFrame で数える待ちには入らない
+	CHECK(scheduler.GetWaitCount() == 0);
+}
+
+// 1組ならフレームごとに前のフレームの完了を待つ（すべてのフレームを同期させる）
+void TestSingleFrame() {
+	ManualFrameFence fence;
+	FrameScheduler scheduler(&fence, 1);
+	for (uint64_t frame = 1; frame <= 5; frame++) {
+		scheduler.EndFrame();
+		CHECK(scheduler.BeginFrame() == 0);
+		CHECK(fence.GetCompletedValue() == frame);
+	}
+	CHECK(scheduler.GetWaitCount() == 5);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	if (argc > 1) {
+		ManualFrameFence fence;
+		FrameScheduler scheduler(&fence, 2);
+		if (std::strcmp(argv[1], "end-twice") == 0) {
+			return ExpectAbort([&] {
+				scheduler.EndFrame();
+				scheduler.EndFrame();
+			});
+		}
+		if (std::strcmp(argv[1], "begin-without-end") == 0) {
+			return ExpectAbort([&] { scheduler.BeginFrame(); });
+		}
+		return 2;
+	}
+
+	TestWaitOnlyOnLap();
+	TestNoWaitWhenGpuKeepsUp();
+	TestIsFrameComplete();
+	TestWaitIdle();
+	TestSingleFrame();
+	return TestResult();
+}
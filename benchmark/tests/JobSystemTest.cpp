@@ -0,0 +1,88 @@
+// JobSystem の Wait が、ジョブを盗めずに眠っても取りこぼさずに起きてくるかを確かめる
+// （入れ子の ParallelFor、依存ジョブ、他のスレッドで長く動くジョブの完了待ち）
+
+#include "JobSystem.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 各要素にちょうど1回ずつ書き込まれる
+void TestParallelForCoversRange(JobSystem& jobSystem) {
+	for (int repeat = 0; repeat < 200; repeat++) {
+		std::vector<uint32_t> hits(10000, 0);
+		jobSystem.ParallelFor(0, 10000, 64, [&](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; i++) {
+				hits[i]++;
+			}
+		});
+		CHECK(std::all_of(hits.begin(), hits.end(), [](uint32_t hit) { return hit == 1; }));
+	}
+}
+
+// ジョブの中から ParallelFor を呼んでも、すべてのスレッドが待ちに入って止まることがない
+void TestNestedParallelFor(JobSystem& jobSystem) {
+	for (int repeat = 0; repeat < 50; repeat++) {
+		std::atomic<uint32_t> sum = 0;
+		jobSystem.ParallelFor(0, 16, 1, [&](uint32_t, uint32_t) {
+			jobSystem.ParallelFor(0, 256, 16, [&](uint32_t begin, uint32_t end) {
+				sum.fetch_add(end - begin, std::memory_order_relaxed);
+			});
+		});
+		CHECK(sum.load() == 16 * 256);
+	}
+}
+
+// 依存先の完了で積まれるジョブも、Wait の中で眠っているスレッドが起きて待ち終える
+void TestDependency(JobSystem& jobSystem) {
+	for (int repeat = 0; repeat < 200; repeat++) {
+		JobSystem::Counter first;
+		JobSystem::Counter second;
+		std::atomic<int> order = 0;
+		int firstOrder = -1;
+		int secondOrder = -1;
+		jobSystem.Run([&] { firstOrder = order.fetch_add(1); }, &first);
+		jobSystem.Run([&] { secondOrder = order.fetch_add(1); }, &second, &first);
+		jobSystem.Wait(second);
+		CHECK(first.IsDone());
+		CHECK(firstOrder == 0 && secondOrder == 1);
+	}
+}
+
+// 盗めるジョブがない間は眠り、他のスレッドで動いているジョブが終われば起きる
+void TestWaitWakesOnCompletion(JobSystem& jobSystem) {
+	for (int repeat = 0; repeat < 20; repeat++) {
+		JobSystem::Counter counter;
+		std::atomic<bool> started = false;
+		jobSystem.Run(
+		  [&] {
+			  started = true;
+			  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		  },
+		  &counter);
+		// 呼び出し元ではなくワーカーが取るまで待ってから Wait に入る
+		while (!started && !counter.IsDone()) {
+			std::this_thread::yield();
+		}
+		jobSystem.Wait(counter);
+		CHECK(counter.IsDone());
+	}
+}
+
+} // namespace
+
+int main() {
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	jobSystem->Initialize(4);
+	TestParallelForCoversRange(*jobSystem);
+	TestNestedParallelFor(*jobSystem);
+	TestDependency(*jobSystem);
+	TestWaitWakesOnCompletion(*jobSystem);
+	jobSystem->Finalize();
+	return TestResult();
+}
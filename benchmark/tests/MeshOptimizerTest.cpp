@@ -0,0 +1,151 @@
+// MeshOptimizer が三角形を変えずに並べ替えているか、頂点の並びと ACMR を確かめる
+
+#include "MeshOptimizer.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+// 格子の一辺の頂点数
+const uint32_t kGridSize = 32;
+
+// kGridSize x kGridSize の格子（四角形ごとに2つの三角形）。三角形の順番は乱数で混ぜる
+ObjMesh MakeShuffledGrid(uint32_t seed) {
+	ObjMesh mesh;
+	for (uint32_t y = 0; y < kGridSize; y++) {
+		for (uint32_t x = 0; x < kGridSize; x++) {
+			ObjVertex vertex{};
+			vertex.pos = {static_cast<float>(x), static_cast<float>(y), 0.0f};
+			vertex.normal = {0.0f, 0.0f, -1.0f};
+			vertex.uv = {static_cast<float>(x) / kGridSize, static_cast<float>(y) / kGridSize};
+			mesh.vertices.push_back(vertex);
+		}
+	}
+	std::vector<std::array<uint32_t, 3>> triangles;
+	for (uint32_t y = 0; y + 1 < kGridSize; y++) {
+		for (uint32_t x = 0; x + 1 < kGridSize; x++) {
+			uint32_t i0 = y * kGridSize + x;
+			uint32_t i1 = i0 + 1;
+			uint32_t i2 = i0 + kGridSize;
+			uint32_t i3 = i2 + 1;
+			triangles.push_back({i0, i2, i1});
+			triangles.push_back({i1, i2, i3});
+		}
+	}
+	std::mt19937 engine(seed);
+	std::shuffle(triangles.begin(), triangles.end(), engine);
+	for (const std::array<uint32_t, 3>& triangle : triangles) {
+		mesh.indices.insert(mesh.indices.end(), triangle.begin(), triangle.end());
+	}
+	return mesh;
+}
+
+// 頂点の座標で表した三角形（回転だけで正規化するので、向きが逆なら別のものになる）
+using Corner = std::tuple<float, float, float>;
+using Triangle = std::array<Corner, 3>;
+
+std::vector<Triangle> GetTriangles(const ObjMesh& mesh) {
+	std::vector<Triangle> triangles;
+	for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+		Triangle triangle;
+		for (size_t k = 0; k < 3; k++) {
+			const Vector3& pos = mesh.vertices[mesh.indices[i + k]].pos;
+			triangle[k] = {pos.x, pos.y, pos.z};
+		}
+		// 最小の角が先頭に来るよう回す
+		size_t first = std::min_element(triangle.begin(), triangle.end()) - triangle.begin();
+		std::rotate(triangle.begin(), triangle.begin() + first, triangle.end());
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+// 三角形の集合と向きは変わらない
+void TestTrianglesPreserved() {
+	for (bool overdraw : {false, true}) {
+		ObjMesh mesh = MakeShuffledGrid(1);
+		std::vector<Triangle> before = GetTriangles(mesh);
+		MeshOptimizer::Optimize(mesh, overdraw);
+		CHECK(mesh.indices.size() == before.size() * 3);
+		CHECK(GetTriangles(mesh) == before);
+	}
+}
+
+// 頂点は最初に使われる順に並び、使われない頂点は除かれる
+void TestVertexFetchOrder() {
+	ObjMesh mesh = MakeShuffledGrid(2);
+	// どのインデックスからも使われない頂点を間に混ぜる
+	size_t usedCount = mesh.vertices.size();
+	ObjVertex unused{};
+	unused.pos = {-1.0f, -1.0f, -1.0f};
+	mesh.vertices.insert(mesh.vertices.begin() + usedCount / 2, unused);
+	for (uint32_t& index : mesh.indices) {
+		if (index >= usedCount / 2) {
+			index++;
+		}
+	}
+	mesh.vertices.push_back(unused);
+	std::vector<Triangle> before = GetTriangles(mesh);
+
+	size_t remaining = MeshOptimizer::OptimizeVertexFetch(mesh.vertices, mesh.indices);
+	CHECK(remaining == usedCount);
+	CHECK(mesh.vertices.size() == usedCount);
+	uint32_t next = 0;
+	for (uint32_t index : mesh.indices) {
+		CHECK(index <= next);
+		if (index == next) {
+			next++;
+		}
+	}
+	CHECK(next == usedCount);
+	CHECK(GetTriangles(mesh) == before);
+}
+
+// インデックスの数が3の倍数でなければそのまま
+void TestNonTriangleListUnchanged() {
+	ObjMesh mesh = MakeShuffledGrid(3);
+	mesh.indices.push_back(0);
+	std::vector<uint32_t> indices = mesh.indices;
+	size_t vertexCount = mesh.vertices.size();
+
+	MeshOptimizer::Stats stats = MeshOptimizer::Optimize(mesh);
+	CHECK(mesh.indices == indices);
+	CHECK(mesh.vertices.size() == vertexCount);
+	CHECK(stats.after.transformedCount == stats.before.transformedCount);
+}
+
+// 三角形の順番を混ぜた格子では ACMR が悪くならない（実際には大きく良くなる）
+void TestAcmrDoesNotRegress() {
+	for (uint32_t seed = 4; seed < 8; seed++) {
+		ObjMesh cacheOnly = MakeShuffledGrid(seed);
+		double shuffledAcmr =
+		  MeshOptimizer::AnalyzeVertexCache(cacheOnly.indices, cacheOnly.vertices.size()).GetAcmr();
+		MeshOptimizer::OptimizeVertexCache(cacheOnly.indices, cacheOnly.vertices.size());
+		double cacheAcmr =
+		  MeshOptimizer::AnalyzeVertexCache(cacheOnly.indices, cacheOnly.vertices.size()).GetAcmr();
+		CHECK(cacheAcmr <= shuffledAcmr);
+
+		ObjMesh mesh = MakeShuffledGrid(seed);
+		MeshOptimizer::Stats stats = MeshOptimizer::Optimize(mesh);
+		CHECK(stats.before.triangleCount == stats.after.triangleCount);
+		CHECK(stats.after.GetAcmr() <= stats.before.GetAcmr());
+		// オーバードローの並べ替えで許す悪化はキャッシュ最適化の結果に対する割合まで
+		CHECK(stats.after.GetAcmr() <= cacheAcmr * MeshOptimizer::kOverdrawThreshold);
+	}
+}
+
+} // namespace
+
+int main() {
+	TestTrianglesPreserved();
+	TestVertexFetchOrder();
+	TestNonTriangleListUnchanged();
+	TestAcmrDoesNotRegress();
+	return TestResult();
+}
@@ -0,0 +1,164 @@
+// ObjLoader の結果を、従来の読み込み（ObjReferenceLoader）と同じ OBJ テキストで比べる
+// （g・usemtl・mtllib の並び、四角形以上の面、v//vn と v/vt/vn、平滑化を通し、
+//   塊の大きさを変えて塊の境目で行が分かれても同じ結果になるかも確かめる）
+
+#include "JobSystem.h"
+#include "ObjLoader.h"
+#include "ObjReferenceLoader.h"
+#include "TestCheck.h"
+
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace {
+
+// グループの前の面、空のグループ、グループの途中の mtllib・usemtl、三角形・四角形・五角形
+const char kObjText[] = "# comment\n"
+                        "mtllib a.mtl\n"
+                        "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 0 0 1\nv 1 0 1\n"
+                        "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+                        "vn 0 0 1\nvn 1 0 0\nvn 0 1 0\n"
+                        "usemtl beforeGroup\n"
+                        "f 1//1 2//1 3//1\n"
+                        "g first\n"
+                        "usemtl red\n"
+                        "f 1/1/1 2/2/1 3/3/1 4/4/1\n"
+                        "mtllib b.mtl\n"
+                        "usemtl blue\n"
+                        "f 2//2 5//2 6//2\n"
+                        "g empty\n"
+                        "g second\n"
+                        "usemtl green\n"
+                        "f 1/1/1 2/2/2 3/3/3 4/4/1 5/1/2\n"
+                        "f 6//3 1//3 4//3\n"
+                        "g third\n"
+                        "s 1\n"
+                        "f 1//2 2//2 3//1\n"
+                        "f 1//3 3//3 4//3\n";
+
+// 塊の大きさ（1行より小さいものから1つの塊に収まるものまで）
+const size_t kChunkSizes[] = {1, 7, 64, 256, ObjLoader::kDefaultChunkSize};
+
+// 同じテキストを両方で読み、どの塊の大きさでも従来と一致するか
+bool MatchesReference(const std::string& text, bool smoothing) {
+	std::istringstream stream(text);
+	ObjModelData reference;
+	ObjReferenceLoader::Parse(stream, smoothing, reference);
+	bool match = true;
+	for (size_t chunkSize : kChunkSizes) {
+		ObjModelData loaded;
+		match &= ObjLoader::Parse(text, smoothing, loaded, chunkSize);
+		match &= ObjReferenceLoader::Equals(reference, loaded);
+	}
+	return match;
+}
+
+void TestMatchesReference() {
+	for (bool smoothing : {false, true}) {
+		CHECK(MatchesReference(kObjText, smoothing));
+	}
+
+	// 並びそのものも確かめる
+	ObjModelData data;
+	CHECK(ObjLoader::Parse(kObjText, false, data));
+	CHECK(data.materialLibraries == std::vector<std::string>{"a.mtl", "b.mtl"});
+	CHECK(data.meshes.size() == 3);
+	// グループの前の面は最初のグループに入り、頂点のない空のグループは次の g で名前だけ変わる
+	CHECK(data.meshes[0].name == "first" && data.meshes[1].name == "second");
+	CHECK(data.meshes[0].vertices.size() == 3 + 4 + 3);
+	CHECK(data.meshes[0].indices.size() == 3 + 6 + 3);
+	CHECK(data.meshes[0].materialUses.size() == 3);
+	CHECK(data.meshes[0].materialUses[0].name == "beforeGroup");
+	CHECK(data.meshes[0].materialUses[0].libraryCount == 1);
+	CHECK(data.meshes[0].materialUses[2].name == "blue");
+	CHECK(data.meshes[0].materialUses[2].libraryCount == 2);
+	// 四角形は (0, 1, 2) (2, 3, 0)、五角形は続けて (3, 4, 1)
+	const std::vector<uint32_t> pentagon = {0, 1, 2, 2, 3, 0, 3, 4, 1, 5, 6, 7};
+	CHECK(data.meshes[1].indices == pentagon);
+	// vt の v 成分は反転する
+	CHECK(data.meshes[0].vertices[5].uv.x == 1.0f && data.meshes[0].vertices[5].uv.y == 0.0f);
+}
+
+// 乱数で作った OBJ（グループ・マテリアル・面の書き方・頂点数を混ぜる）
+std::string MakeRandomObj(std::mt19937& engine) {
+	std::string text;
+	char buffer[128];
+	const uint32_t positionCount = 40;
+	for (uint32_t i = 0; i < positionCount; i++) {
+		// 平滑化で同じ座標を共有する頂点ができるよう、座標は少ない値から選ぶ
+		std::snprintf(
+		  buffer, sizeof(buffer), "v %d %d %d\n", static_cast<int>(engine() % 5),
+		  static_cast<int>(engine() % 5), static_cast<int>(engine() % 5));
+		text += buffer;
+		std::snprintf(
+		  buffer, sizeof(buffer), "vt %.3f %.3f\n", (engine() % 1000) / 1000.0f,
+		  (engine() % 1000) / 1000.0f);
+		text += buffer;
+		std::snprintf(
+		  buffer, sizeof(buffer), "vn %.3f %.3f %.3f\n", (engine() % 200) / 100.0f - 1.0f,
+		  (engine() % 200) / 100.0f - 1.0f, (engine() % 200) / 100.0f - 1.0f);
+		text += buffer;
+	}
+	for (int line = 0; line < 400; line++) {
+		uint32_t op = engine() % 16;
+		if (op == 0) {
+			text += "g group" + std::to_string(engine() % 8) + "\n";
+		} else if (op == 1) {
+			text += "usemtl material" + std::to_string(engine() % 4) + "\n";
+		} else if (op == 2) {
+			text += "mtllib library" + std::to_string(engine() % 4) + ".mtl\n";
+		} else {
+			text += "f";
+			uint32_t cornerCount = 3 + engine() % 4;
+			bool withTexcoord = engine() % 2 == 0;
+			for (uint32_t corner = 0; corner < cornerCount; corner++) {
+				uint32_t index = 1 + engine() % positionCount;
+				if (withTexcoord) {
+					std::snprintf(buffer, sizeof(buffer), " %u/%u/%u", index, index, index);
+				} else {
+					std::snprintf(buffer, sizeof(buffer), " %u//%u", index, index);
+				}
+				text += buffer;
+			}
+			text += "\n";
+		}
+	}
+	return text;
+}
+
+void TestRandomFiles() {
+	std::mt19937 engine(1);
+	for (int round = 0; round < 50; round++) {
+		std::string text = MakeRandomObj(engine);
+		CHECK(MatchesReference(text, round % 2 == 0));
+	}
+}
+
+// 法線のない書き方（v、v/vt）は無い成分を0にし、範囲外の番号は失敗にする
+void TestOtherFaceFormats() {
+	ObjModelData data;
+	CHECK(ObjLoader::Parse(
+	  "v 1 2 3\nv 4 5 6\nv 7 8 9\nvt 0.25 0.5\nf 1 2 3\nf 3/1 2/1 1/1\n", false, data));
+	CHECK(data.meshes.size() == 1 && data.meshes[0].vertices.size() == 6);
+	const ObjVertex& plain = data.meshes[0].vertices[1];
+	CHECK(plain.pos.x == 4 && plain.pos.z == 6 && plain.normal.y == 0 && plain.uv.x == 0);
+	const ObjVertex& textured = data.meshes[0].vertices[3];
+	CHECK(textured.pos.x == 7 && textured.uv.x == 0.25f && textured.uv.y == 0.5f);
+	CHECK(textured.normal.x == 0 && textured.normal.y == 0 && textured.normal.z == 0);
+
+	CHECK(!ObjLoader::Parse("v 0 0 0\nvn 0 0 1\nf 1//1 1//1 2//1\n", false, data));
+	CHECK(!ObjLoader::Parse("v 0 0 0\nvn 0 0 1\nf 1//1 1//1 1//2\n", false, data));
+}
+
+} // namespace
+
+int main() {
+	JobSystem::GetInstance()->Initialize(4);
+	TestMatchesReference();
+	TestRandomFiles();
+	TestOtherFaceFormats();
+	JobSystem::GetInstance()->Finalize();
+	return TestResult();
+}
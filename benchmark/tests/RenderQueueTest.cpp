@@ -0,0 +1,143 @@
+// RenderQueue のソートキーのビット配置と、基数ソート・挿入ソートの結果を std::stable_sort と比べる
+// （同じキーの要素が追加した順を保つかと、Submit が直前と同じ状態の設定を省くかも確かめる）
+
+#include "RenderQueue.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Item = RenderQueue::Item;
+
+// 各フィールドが宣言した位置に入り、取り出すと元の値に戻る
+void TestKeyLayout() {
+	CHECK(RenderQueue::kDepthShift == 0 && RenderQueue::kTextureShift == 24);
+	CHECK(RenderQueue::kMaterialShift == 40 && RenderQueue::kPipelineShift == 54);
+	CHECK(RenderQueue::kLayerShift == 60);
+
+	CHECK(RenderQueue::MakeKey(1, 0, 0, 0, 0.0f) == uint64_t(1) << 60);
+	CHECK(RenderQueue::MakeKey(0, 1, 0, 0, 0.0f) == uint64_t(1) << 54);
+	CHECK(RenderQueue::MakeKey(0, 0, 1, 0, 0.0f) == uint64_t(1) << 40);
+	CHECK(RenderQueue::MakeKey(0, 0, 0, 1, 0.0f) == uint64_t(1) << 24);
+	CHECK(RenderQueue::MakeKey(0, 0, 0, 0, 1.0f) == RenderQueue::kMaxDepth);
+
+	uint64_t key = RenderQueue::MakeKey(9, 33, 1234, 54321, 0.5f);
+	CHECK(RenderQueue::GetLayer(key) == 9);
+	CHECK(RenderQueue::GetPipeline(key) == 33);
+	CHECK(RenderQueue::GetMaterial(key) == 1234);
+	CHECK(RenderQueue::GetTexture(key) == 54321);
+	CHECK(RenderQueue::GetDepth(key) == static_cast<uint32_t>(0.5f * RenderQueue::kMaxDepth));
+
+	// 範囲外は最大値に丸め、隣のフィールドへはみ出さない
+	key = RenderQueue::MakeKey(100, 100, 100000, 100000, 2.0f);
+	CHECK(key == ~uint64_t(0));
+	key = RenderQueue::MakeKey(0, 0, 0, 100000, 0.0f);
+	CHECK(RenderQueue::GetTexture(key) == RenderQueue::kMaxTexture);
+	CHECK(RenderQueue::GetMaterial(key) == 0);
+
+	// 負の深度と NaN は 0 に寄せる
+	CHECK(RenderQueue::GetDepth(RenderQueue::MakeKey(0, 0, 0, 0, -1.0f)) == 0);
+	CHECK(RenderQueue::GetDepth(RenderQueue::MakeKey(0, 0, 0, 0, std::nanf(""))) == 0);
+
+	// 深度の並べ方
+	using DepthOrder = RenderQueue::DepthOrder;
+	CHECK(
+	  RenderQueue::MakeKey(0, 0, 0, 0, 0.25f, DepthOrder::kFrontToBack) <
+	  RenderQueue::MakeKey(0, 0, 0, 0, 0.75f, DepthOrder::kFrontToBack));
+	CHECK(
+	  RenderQueue::MakeKey(0, 0, 0, 0, 0.25f, DepthOrder::kBackToFront) >
+	  RenderQueue::MakeKey(0, 0, 0, 0, 0.75f, DepthOrder::kBackToFront));
+	CHECK(
+	  RenderQueue::GetDepth(RenderQueue::MakeKey(0, 0, 0, 0, 0.0f, DepthOrder::kBackToFront)) ==
+	  RenderQueue::kMaxDepth);
+
+	// 上位のフィールドが深度より優先される
+	CHECK(RenderQueue::MakeKey(0, 1, 0, 0, 0.0f) > RenderQueue::MakeKey(0, 0, 5, 9, 1.0f));
+}
+
+// 乱数のキー（値の種類を絞って同じキーを多く作る）を std::stable_sort と同じ順に並べる
+void TestSortMatchesStableSort() {
+	std::mt19937 engine(1);
+	RenderQueue queue;
+	for (uint32_t count : {0u, 1u, 10u, 63u, 64u, 65u, 1000u, 100000u}) {
+		for (int round = 0; round < 3; round++) {
+			std::vector<Item> expected;
+			queue.Clear();
+			for (uint32_t i = 0; i < count; i++) {
+				uint64_t key = RenderQueue::MakeKey(
+				  engine() % 3, engine() % 4, engine() % 8, engine() % 16,
+				  static_cast<float>(engine() % 32) / 31.0f);
+				if (round == 2) {
+					// 全ビットを使うキー（どのパスも省けない）
+					key = (uint64_t(engine()) << 32) | engine();
+					key &= engine() % 4 == 0 ? ~uint64_t(0xffff) : ~uint64_t(0);
+				}
+				queue.Push(key, i);
+				expected.push_back({key, i});
+			}
+			std::stable_sort(expected.begin(), expected.end(), [](const Item& a, const Item& b) {
+				return a.key < b.key;
+			});
+			queue.Sort();
+			int mismatches = 0;
+			for (uint32_t i = 0; i < count; i++) {
+				const Item& item = queue.GetItems()[i];
+				mismatches += item.key != expected[i].key || item.payload != expected[i].payload;
+			}
+			CHECK(queue.GetItemCount() == count && mismatches == 0);
+		}
+	}
+
+	// 全要素が同じキーなら追加した順のまま
+	queue.Clear();
+	for (uint32_t i = 0; i < 1000; i++) {
+		queue.Push(RenderQueue::MakeKey(1, 2, 3, 4, 0.5f), i);
+	}
+	queue.Sort();
+	bool inOrder = true;
+	for (uint32_t i = 0; i < 1000; i++) {
+		inOrder &= queue.GetItems()[i].payload == i;
+	}
+	CHECK(inOrder);
+}
+
+// 呼ばれた設定と描画を記録する
+struct RecordingBackend {
+	std::vector<uint32_t> calls;
+
+	void SetPipeline(uint32_t pipeline) { calls.push_back(0x100 + pipeline); }
+	void SetMaterial(uint32_t material) { calls.push_back(0x200 + material); }
+	void SetTexture(uint32_t texture) { calls.push_back(0x300 + texture); }
+	void Draw(uint32_t payload) { calls.push_back(payload); }
+};
+
+// 直前と同じ状態は設定せず、パイプラインを替えたらマテリアルとテクスチャも設定し直す
+void TestSubmitSkipsRedundantState() {
+	RenderQueue queue;
+	queue.Push(RenderQueue::MakeKey(0, 0, 1, 1, 0.1f), 0);
+	queue.Push(RenderQueue::MakeKey(0, 0, 1, 1, 0.2f), 1);
+	queue.Push(RenderQueue::MakeKey(0, 0, 1, 2, 0.3f), 2);
+	queue.Push(RenderQueue::MakeKey(0, 1, 1, 2, 0.4f), 3);
+	queue.Sort();
+	RecordingBackend backend;
+	const RenderQueue::Stats& stats = queue.Submit(backend);
+	CHECK(
+	  backend.calls ==
+	  std::vector<uint32_t>{0x100, 0x201, 0x301, 0, 1, 0x302, 2, 0x101, 0x201, 0x302, 3});
+	CHECK(stats.drawCount == 4);
+	CHECK(stats.pipelineChanges == 2 && stats.materialChanges == 2 && stats.textureChanges == 3);
+	CHECK(stats.skippedChanges == 4 * 3 - stats.GetStateChanges());
+}
+
+} // namespace
+
+int main() {
+	TestKeyLayout();
+	TestSortMatchesStableSort();
+	TestSubmitSkipsRedundantState();
+	return TestResult();
+}
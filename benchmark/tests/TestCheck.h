@@ -0,0 +1,53 @@
+#pragma once
+
+// テスト用の簡単な確認
+// CHECK は失敗しても続けて、最後に TestResult() で終了コードを返す。
+// assert で止まることを確かめるときは ExpectAbort を使う（1回の実行で1つだけ）
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef NDEBUG
+#error "テストは assert を有効にしてビルドする（NDEBUG を外す）"
+#endif
+
+namespace TestCheck {
+
+inline int& FailureCount() {
+	static int count = 0;
+	return count;
+}
+
+inline void Fail(const char* expression, const char* file, int line) {
+	std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+	FailureCount()++;
+}
+
+} // namespace TestCheck
+
+// 条件にテンプレート引数のカンマを含めてもよいよう、可変長引数で受ける
+#define CHECK(...)                                                                                \
+	((__VA_ARGS__) ? (void)0 : TestCheck::Fail(#__VA_ARGS__, __FILE__, __LINE__))
+
+/// <summary>
+/// 失敗した CHECK がなければ 0
+/// </summary>
+inline int TestResult() {
+	if (TestCheck::FailureCount() != 0) {
+		std::fprintf(stderr, "%d check(s) failed\n", TestCheck::FailureCount());
+		return 1;
+	}
+	return 0;
+}
+
+/// <summary>
+/// func が assert などで abort することを確かめる（abort したら成功としてその場で終了する）
+/// </summary>
+template<class Func>
+int ExpectAbort(const Func& func) {
+	std::signal(SIGABRT, [](int) { std::_Exit(0); });
+	func();
+	std::fprintf(stderr, "expected abort, but returned\n");
+	return 1;
+}
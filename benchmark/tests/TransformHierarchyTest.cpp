@@ -0,0 +1,269 @@
+// TransformHierarchy のワールド行列を、親をたどって掛け合わせた結果と比べる
+// （SetParent・Destroy による並べ替えと、部分木の分割・隣り合う範囲のまとめを通す）
+
+#include "JobSystem.h"
+#include "Matrix4Multiply.h"
+#include "TestCheck.h"
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+using NodeId = TransformHierarchy::NodeId;
+
+float RandomFloat(std::mt19937& engine, float min, float max) {
+	return std::uniform_real_distribution<float>(min, max)(engine);
+}
+
+void SetRandomTransform(TransformHierarchy& hierarchy, NodeId node, std::mt19937& engine) {
+	hierarchy.SetScale(
+	  node, {RandomFloat(engine, 0.8f, 1.2f), RandomFloat(engine, 0.8f, 1.2f),
+	         RandomFloat(engine, 0.8f, 1.2f)});
+	Vector3 rotation = {
+	  RandomFloat(engine, -3.0f, 3.0f), RandomFloat(engine, -3.0f, 3.0f),
+	  RandomFloat(engine, -3.0f, 3.0f)};
+	if (engine() % 2 == 0) {
+		hierarchy.SetRotation(node, rotation);
+	} else {
+		hierarchy.SetQuaternion(node, Quaternion::MakeFromEuler(rotation));
+	}
+	hierarchy.SetTranslation(
+	  node, {RandomFloat(engine, -5.0f, 5.0f), RandomFloat(engine, -5.0f, 5.0f),
+	         RandomFloat(engine, -5.0f, 5.0f)});
+}
+
+// 親をたどってローカル行列を掛け合わせる
+Matrix4 ReferenceWorld(
+  const TransformHierarchy& hierarchy, NodeId node, std::unordered_map<NodeId, Matrix4>& cache) {
+	auto it = cache.find(node);
+	if (it != cache.end()) {
+		return it->second;
+	}
+	Matrix4 local =
+	  hierarchy.UsesQuaternion(node)
+	    ? Matrix4::MakeAffine(
+	        hierarchy.GetScale(node), hierarchy.GetQuaternion(node), hierarchy.GetTranslation(node))
+	    : Matrix4::MakeAffine(
+	        hierarchy.GetScale(node), hierarchy.GetRotation(node), hierarchy.GetTranslation(node));
+	Matrix4 world = local;
+	NodeId parent = hierarchy.GetParent(node);
+	if (parent != TransformHierarchy::kInvalidNode) {
+		MathUtility::Matrix4Multiply(local, ReferenceWorld(hierarchy, parent, cache), world);
+	}
+	cache[node] = world;
+	return world;
+}
+
+bool NearlyEqual(const Matrix4& a, const Matrix4& b) {
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			if (std::abs(a.m[i][j] - b.m[i][j]) > 1e-4f * (1.0f + std::abs(b.m[i][j]))) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// すべてのノードのワールド行列が親をたどった結果と一致するか
+void CheckWorldMatrices(const TransformHierarchy& hierarchy, const std::vector<NodeId>& nodes) {
+	std::unordered_map<NodeId, Matrix4> cache;
+	int mismatches = 0;
+	for (NodeId node : nodes) {
+		mismatches +=
+		  !NearlyEqual(hierarchy.GetWorldMatrix(node), ReferenceWorld(hierarchy, node, cache));
+	}
+	CHECK(mismatches == 0);
+}
+
+// 範囲は並び順に整列して重ならず、隣り合う範囲は grainSize を超えない限りまとめられている
+void CheckRanges(std::span<const TransformHierarchy::Range> ranges, uint32_t grainSize) {
+	for (size_t i = 0; i < ranges.size(); i++) {
+		CHECK(ranges[i].begin < ranges[i].end);
+		if (i > 0) {
+			CHECK(ranges[i - 1].end <= ranges[i].begin);
+			if (ranges[i - 1].end == ranges[i].begin) {
+				CHECK(ranges[i].end - ranges[i - 1].begin > grainSize);
+			}
+		}
+	}
+}
+
+// 範囲を逆順に処理しても結果が変わらない（範囲どうしが独立している）
+void UpdateReversed(TransformHierarchy& hierarchy, uint32_t grainSize) {
+	std::span<const TransformHierarchy::Range> ranges = hierarchy.PrepareUpdate(grainSize);
+	CheckRanges(ranges, grainSize);
+	for (size_t i = ranges.size(); i-- > 0;) {
+		hierarchy.UpdateRange(ranges[i]);
+	}
+	hierarchy.FinishUpdate();
+}
+
+void UpdateParallel(TransformHierarchy& hierarchy, uint32_t grainSize) {
+	std::span<const TransformHierarchy::Range> ranges = hierarchy.PrepareUpdate(grainSize);
+	CheckRanges(ranges, grainSize);
+	JobSystem::GetInstance()->ParallelFor(
+	  0, static_cast<uint32_t>(ranges.size()), hierarchy.GetRangeGrainSize(),
+	  [&](uint32_t begin, uint32_t end) {
+		  for (uint32_t i = begin; i < end; i++) {
+			  hierarchy.UpdateRange(ranges[i]);
+		  }
+	  });
+	hierarchy.FinishUpdate();
+}
+
+// 乱数で作った木（浅く広い部分と深い鎖を含む）
+std::vector<NodeId>
+MakeForest(TransformHierarchy& hierarchy, std::mt19937& engine, uint32_t count) {
+	std::vector<NodeId> nodes;
+	for (uint32_t i = 0; i < count; i++) {
+		NodeId parent = TransformHierarchy::kInvalidNode;
+		if (!nodes.empty() && engine() % 8 != 0) {
+			// 半分は直前のノードにつないで深い鎖を作る
+			parent = engine() % 2 == 0 ? nodes.back() : nodes[engine() % nodes.size()];
+		}
+		NodeId node = hierarchy.Create(parent);
+		SetRandomTransform(hierarchy, node, engine);
+		nodes.push_back(node);
+	}
+	return nodes;
+}
+
+bool IsDescendant(const TransformHierarchy& hierarchy, NodeId node, NodeId ancestor) {
+	for (NodeId n = node; n != TransformHierarchy::kInvalidNode; n = hierarchy.GetParent(n)) {
+		if (n == ancestor) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// 分割と範囲のまとめを通しても、すべてのノードが正しく更新される
+void TestSplitRanges() {
+	std::mt19937 engine(1);
+	TransformHierarchy hierarchy;
+	std::vector<NodeId> nodes = MakeForest(hierarchy, engine, 3000);
+	for (uint32_t grainSize : {1u, 4u, 16u, 256u, 100000u}) {
+		for (NodeId node : nodes) {
+			SetRandomTransform(hierarchy, node, engine);
+		}
+		UpdateReversed(hierarchy, grainSize);
+		CheckWorldMatrices(hierarchy, nodes);
+		CHECK(hierarchy.GetUpdatedNodes().size() == nodes.size());
+	}
+
+	// 離れた小さな部分木だけが変更されたときも、1ジョブに複数の範囲をまとめる
+	std::vector<NodeId> roots;
+	TransformHierarchy flat;
+	for (uint32_t i = 0; i < 1000; i++) {
+		NodeId root = flat.Create();
+		flat.Create(root);
+		roots.push_back(root);
+	}
+	flat.Update();
+	for (size_t i = 0; i < roots.size(); i += 2) {
+		flat.SetTranslation(roots[i], {1, 2, 3});
+	}
+	std::span<const TransformHierarchy::Range> ranges = flat.PrepareUpdate(64);
+	CHECK(ranges.size() == 500);
+	CHECK(flat.GetRangeGrainSize() == 32);
+	for (const TransformHierarchy::Range& range : ranges) {
+		flat.UpdateRange(range);
+	}
+	flat.FinishUpdate();
+
+	// 隣り合う部分木がすべて変更されたときは grainSize ずつの範囲にまとまる
+	for (NodeId root : roots) {
+		flat.SetTranslation(root, {3, 2, 1});
+	}
+	ranges = flat.PrepareUpdate(64);
+	CHECK(ranges.size() == 2000 / 64 + 1);
+	CheckRanges(ranges, 64);
+	for (const TransformHierarchy::Range& range : ranges) {
+		flat.UpdateRange(range);
+	}
+	flat.FinishUpdate();
+	CHECK(flat.GetUpdatedNodes().size() == 2000);
+}
+
+// SetParent・Destroy・Create と変換の変更を乱数で繰り返す
+void TestRandomEdits() {
+	std::mt19937 engine(2);
+	TransformHierarchy hierarchy;
+	std::vector<NodeId> nodes = MakeForest(hierarchy, engine, 500);
+	hierarchy.Update();
+
+	for (int round = 0; round < 200; round++) {
+		for (int edit = 0; edit < 8; edit++) {
+			uint32_t op = engine() % 4;
+			NodeId node = nodes[engine() % nodes.size()];
+			if (op == 0) {
+				// 自分の子孫でない親に付け替える（ルートにすることもある）
+				NodeId parent = engine() % 4 == 0 ? TransformHierarchy::kInvalidNode
+				                                  : nodes[engine() % nodes.size()];
+				if (
+				  parent == TransformHierarchy::kInvalidNode ||
+				  !IsDescendant(hierarchy, parent, node)) {
+					hierarchy.SetParent(node, parent);
+					CHECK(hierarchy.GetParent(node) == parent);
+				}
+			} else if (op == 1 && nodes.size() > 50) {
+				hierarchy.Destroy(node);
+				nodes.erase(
+				  std::remove_if(
+				    nodes.begin(), nodes.end(), [&](NodeId n) { return !hierarchy.IsValid(n); }),
+				  nodes.end());
+			} else if (op == 2) {
+				NodeId child =
+				  hierarchy.Create(engine() % 2 == 0 ? node : TransformHierarchy::kInvalidNode);
+				SetRandomTransform(hierarchy, child, engine);
+				nodes.push_back(child);
+			} else {
+				SetRandomTransform(hierarchy, node, engine);
+			}
+		}
+		CHECK(hierarchy.GetNodeCount() == nodes.size());
+
+		// ワールド行列が変わったノードはすべて更新済みの一覧に入っている
+		std::vector<Matrix4> before;
+		for (NodeId node : nodes) {
+			before.push_back(hierarchy.GetWorldMatrix(node));
+		}
+		uint32_t grainSize = 1u << (engine() % 8);
+		if (round % 2 == 0) {
+			UpdateReversed(hierarchy, grainSize);
+		} else {
+			UpdateParallel(hierarchy, grainSize);
+		}
+		CheckWorldMatrices(hierarchy, nodes);
+
+		std::unordered_set<NodeId> updated(
+		  hierarchy.GetUpdatedNodes().begin(), hierarchy.GetUpdatedNodes().end());
+		CHECK(updated.size() == hierarchy.GetUpdatedNodes().size());
+		int missed = 0;
+		for (size_t i = 0; i < nodes.size(); i++) {
+			const Matrix4& after = hierarchy.GetWorldMatrix(nodes[i]);
+			if (std::memcmp(&before[i], &after, sizeof(Matrix4)) != 0 && !updated.count(nodes[i])) {
+				missed++;
+			}
+		}
+		CHECK(missed == 0);
+	}
+}
+
+} // namespace
+
+int main() {
+	JobSystem::GetInstance()->Initialize(4);
+	TestSplitRanges();
+	TestRandomEdits();
+	JobSystem::GetInstance()->Finalize();
+	return TestResult();
+}
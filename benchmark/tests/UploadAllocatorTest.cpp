@@ -0,0 +1,203 @@
+// UploadAllocator を CpuUploadPageBackend で動かして、切り出しと回収を確かめる
+
+#include "TestCheck.h"
+#include "UploadAllocator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// テストで使う小さなページ（定数バッファ4つ分）
+const uint64_t kPageSize = 1024;
+
+bool IsAligned(uint64_t value, uint64_t alignment) { return value % alignment == 0; }
+
+// 切り出した領域が CPU 側でも GPU 側でも互いに重ならないか
+bool IsDisjoint(const std::vector<UploadAllocation>& allocations) {
+	std::vector<std::pair<uint64_t, uint64_t>> cpuRanges;
+	std::vector<std::pair<uint64_t, uint64_t>> gpuRanges;
+	for (const UploadAllocation& allocation : allocations) {
+		uint64_t cpu = reinterpret_cast<uintptr_t>(allocation.cpuAddress);
+		cpuRanges.push_back({cpu, cpu + allocation.size});
+		gpuRanges.push_back({allocation.gpuAddress, allocation.gpuAddress + allocation.size});
+	}
+	for (std::vector<std::pair<uint64_t, uint64_t>>* ranges : {&cpuRanges, &gpuRanges}) {
+		std::sort(ranges->begin(), ranges->end());
+		for (size_t i = 1; i < ranges->size(); i++) {
+			if ((*ranges)[i].first < (*ranges)[i - 1].second) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// 256 バイト境界に揃い、同じフレームの中では重ならない
+void TestAlignmentAndNoOverlap() {
+	CpuUploadPageBackend backend;
+	UploadAllocator allocator(&backend, 2, kPageSize);
+	std::vector<UploadAllocation> allocations;
+	const uint32_t sizes[] = {1, 64, 255, 256, 257, 100, 512, 4, 768, 16};
+	for (uint32_t size : sizes) {
+		UploadAllocation allocation = allocator.Allocate(size);
+		CHECK(allocation.size == size);
+		CHECK(IsAligned(reinterpret_cast<uintptr_t>(allocation.cpuAddress), 256));
+		CHECK(IsAligned(allocation.gpuAddress, 256));
+		std::memset(allocation.cpuAddress, 0xcd, size);
+		allocations.push_back(allocation);
+	}
+	// 256 より大きい境界も守る
+	UploadAllocation aligned = allocator.Allocate(16, 512);
+	CHECK(IsAligned(reinterpret_cast<uintptr_t>(aligned.cpuAddress), 512));
+	CHECK(IsAligned(aligned.gpuAddress, 512));
+	allocations.push_back(aligned);
+	CHECK(IsDisjoint(allocations));
+}
+
+// ページに収まらなくなったら次のページに移る
+void TestPageRollover() {
+	CpuUploadPageBackend backend;
+	UploadAllocator allocator(&backend, 1, kPageSize);
+	CHECK(allocator.GetPageCount() == 0);
+
+	UploadAllocation first = allocator.Allocate(256);
+	for (int i = 0; i < 3; i++) {
+		allocator.Allocate(256);
+	}
+	CHECK(allocator.GetPageCount() == 1);
+	CHECK(allocator.GetFrameUsedBytes() == kPageSize);
+
+	// 5つ目は新しいページの先頭から
+	UploadAllocation next = allocator.Allocate(256);
+	CHECK(allocator.GetPageCount() == 2);
+	CHECK(backend.GetCreatedPageCount() == 2);
+	CHECK(IsDisjoint({first, next}));
+
+	// 残りに収まらない要求は、前のページの空きを残して次のページに移る
+	allocator.Allocate(512);
+	allocator.Allocate(512);
+	CHECK(allocator.GetPageCount() == 3);
+}
+
+// BeginFrame はその枠のページだけを回収し、回収したページを使い回す
+void TestBeginFrameRecyclesOnlyThatSlot() {
+	const uint32_t kFrameCount = 2;
+	CpuUploadPageBackend backend;
+	UploadAllocator allocator(&backend, kFrameCount, kPageSize);
+
+	// 枠0 で2ページ分使う
+	allocator.BeginFrame(0);
+	std::vector<UploadAllocation> frame0;
+	for (int i = 0; i < 8; i++) {
+		UploadAllocation allocation = allocator.Allocate(256);
+		std::memset(allocation.cpuAddress, 0x10 + i, 256);
+		frame0.push_back(allocation);
+	}
+	CHECK(allocator.GetPageCount() == 2);
+
+	// 枠1 は枠0 のページを使わない（GPU がまだ読んでいるかもしれない）
+	allocator.BeginFrame(1);
+	CHECK(allocator.GetFrameUsedBytes() == 0);
+	std::vector<UploadAllocation> frame1;
+	for (int i = 0; i < 8; i++) {
+		frame1.push_back(allocator.Allocate(256));
+		std::memset(frame1.back().cpuAddress, 0x80 + i, 256);
+	}
+	CHECK(allocator.GetPageCount() == 4);
+	std::vector<UploadAllocation> both = frame0;
+	both.insert(both.end(), frame1.begin(), frame1.end());
+	CHECK(IsDisjoint(both));
+	// 枠0 の内容は壊れていない
+	for (int i = 0; i < 8; i++) {
+		const uint8_t* data = frame0[i].As<uint8_t>();
+		CHECK(data[0] == 0x10 + i && data[255] == 0x10 + i);
+	}
+
+	// 枠0 を回収して使い直しても、枠1 の内容は残る
+	allocator.BeginFrame(0);
+	std::vector<UploadAllocation> reused;
+	for (int i = 0; i < 8; i++) {
+		reused.push_back(allocator.Allocate(256));
+		std::memset(reused.back().cpuAddress, 0xff, 256);
+	}
+	for (int i = 0; i < 8; i++) {
+		const uint8_t* data = frame1[i].As<uint8_t>();
+		CHECK(data[0] == 0x80 + i && data[255] == 0x80 + i);
+	}
+	both = reused;
+	both.insert(both.end(), frame1.begin(), frame1.end());
+	CHECK(IsDisjoint(both));
+
+	// 同じ使い方を続ける間は新しいページを作らない
+	uint32_t createdCount = backend.GetCreatedPageCount();
+	CHECK(createdCount == 4);
+	for (uint32_t frame = 0; frame < 100; frame++) {
+		allocator.BeginFrame(frame % kFrameCount);
+		for (int i = 0; i < 8; i++) {
+			allocator.Allocate(256);
+		}
+	}
+	CHECK(backend.GetCreatedPageCount() == createdCount);
+	CHECK(allocator.GetPageCount() == createdCount);
+	CHECK(backend.GetLivePageCount() == createdCount);
+}
+
+// ページより大きな要求は専用のページを作り、その枠の回収で破棄する
+void TestLargePagesDestroyedOnRecycle() {
+	CpuUploadPageBackend backend;
+	UploadAllocator allocator(&backend, 2, kPageSize);
+
+	allocator.BeginFrame(0);
+	UploadAllocation large = allocator.Allocate(static_cast<uint32_t>(kPageSize) + 1);
+	CHECK(large.size == kPageSize + 1);
+	CHECK(IsAligned(large.gpuAddress, 256));
+	std::memset(large.cpuAddress, 0x5a, large.size);
+	CHECK(backend.GetLivePageCount() == 1);
+	// 専用のページは使い回すページに数えない
+	CHECK(allocator.GetPageCount() == 0);
+	UploadAllocation small = allocator.Allocate(256);
+	CHECK(IsDisjoint({large, small}));
+	CHECK(backend.GetLivePageCount() == 2);
+
+	// 別の枠の開始では破棄しない
+	allocator.BeginFrame(1);
+	CHECK(backend.GetLivePageCount() == 2);
+	CHECK(large.As<uint8_t>()[kPageSize] == 0x5a);
+
+	// 同じ枠の開始で破棄し、通常のページは残す
+	allocator.BeginFrame(0);
+	CHECK(backend.GetLivePageCount() == 1);
+	CHECK(allocator.GetPageCount() == 1);
+}
+
+// 破棄するとすべてのページをバックエンドに返す
+void TestDestructionReleasesAllPages() {
+	CpuUploadPageBackend backend;
+	{
+		UploadAllocator allocator(&backend, 3, kPageSize);
+		for (uint32_t frame = 0; frame < 3; frame++) {
+			allocator.BeginFrame(frame);
+			for (int i = 0; i < 6; i++) {
+				allocator.Allocate(200);
+			}
+			allocator.Allocate(static_cast<uint32_t>(kPageSize) * 2);
+		}
+		CHECK(backend.GetLivePageCount() > 0);
+	}
+	CHECK(backend.GetLivePageCount() == 0);
+}
+
+} // namespace
+
+int main() {
+	TestAlignmentAndNoOverlap();
+	TestPageRollover();
+	TestBeginFrameRecyclesOnlyThatSlot();
+	TestLargePagesDestroyedOnRecycle();
+	TestDestructionReleasesAllPages();
+	return TestResult();
+}
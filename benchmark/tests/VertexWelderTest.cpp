@@ -0,0 +1,175 @@
+// VertexWelder の対応表と詰め直しを、頂点のバイト列で引く単純な表の結果と比べる
+// （-0 と 0・NaN の比較がビット単位になるか、インデックスが16ビットに収まるようになる場合も確かめる）
+
+#include "JobSystem.h"
+#include "TestCheck.h"
+#include "VertexWelder.h"
+
+#include <cstring>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+ObjVertex MakeVertex(float x, float y = 0.0f, float u = 0.0f) {
+	return {{x, y, 0.0f}, {0.0f, 0.0f, 1.0f}, {u, 0.0f}};
+}
+
+bool BitwiseEqual(const ObjVertex& a, const ObjVertex& b) {
+	return std::memcmp(&a, &b, sizeof(ObjVertex)) == 0;
+}
+
+// 頂点のバイト列で引く表で作った対応（最初に現れた順に番号を振る）
+uint32_t ReferenceRemap(const std::vector<ObjVertex>& vertices, std::vector<uint32_t>& remap) {
+	std::map<std::string, uint32_t> numbers;
+	remap.clear();
+	for (const ObjVertex& vertex : vertices) {
+		std::string bytes(reinterpret_cast<const char*>(&vertex), sizeof(ObjVertex));
+		auto [it, inserted] = numbers.emplace(bytes, static_cast<uint32_t>(numbers.size()));
+		remap.push_back(it->second);
+	}
+	return static_cast<uint32_t>(numbers.size());
+}
+
+// 面の頂点を1つずつ頂点にしたメッシュ（値の種類を絞って重複を作る）
+ObjMesh MakeRandomMesh(std::mt19937& engine, uint32_t triangleCount, uint32_t valueCount) {
+	ObjMesh mesh;
+	mesh.name = "random";
+	for (uint32_t i = 0; i < triangleCount * 3; i++) {
+		mesh.vertices.push_back(MakeVertex(
+		  static_cast<float>(engine() % valueCount), static_cast<float>(engine() % 2),
+		  static_cast<float>(engine() % 2)));
+		mesh.indices.push_back(i);
+	}
+	return mesh;
+}
+
+// 詰め直した後も、各インデックスが指す頂点は元と同じ
+bool SameTriangles(const ObjMesh& before, const ObjMesh& after) {
+	if (before.indices.size() != after.indices.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < before.indices.size(); i++) {
+		if (!BitwiseEqual(before.vertices[before.indices[i]], after.vertices[after.indices[i]])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// 同じ頂点は最初に現れたものの番号になり、番号は現れた順に振られる
+void TestRemap() {
+	std::vector<ObjVertex> vertices = {
+	  MakeVertex(1), MakeVertex(2), MakeVertex(1), MakeVertex(3), MakeVertex(2), MakeVertex(1)};
+	std::vector<uint32_t> remap;
+	CHECK(VertexWelder::BuildRemap(vertices, remap) == 3);
+	CHECK(remap == std::vector<uint32_t>{0, 1, 0, 2, 1, 0});
+
+	vertices.clear();
+	CHECK(VertexWelder::BuildRemap(vertices, remap) == 0);
+	CHECK(remap.empty());
+
+	// 乱数の頂点で単純な表と比べる（表が埋まって探査が長くなる場合も通す）
+	std::mt19937 engine(1);
+	for (uint32_t valueCount : {1u, 4u, 100u, 100000u}) {
+		ObjMesh mesh = MakeRandomMesh(engine, 5000, valueCount);
+		std::vector<uint32_t> expected;
+		uint32_t expectedCount = ReferenceRemap(mesh.vertices, expected);
+		CHECK(VertexWelder::BuildRemap(mesh.vertices, remap) == expectedCount);
+		CHECK(remap == expected);
+	}
+}
+
+// 比較はビット単位（-0 と 0 は別、同じビットの NaN は同じ、ペイロードの違う NaN は別）
+void TestBitwiseKeys() {
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	uint32_t otherNanBits;
+	std::memcpy(&otherNanBits, &nan, sizeof(float));
+	otherNanBits |= 1;
+	float otherNan;
+	std::memcpy(&otherNan, &otherNanBits, sizeof(float));
+
+	std::vector<ObjVertex> vertices = {
+	  MakeVertex(0.0f), MakeVertex(-0.0f),    MakeVertex(0.0f),       MakeVertex(nan),
+	  MakeVertex(nan),  MakeVertex(otherNan), MakeVertex(0.0f, -0.0f)};
+	std::vector<uint32_t> remap;
+	CHECK(VertexWelder::BuildRemap(vertices, remap) == 5);
+	CHECK(remap == std::vector<uint32_t>{0, 1, 0, 2, 2, 3, 4});
+}
+
+// 詰め直しは最初に現れた順に並べ、インデックスを付け替える
+void TestWeld() {
+	ObjMesh mesh;
+	mesh.vertices = {MakeVertex(1), MakeVertex(2), MakeVertex(3),
+	                 MakeVertex(3), MakeVertex(2), MakeVertex(4)};
+	mesh.indices = {0, 1, 2, 3, 4, 5};
+	ObjMesh before = mesh;
+	VertexWelder::Stats stats = VertexWelder::Weld(mesh);
+	CHECK(mesh.vertices.size() == 4);
+	CHECK(mesh.indices == std::vector<uint32_t>{0, 1, 2, 2, 1, 3});
+	CHECK(BitwiseEqual(mesh.vertices[3], MakeVertex(4)));
+	CHECK(SameTriangles(before, mesh));
+	CHECK(stats.vertexCountBefore == 6 && stats.vertexCountAfter == 4 && stats.indexCount == 6);
+	CHECK(stats.indexBytesBefore == 12 && stats.indexBytesAfter == 12);
+	CHECK(stats.GetBytesBefore() == 6 * sizeof(ObjVertex) + 12);
+	CHECK(stats.GetBytesAfter() == 4 * sizeof(ObjVertex) + 12);
+	CHECK(stats.GetVertexRatio() == 1.5);
+
+	// 重複がなければ何も変えない
+	before = mesh;
+	stats = VertexWelder::Weld(mesh);
+	CHECK(stats.vertexCountAfter == 4 && mesh.indices == before.indices);
+
+	// まとめた結果、インデックスが16ビットに収まるようになる
+	std::mt19937 engine(2);
+	mesh = MakeRandomMesh(engine, 30000, 20000);
+	before = mesh;
+	stats = VertexWelder::Weld(mesh);
+	CHECK(stats.vertexCountBefore == 90000 && stats.vertexCountAfter <= 80000);
+	CHECK(stats.vertexCountAfter == mesh.vertices.size());
+	CHECK(stats.indexBytesBefore == 90000 * 4 && stats.indexBytesAfter == 90000 * 2);
+	CHECK(SameTriangles(before, mesh));
+}
+
+// 複数のメッシュを並列に処理しても、1つずつ処理した結果と同じで、統計は合計になる
+void TestWeldModel() {
+	std::mt19937 engine(3);
+	ObjModelData data;
+	for (uint32_t i = 0; i < 8; i++) {
+		data.meshes.push_back(MakeRandomMesh(engine, 1000 + i * 500, 50 + i * 100));
+	}
+	ObjModelData expected = data;
+	VertexWelder::Stats expectedStats;
+	for (ObjMesh& mesh : expected.meshes) {
+		expectedStats += VertexWelder::Weld(mesh);
+	}
+	VertexWelder::Stats stats = VertexWelder::Weld(data);
+	int mismatches = 0;
+	for (size_t i = 0; i < data.meshes.size(); i++) {
+		const ObjMesh& mesh = data.meshes[i];
+		mismatches += mesh.indices != expected.meshes[i].indices;
+		mismatches += mesh.vertices.size() != expected.meshes[i].vertices.size() ||
+		              std::memcmp(
+		                mesh.vertices.data(), expected.meshes[i].vertices.data(),
+		                mesh.vertices.size() * sizeof(ObjVertex)) != 0;
+	}
+	CHECK(mismatches == 0);
+	CHECK(stats.vertexCountBefore == expectedStats.vertexCountBefore);
+	CHECK(stats.vertexCountAfter == expectedStats.vertexCountAfter);
+	CHECK(stats.indexBytesAfter == expectedStats.indexBytesAfter);
+}
+
+} // namespace
+
+int main() {
+	JobSystem::GetInstance()->Initialize(4);
+	TestRemap();
+	TestBitwiseKeys();
+	TestWeld();
+	TestWeldModel();
+	JobSystem::GetInstance()->Finalize();
+	return TestResult();
+}
@@ -6,6 +6,9 @@
 #include "AxisIndicator.h"
 #include "PrimitiveDrawer.h"
 #include "Global.h"
+#include "FrameLoop.h"
+#include "JobSystem.h"
+#include "ModelRenderQueue.h"
 
 // Windowsアプリでのエントリーポイント(main関数)
 int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
@@ -17,6 +20,7 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	DebugText* debugText = nullptr;
 	AxisIndicator* axisIndicator = nullptr;
 	PrimitiveDrawer* primitiveDrawer = nullptr;
+	JobSystem* jobSystem = nullptr;
 	GameScene* gameScene = nullptr;
 
 	// ゲームウィンドウの作成
@@ -28,6 +32,10 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	dxCommon->Initialize(win);
 
 #pragma region 汎用機能初期化
+	// ジョブシステム初期化（処理順を固定してデバッグしたい場合は Initialize(1)）
+	jobSystem = JobSystem::GetInstance();
+	jobSystem->Initialize();
+
 	// 入力の初期化
 	input = Input::GetInstance();
 	input->Initialize();
@@ -49,6 +57,8 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
 	// 3Dモデル静的初期化
 	Model::StaticInitialize();
+	// 3Dモデルのインスタンス描画用パイプライン生成
+	ModelRenderQueue::StaticInitialize();
 
 	// 軸方向表示初期化
 	axisIndicator = AxisIndicator::GetInstance();
@@ -62,6 +72,9 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	gameScene = new GameScene();
 	gameScene->Initialize();
 
+	// シミュレーションは 1/60 秒の固定ステップで進め、描画はステップの間を補間する
+	FrameLoop frameLoop;
+
 	// メインループ
 	while (true) {
 		// メッセージ処理
@@ -71,8 +84,14 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
 		// 入力関連の毎フレーム処理
 		input->Update();
-		// ゲームシーンの毎フレーム処理
-		gameScene->Update();
+		// ゲームシーンの固定ステップ処理（描画の間隔に応じて0回以上）
+		uint32_t stepCount = frameLoop.BeginFrame();
+		for (uint32_t i = 0; i < stepCount; i++) {
+			gameScene->Update();
+		}
+		// カメラは入力と同じくフレームごとに1回更新する
+		gameScene->UpdateCamera();
+		gameScene->Interpolate(frameLoop.GetAlpha());
 		// 軸表示の更新
 		axisIndicator->Update();
 
@@ -88,9 +107,13 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		dxCommon->PostDraw();
 	}
 
+	// 描画中の資源を解放しないよう、GPU の完了を待つ
+	dxCommon->WaitForGpuIdle();
+
 	// 各種解放
 	SafeDelete(gameScene);
 	audio->Finalize();
+	jobSystem->Finalize();
 
 	// ゲームウィンドウの破棄
 	win->TerminateGameWindow();
@@ -0,0 +1,34 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <new>
+
+/// <summary>
+/// 指定境界にそろえて確保するアロケータ（SIMD 用の配列に使う）
+/// </summary>
+/// <typeparam name="T">要素の型</typeparam>
+/// <typeparam name="Alignment">境界（バイト）</typeparam>
+template<class T, size_t Alignment> class AlignedAllocator {
+  public:
+	using value_type = T;
+
+	template<class U> struct rebind {
+		using other = AlignedAllocator<U, Alignment>;
+	};
+
+	AlignedAllocator() noexcept = default;
+	template<class U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+	T* allocate(size_t n) {
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+	}
+
+	void deallocate(T* p, size_t) noexcept { ::operator delete(p, std::align_val_t(Alignment)); }
+
+	template<class U> bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+		return true;
+	}
+	template<class U> bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept {
+		return false;
+	}
+};
@@ -0,0 +1,212 @@
+﻿#include "FastMath.h"
+#include <cassert>
+
+namespace MathUtility {
+
+namespace {
+
+#if MATH_SIMD_X86
+
+// mask が立っている要素は a、それ以外は b を選ぶ
+inline __m128 Select(__m128 mask, __m128 a, __m128 b) {
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+const __m128 kSignMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000u)));
+
+// 以下のカーネルはスカラー版（FastMath.h）と同じ順序で演算する
+
+__m128 RsqrtSSE2(__m128 x, MathPrecision precision) {
+	__m128 y = _mm_rsqrt_ps(x);
+	if (precision == MathPrecision::kFast) {
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 threeHalves = _mm_set1_ps(1.5f);
+		__m128 hxyy = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(half, x), y), y);
+		y = _mm_mul_ps(y, _mm_sub_ps(threeHalves, hxyy));
+	}
+	return y;
+}
+
+void SinCosSSE2(__m128 x, __m128& sin, __m128& cos, MathPrecision precision) {
+	using namespace FastMathDetail;
+	const __m128 ax = _mm_andnot_ps(kSignMask, x);
+	__m128i j = _mm_cvttps_epi32(_mm_mul_ps(ax, _mm_set1_ps(kFourOverPi)));
+	j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+	const __m128 fj = _mm_cvtepi32_ps(j);
+
+	__m128 r = _mm_sub_ps(ax, _mm_mul_ps(fj, _mm_set1_ps(kPiOver4Part1)));
+	r = _mm_sub_ps(r, _mm_mul_ps(fj, _mm_set1_ps(kPiOver4Part2)));
+	r = _mm_sub_ps(r, _mm_mul_ps(fj, _mm_set1_ps(kPiOver4Part3)));
+	const __m128 z = _mm_mul_ps(r, r);
+
+	__m128 ps, pc;
+	if (precision == MathPrecision::kFast) {
+		ps = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), z), _mm_set1_ps(8.3321608736e-3f));
+		ps = _mm_sub_ps(_mm_mul_ps(ps, z), _mm_set1_ps(1.6666654611e-1f));
+		ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, z), r), r);
+
+		pc = _mm_sub_ps(
+		  _mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), z), _mm_set1_ps(1.388731625493765e-3f));
+		pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(4.166664568298827e-2f));
+		pc = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(pc, z), z), _mm_mul_ps(_mm_set1_ps(0.5f), z));
+		pc = _mm_add_ps(pc, _mm_set1_ps(1.0f));
+	} else {
+		ps = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(8.3333333e-3f), z), _mm_set1_ps(1.6666667e-1f));
+		ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, z), r), r);
+
+		pc = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(4.1666667e-2f), z), _mm_set1_ps(0.5f));
+		pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(1.0f));
+	}
+
+	const __m128i two = _mm_set1_epi32(2);
+	const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, two), two));
+	const __m128 s = Select(swap, pc, ps);
+	const __m128 c = Select(swap, ps, pc);
+
+	// 象限のビット2を符号ビットの位置へ移す
+	const __m128i four = _mm_set1_epi32(4);
+	const __m128 sinSign = _mm_xor_ps(
+	  _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, four), 29)), _mm_and_ps(x, kSignMask));
+	const __m128 cosSign =
+	  _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(j, two), four), 29));
+	sin = _mm_xor_ps(s, sinSign);
+	cos = _mm_xor_ps(c, cosSign);
+}
+
+__m128 Atan2SSE2(__m128 y, __m128 x, MathPrecision precision) {
+	using namespace FastMathDetail;
+	const __m128 ax = _mm_andnot_ps(kSignMask, x);
+	const __m128 ay = _mm_andnot_ps(kSignMask, y);
+	const __m128 maxValue = _mm_max_ps(ax, ay);
+	const __m128 zero = _mm_cmpeq_ps(maxValue, _mm_setzero_ps());
+	__m128 t = _mm_div_ps(_mm_min_ps(ax, ay), maxValue);
+
+	const __m128 one = _mm_set1_ps(1.0f);
+	__m128 angle;
+	if (precision == MathPrecision::kFast) {
+		const __m128 reduce = _mm_cmpgt_ps(t, _mm_set1_ps(0.4142135623730950f));
+		t = Select(reduce, _mm_div_ps(_mm_sub_ps(t, one), _mm_add_ps(t, one)), t);
+		const __m128 offset = _mm_and_ps(reduce, _mm_set1_ps(kPi * 0.25f));
+		const __m128 z = _mm_mul_ps(t, t);
+		__m128 p = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(8.05374449538e-2f), z), _mm_set1_ps(1.38776856032e-1f));
+		p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.99777106478e-1f));
+		p = _mm_sub_ps(_mm_mul_ps(p, z), _mm_set1_ps(3.33329491539e-1f));
+		angle = _mm_add_ps(_mm_add_ps(offset, _mm_mul_ps(_mm_mul_ps(p, z), t)), t);
+	} else {
+		const __m128 p = _mm_add_ps(_mm_set1_ps(0.2447f), _mm_mul_ps(_mm_set1_ps(0.0663f), t));
+		angle = _mm_sub_ps(
+		  _mm_mul_ps(_mm_set1_ps(kPi * 0.25f), t), _mm_mul_ps(_mm_mul_ps(t, _mm_sub_ps(t, one)), p));
+	}
+
+	angle = Select(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(kHalfPi), angle), angle);
+	angle = Select(
+	  _mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(kPi), angle), angle);
+	angle = _mm_or_ps(angle, _mm_and_ps(y, kSignMask));
+	return _mm_andnot_ps(zero, angle);
+}
+
+__m128 AcosSSE2(__m128 x, MathPrecision precision) {
+	using namespace FastMathDetail;
+	const __m128 ax = _mm_andnot_ps(kSignMask, x);
+	const __m128 one = _mm_set1_ps(1.0f);
+	__m128 acosAbs;
+	if (precision == MathPrecision::kFast) {
+		const __m128 reduce = _mm_cmpgt_ps(ax, _mm_set1_ps(0.5f));
+		const __m128 z =
+		  Select(reduce, _mm_mul_ps(_mm_set1_ps(0.5f), _mm_sub_ps(one, ax)), _mm_mul_ps(ax, ax));
+		const __m128 a = Select(reduce, _mm_sqrt_ps(z), ax);
+		__m128 p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(4.2163199048e-2f), z), _mm_set1_ps(2.4181311049e-2f));
+		p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(4.5470025998e-2f));
+		p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(7.4953002686e-2f));
+		p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.6666752422e-1f));
+		const __m128 asinA = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, z), a), a);
+		acosAbs = Select(
+		  reduce, _mm_mul_ps(_mm_set1_ps(2.0f), asinA), _mm_sub_ps(_mm_set1_ps(kHalfPi), asinA));
+	} else {
+		__m128 p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-0.0187293f), ax), _mm_set1_ps(0.0742610f));
+		p = _mm_sub_ps(_mm_mul_ps(p, ax), _mm_set1_ps(0.2121144f));
+		p = _mm_add_ps(_mm_mul_ps(p, ax), _mm_set1_ps(1.5707288f));
+		acosAbs = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(one, ax)), p);
+	}
+	return Select(
+	  _mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(FastMathDetail::kPi), acosAbs),
+	  acosAbs);
+}
+
+#endif
+
+} // namespace
+
+void RsqrtArray(std::span<const float> x, std::span<float> out, MathPrecision precision) {
+	assert(out.size() == x.size());
+	const size_t count = x.size();
+	size_t i = 0;
+#if MATH_SIMD_X86
+	if (precision != MathPrecision::kExact) {
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(out.data() + i, RsqrtSSE2(_mm_loadu_ps(x.data() + i), precision));
+		}
+	}
+#endif
+	for (; i < count; i++) {
+		out[i] = Rsqrt(x[i], precision);
+	}
+}
+
+void SinCosArray(
+  std::span<const float> x, std::span<float> sin, std::span<float> cos, MathPrecision precision) {
+	assert(sin.size() == x.size() && cos.size() == x.size());
+	const size_t count = x.size();
+	size_t i = 0;
+#if MATH_SIMD_X86
+	if (precision != MathPrecision::kExact) {
+		for (; i + 4 <= count; i += 4) {
+			__m128 s, c;
+			SinCosSSE2(_mm_loadu_ps(x.data() + i), s, c, precision);
+			_mm_storeu_ps(sin.data() + i, s);
+			_mm_storeu_ps(cos.data() + i, c);
+		}
+	}
+#endif
+	for (; i < count; i++) {
+		SinCos(x[i], sin[i], cos[i], precision);
+	}
+}
+
+void Atan2Array(
+  std::span<const float> y, std::span<const float> x, std::span<float> out,
+  MathPrecision precision) {
+	assert(x.size() == y.size() && out.size() == y.size());
+	const size_t count = y.size();
+	size_t i = 0;
+#if MATH_SIMD_X86
+	if (precision != MathPrecision::kExact) {
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(
+			  out.data() + i,
+			  Atan2SSE2(_mm_loadu_ps(y.data() + i), _mm_loadu_ps(x.data() + i), precision));
+		}
+	}
+#endif
+	for (; i < count; i++) {
+		out[i] = Atan2(y[i], x[i], precision);
+	}
+}
+
+void AcosArray(std::span<const float> x, std::span<float> out, MathPrecision precision) {
+	assert(out.size() == x.size());
+	const size_t count = x.size();
+	size_t i = 0;
+#if MATH_SIMD_X86
+	if (precision != MathPrecision::kExact) {
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(out.data() + i, AcosSSE2(_mm_loadu_ps(x.data() + i), precision));
+		}
+	}
+#endif
+	for (; i < count; i++) {
+		out[i] = Acos(x[i], precision);
+	}
+}
+
+} // namespace MathUtility
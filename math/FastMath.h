@@ -0,0 +1,233 @@
+﻿#pragma once
+
+#include "MathSimd.h"
+#include "Vector3.h"
+#include <cmath>
+#include <cstdint>
+#include <span>
+
+namespace MathUtility {
+
+/// <summary>
+/// 計算精度の段階（呼び出し側で用途に合わせて選ぶ）
+/// </summary>
+enum class MathPrecision {
+	kExact,  // 標準ライブラリと同じ結果
+	kFast,   // 多項式近似・Newton 法で float の精度をほぼ保つ
+	kApprox, // 低次の近似（見た目に影響しない演出・カリング向け）
+};
+
+// 各段階の最大誤差（double で計算した値との比較による実測値を、有効数字2桁に切り上げたもの）
+// math_benchmark --verify で測り直し、超えていれば失敗する。スカラー版と一括版の大きい方
+// 測定範囲：rsqrt は [1e-30, 1e30] の対数一様 2^24 点、
+// sincos は [-8192, 8192]、atan2 は原点中心の円周上の全方向、acos は [-1, 1] をそれぞれ等間隔に 2^24 点
+// rsqrt は相対誤差、それ以外は絶対誤差（ラジアン）
+// rsqrt の kApprox は rsqrtss の近似が CPU ごとに異なるため、仕様上の上限 1.5 * 2^-12 を使う（実測 3.3e-4）
+const float kRsqrtFastMaxError = 2.8e-7f;
+const float kRsqrtApproxMaxError = 3.7e-4f;
+const float kSinCosFastMaxError = 7.8e-8f;
+const float kSinCosApproxMaxError = 3.3e-4f;
+const float kAtan2FastMaxError = 2.9e-7f;
+const float kAtan2ApproxMaxError = 1.6e-3f;
+const float kAcosFastMaxError = 3.1e-7f;
+const float kAcosApproxMaxError = 6.8e-5f;
+
+// sincos の高速版が精度を保てる入力範囲（これを超えると範囲縮約の誤差が増える）
+const float kSinCosFastMaxInput = 8192.0f;
+
+namespace FastMathDetail {
+
+// π/4 を3分割した定数（範囲縮約の桁落ちを防ぐ）
+const float kPiOver4Part1 = 0.78515625f;
+const float kPiOver4Part2 = 2.4187564849853515625e-4f;
+const float kPiOver4Part3 = 3.77489497744594108e-8f;
+const float kFourOverPi = 1.27323954473516f;
+const float kHalfPi = 1.57079632679489661923f;
+const float kPi = 3.14159265358979323846f;
+
+// 符号ビットを付け替える
+inline float CopySign(float magnitude, float sign) { return std::copysign(magnitude, sign); }
+
+} // namespace FastMathDetail
+
+/// <summary>
+/// 平方根の逆数 1 / √x
+/// </summary>
+/// <param name="x">入力（正の値）</param>
+/// <param name="precision">精度</param>
+inline float Rsqrt(float x, MathPrecision precision = MathPrecision::kExact) {
+	if (precision != MathPrecision::kExact) {
+#if MATH_SIMD_X86
+		// rsqrtss は約12bit 精度。kFast は Newton 法を1回かけて約23bit にする
+		float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+		if (precision == MathPrecision::kFast) {
+			y = y * (1.5f - 0.5f * x * y * y);
+		}
+		return y;
+#endif
+	}
+	// SIMD が無い環境では全段階とも正確な計算を行う
+	return 1.0f / std::sqrt(x);
+}
+
+/// <summary>
+/// sin と cos を同時に求める
+/// </summary>
+/// <param name="x">角度（ラジアン）。kFast / kApprox は |x| ≦ kSinCosFastMaxInput</param>
+/// <param name="sin">sin(x) の格納先</param>
+/// <param name="cos">cos(x) の格納先</param>
+/// <param name="precision">精度</param>
+inline void SinCos(float x, float& sin, float& cos, MathPrecision precision = MathPrecision::kExact) {
+	using namespace FastMathDetail;
+	if (precision == MathPrecision::kExact) {
+		sin = std::sin(x);
+		cos = std::cos(x);
+		return;
+	}
+
+	// |x| を π/4 単位の偶数象限 j に丸め、r = |x| - j * π/4 ∈ [-π/4, π/4] に縮約する
+	float ax = std::fabs(x);
+	int32_t j = static_cast<int32_t>(ax * kFourOverPi);
+	j = (j + 1) & ~1;
+	float fj = static_cast<float>(j);
+	float r = ((ax - fj * kPiOver4Part1) - fj * kPiOver4Part2) - fj * kPiOver4Part3;
+	float z = r * r;
+
+	float ps, pc;
+	if (precision == MathPrecision::kFast) {
+		ps = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * r + r;
+		pc = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) *
+		       z * z -
+		     0.5f * z + 1.0f;
+	} else {
+		ps = (8.3333333e-3f * z - 1.6666667e-1f) * z * r + r;
+		pc = (4.1666667e-2f * z - 0.5f) * z + 1.0f;
+	}
+
+	// 象限に応じて sin/cos を入れ替え、符号を決める
+	bool swap = (j & 2) != 0;
+	float s = swap ? pc : ps;
+	float c = swap ? ps : pc;
+	bool sinNegative = ((j & 4) != 0) != (x < 0.0f);
+	bool cosNegative = ((j + 2) & 4) != 0;
+	sin = sinNegative ? -s : s;
+	cos = cosNegative ? -c : c;
+}
+
+/// <summary>
+/// atan2(y, x)
+/// </summary>
+/// <param name="y">y成分</param>
+/// <param name="x">x成分</param>
+/// <param name="precision">精度</param>
+/// <returns>角度 [-π, π]（x = y = 0 のときは0）</returns>
+inline float Atan2(float y, float x, MathPrecision precision = MathPrecision::kExact) {
+	using namespace FastMathDetail;
+	if (precision == MathPrecision::kExact) {
+		return std::atan2(y, x);
+	}
+
+	float ax = std::fabs(x);
+	float ay = std::fabs(y);
+	float maxValue = ax > ay ? ax : ay;
+	if (maxValue == 0.0f) {
+		return 0.0f;
+	}
+	// t = min/max ∈ [0, 1] の atan を求め、八分円ごとに展開する
+	float t = (ax > ay ? ay : ax) / maxValue;
+
+	float angle;
+	if (precision == MathPrecision::kFast) {
+		// tan(π/8) を超える範囲は atan(t) = π/4 + atan((t-1)/(t+1)) で縮約する
+		float offset = 0.0f;
+		if (t > 0.4142135623730950f) {
+			t = (t - 1.0f) / (t + 1.0f);
+			offset = kPi * 0.25f;
+		}
+		float z = t * t;
+		angle = offset +
+		        (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z -
+		         3.33329491539e-1f) *
+		          z * t +
+		        t;
+	} else {
+		angle = kPi * 0.25f * t - t * (t - 1.0f) * (0.2447f + 0.0663f * t);
+	}
+
+	if (ay > ax) {
+		angle = kHalfPi - angle;
+	}
+	if (x < 0.0f) {
+		angle = kPi - angle;
+	}
+	return CopySign(angle, y);
+}
+
+/// <summary>
+/// acos(x)
+/// </summary>
+/// <param name="x">入力 [-1, 1]</param>
+/// <param name="precision">精度</param>
+/// <returns>角度 [0, π]</returns>
+inline float Acos(float x, MathPrecision precision = MathPrecision::kExact) {
+	using namespace FastMathDetail;
+	if (precision == MathPrecision::kExact) {
+		return std::acos(x);
+	}
+
+	float ax = std::fabs(x);
+	if (precision == MathPrecision::kFast) {
+		// asin の多項式を使う。|x| > 0.5 は asin(x) = π/2 - 2 asin(√((1-x)/2)) で縮約する
+		float a, z;
+		bool reduced = ax > 0.5f;
+		if (reduced) {
+			z = 0.5f * (1.0f - ax);
+			a = std::sqrt(z);
+		} else {
+			z = ax * ax;
+			a = ax;
+		}
+		float asinA =
+		  ((((4.2163199048e-2f * z + 2.4181311049e-2f) * z + 4.5470025998e-2f) * z +
+		    7.4953002686e-2f) *
+		     z +
+		   1.6666752422e-1f) *
+		    z * a +
+		  a;
+		float acosAbs = reduced ? 2.0f * asinA : kHalfPi - asinA;
+		return x < 0.0f ? kPi - acosAbs : acosAbs;
+	}
+
+	// Abramowitz & Stegun 4.4.45
+	float acosAbs =
+	  std::sqrt(1.0f - ax) * (((-0.0187293f * ax + 0.0742610f) * ax - 0.2121144f) * ax + 1.5707288f);
+	return x < 0.0f ? kPi - acosAbs : acosAbs;
+}
+
+/// <summary>
+/// 正規化する（長さ0のベクトルはそのまま）
+/// </summary>
+/// <param name="v">ベクトル</param>
+/// <param name="precision">精度</param>
+inline Vector3& Vector3Normalize(Vector3& v, MathPrecision precision) {
+	float lengthSq = v.Dot(v);
+	if (lengthSq == 0) {
+		return v;
+	}
+	if (precision == MathPrecision::kExact) {
+		return v /= std::sqrt(lengthSq);
+	}
+	return v *= Rsqrt(lengthSq, precision);
+}
+
+// 一括計算（出力の要素数は入力と同じであること）
+// kFast / kApprox は SSE2 で4要素ずつ処理し、結果は上のスカラー版と同じ段階の精度になる
+void RsqrtArray(std::span<const float> x, std::span<float> out, MathPrecision precision);
+void SinCosArray(
+  std::span<const float> x, std::span<float> sin, std::span<float> cos, MathPrecision precision);
+void Atan2Array(
+  std::span<const float> y, std::span<const float> x, std::span<float> out,
+  MathPrecision precision);
+void AcosArray(std::span<const float> x, std::span<float> out, MathPrecision precision);
+
+} // namespace MathUtility
@@ -0,0 +1,359 @@
+﻿#include "FrustumCulling.h"
+#include <cassert>
+#include <cmath>
+
+namespace MathUtility {
+
+Frustum FrustumFromMatrix(const Matrix4& viewProjection) {
+	// 行ベクトル規約なので、クリップ座標の各成分の係数は行列の各列になる
+	const Matrix4& m = viewProjection;
+	auto column = [&m](int j) -> Plane {
+		return {{m.m[0][j], m.m[1][j], m.m[2][j]}, m.m[3][j]};
+	};
+	auto add = [](const Plane& a, const Plane& b) -> Plane {
+		return {a.normal + b.normal, a.distance + b.distance};
+	};
+	auto sub = [](const Plane& a, const Plane& b) -> Plane {
+		return {a.normal - b.normal, a.distance - b.distance};
+	};
+	const Plane x = column(0), y = column(1), z = column(2), w = column(3);
+
+	Frustum frustum;
+	frustum.planes[0] = add(w, x); // 左   -w <= x
+	frustum.planes[1] = sub(w, x); // 右    x <= w
+	frustum.planes[2] = add(w, y); // 下   -w <= y
+	frustum.planes[3] = sub(w, y); // 上    y <= w
+	frustum.planes[4] = z;         // 近    0 <= z
+	frustum.planes[5] = sub(w, z); // 遠    z <= w
+	for (Plane& plane : frustum.planes) {
+		float length = Vector3Length(plane.normal);
+		if (length > 0.0f) {
+			plane.normal /= length;
+			plane.distance /= length;
+		}
+	}
+	return frustum;
+}
+
+namespace {
+
+// 1要素分の判定（Geometry.h の判定と同じ順序で計算する）
+inline bool SphereVisible(const Frustum& frustum, float x, float y, float z, float radius) {
+	for (const Plane& plane : frustum.planes) {
+		float distance = plane.normal.x * x + plane.normal.y * y + plane.normal.z * z + plane.distance;
+		if (distance < -radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+inline bool AABBVisible(
+  const Frustum& frustum, float cx, float cy, float cz, float ex, float ey, float ez) {
+	for (const Plane& plane : frustum.planes) {
+		float distance =
+		  plane.normal.x * cx + plane.normal.y * cy + plane.normal.z * cz + plane.distance;
+		float radius = std::abs(plane.normal.x) * ex + std::abs(plane.normal.y) * ey +
+		               std::abs(plane.normal.z) * ez;
+		if (distance < -radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// 先頭 start 要素を処理済みとして、残りをスカラーで判定する
+uint32_t CullSpheresTail(
+  const Frustum& frustum, const SphereSoAConstSpan& spheres, uint32_t* out, uint32_t visible,
+  size_t start, uint32_t indexOffset) {
+	for (size_t i = start; i < spheres.size(); i++) {
+		if (SphereVisible(frustum, spheres.x[i], spheres.y[i], spheres.z[i], spheres.radius[i])) {
+			out[visible++] = static_cast<uint32_t>(i) + indexOffset;
+		}
+	}
+	return visible;
+}
+
+uint32_t CullAABBsTail(
+  const Frustum& frustum, const AABBSoAConstSpan& boxes, uint32_t* out, uint32_t visible,
+  size_t start, uint32_t indexOffset) {
+	for (size_t i = start; i < boxes.size(); i++) {
+		if (AABBVisible(
+		      frustum, boxes.centerX[i], boxes.centerY[i], boxes.centerZ[i], boxes.extentX[i],
+		      boxes.extentY[i], boxes.extentZ[i])) {
+			out[visible++] = static_cast<uint32_t>(i) + indexOffset;
+		}
+	}
+	return visible;
+}
+
+#if MATH_SIMD_X86
+
+// 4bit のマスクで立っているレーンの番号を前に詰めたもの
+alignas(16) const uint32_t kLeftPack[16][4] = {
+  {0, 0, 0, 0}, {0, 0, 0, 0}, {1, 0, 0, 0}, {0, 1, 0, 0}, {2, 0, 0, 0}, {0, 2, 0, 0},
+  {1, 2, 0, 0}, {0, 1, 2, 0}, {3, 0, 0, 0}, {0, 3, 0, 0}, {1, 3, 0, 0}, {0, 1, 3, 0},
+  {2, 3, 0, 0}, {0, 2, 3, 0}, {1, 2, 3, 0}, {0, 1, 2, 3},
+};
+const uint32_t kBitCount[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+// 見えている要素の番号を分岐なしで書き込む（4要素分を書くが、進めるのは見えている数だけ）
+// 書き込み位置は常に処理済みの要素数以下なので、out の範囲は超えない
+inline uint32_t Compact4(int mask, uint32_t base, uint32_t* out) {
+	__m128i lanes = _mm_load_si128(reinterpret_cast<const __m128i*>(kLeftPack[mask]));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_add_epi32(lanes, _mm_set1_epi32(base)));
+	return kBitCount[mask];
+}
+
+// 平面の係数を成分ごとに並べたもの
+struct PlaneSoA {
+	float nx[Frustum::kPlaneCount];
+	float ny[Frustum::kPlaneCount];
+	float nz[Frustum::kPlaneCount];
+	float ax[Frustum::kPlaneCount]; // |nx|
+	float ay[Frustum::kPlaneCount]; // |ny|
+	float az[Frustum::kPlaneCount]; // |nz|
+	float d[Frustum::kPlaneCount];
+};
+
+PlaneSoA ToPlaneSoA(const Frustum& frustum) {
+	PlaneSoA planes;
+	for (uint32_t p = 0; p < Frustum::kPlaneCount; p++) {
+		const Plane& plane = frustum.planes[p];
+		planes.nx[p] = plane.normal.x;
+		planes.ny[p] = plane.normal.y;
+		planes.nz[p] = plane.normal.z;
+		planes.ax[p] = std::abs(plane.normal.x);
+		planes.ay[p] = std::abs(plane.normal.y);
+		planes.az[p] = std::abs(plane.normal.z);
+		planes.d[p] = plane.distance;
+	}
+	return planes;
+}
+
+#endif
+
+} // namespace
+
+uint32_t FrustumCullSpheresScalar(
+  const Frustum& frustum, const SphereSoAConstSpan& spheres, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset) {
+	assert(visibleIndices.size() >= spheres.size());
+	return CullSpheresTail(frustum, spheres, visibleIndices.data(), 0, 0, indexOffset);
+}
+
+uint32_t FrustumCullAABBsScalar(
+  const Frustum& frustum, const AABBSoAConstSpan& boxes, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset) {
+	assert(visibleIndices.size() >= boxes.size());
+	return CullAABBsTail(frustum, boxes, visibleIndices.data(), 0, 0, indexOffset);
+}
+
+#if MATH_SIMD_X86
+
+uint32_t FrustumCullSpheresSSE2(
+  const Frustum& frustum, const SphereSoAConstSpan& spheres, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset) {
+	assert(visibleIndices.size() >= spheres.size());
+	const PlaneSoA planes = ToPlaneSoA(frustum);
+	const size_t count = spheres.size();
+	uint32_t* out = visibleIndices.data();
+	uint32_t visible = 0;
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128 x = _mm_loadu_ps(spheres.x.data() + i);
+		const __m128 y = _mm_loadu_ps(spheres.y.data() + i);
+		const __m128 z = _mm_loadu_ps(spheres.z.data() + i);
+		const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(spheres.radius.data() + i));
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (uint32_t p = 0; p < Frustum::kPlaneCount; p++) {
+			__m128 distance = _mm_add_ps(
+			  _mm_add_ps(
+			    _mm_add_ps(
+			      _mm_mul_ps(_mm_set1_ps(planes.nx[p]), x), _mm_mul_ps(_mm_set1_ps(planes.ny[p]), y)),
+			    _mm_mul_ps(_mm_set1_ps(planes.nz[p]), z)),
+			  _mm_set1_ps(planes.d[p]));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+		}
+		visible += Compact4(
+		  _mm_movemask_ps(inside), static_cast<uint32_t>(i) + indexOffset, out + visible);
+	}
+	return CullSpheresTail(frustum, spheres, out, visible, i, indexOffset);
+}
+
+uint32_t FrustumCullAABBsSSE2(
+  const Frustum& frustum, const AABBSoAConstSpan& boxes, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset) {
+	assert(visibleIndices.size() >= boxes.size());
+	const PlaneSoA planes = ToPlaneSoA(frustum);
+	const size_t count = boxes.size();
+	uint32_t* out = visibleIndices.data();
+	uint32_t visible = 0;
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128 cx = _mm_loadu_ps(boxes.centerX.data() + i);
+		const __m128 cy = _mm_loadu_ps(boxes.centerY.data() + i);
+		const __m128 cz = _mm_loadu_ps(boxes.centerZ.data() + i);
+		const __m128 ex = _mm_loadu_ps(boxes.extentX.data() + i);
+		const __m128 ey = _mm_loadu_ps(boxes.extentY.data() + i);
+		const __m128 ez = _mm_loadu_ps(boxes.extentZ.data() + i);
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (uint32_t p = 0; p < Frustum::kPlaneCount; p++) {
+			__m128 distance = _mm_add_ps(
+			  _mm_add_ps(
+			    _mm_add_ps(
+			      _mm_mul_ps(_mm_set1_ps(planes.nx[p]), cx),
+			      _mm_mul_ps(_mm_set1_ps(planes.ny[p]), cy)),
+			    _mm_mul_ps(_mm_set1_ps(planes.nz[p]), cz)),
+			  _mm_set1_ps(planes.d[p]));
+			__m128 radius = _mm_add_ps(
+			  _mm_add_ps(
+			    _mm_mul_ps(_mm_set1_ps(planes.ax[p]), ex), _mm_mul_ps(_mm_set1_ps(planes.ay[p]), ey)),
+			  _mm_mul_ps(_mm_set1_ps(planes.az[p]), ez));
+			inside = _mm_and_ps(
+			  inside, _mm_cmpge_ps(distance, _mm_sub_ps(_mm_setzero_ps(), radius)));
+		}
+		visible += Compact4(
+		  _mm_movemask_ps(inside), static_cast<uint32_t>(i) + indexOffset, out + visible);
+	}
+	return CullAABBsTail(frustum, boxes, out, visible, i, indexOffset);
+}
+
+// AVX2 版も FMA は使わない（スカラー版と結果を一致させるため）
+MATH_TARGET_AVX2
+uint32_t FrustumCullSpheresAVX2(
+  const Frustum& frustum, const SphereSoAConstSpan& spheres, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset) {
+	assert(visibleIndices.size() >= spheres.size());
+	const PlaneSoA planes = ToPlaneSoA(frustum);
+	const size_t count = spheres.size();
+	uint32_t* out = visibleIndices.data();
+	uint32_t visible = 0;
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256 x = _mm256_loadu_ps(spheres.x.data() + i);
+		const __m256 y = _mm256_loadu_ps(spheres.y.data() + i);
+		const __m256 z = _mm256_loadu_ps(spheres.z.data() + i);
+		const __m256 negRadius =
+		  _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(spheres.radius.data() + i));
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (uint32_t p = 0; p < Frustum::kPlaneCount; p++) {
+			__m256 distance = _mm256_add_ps(
+			  _mm256_add_ps(
+			    _mm256_add_ps(
+			      _mm256_mul_ps(_mm256_set1_ps(planes.nx[p]), x),
+			      _mm256_mul_ps(_mm256_set1_ps(planes.ny[p]), y)),
+			    _mm256_mul_ps(_mm256_set1_ps(planes.nz[p]), z)),
+			  _mm256_set1_ps(planes.d[p]));
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+		}
+		int mask = _mm256_movemask_ps(inside);
+		uint32_t base = static_cast<uint32_t>(i) + indexOffset;
+		visible += Compact4(mask & 0xF, base, out + visible);
+		visible += Compact4(mask >> 4, base + 4, out + visible);
+	}
+	return CullSpheresTail(frustum, spheres, out, visible, i, indexOffset);
+}
+
+MATH_TARGET_AVX2
+uint32_t FrustumCullAABBsAVX2(
+  const Frustum& frustum, const AABBSoAConstSpan& boxes, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset) {
+	assert(visibleIndices.size() >= boxes.size());
+	const PlaneSoA planes = ToPlaneSoA(frustum);
+	const size_t count = boxes.size();
+	uint32_t* out = visibleIndices.data();
+	uint32_t visible = 0;
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256 cx = _mm256_loadu_ps(boxes.centerX.data() + i);
+		const __m256 cy = _mm256_loadu_ps(boxes.centerY.data() + i);
+		const __m256 cz = _mm256_loadu_ps(boxes.centerZ.data() + i);
+		const __m256 ex = _mm256_loadu_ps(boxes.extentX.data() + i);
+		const __m256 ey = _mm256_loadu_ps(boxes.extentY.data() + i);
+		const __m256 ez = _mm256_loadu_ps(boxes.extentZ.data() + i);
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (uint32_t p = 0; p < Frustum::kPlaneCount; p++) {
+			__m256 distance = _mm256_add_ps(
+			  _mm256_add_ps(
+			    _mm256_add_ps(
+			      _mm256_mul_ps(_mm256_set1_ps(planes.nx[p]), cx),
+			      _mm256_mul_ps(_mm256_set1_ps(planes.ny[p]), cy)),
+			    _mm256_mul_ps(_mm256_set1_ps(planes.nz[p]), cz)),
+			  _mm256_set1_ps(planes.d[p]));
+			__m256 radius = _mm256_add_ps(
+			  _mm256_add_ps(
+			    _mm256_mul_ps(_mm256_set1_ps(planes.ax[p]), ex),
+			    _mm256_mul_ps(_mm256_set1_ps(planes.ay[p]), ey)),
+			  _mm256_mul_ps(_mm256_set1_ps(planes.az[p]), ez));
+			inside = _mm256_and_ps(
+			  inside,
+			  _mm256_cmp_ps(distance, _mm256_sub_ps(_mm256_setzero_ps(), radius), _CMP_GE_OQ));
+		}
+		int mask = _mm256_movemask_ps(inside);
+		uint32_t base = static_cast<uint32_t>(i) + indexOffset;
+		visible += Compact4(mask & 0xF, base, out + visible);
+		visible += Compact4(mask >> 4, base + 4, out + visible);
+	}
+	return CullAABBsTail(frustum, boxes, out, visible, i, indexOffset);
+}
+
+#else
+
+uint32_t FrustumCullSpheresSSE2(
+  const Frustum& frustum, const SphereSoAConstSpan& spheres, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset) {
+	return FrustumCullSpheresScalar(frustum, spheres, visibleIndices, indexOffset);
+}
+
+uint32_t FrustumCullAABBsSSE2(
+  const Frustum& frustum, const AABBSoAConstSpan& boxes, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset) {
+	return FrustumCullAABBsScalar(frustum, boxes, visibleIndices, indexOffset);
+}
+
+uint32_t FrustumCullSpheresAVX2(
+  const Frustum& frustum, const SphereSoAConstSpan& spheres, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset) {
+	return FrustumCullSpheresScalar(frustum, spheres, visibleIndices, indexOffset);
+}
+
+uint32_t FrustumCullAABBsAVX2(
+  const Frustum& frustum, const AABBSoAConstSpan& boxes, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset) {
+	return FrustumCullAABBsScalar(frustum, boxes, visibleIndices, indexOffset);
+}
+
+#endif
+
+uint32_t FrustumCullSpheres(
+  const Frustum& frustum, const SphereSoAConstSpan& spheres, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset) {
+	switch (GetSimdLevel()) {
+	case SimdLevel::kAVX2:
+		return FrustumCullSpheresAVX2(frustum, spheres, visibleIndices, indexOffset);
+	case SimdLevel::kSSE2:
+		return FrustumCullSpheresSSE2(frustum, spheres, visibleIndices, indexOffset);
+	default:
+		return FrustumCullSpheresScalar(frustum, spheres, visibleIndices, indexOffset);
+	}
+}
+
+uint32_t FrustumCullAABBs(
+  const Frustum& frustum, const AABBSoAConstSpan& boxes, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset) {
+	switch (GetSimdLevel()) {
+	case SimdLevel::kAVX2:
+		return FrustumCullAABBsAVX2(frustum, boxes, visibleIndices, indexOffset);
+	case SimdLevel::kSSE2:
+		return FrustumCullAABBsSSE2(frustum, boxes, visibleIndices, indexOffset);
+	default:
+		return FrustumCullAABBsScalar(frustum, boxes, visibleIndices, indexOffset);
+	}
+}
+
+} // namespace MathUtility
@@ -0,0 +1,86 @@
+﻿#pragma once
+
+#include "Geometry.h"
+#include "MathSimd.h"
+#include "Matrix4.h"
+#include <cstdint>
+#include <span>
+
+namespace MathUtility {
+
+// SoA 形式の球の列（中心と半径を別々の配列で持つ）
+struct SphereSoAConstSpan {
+	std::span<const float> x;
+	std::span<const float> y;
+	std::span<const float> z;
+	std::span<const float> radius;
+
+	size_t size() const { return x.size(); }
+	// [offset, offset + count) の部分列
+	SphereSoAConstSpan subspan(size_t offset, size_t count) const {
+		return {
+		  x.subspan(offset, count), y.subspan(offset, count), z.subspan(offset, count),
+		  radius.subspan(offset, count)};
+	}
+};
+
+// SoA 形式の軸平行境界ボックスの列（中心と各軸の半分の大きさ）
+struct AABBSoAConstSpan {
+	std::span<const float> centerX;
+	std::span<const float> centerY;
+	std::span<const float> centerZ;
+	std::span<const float> extentX;
+	std::span<const float> extentY;
+	std::span<const float> extentZ;
+
+	size_t size() const { return centerX.size(); }
+	// [offset, offset + count) の部分列
+	AABBSoAConstSpan subspan(size_t offset, size_t count) const {
+		return {
+		  centerX.subspan(offset, count), centerY.subspan(offset, count),
+		  centerZ.subspan(offset, count), extentX.subspan(offset, count),
+		  extentY.subspan(offset, count), extentZ.subspan(offset, count)};
+	}
+};
+
+/// <summary>
+/// ビュープロジェクション行列から視錐台を取り出す（法線は正規化済み）
+/// 深度の範囲は Direct3D と同じ [0, 1] とする
+/// </summary>
+/// <param name="viewProjection">ワールド → クリップ空間の変換行列</param>
+Frustum FrustumFromMatrix(const Matrix4& viewProjection);
+
+// 視錐台カリング
+// 見えている要素の番号（先頭からの添字 + indexOffset）を visibleIndices の先頭から詰めて書き込み、その数を返す
+// visibleIndices の要素数は入力と同じ以上であること（見えない要素の分の領域も作業に使う）
+// 判定は Geometry.h の FrustumIntersectsSphere / FrustumIntersectsAABB と同じ計算で、
+// どのカーネルでも結果は完全に一致する
+uint32_t FrustumCullSpheres(
+  const Frustum& frustum, const SphereSoAConstSpan& spheres, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset = 0);
+uint32_t FrustumCullAABBs(
+  const Frustum& frustum, const AABBSoAConstSpan& boxes, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset = 0);
+
+// カーネル（スカラー / SSE2 で4要素ずつ / AVX2 で8要素ずつ）
+// AVX2 版は AVX2 非対応の CPU で呼んではいけない
+uint32_t FrustumCullSpheresScalar(
+  const Frustum& frustum, const SphereSoAConstSpan& spheres, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset);
+uint32_t FrustumCullSpheresSSE2(
+  const Frustum& frustum, const SphereSoAConstSpan& spheres, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset);
+uint32_t FrustumCullSpheresAVX2(
+  const Frustum& frustum, const SphereSoAConstSpan& spheres, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset);
+uint32_t FrustumCullAABBsScalar(
+  const Frustum& frustum, const AABBSoAConstSpan& boxes, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset);
+uint32_t FrustumCullAABBsSSE2(
+  const Frustum& frustum, const AABBSoAConstSpan& boxes, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset);
+uint32_t FrustumCullAABBsAVX2(
+  const Frustum& frustum, const AABBSoAConstSpan& boxes, std::span<uint32_t> visibleIndices,
+  uint32_t indexOffset);
+
+} // namespace MathUtility
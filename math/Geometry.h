@@ -0,0 +1,195 @@
+﻿#pragma once
+
+#include "MathUtility.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/// <summary>
+/// 軸平行境界ボックス
+/// </summary>
+struct AABB {
+	Vector3 min; // 最小点
+	Vector3 max; // 最大点
+};
+
+/// <summary>
+/// 球
+/// </summary>
+struct Sphere {
+	Vector3 center; // 中心
+	float radius;   // 半径
+};
+
+/// <summary>
+/// 半直線（origin + direction * t, t >= 0）
+/// </summary>
+struct Ray {
+	Vector3 origin;    // 始点
+	Vector3 direction; // 方向（正規化しなくてよい。t は direction の長さ単位）
+};
+
+/// <summary>
+/// 平面（Dot(normal, p) + distance >= 0 の側を表とする）
+/// </summary>
+struct Plane {
+	Vector3 normal;
+	float distance;
+};
+
+/// <summary>
+/// 視錐台（6平面。法線は内側を向く）
+/// </summary>
+struct Frustum {
+	static const uint32_t kPlaneCount = 6;
+	Plane planes[kPlaneCount]; // 左, 右, 下, 上, 近, 遠
+};
+
+namespace MathUtility {
+
+// 成分ごとの最小値
+inline Vector3 Vector3Min(const Vector3& v1, const Vector3& v2) {
+	return {(std::min)(v1.x, v2.x), (std::min)(v1.y, v2.y), (std::min)(v1.z, v2.z)};
+}
+// 成分ごとの最大値
+inline Vector3 Vector3Max(const Vector3& v1, const Vector3& v2) {
+	return {(std::max)(v1.x, v2.x), (std::max)(v1.y, v2.y), (std::max)(v1.z, v2.z)};
+}
+
+// 中心と半径（各軸の半分の大きさ）からボックスを作る
+inline AABB AABBFromCenterExtents(const Vector3& center, const Vector3& extents) {
+	return {center - extents, center + extents};
+}
+// 中心
+inline Vector3 AABBCenter(const AABB& box) { return (box.min + box.max) * 0.5f; }
+// 各軸の半分の大きさ
+inline Vector3 AABBExtents(const AABB& box) { return (box.max - box.min) * 0.5f; }
+// 2つのボックスを囲むボックス
+inline AABB AABBMerge(const AABB& a, const AABB& b) {
+	return {Vector3Min(a.min, b.min), Vector3Max(a.max, b.max)};
+}
+// 各方向に margin だけ広げる
+inline AABB AABBExpand(const AABB& box, float margin) {
+	return {box.min - Vector3(margin, margin, margin), box.max + Vector3(margin, margin, margin)};
+}
+// 表面積
+inline float AABBSurfaceArea(const AABB& box) {
+	Vector3 d = box.max - box.min;
+	return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+// inner が outer に完全に含まれるか
+inline bool AABBContains(const AABB& outer, const AABB& inner) {
+	return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+	       inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+// 2つのボックスが重なっているか
+inline bool AABBIntersects(const AABB& a, const AABB& b) {
+	return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y &&
+	       a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+// ボックスと球が重なっているか
+inline bool AABBIntersectsSphere(const AABB& box, const Sphere& sphere) {
+	// ボックス上の最近点までの距離で判定する
+	Vector3 closest = Vector3Min(Vector3Max(sphere.center, box.min), box.max);
+	Vector3 d = sphere.center - closest;
+	return Vector3Dot(d, d) <= sphere.radius * sphere.radius;
+}
+
+// ボックスを行列で変換したものを囲むボックス
+inline AABB AABBTransform(const AABB& box, const Matrix4& m) {
+	// 平行移動から始め、各行の寄与の小さい方と大きい方を足し込む
+	AABB result = {{m.m[3][0], m.m[3][1], m.m[3][2]}, {m.m[3][0], m.m[3][1], m.m[3][2]}};
+	const float mins[3] = {box.min.x, box.min.y, box.min.z};
+	const float maxs[3] = {box.max.x, box.max.y, box.max.z};
+	float* resultMin[3] = {&result.min.x, &result.min.y, &result.min.z};
+	float* resultMax[3] = {&result.max.x, &result.max.y, &result.max.z};
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			float a = m.m[i][j] * mins[i];
+			float b = m.m[i][j] * maxs[i];
+			*resultMin[j] += (std::min)(a, b);
+			*resultMax[j] += (std::max)(a, b);
+		}
+	}
+	return result;
+}
+
+// 半直線の方向の逆数（同じ半直線で何度も判定する場合に使い回す）
+inline Vector3 RayInverseDirection(const Ray& ray) {
+	return {1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z};
+}
+/// <summary>
+/// 半直線とボックスの交差（スラブ法）
+/// </summary>
+/// <param name="inverseDirection">RayInverseDirection の結果</param>
+/// <param name="maxT">これより遠い交差は無視する</param>
+/// <param name="t">交差していればボックスに入る位置（始点が内側なら 0）</param>
+inline bool RayIntersectsAABB(
+  const Ray& ray, const Vector3& inverseDirection, const AABB& box, float maxT, float& t) {
+	float tx1 = (box.min.x - ray.origin.x) * inverseDirection.x;
+	float tx2 = (box.max.x - ray.origin.x) * inverseDirection.x;
+	float ty1 = (box.min.y - ray.origin.y) * inverseDirection.y;
+	float ty2 = (box.max.y - ray.origin.y) * inverseDirection.y;
+	float tz1 = (box.min.z - ray.origin.z) * inverseDirection.z;
+	float tz2 = (box.max.z - ray.origin.z) * inverseDirection.z;
+	float tEnter = (std::max)({0.0f, (std::min)(tx1, tx2), (std::min)(ty1, ty2), (std::min)(tz1, tz2)});
+	float tExit = (std::min)({maxT, (std::max)(tx1, tx2), (std::max)(ty1, ty2), (std::max)(tz1, tz2)});
+	t = tEnter;
+	return tEnter <= tExit;
+}
+
+// 点から平面までの符号付き距離
+inline float PlaneDistance(const Plane& plane, const Vector3& point) {
+	return Vector3Dot(plane.normal, point) + plane.distance;
+}
+
+// 視錐台に対する位置関係
+enum class Containment {
+	kOutside,    // 完全に外
+	kIntersects, // 境界にかかっている
+	kInside,     // 完全に内側
+};
+
+/// <summary>
+/// 視錐台とボックスの判定
+/// </summary>
+/// <param name="planeMask">
+/// 判定する平面のビット集合。完全に内側だった平面のビットを落として返すので、
+/// 子のボックスの判定に渡せば同じ平面を調べ直さずに済む
+/// </param>
+inline Containment FrustumClassifyAABB(const Frustum& frustum, const AABB& box, uint32_t& planeMask) {
+	Vector3 center = AABBCenter(box);
+	Vector3 extents = AABBExtents(box);
+	for (uint32_t i = 0; i < Frustum::kPlaneCount; i++) {
+		if (!(planeMask & (1u << i))) {
+			continue;
+		}
+		const Plane& plane = frustum.planes[i];
+		float distance = PlaneDistance(plane, center);
+		float radius = std::abs(plane.normal.x) * extents.x + std::abs(plane.normal.y) * extents.y +
+		               std::abs(plane.normal.z) * extents.z;
+		if (distance < -radius) {
+			return Containment::kOutside;
+		}
+		if (distance >= radius) {
+			planeMask &= ~(1u << i);
+		}
+	}
+	return planeMask == 0 ? Containment::kInside : Containment::kIntersects;
+}
+// 視錐台とボックスが重なっているか
+inline bool FrustumIntersectsAABB(const Frustum& frustum, const AABB& box) {
+	uint32_t planeMask = (1u << Frustum::kPlaneCount) - 1;
+	return FrustumClassifyAABB(frustum, box, planeMask) != Containment::kOutside;
+}
+// 視錐台と球が重なっているか
+inline bool FrustumIntersectsSphere(const Frustum& frustum, const Sphere& sphere) {
+	for (const Plane& plane : frustum.planes) {
+		if (PlaneDistance(plane, sphere.center) < -sphere.radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace MathUtility
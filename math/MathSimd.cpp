@@ -0,0 +1,64 @@
+﻿#include "MathSimd.h"
+
+#if MATH_SIMD_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace MathUtility {
+
+namespace {
+
+SimdLevel DetectSimdLevel() {
+#if !MATH_SIMD_X86
+	return SimdLevel::kScalar;
+#elif defined(__AVX2__) && defined(__FMA__)
+	// コンパイル時に AVX2 が有効（/arch:AVX2, -mavx2 -mfma）
+	return SimdLevel::kAVX2;
+#elif defined(_MSC_VER)
+	int info[4] = {};
+	__cpuid(info, 0);
+	if (info[0] < 7) {
+		return SimdLevel::kSSE2;
+	}
+	__cpuid(info, 1);
+	const bool fma = (info[2] & (1 << 12)) != 0;
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	if (!fma || !osxsave || !avx) {
+		return SimdLevel::kSSE2;
+	}
+	// OS が YMM レジスタを保存するか
+	if ((_xgetbv(0) & 0x6) != 0x6) {
+		return SimdLevel::kSSE2;
+	}
+	__cpuidex(info, 7, 0);
+	const bool avx2 = (info[1] & (1 << 5)) != 0;
+	return avx2 ? SimdLevel::kAVX2 : SimdLevel::kSSE2;
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+		return SimdLevel::kAVX2;
+	}
+	return SimdLevel::kSSE2;
+#endif
+}
+
+} // namespace
+
+SimdLevel GetSimdLevel() {
+	static const SimdLevel level = DetectSimdLevel();
+	return level;
+}
+
+const char* GetSimdLevelName(SimdLevel level) {
+	switch (level) {
+	case SimdLevel::kSSE2:
+		return "SSE2";
+	case SimdLevel::kAVX2:
+		return "AVX2";
+	default:
+		return "Scalar";
+	}
+}
+
+} // namespace MathUtility
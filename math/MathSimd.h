@@ -0,0 +1,44 @@
+﻿#pragma once
+
+// SIMD 命令セットの設定
+// x64 では SSE2 が常に利用可能なので、SSE2 を基本とし AVX2 は実行時に判定する
+// MATH_FORCE_SCALAR を定義するとスカラー実装のみでビルドする
+#if !defined(MATH_FORCE_SCALAR) && (defined(_M_X64) || defined(__x86_64__))
+#define MATH_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define MATH_SIMD_X86 0
+#endif
+
+// AVX2 を使う関数に付ける属性（MSVC は属性なしで組み込み関数を使える）
+#if MATH_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define MATH_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define MATH_TARGET_AVX2
+#endif
+
+namespace MathUtility {
+
+/// <summary>
+/// SIMD 命令セットの段階
+/// </summary>
+enum class SimdLevel {
+	kScalar, // SIMD なし
+	kSSE2,   // SSE2 (128bit)
+	kAVX2,   // AVX2 + FMA (256bit)
+};
+
+/// <summary>
+/// 実行環境で利用できる最上位の命令セットを取得
+/// </summary>
+/// <returns>命令セット（初回呼び出し時に判定し、以降はキャッシュ）</returns>
+SimdLevel GetSimdLevel();
+
+/// <summary>
+/// 命令セット名を取得
+/// </summary>
+/// <param name="level">命令セット</param>
+/// <returns>名前</returns>
+const char* GetSimdLevelName(SimdLevel level);
+
+} // namespace MathUtility
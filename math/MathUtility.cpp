@@ -0,0 +1,232 @@
+﻿#include "MathUtility.h"
+#include "Matrix4Multiply.h"
+#include <cmath>
+
+namespace MathUtility {
+
+const Vector3 Vector3Zero() { return {0.0f, 0.0f, 0.0f}; }
+
+bool Vector3Equal(const Vector3& v1, const Vector3& v2) {
+	return v1.x == v2.x && v1.y == v2.y && v1.z == v2.z;
+}
+
+float Vector3Length(const Vector3& v) { return std::sqrt(Vector3Dot(v, v)); }
+
+Vector3& Vector3Normalize(Vector3& v) {
+	float len = Vector3Length(v);
+	if (len != 0) {
+		return v /= len;
+	}
+	return v;
+}
+
+float Vector3Dot(const Vector3& v1, const Vector3& v2) {
+	return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+}
+
+Vector3 Vector3Cross(const Vector3& v1, const Vector3& v2) {
+	return {v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x};
+}
+
+Vector3 Vector3Lerp(const Vector3& v1, const Vector3& v2, float t) {
+	return {v1.x + (v2.x - v1.x) * t, v1.y + (v2.y - v1.y) * t, v1.z + (v2.z - v1.z) * t};
+}
+
+const Vector3 operator+(const Vector3& v1, const Vector3& v2) {
+	Vector3 temp(v1);
+	return temp += v2;
+}
+
+const Vector3 operator-(const Vector3& v1, const Vector3& v2) {
+	Vector3 temp(v1);
+	return temp -= v2;
+}
+
+const Vector3 operator*(const Vector3& v, float s) {
+	Vector3 temp(v);
+	return temp *= s;
+}
+
+const Vector3 operator*(float s, const Vector3& v) {
+	Vector3 temp(v);
+	return temp *= s;
+}
+
+const Vector3 operator/(const Vector3& v, float s) {
+	Vector3 temp(v);
+	return temp /= s;
+}
+
+Matrix4 Matrix4Identity() {
+	Matrix4 result;
+	result.Identity();
+	return result;
+}
+
+Matrix4 Matrix4Transpose(const Matrix4& m) {
+	Matrix4 result;
+
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			result.m[i][j] = m.m[j][i];
+		}
+	}
+
+	return result;
+}
+
+Matrix4 Matrix4Scaling(float sx, float sy, float sz) {
+	Matrix4 result{
+	  sx, 0.0f, 0.0f, 0.0f, 0.0f, sy, 0.0f, 0.0f,
+	  0.0f, 0.0f, sz, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+
+	return result;
+}
+
+Matrix4 Matrix4RotationX(float angle) {
+	float sin = std::sin(angle);
+	float cos = std::cos(angle);
+
+	Matrix4 result{
+	  1.0f, 0.0f, 0.0f, 0.0f, 0.0f, cos,  sin,  0.0f,
+	  0.0f, -sin, cos,  0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+
+	return result;
+}
+
+Matrix4 Matrix4RotationY(float angle) {
+	float sin = std::sin(angle);
+	float cos = std::cos(angle);
+
+	Matrix4 result{
+	  cos, 0.0f, -sin, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+	  sin, 0.0f, cos,  0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+
+	return result;
+}
+
+Matrix4 Matrix4RotationZ(float angle) {
+	float sin = std::sin(angle);
+	float cos = std::cos(angle);
+
+	Matrix4 result{
+	  cos,  sin,  0.0f, 0.0f, -sin, cos,  0.0f, 0.0f,
+	  0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+
+	return result;
+}
+
+Matrix4 Matrix4Translation(float tx, float ty, float tz) {
+	Matrix4 result{
+	  1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+	  0.0f, 0.0f, 1.0f, 0.0f, tx,   ty,   tz,   1.0f};
+
+	return result;
+}
+
+Matrix4 Matrix4LookAtLH(const Vector3& eye, const Vector3& target, const Vector3& up) {
+	Vector3 zaxis(target);
+	zaxis -= eye;
+	Vector3Normalize(zaxis);
+	Vector3 xaxis = Vector3Cross(up, zaxis);
+	Vector3Normalize(xaxis);
+	Vector3 yaxis = Vector3Cross(zaxis, xaxis);
+
+	Matrix4 result{
+	  xaxis.x,
+	  yaxis.x,
+	  zaxis.x,
+	  0.0f,
+	  xaxis.y,
+	  yaxis.y,
+	  zaxis.y,
+	  0.0f,
+	  xaxis.z,
+	  yaxis.z,
+	  zaxis.z,
+	  0.0f,
+	  -Vector3Dot(xaxis, eye),
+	  -Vector3Dot(yaxis, eye),
+	  -Vector3Dot(zaxis, eye),
+	  1.0f};
+
+	return result;
+}
+
+Matrix4 Matrix4Orthographic(
+  float viewLeft, float viewRight, float viewBottom, float viewTop, float nearZ, float farZ) {
+	float width = viewRight - viewLeft;
+	float height = viewTop - viewBottom;
+	float range = farZ - nearZ;
+
+	Matrix4 result{
+	  2.0f / width,
+	  0.0f,
+	  0.0f,
+	  0.0f,
+	  0.0f,
+	  2.0f / height,
+	  0.0f,
+	  0.0f,
+	  0.0f,
+	  0.0f,
+	  1.0f / range,
+	  0.0f,
+	  (viewLeft + viewRight) / (viewLeft - viewRight),
+	  (viewTop + viewBottom) / (viewBottom - viewTop),
+	  nearZ / (nearZ - farZ),
+	  1.0f};
+
+	return result;
+}
+
+Matrix4 Matrix4Perspective(float fovAngleY, float aspectRatio, float nearZ, float farZ) {
+	float height = 1.0f / std::tan(fovAngleY / 2.0f);
+	float width = height / aspectRatio;
+	float range = farZ / (farZ - nearZ);
+
+	Matrix4 result{
+	  width, 0.0f,   0.0f,  0.0f, 0.0f, height,          0.0f, 0.0f,
+	  0.0f,  0.0f,   range, 1.0f, 0.0f, 0.0f,   -range * nearZ, 0.0f};
+
+	return result;
+}
+
+Vector3 Vector3Transform(const Vector3& v, const Matrix4& m) {
+	Vector3 result{
+	  v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0] + m.m[3][0],
+	  v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1] + m.m[3][1],
+	  v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] + m.m[3][2]};
+
+	return result;
+}
+
+Vector3 Vector3TransformCoord(const Vector3& v, const Matrix4& m) {
+	float w = v.x * m.m[0][3] + v.y * m.m[1][3] + v.z * m.m[2][3] + m.m[3][3];
+
+	Vector3 result{
+	  (v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0] + m.m[3][0]) / w,
+	  (v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1] + m.m[3][1]) / w,
+	  (v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] + m.m[3][2]) / w};
+
+	return result;
+}
+
+Vector3 Vector3TransformNormal(const Vector3& v, const Matrix4& m) {
+	Vector3 result{
+	  v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0],
+	  v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1],
+	  v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2]};
+
+	return result;
+}
+
+Matrix4 operator*(const Matrix4& m1, const Matrix4& m2) {
+	Matrix4 result;
+	Matrix4Multiply(m1, m2, result);
+	return result;
+}
+
+Vector3 operator*(const Vector3& v, const Matrix4& m) { return Vector3Transform(v, m); }
+
+} // namespace MathUtility
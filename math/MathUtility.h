@@ -5,7 +5,7 @@
 
 namespace MathUtility {
 
-const float PI = 3.141592654f;
+constexpr float PI = 3.141592654f;
 
 // 零ベクトルを返す
 const Vector3 Vector3Zero();
@@ -19,6 +19,8 @@ Vector3& Vector3Normalize(Vector3& v);
 float Vector3Dot(const Vector3& v1, const Vector3& v2);
 // 外積を求める
 Vector3 Vector3Cross(const Vector3& v1, const Vector3& v2);
+// 線形補間する（t = 0 で v1、t = 1 で v2）
+Vector3 Vector3Lerp(const Vector3& v1, const Vector3& v2, float t);
 
 // 2項演算子オーバーロード
 const Vector3 operator+(const Vector3& v1, const Vector3& v2);
@@ -31,6 +33,14 @@ const Vector3 operator/(const Vector3& v, float s);
 Matrix4 Matrix4Identity();
 // 転置行列を求める
 Matrix4 Matrix4Transpose(const Matrix4& m);
+// 行列式を求める
+float Matrix4Determinant(const Matrix4& m);
+// 逆行列を求める（特異行列の場合は零行列を返す。determinant には行列式を格納）
+Matrix4 Matrix4Inverse(const Matrix4& m, float* determinant = nullptr);
+// アフィン変換行列の逆行列を求める（4列目が (0,0,0,1) の行列専用）
+Matrix4 Matrix4InverseAffine(const Matrix4& m);
+// 回転と平行移動のみの行列の逆行列を求める（回転部分を転置するだけの高速版）
+Matrix4 Matrix4InverseRigid(const Matrix4& m);
 
 // 拡大縮小行列の作成
 Matrix4 Matrix4Scaling(float sx, float sy, float sz);
@@ -62,4 +72,4 @@ Vector3 Vector3TransformNormal(const Vector3& v, const Matrix4& m);
 Matrix4 operator*(const Matrix4& m1, const Matrix4& m2);
 Vector3 operator*(const Vector3& v, const Matrix4& m);
 
-} // namespace MathUtility
\ No newline at end of file
+} // namespace MathUtility
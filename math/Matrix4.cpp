@@ -0,0 +1,169 @@
+﻿#include "Matrix4.h"
+#include "FastMath.h"
+#include "Matrix4Multiply.h"
+#include "Quaternion.h"
+#include <cmath>
+
+Matrix4::Matrix4() : m{} {}
+
+Matrix4::Matrix4(
+	float m00, float m01, float m02, float m03,
+	float m10, float m11, float m12, float m13,
+	float m20, float m21, float m22, float m23,
+	float m30, float m31, float m32, float m33) {
+	m[0][0] = m00; m[0][1] = m01; m[0][2] = m02; m[0][3] = m03;
+	m[1][0] = m10; m[1][1] = m11; m[1][2] = m12; m[1][3] = m13;
+	m[2][0] = m20; m[2][1] = m21; m[2][2] = m22; m[2][3] = m23;
+	m[3][0] = m30; m[3][1] = m31; m[3][2] = m32; m[3][3] = m33;
+}
+
+Matrix4& Matrix4::operator*=(const Matrix4& m2) {
+	MathUtility::Matrix4Multiply(*this, m2, *this);
+	return *this;
+}
+
+void Matrix4::Identity() {
+	// 一時オブジェクトを作らずに成分を直接書き込む
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			m[i][j] = i == j ? 1.0f : 0.0f;
+		}
+	}
+}
+
+void Matrix4::Scale(const Vector3 scale)
+{
+	m[0][0] = scale.x;
+	m[1][1] = scale.y;
+	m[2][2] = scale.z;
+	m[3][3] = 1;
+}
+
+void Matrix4::Rotation(const Vector3 rot) {
+	Matrix4 rotX;
+	Matrix4 rotY;
+	Matrix4 rotZ;
+
+	// 各軸の sin/cos は1回ずつだけ計算する
+	float sinX, cosX, sinY, cosY, sinZ, cosZ;
+	MathUtility::SinCos(rot.x, sinX, cosX);
+	MathUtility::SinCos(rot.y, sinY, cosY);
+	MathUtility::SinCos(rot.z, sinZ, cosZ);
+
+	rotX = {
+		1,0,0,0,
+		0,cosX,sinX,0,
+		0,-sinX,cosX,0,
+		0,0,0,1
+	};
+	rotY = {
+		cosY,0,sinY,0,
+		0,1,0,0,
+		-sinY,0,cosY,0,
+		0,0,0,1
+	};
+	rotZ = {
+		cosZ,sinZ,0,0,
+		-sinZ,cosZ,0,0,
+		0,0,1,0,
+		0,0,0,1
+	};
+	*this *= rotX;
+	*this *= rotY;
+	*this *= rotZ;
+}
+
+void Matrix4::Transform(const Vector3 trans) {
+	m[3][0] = trans.x;
+	m[3][1] = trans.y;
+	m[3][2] = trans.z;
+	m[3][3] = 1;
+}
+
+Matrix4 Matrix4::MakeAffine(const Vector3& scale, const Vector3& rotation, const Vector3& translation) {
+	Matrix4 result;
+	MakeAffine(&scale, &rotation, &translation, &result, 1);
+	return result;
+}
+
+void Matrix4::MakeAffine(
+	const Vector3* scales, const Vector3* rotations, const Vector3* translations,
+	Matrix4* out, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		const Vector3& s = scales[i];
+		const Vector3& r = rotations[i];
+		const Vector3& t = translations[i];
+
+		// 各軸の sin/cos は1回ずつだけ計算する
+		float sx, cx, sy, cy, sz, cz;
+		MathUtility::SinCos(r.x, sx, cx);
+		MathUtility::SinCos(r.y, sy, cy);
+		MathUtility::SinCos(r.z, sz, cz);
+
+		// Rotation() と同じ rotX * rotY * rotZ の各行にスケールを掛ける
+		const float sxsy = sx * sy;
+		const float cxsy = cx * sy;
+
+		float (*m)[4] = out[i].m;
+		m[0][0] = s.x * (cy * cz);
+		m[0][1] = s.x * (cy * sz);
+		m[0][2] = s.x * sy;
+		m[0][3] = 0;
+
+		m[1][0] = s.y * (-sxsy * cz - cx * sz);
+		m[1][1] = s.y * (-sxsy * sz + cx * cz);
+		m[1][2] = s.y * (sx * cy);
+		m[1][3] = 0;
+
+		m[2][0] = s.z * (-cxsy * cz + sx * sz);
+		m[2][1] = s.z * (-cxsy * sz - sx * cz);
+		m[2][2] = s.z * (cx * cy);
+		m[2][3] = 0;
+
+		m[3][0] = t.x;
+		m[3][1] = t.y;
+		m[3][2] = t.z;
+		m[3][3] = 1;
+	}
+}
+
+Matrix4 Matrix4::MakeAffine(const Vector3& scale, const Quaternion& rotation, const Vector3& translation) {
+	Matrix4 result;
+	MakeAffine(&scale, &rotation, &translation, &result, 1);
+	return result;
+}
+
+void Matrix4::MakeAffine(
+	const Vector3* scales, const Quaternion* rotations, const Vector3* translations,
+	Matrix4* out, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		const Vector3& s = scales[i];
+		const Quaternion& q = rotations[i];
+		const Vector3& t = translations[i];
+
+		const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+		const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+		const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+		float (*m)[4] = out[i].m;
+		m[0][0] = s.x * (1 - 2 * (yy + zz));
+		m[0][1] = s.x * (2 * (xy + wz));
+		m[0][2] = s.x * (2 * (xz - wy));
+		m[0][3] = 0;
+
+		m[1][0] = s.y * (2 * (xy - wz));
+		m[1][1] = s.y * (1 - 2 * (xx + zz));
+		m[1][2] = s.y * (2 * (yz + wx));
+		m[1][3] = 0;
+
+		m[2][0] = s.z * (2 * (xz + wy));
+		m[2][1] = s.z * (2 * (yz - wx));
+		m[2][2] = s.z * (1 - 2 * (xx + yy));
+		m[2][3] = 0;
+
+		m[3][0] = t.x;
+		m[3][1] = t.y;
+		m[3][2] = t.z;
+		m[3][3] = 1;
+	}
+}
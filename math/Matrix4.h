@@ -1,5 +1,9 @@
 ﻿#pragma once
 #include "Vector3.h"
+#include <cstddef>
+
+class Quaternion;
+
 /// <summary>
 /// 行列
 /// </summary>
@@ -27,4 +31,20 @@ public:
 	void Rotation(const Vector3 rot);
 
 	void Transform(const Vector3 trans);
+
+	// スケール・回転・平行移動を合成したアフィン行列を直接生成する
+	// （Identity→Scale→Rotation→Transform を順に掛けた結果と成分の差 1e-6 以内で一致する。
+	//   拡大率 0.5〜2 の範囲で math_benchmark --verify が確かめる）
+	static Matrix4 MakeAffine(const Vector3& scale, const Vector3& rotation, const Vector3& translation);
+
+	// アフィン行列の一括生成（out[i] = MakeAffine(scales[i], rotations[i], translations[i])）
+	static void MakeAffine(
+		const Vector3* scales, const Vector3* rotations, const Vector3* translations,
+		Matrix4* out, size_t count);
+
+	// 回転をクォータニオンで指定する版
+	static Matrix4 MakeAffine(const Vector3& scale, const Quaternion& rotation, const Vector3& translation);
+	static void MakeAffine(
+		const Vector3* scales, const Quaternion* rotations, const Vector3* translations,
+		Matrix4* out, size_t count);
 };
@@ -0,0 +1,253 @@
+﻿#include "Matrix4Inverse.h"
+#include "MathUtility.h"
+
+namespace MathUtility {
+
+namespace {
+
+// 4x4 の余因子（行列式の計算と逆行列で共有する）
+struct Cofactors {
+	float c[4][4];
+	float det;
+};
+
+Cofactors CalcCofactors(const Matrix4& mat) {
+	const float(*m)[4] = mat.m;
+	Cofactors r;
+
+	// 下2行の 2x2 小行列式
+	float s0 = m[2][0] * m[3][1] - m[2][1] * m[3][0];
+	float s1 = m[2][0] * m[3][2] - m[2][2] * m[3][0];
+	float s2 = m[2][0] * m[3][3] - m[2][3] * m[3][0];
+	float s3 = m[2][1] * m[3][2] - m[2][2] * m[3][1];
+	float s4 = m[2][1] * m[3][3] - m[2][3] * m[3][1];
+	float s5 = m[2][2] * m[3][3] - m[2][3] * m[3][2];
+	// 上2行の 2x2 小行列式
+	float t0 = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+	float t1 = m[0][0] * m[1][2] - m[0][2] * m[1][0];
+	float t2 = m[0][0] * m[1][3] - m[0][3] * m[1][0];
+	float t3 = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+	float t4 = m[0][1] * m[1][3] - m[0][3] * m[1][1];
+	float t5 = m[0][2] * m[1][3] - m[0][3] * m[1][2];
+
+	// 余因子行列の転置（随伴行列）を直接求める
+	r.c[0][0] = m[1][1] * s5 - m[1][2] * s4 + m[1][3] * s3;
+	r.c[0][1] = -m[0][1] * s5 + m[0][2] * s4 - m[0][3] * s3;
+	r.c[0][2] = m[3][1] * t5 - m[3][2] * t4 + m[3][3] * t3;
+	r.c[0][3] = -m[2][1] * t5 + m[2][2] * t4 - m[2][3] * t3;
+
+	r.c[1][0] = -m[1][0] * s5 + m[1][2] * s2 - m[1][3] * s1;
+	r.c[1][1] = m[0][0] * s5 - m[0][2] * s2 + m[0][3] * s1;
+	r.c[1][2] = -m[3][0] * t5 + m[3][2] * t2 - m[3][3] * t1;
+	r.c[1][3] = m[2][0] * t5 - m[2][2] * t2 + m[2][3] * t1;
+
+	r.c[2][0] = m[1][0] * s4 - m[1][1] * s2 + m[1][3] * s0;
+	r.c[2][1] = -m[0][0] * s4 + m[0][1] * s2 - m[0][3] * s0;
+	r.c[2][2] = m[3][0] * t4 - m[3][1] * t2 + m[3][3] * t0;
+	r.c[2][3] = -m[2][0] * t4 + m[2][1] * t2 - m[2][3] * t0;
+
+	r.c[3][0] = -m[1][0] * s3 + m[1][1] * s1 - m[1][2] * s0;
+	r.c[3][1] = m[0][0] * s3 - m[0][1] * s1 + m[0][2] * s0;
+	r.c[3][2] = -m[3][0] * t3 + m[3][1] * t1 - m[3][2] * t0;
+	r.c[3][3] = m[2][0] * t3 - m[2][1] * t1 + m[2][2] * t0;
+
+	r.det = t0 * s5 - t1 * s4 + t2 * s3 + t3 * s2 - t4 * s1 + t5 * s0;
+	return r;
+}
+
+} // namespace
+
+Matrix4 Matrix4InverseScalar(const Matrix4& m, float* determinant) {
+	Cofactors cof = CalcCofactors(m);
+	if (determinant) {
+		*determinant = cof.det;
+	}
+
+	Matrix4 result;
+	if (cof.det == 0.0f) {
+		return result;
+	}
+
+	float invDet = 1.0f / cof.det;
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			result.m[i][j] = cof.c[i][j] * invDet;
+		}
+	}
+	return result;
+}
+
+#if MATH_SIMD_X86
+
+namespace {
+
+// 2x2 行列を (a00, a01, a10, a11) の順で1レジスタに持つ
+#define MATH_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define MATH_SWIZZLE(v, x, y, z, w) \
+	_mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(v), MATH_SHUFFLE_MASK(x, y, z, w)))
+
+// A * B
+inline __m128 Mat2Mul(__m128 a, __m128 b) {
+	return _mm_add_ps(
+	  _mm_mul_ps(a, MATH_SWIZZLE(b, 0, 3, 0, 3)),
+	  _mm_mul_ps(MATH_SWIZZLE(a, 1, 0, 3, 2), MATH_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// adj(A) * B
+inline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+	return _mm_sub_ps(
+	  _mm_mul_ps(MATH_SWIZZLE(a, 3, 3, 0, 0), b),
+	  _mm_mul_ps(MATH_SWIZZLE(a, 1, 1, 2, 2), MATH_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+// A * adj(B)
+inline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+	return _mm_sub_ps(
+	  _mm_mul_ps(a, MATH_SWIZZLE(b, 3, 0, 3, 0)),
+	  _mm_mul_ps(MATH_SWIZZLE(a, 1, 0, 3, 2), MATH_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+} // namespace
+
+Matrix4 Matrix4InverseSSE2(const Matrix4& m, float* determinant) {
+	const __m128 r0 = _mm_loadu_ps(m.m[0]);
+	const __m128 r1 = _mm_loadu_ps(m.m[1]);
+	const __m128 r2 = _mm_loadu_ps(m.m[2]);
+	const __m128 r3 = _mm_loadu_ps(m.m[3]);
+
+	// M = | A B |
+	//     | C D |
+	const __m128 a = _mm_movelh_ps(r0, r1);
+	const __m128 b = _mm_movehl_ps(r1, r0);
+	const __m128 c = _mm_movelh_ps(r2, r3);
+	const __m128 d = _mm_movehl_ps(r3, r2);
+
+	// (|A|, |B|, |C|, |D|)
+	const __m128 detSub = _mm_sub_ps(
+	  _mm_mul_ps(
+	    _mm_shuffle_ps(r0, r2, MATH_SHUFFLE_MASK(0, 2, 0, 2)),
+	    _mm_shuffle_ps(r1, r3, MATH_SHUFFLE_MASK(1, 3, 1, 3))),
+	  _mm_mul_ps(
+	    _mm_shuffle_ps(r0, r2, MATH_SHUFFLE_MASK(1, 3, 1, 3)),
+	    _mm_shuffle_ps(r1, r3, MATH_SHUFFLE_MASK(0, 2, 0, 2))));
+	const __m128 detA = MATH_SWIZZLE(detSub, 0, 0, 0, 0);
+	const __m128 detB = MATH_SWIZZLE(detSub, 1, 1, 1, 1);
+	const __m128 detC = MATH_SWIZZLE(detSub, 2, 2, 2, 2);
+	const __m128 detD = MATH_SWIZZLE(detSub, 3, 3, 3, 3);
+
+	const __m128 dc = Mat2AdjMul(d, c);
+	const __m128 ab = Mat2AdjMul(a, b);
+	// inv(M) = 1/|M| * | X Y |  の各ブロックの随伴行列
+	//                  | Z W |
+	__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Mat2Mul(b, dc));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Mat2Mul(c, ab));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MulAdj(d, ab));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MulAdj(a, dc));
+
+	// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+	__m128 tr = _mm_mul_ps(ab, MATH_SWIZZLE(dc, 0, 2, 1, 3));
+	tr = _mm_add_ps(tr, MATH_SWIZZLE(tr, 2, 3, 0, 1));
+	tr = _mm_add_ps(tr, MATH_SWIZZLE(tr, 1, 0, 3, 2));
+	__m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+	const float det = _mm_cvtss_f32(detM);
+	if (determinant) {
+		*determinant = det;
+	}
+
+	Matrix4 result;
+	if (det == 0.0f) {
+		return result;
+	}
+
+	const __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+	x = _mm_mul_ps(x, rDetM);
+	y = _mm_mul_ps(y, rDetM);
+	z = _mm_mul_ps(z, rDetM);
+	w = _mm_mul_ps(w, rDetM);
+
+	// 随伴の並べ替えと行への展開をまとめて行う
+	_mm_storeu_ps(result.m[0], _mm_shuffle_ps(x, y, MATH_SHUFFLE_MASK(3, 1, 3, 1)));
+	_mm_storeu_ps(result.m[1], _mm_shuffle_ps(x, y, MATH_SHUFFLE_MASK(2, 0, 2, 0)));
+	_mm_storeu_ps(result.m[2], _mm_shuffle_ps(z, w, MATH_SHUFFLE_MASK(3, 1, 3, 1)));
+	_mm_storeu_ps(result.m[3], _mm_shuffle_ps(z, w, MATH_SHUFFLE_MASK(2, 0, 2, 0)));
+	return result;
+}
+
+#undef MATH_SWIZZLE
+#undef MATH_SHUFFLE_MASK
+
+#else
+
+Matrix4 Matrix4InverseSSE2(const Matrix4& m, float* determinant) {
+	return Matrix4InverseScalar(m, determinant);
+}
+
+#endif
+
+float Matrix4Determinant(const Matrix4& m) { return CalcCofactors(m).det; }
+
+Matrix4 Matrix4Inverse(const Matrix4& m, float* determinant) {
+#if MATH_SIMD_X86
+	return Matrix4InverseSSE2(m, determinant);
+#else
+	return Matrix4InverseScalar(m, determinant);
+#endif
+}
+
+Matrix4 Matrix4InverseAffine(const Matrix4& m) {
+	// 左上 3x3 の逆行列を余因子から求める
+	float c00 = m.m[1][1] * m.m[2][2] - m.m[1][2] * m.m[2][1];
+	float c01 = m.m[0][2] * m.m[2][1] - m.m[0][1] * m.m[2][2];
+	float c02 = m.m[0][1] * m.m[1][2] - m.m[0][2] * m.m[1][1];
+	float c10 = m.m[1][2] * m.m[2][0] - m.m[1][0] * m.m[2][2];
+	float c11 = m.m[0][0] * m.m[2][2] - m.m[0][2] * m.m[2][0];
+	float c12 = m.m[0][2] * m.m[1][0] - m.m[0][0] * m.m[1][2];
+	float c20 = m.m[1][0] * m.m[2][1] - m.m[1][1] * m.m[2][0];
+	float c21 = m.m[0][1] * m.m[2][0] - m.m[0][0] * m.m[2][1];
+	float c22 = m.m[0][0] * m.m[1][1] - m.m[0][1] * m.m[1][0];
+
+	float det = m.m[0][0] * c00 + m.m[0][1] * c10 + m.m[0][2] * c20;
+	if (det == 0.0f) {
+		return Matrix4();
+	}
+	float invDet = 1.0f / det;
+
+	Matrix4 result;
+	result.m[0][0] = c00 * invDet;
+	result.m[0][1] = c01 * invDet;
+	result.m[0][2] = c02 * invDet;
+	result.m[1][0] = c10 * invDet;
+	result.m[1][1] = c11 * invDet;
+	result.m[1][2] = c12 * invDet;
+	result.m[2][0] = c20 * invDet;
+	result.m[2][1] = c21 * invDet;
+	result.m[2][2] = c22 * invDet;
+
+	// 平行移動は -t * inv(R)
+	const float tx = m.m[3][0], ty = m.m[3][1], tz = m.m[3][2];
+	for (int j = 0; j < 3; j++) {
+		result.m[3][j] = -(tx * result.m[0][j] + ty * result.m[1][j] + tz * result.m[2][j]);
+	}
+	result.m[3][3] = 1.0f;
+	return result;
+}
+
+Matrix4 Matrix4InverseRigid(const Matrix4& m) {
+	Matrix4 result;
+	// 回転部分は直交行列なので転置が逆行列
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			result.m[i][j] = m.m[j][i];
+		}
+	}
+
+	const float tx = m.m[3][0], ty = m.m[3][1], tz = m.m[3][2];
+	for (int j = 0; j < 3; j++) {
+		result.m[3][j] = -(tx * result.m[0][j] + ty * result.m[1][j] + tz * result.m[2][j]);
+	}
+	result.m[3][3] = 1.0f;
+	return result;
+}
+
+} // namespace MathUtility
@@ -0,0 +1,21 @@
+﻿#pragma once
+
+#include "MathSimd.h"
+#include "Matrix4.h"
+
+namespace MathUtility {
+
+// 逆行列の許容誤差（拡大率 0.5〜2 のアフィン行列と、対角優位な一般の行列で
+// math_benchmark --verify が確かめる。実測の最大はどちらも 6e-7 程度）
+// ・M * inv(M) と単位行列の差の成分ごとの最大値
+const float kMatrix4InverseMaxResidual = 2e-6f;
+// ・SSE2 とスカラー実装の逆行列・行列式の差（成分の絶対値の最大値に対する比）
+const float kMatrix4InverseMaxDifference = 2e-6f;
+// 行列式が 0 のときはどのカーネルも零行列を返し、*determinant に 0 を書き込む
+
+// 逆行列（スカラー参照実装、余因子展開）
+Matrix4 Matrix4InverseScalar(const Matrix4& m, float* determinant);
+// 逆行列（SSE2、2x2 ブロック分解）
+Matrix4 Matrix4InverseSSE2(const Matrix4& m, float* determinant);
+
+} // namespace MathUtility
@@ -0,0 +1,135 @@
+﻿#include "Matrix4Multiply.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace MathUtility {
+
+void Matrix4MultiplyScalar(const Matrix4& m1, const Matrix4& m2, Matrix4& out) {
+	// out が m1, m2 と同じでも壊れないよう一時領域で計算する
+	float result[4][4];
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			result[i][j] = m1.m[i][0] * m2.m[0][j] + m1.m[i][1] * m2.m[1][j] +
+			               m1.m[i][2] * m2.m[2][j] + m1.m[i][3] * m2.m[3][j];
+		}
+	}
+	std::memcpy(out.m, result, sizeof(result));
+}
+
+#if MATH_SIMD_X86
+
+void Matrix4MultiplySSE2(const Matrix4& m1, const Matrix4& m2, Matrix4& out) {
+	const __m128 b0 = _mm_loadu_ps(m2.m[0]);
+	const __m128 b1 = _mm_loadu_ps(m2.m[1]);
+	const __m128 b2 = _mm_loadu_ps(m2.m[2]);
+	const __m128 b3 = _mm_loadu_ps(m2.m[3]);
+
+	// 全行を計算してから書き込む（out の別名対策）
+	__m128 rows[4];
+	for (int i = 0; i < 4; i++) {
+		const __m128 a = _mm_loadu_ps(m1.m[i]);
+		__m128 r = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+		rows[i] = r;
+	}
+	for (int i = 0; i < 4; i++) {
+		_mm_storeu_ps(out.m[i], rows[i]);
+	}
+}
+
+MATH_TARGET_AVX2
+void Matrix4MultiplyAVX2(const Matrix4& m1, const Matrix4& m2, Matrix4& out) {
+	// 右辺の各行を上下 128bit に複製
+	const __m256 b01 = _mm256_loadu_ps(m2.m[0]);
+	const __m256 b23 = _mm256_loadu_ps(m2.m[2]);
+	const __m256 b0 = _mm256_permute2f128_ps(b01, b01, 0x00);
+	const __m256 b1 = _mm256_permute2f128_ps(b01, b01, 0x11);
+	const __m256 b2 = _mm256_permute2f128_ps(b23, b23, 0x00);
+	const __m256 b3 = _mm256_permute2f128_ps(b23, b23, 0x11);
+
+	// 左辺は2行ずつ処理する（shuffle は 128bit レーン内で行ごとに働く）
+	const __m256 a01 = _mm256_loadu_ps(m1.m[0]);
+	const __m256 a23 = _mm256_loadu_ps(m1.m[2]);
+
+	__m256 r01 = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x00), b0);
+	r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0x55), b1, r01);
+	r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0xAA), b2, r01);
+	r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0xFF), b3, r01);
+
+	__m256 r23 = _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x00), b0);
+	r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, 0x55), b1, r23);
+	r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, 0xAA), b2, r23);
+	r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, 0xFF), b3, r23);
+
+	_mm256_storeu_ps(out.m[0], r01);
+	_mm256_storeu_ps(out.m[2], r23);
+}
+
+#else
+
+void Matrix4MultiplySSE2(const Matrix4& m1, const Matrix4& m2, Matrix4& out) {
+	Matrix4MultiplyScalar(m1, m2, out);
+}
+
+void Matrix4MultiplyAVX2(const Matrix4& m1, const Matrix4& m2, Matrix4& out) {
+	Matrix4MultiplyScalar(m1, m2, out);
+}
+
+#endif
+
+namespace {
+
+using Matrix4MultiplyFunc = void (*)(const Matrix4&, const Matrix4&, Matrix4&);
+
+Matrix4MultiplyFunc SelectMatrix4Multiply() {
+	switch (GetSimdLevel()) {
+	case SimdLevel::kAVX2:
+		return Matrix4MultiplyAVX2;
+	case SimdLevel::kSSE2:
+		return Matrix4MultiplySSE2;
+	default:
+		return Matrix4MultiplyScalar;
+	}
+}
+
+// 大きさ magnitude の float の間隔（0 なら最小の非正規化数）
+double FloatUlp(double magnitude) {
+	if (magnitude == 0.0) {
+		return std::numeric_limits<float>::denorm_min();
+	}
+	int exponent;
+	std::frexp(magnitude, &exponent);
+	// magnitude は [2^(exponent-1), 2^exponent) にあり、float の仮数は 24 ビット
+	return std::ldexp(1.0, (std::max)(exponent - 24, std::numeric_limits<float>::min_exponent - 24));
+}
+
+} // namespace
+
+void Matrix4Multiply(const Matrix4& m1, const Matrix4& m2, Matrix4& out) {
+	// コンパイル時に AVX2 が有効な場合も GetSimdLevel が AVX2 を返す
+	static const Matrix4MultiplyFunc kernel = SelectMatrix4Multiply();
+	kernel(m1, m2, out);
+}
+
+double Matrix4MultiplyMaxUlpError(
+  const Matrix4& m1, const Matrix4& m2, const Matrix4& result1, const Matrix4& result2) {
+	double maxUlp = 0.0;
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			double magnitude = 0.0;
+			for (int k = 0; k < 4; k++) {
+				magnitude += std::fabs(static_cast<double>(m1.m[i][k]) * m2.m[k][j]);
+			}
+			double difference =
+			  std::fabs(static_cast<double>(result1.m[i][j]) - static_cast<double>(result2.m[i][j]));
+			maxUlp = (std::max)(maxUlp, difference / FloatUlp(magnitude));
+		}
+	}
+	return maxUlp;
+}
+
+} // namespace MathUtility
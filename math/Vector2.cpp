@@ -1,18 +1,12 @@
-#include "Vector2.h"
+﻿#include "Vector2.h"
 #include <cmath>
 
-Vector2::Vector2() {
-	x = 0;
-	y = 0;
-}
+Vector2::Vector2() : x(0), y(0) {}
 
-Vector2::Vector2(float x, float y) {
-	this->x = x;
-	this->y = y;
-}
+Vector2::Vector2(float x, float y) : x(x), y(y) {}
 
 float Vector2::Magnitude()const {
-	return sqrtf(pow(x, 2) + pow(y, 2));
+	return std::sqrt(Dot(*this));
 }
 
 Vector2& Vector2::Norm() {
@@ -28,7 +22,7 @@ float Vector2::Dot(const Vector2& v)const {
 }
 
 float Vector2::Cross(const Vector2& v)const {
-	return x * v.y + y * v.x;
+	return x * v.y - y * v.x;
 }
 
 Vector2 Vector2::operator+()const {
@@ -36,7 +30,7 @@ Vector2 Vector2::operator+()const {
 }
 
 Vector2 Vector2::operator-()const {
-	return Vector2(-*this);
+	return Vector2(-x, -y);
 }
 
 Vector2& Vector2::operator+=(const Vector2& v) {
@@ -75,7 +69,7 @@ const Vector2 operator-(const Vector2& v1, const Vector2& v2) {
 
 const Vector2 operator*(const Vector2& v, float s) {
 	Vector2 temp(v);
-	return s * v;
+	return temp *= s;
 }
 
 const Vector2 operator*(float s, const Vector2 v) {
@@ -84,5 +78,5 @@ const Vector2 operator*(float s, const Vector2 v) {
 
 const Vector2 operator/(const Vector2& v, float s) {
 	Vector2 temp(v);
-	return v / s;
-}
\ No newline at end of file
+	return temp /= s;
+}
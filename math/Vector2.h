@@ -13,6 +13,15 @@ class Vector2 {
 	Vector2();                          // 零ベクトルとする
 	Vector2(float x, float y); // x成分, y成分 を指定しての生成
 
+	// ノルム(長さ)を求める
+	float Magnitude() const;
+	// 正規化する
+	Vector2& Norm();
+	// 内積
+	float Dot(const Vector2& v) const;
+	// 外積
+	float Cross(const Vector2& v) const;
+
 	// 単項演算子オーバーロード
 	Vector2 operator+() const;
 	Vector2 operator-() const;
@@ -23,3 +32,10 @@ class Vector2 {
 	Vector2& operator*=(float s);
 	Vector2& operator/=(float s);
 };
+
+// 2項演算子オーバーロード
+const Vector2 operator+(const Vector2& v1, const Vector2& v2);
+const Vector2 operator-(const Vector2& v1, const Vector2& v2);
+const Vector2 operator*(const Vector2& v, float s);
+const Vector2 operator*(float s, const Vector2 v);
+const Vector2 operator/(const Vector2& v, float s);
@@ -0,0 +1,70 @@
+﻿#include "Vector3.h"
+#include <cmath>
+
+Vector3::Vector3() : x(0), y(0), z(0) {}
+
+Vector3::Vector3(float x, float y, float z) : x(x), y(y), z(z) {}
+
+Vector3& Vector3::Zero() {
+	x = 0.f;
+	y = 0.f;
+	z = 0.f;
+	return *this;
+}
+
+Vector3 Vector3::Cross(const Vector3& v)const {
+	Vector3 vecCross = { (y * v.z) - (z * v.y) ,(z * v.x) - (x * v.z) ,(x * v.y) - (y * v.x) };
+	return vecCross;
+}
+
+float Vector3::Magnitude()const {
+	return std::sqrt(Dot(*this));
+}
+
+float Vector3::Dot(const Vector3& v)const {
+	return x * v.x + y * v.y + z * v.z;
+}
+
+Vector3& Vector3::Normalize() {
+	float mag = Magnitude();
+	if (mag != 0) {
+		return *this /= mag;
+	}
+	return *this;
+}
+
+Vector3 Vector3::operator+() const {
+	return *this;
+}
+
+Vector3 Vector3::operator-() const {
+	return Vector3(-x, -y, -z);
+}
+
+Vector3& Vector3::operator+=(const Vector3& v) {
+	x += v.x;
+	y += v.y;
+	z += v.z;
+	return *this;
+}
+
+Vector3& Vector3::operator-=(const Vector3& v) {
+	x -= v.x;
+	y -= v.y;
+	z -= v.z;
+	return *this;
+}
+
+Vector3& Vector3::operator*=(float s) {
+	x *= s;
+	y *= s;
+	z *= s;
+	return *this;
+}
+
+Vector3& Vector3::operator/=(float s) {
+	x /= s;
+	y /= s;
+	z /= s;
+	return *this;
+}
@@ -37,8 +37,20 @@ public:
 	Vector3& operator/=(float s);
 };
 
+namespace MathUtility {
+
+// 2項演算子オーバーロード（定義は MathUtility.cpp）
 const Vector3 operator+(const Vector3& v1, const Vector3& v2);
 const Vector3 operator-(const Vector3& v1, const Vector3& v2);
 const Vector3 operator*(const Vector3& v, float s);
 const Vector3 operator*(float s, const Vector3& v);
-const Vector3 operator/(const Vector3& v, float s);
\ No newline at end of file
+const Vector3 operator/(const Vector3& v, float s);
+
+} // namespace MathUtility
+
+// グローバル名前空間からも同じ関数を参照する
+// （別の関数にすると using namespace MathUtility した所で呼び出しが曖昧になる）
+using MathUtility::operator+;
+using MathUtility::operator-;
+using MathUtility::operator*;
+using MathUtility::operator/;
@@ -0,0 +1,244 @@
+﻿#include "Vector3Batch.h"
+#include "MathSimd.h"
+#include <cassert>
+#include <cstdint>
+
+namespace MathUtility {
+
+namespace {
+
+// 変換の種類
+enum class TransformKind {
+	kPoint,  // 平行移動あり、w除算なし
+	kCoord,  // 平行移動あり、w除算あり
+	kNormal, // 平行移動なし
+};
+
+// 1要素分の変換（スカラー）
+template<TransformKind kind>
+void TransformScalar(float x, float y, float z, const Matrix4& m, float& ox, float& oy, float& oz) {
+	float rx = x * m.m[0][0] + y * m.m[1][0] + z * m.m[2][0];
+	float ry = x * m.m[0][1] + y * m.m[1][1] + z * m.m[2][1];
+	float rz = x * m.m[0][2] + y * m.m[1][2] + z * m.m[2][2];
+	if constexpr (kind != TransformKind::kNormal) {
+		rx += m.m[3][0];
+		ry += m.m[3][1];
+		rz += m.m[3][2];
+	}
+	if constexpr (kind == TransformKind::kCoord) {
+		float w = x * m.m[0][3] + y * m.m[1][3] + z * m.m[2][3] + m.m[3][3];
+		rx /= w;
+		ry /= w;
+		rz /= w;
+	}
+	ox = rx;
+	oy = ry;
+	oz = rz;
+}
+
+template<TransformKind kind>
+void TransformScalar(const Vector3& v, const Matrix4& m, Vector3& out) {
+	TransformScalar<kind>(v.x, v.y, v.z, m, out.x, out.y, out.z);
+}
+
+#if MATH_SIMD_X86
+
+inline bool IsAligned16(const void* p) { return (reinterpret_cast<uintptr_t>(p) & 0xF) == 0; }
+
+// 4成分を一度に書き込む
+template<bool nonTemporal> inline void Store(float* p, __m128 v) {
+	if constexpr (nonTemporal) {
+		_mm_stream_ps(p, v);
+	} else {
+		_mm_storeu_ps(p, v);
+	}
+}
+
+// 1ベクトル (x, y, z) を行列の各行に掛けて (x', y', z', w') を得る
+template<TransformKind kind>
+inline __m128 TransformOne(
+  __m128 x, __m128 y, __m128 z, __m128 r0, __m128 r1, __m128 r2, __m128 r3) {
+	__m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, r0), _mm_mul_ps(y, r1)), _mm_mul_ps(z, r2));
+	if constexpr (kind != TransformKind::kNormal) {
+		r = _mm_add_ps(r, r3);
+	}
+	if constexpr (kind == TransformKind::kCoord) {
+		r = _mm_div_ps(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3)));
+	}
+	return r;
+}
+
+// AoS 配列を4要素（48バイト）ずつ処理する
+template<TransformKind kind, bool nonTemporal>
+size_t TransformAoS4(const Vector3* src, Vector3* dst, size_t count, const Matrix4& m) {
+	const __m128 r0 = _mm_loadu_ps(m.m[0]);
+	const __m128 r1 = _mm_loadu_ps(m.m[1]);
+	const __m128 r2 = _mm_loadu_ps(m.m[2]);
+	const __m128 r3 = _mm_loadu_ps(m.m[3]);
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const float* in = &src[i].x;
+		float* out = &dst[i].x;
+		// x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+		const __m128 v0 = _mm_loadu_ps(in);
+		const __m128 v1 = _mm_loadu_ps(in + 4);
+		const __m128 v2 = _mm_loadu_ps(in + 8);
+
+		const __m128 a = TransformOne<kind>(
+		  _mm_shuffle_ps(v0, v0, 0x00), _mm_shuffle_ps(v0, v0, 0x55), _mm_shuffle_ps(v0, v0, 0xAA),
+		  r0, r1, r2, r3);
+		const __m128 b = TransformOne<kind>(
+		  _mm_shuffle_ps(v0, v0, 0xFF), _mm_shuffle_ps(v1, v1, 0x00), _mm_shuffle_ps(v1, v1, 0x55),
+		  r0, r1, r2, r3);
+		const __m128 c = TransformOne<kind>(
+		  _mm_shuffle_ps(v1, v1, 0xAA), _mm_shuffle_ps(v1, v1, 0xFF), _mm_shuffle_ps(v2, v2, 0x00),
+		  r0, r1, r2, r3);
+		const __m128 d = TransformOne<kind>(
+		  _mm_shuffle_ps(v2, v2, 0x55), _mm_shuffle_ps(v2, v2, 0xAA), _mm_shuffle_ps(v2, v2, 0xFF),
+		  r0, r1, r2, r3);
+
+		// a0 a1 a2 b0 | b1 b2 c0 c1 | c2 d0 d1 d2 に詰め直す
+		const __m128 ab = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 2, 2));
+		const __m128 cd = _mm_shuffle_ps(c, d, _MM_SHUFFLE(0, 0, 2, 2));
+		Store<nonTemporal>(out, _mm_shuffle_ps(a, ab, _MM_SHUFFLE(2, 0, 1, 0)));
+		Store<nonTemporal>(out + 4, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 2, 1)));
+		Store<nonTemporal>(out + 8, _mm_shuffle_ps(cd, d, _MM_SHUFFLE(2, 1, 2, 0)));
+	}
+	return i;
+}
+
+// SoA 配列を4要素ずつ処理する
+template<TransformKind kind, bool nonTemporal>
+size_t TransformSoA4(
+  const float* x, const float* y, const float* z, float* ox, float* oy, float* oz, size_t count,
+  const Matrix4& m) {
+	const __m128 m00 = _mm_set1_ps(m.m[0][0]), m01 = _mm_set1_ps(m.m[0][1]),
+	             m02 = _mm_set1_ps(m.m[0][2]), m03 = _mm_set1_ps(m.m[0][3]);
+	const __m128 m10 = _mm_set1_ps(m.m[1][0]), m11 = _mm_set1_ps(m.m[1][1]),
+	             m12 = _mm_set1_ps(m.m[1][2]), m13 = _mm_set1_ps(m.m[1][3]);
+	const __m128 m20 = _mm_set1_ps(m.m[2][0]), m21 = _mm_set1_ps(m.m[2][1]),
+	             m22 = _mm_set1_ps(m.m[2][2]), m23 = _mm_set1_ps(m.m[2][3]);
+	const __m128 m30 = _mm_set1_ps(m.m[3][0]), m31 = _mm_set1_ps(m.m[3][1]),
+	             m32 = _mm_set1_ps(m.m[3][2]), m33 = _mm_set1_ps(m.m[3][3]);
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128 vx = _mm_loadu_ps(x + i);
+		const __m128 vy = _mm_loadu_ps(y + i);
+		const __m128 vz = _mm_loadu_ps(z + i);
+
+		__m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m00), _mm_mul_ps(vy, m10)), _mm_mul_ps(vz, m20));
+		__m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m01), _mm_mul_ps(vy, m11)), _mm_mul_ps(vz, m21));
+		__m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m02), _mm_mul_ps(vy, m12)), _mm_mul_ps(vz, m22));
+		if constexpr (kind != TransformKind::kNormal) {
+			rx = _mm_add_ps(rx, m30);
+			ry = _mm_add_ps(ry, m31);
+			rz = _mm_add_ps(rz, m32);
+		}
+		if constexpr (kind == TransformKind::kCoord) {
+			__m128 w = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m03), _mm_mul_ps(vy, m13)), _mm_mul_ps(vz, m23));
+			w = _mm_add_ps(w, m33);
+			rx = _mm_div_ps(rx, w);
+			ry = _mm_div_ps(ry, w);
+			rz = _mm_div_ps(rz, w);
+		}
+		Store<nonTemporal>(ox + i, rx);
+		Store<nonTemporal>(oy + i, ry);
+		Store<nonTemporal>(oz + i, rz);
+	}
+	return i;
+}
+
+#endif
+
+template<TransformKind kind>
+void TransformArray(
+  std::span<const Vector3> src, std::span<Vector3> dst, const Matrix4& m, StoreHint hint) {
+	assert(src.size() == dst.size());
+	const size_t count = src.size();
+	size_t i = 0;
+
+#if MATH_SIMD_X86
+	if (hint == StoreHint::kNonTemporal) {
+		// 12バイト単位で進むと4要素以内に16バイト境界に揃う
+		for (; i < count && !IsAligned16(dst.data() + i); i++) {
+			TransformScalar<kind>(src[i], m, dst[i]);
+		}
+		if (IsAligned16(dst.data() + i)) {
+			i += TransformAoS4<kind, true>(src.data() + i, dst.data() + i, count - i, m);
+			_mm_sfence();
+		}
+	}
+	i += TransformAoS4<kind, false>(src.data() + i, dst.data() + i, count - i, m);
+#else
+	(void)hint;
+#endif
+
+	for (; i < count; i++) {
+		TransformScalar<kind>(src[i], m, dst[i]);
+	}
+}
+
+template<TransformKind kind>
+void TransformSoA(
+  const Vector3SoAConstSpan& src, const Vector3SoASpan& dst, const Matrix4& m, StoreHint hint) {
+	const size_t count = src.x.size();
+	assert(src.y.size() == count && src.z.size() == count);
+	assert(dst.x.size() == count && dst.y.size() == count && dst.z.size() == count);
+	size_t i = 0;
+
+#if MATH_SIMD_X86
+	if (hint == StoreHint::kNonTemporal && IsAligned16(dst.x.data()) &&
+	    IsAligned16(dst.y.data()) && IsAligned16(dst.z.data())) {
+		i = TransformSoA4<kind, true>(
+		  src.x.data(), src.y.data(), src.z.data(), dst.x.data(), dst.y.data(), dst.z.data(),
+		  count, m);
+		_mm_sfence();
+	} else {
+		i = TransformSoA4<kind, false>(
+		  src.x.data(), src.y.data(), src.z.data(), dst.x.data(), dst.y.data(), dst.z.data(),
+		  count, m);
+	}
+#else
+	(void)hint;
+#endif
+
+	for (; i < count; i++) {
+		TransformScalar<kind>(src.x[i], src.y[i], src.z[i], m, dst.x[i], dst.y[i], dst.z[i]);
+	}
+}
+
+} // namespace
+
+void Vector3TransformArray(
+  std::span<const Vector3> src, std::span<Vector3> dst, const Matrix4& m, StoreHint hint) {
+	TransformArray<TransformKind::kPoint>(src, dst, m, hint);
+}
+
+void Vector3TransformCoordArray(
+  std::span<const Vector3> src, std::span<Vector3> dst, const Matrix4& m, StoreHint hint) {
+	TransformArray<TransformKind::kCoord>(src, dst, m, hint);
+}
+
+void Vector3TransformNormalArray(
+  std::span<const Vector3> src, std::span<Vector3> dst, const Matrix4& m, StoreHint hint) {
+	TransformArray<TransformKind::kNormal>(src, dst, m, hint);
+}
+
+void Vector3TransformSoA(
+  const Vector3SoAConstSpan& src, const Vector3SoASpan& dst, const Matrix4& m, StoreHint hint) {
+	TransformSoA<TransformKind::kPoint>(src, dst, m, hint);
+}
+
+void Vector3TransformCoordSoA(
+  const Vector3SoAConstSpan& src, const Vector3SoASpan& dst, const Matrix4& m, StoreHint hint) {
+	TransformSoA<TransformKind::kCoord>(src, dst, m, hint);
+}
+
+void Vector3TransformNormalSoA(
+  const Vector3SoAConstSpan& src, const Vector3SoASpan& dst, const Matrix4& m, StoreHint hint) {
+	TransformSoA<TransformKind::kNormal>(src, dst, m, hint);
+}
+
+} // namespace MathUtility
@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include "Matrix4.h"
+#include "Vector3.h"
+#include <span>
+
+namespace MathUtility {
+
+/// <summary>
+/// 書き込み方法の指定
+/// </summary>
+enum class StoreHint {
+	kCached,      // 通常の書き込み
+	kNonTemporal, // キャッシュを汚さない書き込み（結果をすぐ読まない大量データ向け）
+};
+
+// SoA 形式の3次元ベクトル列（x, y, z 成分を別々の配列で持つ）
+struct Vector3SoASpan {
+	std::span<float> x;
+	std::span<float> y;
+	std::span<float> z;
+};
+
+// SoA 形式の3次元ベクトル列（読み取り専用）
+struct Vector3SoAConstSpan {
+	std::span<const float> x;
+	std::span<const float> y;
+	std::span<const float> z;
+};
+
+// 一括変換の結果は StoreHint や配列の境界によらず、1要素ずつの関数とビット単位で一致する
+// （math_benchmark --verify で確かめる）
+
+// 配列の座標変換（w除算なし） dst[i] = Vector3Transform(src[i], m)
+// src と dst は同じ配列でもよい
+void Vector3TransformArray(
+  std::span<const Vector3> src, std::span<Vector3> dst, const Matrix4& m,
+  StoreHint hint = StoreHint::kCached);
+// 配列の座標変換（w除算あり） dst[i] = Vector3TransformCoord(src[i], m)
+void Vector3TransformCoordArray(
+  std::span<const Vector3> src, std::span<Vector3> dst, const Matrix4& m,
+  StoreHint hint = StoreHint::kCached);
+// 配列のベクトル変換 dst[i] = Vector3TransformNormal(src[i], m)
+void Vector3TransformNormalArray(
+  std::span<const Vector3> src, std::span<Vector3> dst, const Matrix4& m,
+  StoreHint hint = StoreHint::kCached);
+
+// SoA 配列の座標変換（w除算なし）
+// kNonTemporal は出力の3配列がすべて16バイト境界に揃っている場合のみ有効
+void Vector3TransformSoA(
+  const Vector3SoAConstSpan& src, const Vector3SoASpan& dst, const Matrix4& m,
+  StoreHint hint = StoreHint::kCached);
+// SoA 配列の座標変換（w除算あり）
+void Vector3TransformCoordSoA(
+  const Vector3SoAConstSpan& src, const Vector3SoASpan& dst, const Matrix4& m,
+  StoreHint hint = StoreHint::kCached);
+// SoA 配列のベクトル変換
+void Vector3TransformNormalSoA(
+  const Vector3SoAConstSpan& src, const Vector3SoASpan& dst, const Matrix4& m,
+  StoreHint hint = StoreHint::kCached);
+
+} // namespace MathUtility
@@ -0,0 +1,262 @@
+﻿#include "Vector3Stream.h"
+#include "MathSimd.h"
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+#if MATH_SIMD_X86
+// 成分配列は整列済みだが、部分範囲を扱っても壊れないよう非整列ロードを使う
+inline __m128 Load(const float* p) { return _mm_loadu_ps(p); }
+inline void Store(float* p, __m128 v) { _mm_storeu_ps(p, v); }
+#endif
+
+} // namespace
+
+Vector3Stream::Vector3Stream(size_t size) { Resize(size); }
+
+Vector3Stream::Vector3Stream(std::span<const Vector3> vectors) { Assign(vectors); }
+
+void Vector3Stream::Assign(std::span<const Vector3> vectors) {
+	Resize(vectors.size());
+	for (size_t i = 0; i < vectors.size(); i++) {
+		x_[i] = vectors[i].x;
+		y_[i] = vectors[i].y;
+		z_[i] = vectors[i].z;
+	}
+}
+
+void Vector3Stream::CopyTo(std::span<Vector3> dst) const {
+	assert(dst.size() == Size());
+	for (size_t i = 0; i < dst.size(); i++) {
+		dst[i].x = x_[i];
+		dst[i].y = y_[i];
+		dst[i].z = z_[i];
+	}
+}
+
+std::vector<Vector3> Vector3Stream::ToVector() const {
+	std::vector<Vector3> result(Size());
+	CopyTo(result);
+	return result;
+}
+
+void Vector3Stream::Resize(size_t size) {
+	x_.resize(size);
+	y_.resize(size);
+	z_.resize(size);
+}
+
+void Vector3Stream::Reserve(size_t capacity) {
+	x_.reserve(capacity);
+	y_.reserve(capacity);
+	z_.reserve(capacity);
+}
+
+void Vector3Stream::Clear() {
+	x_.clear();
+	y_.clear();
+	z_.clear();
+}
+
+void Vector3Stream::PushBack(const Vector3& v) {
+	x_.push_back(v.x);
+	y_.push_back(v.y);
+	z_.push_back(v.z);
+}
+
+void Vector3Stream::Set(size_t index, const Vector3& v) {
+	x_[index] = v.x;
+	y_[index] = v.y;
+	z_[index] = v.z;
+}
+
+void Vector3Stream::Add(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& out) {
+	assert(a.Size() == b.Size());
+	const size_t count = a.Size();
+	out.Resize(count);
+	size_t i = 0;
+#if MATH_SIMD_X86
+	for (; i + 4 <= count; i += 4) {
+		Store(&out.x_[i], _mm_add_ps(Load(&a.x_[i]), Load(&b.x_[i])));
+		Store(&out.y_[i], _mm_add_ps(Load(&a.y_[i]), Load(&b.y_[i])));
+		Store(&out.z_[i], _mm_add_ps(Load(&a.z_[i]), Load(&b.z_[i])));
+	}
+#endif
+	for (; i < count; i++) {
+		out.x_[i] = a.x_[i] + b.x_[i];
+		out.y_[i] = a.y_[i] + b.y_[i];
+		out.z_[i] = a.z_[i] + b.z_[i];
+	}
+}
+
+void Vector3Stream::Subtract(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& out) {
+	assert(a.Size() == b.Size());
+	const size_t count = a.Size();
+	out.Resize(count);
+	size_t i = 0;
+#if MATH_SIMD_X86
+	for (; i + 4 <= count; i += 4) {
+		Store(&out.x_[i], _mm_sub_ps(Load(&a.x_[i]), Load(&b.x_[i])));
+		Store(&out.y_[i], _mm_sub_ps(Load(&a.y_[i]), Load(&b.y_[i])));
+		Store(&out.z_[i], _mm_sub_ps(Load(&a.z_[i]), Load(&b.z_[i])));
+	}
+#endif
+	for (; i < count; i++) {
+		out.x_[i] = a.x_[i] - b.x_[i];
+		out.y_[i] = a.y_[i] - b.y_[i];
+		out.z_[i] = a.z_[i] - b.z_[i];
+	}
+}
+
+void Vector3Stream::Scale(const Vector3Stream& a, float s, Vector3Stream& out) {
+	const size_t count = a.Size();
+	out.Resize(count);
+	size_t i = 0;
+#if MATH_SIMD_X86
+	const __m128 vs = _mm_set1_ps(s);
+	for (; i + 4 <= count; i += 4) {
+		Store(&out.x_[i], _mm_mul_ps(Load(&a.x_[i]), vs));
+		Store(&out.y_[i], _mm_mul_ps(Load(&a.y_[i]), vs));
+		Store(&out.z_[i], _mm_mul_ps(Load(&a.z_[i]), vs));
+	}
+#endif
+	for (; i < count; i++) {
+		out.x_[i] = a.x_[i] * s;
+		out.y_[i] = a.y_[i] * s;
+		out.z_[i] = a.z_[i] * s;
+	}
+}
+
+void Vector3Stream::MultiplyAdd(
+  const Vector3Stream& a, const Vector3Stream& b, float s, Vector3Stream& out) {
+	assert(a.Size() == b.Size());
+	const size_t count = a.Size();
+	out.Resize(count);
+	size_t i = 0;
+#if MATH_SIMD_X86
+	const __m128 vs = _mm_set1_ps(s);
+	for (; i + 4 <= count; i += 4) {
+		Store(&out.x_[i], _mm_add_ps(Load(&a.x_[i]), _mm_mul_ps(Load(&b.x_[i]), vs)));
+		Store(&out.y_[i], _mm_add_ps(Load(&a.y_[i]), _mm_mul_ps(Load(&b.y_[i]), vs)));
+		Store(&out.z_[i], _mm_add_ps(Load(&a.z_[i]), _mm_mul_ps(Load(&b.z_[i]), vs)));
+	}
+#endif
+	for (; i < count; i++) {
+		out.x_[i] = a.x_[i] + b.x_[i] * s;
+		out.y_[i] = a.y_[i] + b.y_[i] * s;
+		out.z_[i] = a.z_[i] + b.z_[i] * s;
+	}
+}
+
+void Vector3Stream::Lerp(
+  const Vector3Stream& a, const Vector3Stream& b, float t, Vector3Stream& out) {
+	assert(a.Size() == b.Size());
+	const size_t count = a.Size();
+	out.Resize(count);
+	size_t i = 0;
+#if MATH_SIMD_X86
+	const __m128 vt = _mm_set1_ps(t);
+	for (; i + 4 <= count; i += 4) {
+		const __m128 ax = Load(&a.x_[i]);
+		const __m128 ay = Load(&a.y_[i]);
+		const __m128 az = Load(&a.z_[i]);
+		Store(&out.x_[i], _mm_add_ps(ax, _mm_mul_ps(_mm_sub_ps(Load(&b.x_[i]), ax), vt)));
+		Store(&out.y_[i], _mm_add_ps(ay, _mm_mul_ps(_mm_sub_ps(Load(&b.y_[i]), ay), vt)));
+		Store(&out.z_[i], _mm_add_ps(az, _mm_mul_ps(_mm_sub_ps(Load(&b.z_[i]), az), vt)));
+	}
+#endif
+	for (; i < count; i++) {
+		out.x_[i] = a.x_[i] + (b.x_[i] - a.x_[i]) * t;
+		out.y_[i] = a.y_[i] + (b.y_[i] - a.y_[i]) * t;
+		out.z_[i] = a.z_[i] + (b.z_[i] - a.z_[i]) * t;
+	}
+}
+
+void Vector3Stream::Cross(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& out) {
+	assert(a.Size() == b.Size());
+	const size_t count = a.Size();
+	out.Resize(count);
+	size_t i = 0;
+#if MATH_SIMD_X86
+	for (; i + 4 <= count; i += 4) {
+		const __m128 ax = Load(&a.x_[i]), ay = Load(&a.y_[i]), az = Load(&a.z_[i]);
+		const __m128 bx = Load(&b.x_[i]), by = Load(&b.y_[i]), bz = Load(&b.z_[i]);
+		Store(&out.x_[i], _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by)));
+		Store(&out.y_[i], _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz)));
+		Store(&out.z_[i], _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx)));
+	}
+#endif
+	for (; i < count; i++) {
+		const float ax = a.x_[i], ay = a.y_[i], az = a.z_[i];
+		const float bx = b.x_[i], by = b.y_[i], bz = b.z_[i];
+		out.x_[i] = ay * bz - az * by;
+		out.y_[i] = az * bx - ax * bz;
+		out.z_[i] = ax * by - ay * bx;
+	}
+}
+
+void Vector3Stream::Normalize(const Vector3Stream& a, Vector3Stream& out) {
+	const size_t count = a.Size();
+	out.Resize(count);
+	size_t i = 0;
+#if MATH_SIMD_X86
+	const __m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= count; i += 4) {
+		const __m128 ax = Load(&a.x_[i]), ay = Load(&a.y_[i]), az = Load(&a.z_[i]);
+		const __m128 len = _mm_sqrt_ps(
+		  _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, ax), _mm_mul_ps(ay, ay)), _mm_mul_ps(az, az)));
+		// 長さ0の要素は除算結果を捨てて元の値を残す
+		const __m128 valid = _mm_cmpneq_ps(len, zero);
+		Store(&out.x_[i], _mm_or_ps(_mm_and_ps(valid, _mm_div_ps(ax, len)), _mm_andnot_ps(valid, ax)));
+		Store(&out.y_[i], _mm_or_ps(_mm_and_ps(valid, _mm_div_ps(ay, len)), _mm_andnot_ps(valid, ay)));
+		Store(&out.z_[i], _mm_or_ps(_mm_and_ps(valid, _mm_div_ps(az, len)), _mm_andnot_ps(valid, az)));
+	}
+#endif
+	for (; i < count; i++) {
+		const float ax = a.x_[i], ay = a.y_[i], az = a.z_[i];
+		const float len = std::sqrt(ax * ax + ay * ay + az * az);
+		if (len != 0) {
+			out.x_[i] = ax / len;
+			out.y_[i] = ay / len;
+			out.z_[i] = az / len;
+		} else {
+			out.x_[i] = ax;
+			out.y_[i] = ay;
+			out.z_[i] = az;
+		}
+	}
+}
+
+void Vector3Stream::Dot(const Vector3Stream& a, const Vector3Stream& b, std::span<float> out) {
+	assert(a.Size() == b.Size() && out.size() == a.Size());
+	const size_t count = a.Size();
+	size_t i = 0;
+#if MATH_SIMD_X86
+	for (; i + 4 <= count; i += 4) {
+		const __m128 xx = _mm_mul_ps(Load(&a.x_[i]), Load(&b.x_[i]));
+		const __m128 yy = _mm_mul_ps(Load(&a.y_[i]), Load(&b.y_[i]));
+		const __m128 zz = _mm_mul_ps(Load(&a.z_[i]), Load(&b.z_[i]));
+		Store(&out[i], _mm_add_ps(_mm_add_ps(xx, yy), zz));
+	}
+#endif
+	for (; i < count; i++) {
+		out[i] = a.x_[i] * b.x_[i] + a.y_[i] * b.y_[i] + a.z_[i] * b.z_[i];
+	}
+}
+
+void Vector3Stream::Length(const Vector3Stream& a, std::span<float> out) {
+	assert(out.size() == a.Size());
+	const size_t count = a.Size();
+	size_t i = 0;
+#if MATH_SIMD_X86
+	for (; i + 4 <= count; i += 4) {
+		const __m128 ax = Load(&a.x_[i]), ay = Load(&a.y_[i]), az = Load(&a.z_[i]);
+		Store(&out[i], _mm_sqrt_ps(_mm_add_ps(
+		                 _mm_add_ps(_mm_mul_ps(ax, ax), _mm_mul_ps(ay, ay)), _mm_mul_ps(az, az))));
+	}
+#endif
+	for (; i < count; i++) {
+		out[i] = std::sqrt(a.x_[i] * a.x_[i] + a.y_[i] * a.y_[i] + a.z_[i] * a.z_[i]);
+	}
+}
@@ -0,0 +1,88 @@
+﻿#pragma once
+
+#include "AlignedAllocator.h"
+#include "Vector3.h"
+#include "Vector3Batch.h"
+#include <span>
+#include <vector>
+
+/// <summary>
+/// 3次元ベクトル列（SoA 形式）
+/// x, y, z 成分を別々の整列済み配列で持ち、一括演算を SIMD 幅で処理する
+/// </summary>
+class Vector3Stream {
+  public:
+	// 各成分配列の境界（AVX の 256bit に合わせる）
+	static const size_t kAlignment = 32;
+	// 成分配列の型
+	using FloatArray = std::vector<float, AlignedAllocator<float, kAlignment>>;
+
+  public: // メンバ関数
+	// コンストラクタ
+	Vector3Stream() = default;
+	// 要素数を指定しての生成（零ベクトルで埋める）
+	explicit Vector3Stream(size_t size);
+	// AoS 配列からの生成
+	explicit Vector3Stream(std::span<const Vector3> vectors);
+
+	// AoS 配列の内容で置き換える
+	void Assign(std::span<const Vector3> vectors);
+	// AoS 配列へ書き出す（dst の要素数は Size() と同じであること）
+	void CopyTo(std::span<Vector3> dst) const;
+	// AoS 配列に変換する
+	std::vector<Vector3> ToVector() const;
+
+	// 要素数
+	size_t Size() const { return x_.size(); }
+	bool Empty() const { return x_.empty(); }
+	// 要素数の変更（増えた分は零ベクトル）
+	void Resize(size_t size);
+	// 容量の確保
+	void Reserve(size_t capacity);
+	// 全要素の削除
+	void Clear();
+	// 末尾に追加
+	void PushBack(const Vector3& v);
+
+	// 要素の取得・設定
+	Vector3 Get(size_t index) const { return {x_[index], y_[index], z_[index]}; }
+	void Set(size_t index, const Vector3& v);
+
+	// 成分配列の取得
+	float* X() { return x_.data(); }
+	float* Y() { return y_.data(); }
+	float* Z() { return z_.data(); }
+	const float* X() const { return x_.data(); }
+	const float* Y() const { return y_.data(); }
+	const float* Z() const { return z_.data(); }
+
+	// 一括座標変換用の SoA 参照
+	MathUtility::Vector3SoASpan GetSpan() { return {x_, y_, z_}; }
+	MathUtility::Vector3SoAConstSpan GetSpan() const { return {x_, y_, z_}; }
+
+  public: // 一括演算（out は入力と同じストリームでもよい。out の要素数は入力に合わせる）
+	// out[i] = a[i] + b[i]
+	static void Add(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& out);
+	// out[i] = a[i] - b[i]
+	static void Subtract(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& out);
+	// out[i] = a[i] * s
+	static void Scale(const Vector3Stream& a, float s, Vector3Stream& out);
+	// out[i] = a[i] + b[i] * s（位置 += 速度 * dt などに使う）
+	static void MultiplyAdd(
+	  const Vector3Stream& a, const Vector3Stream& b, float s, Vector3Stream& out);
+	// out[i] = a[i] + (b[i] - a[i]) * t
+	static void Lerp(const Vector3Stream& a, const Vector3Stream& b, float t, Vector3Stream& out);
+	// out[i] = a[i] × b[i]
+	static void Cross(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& out);
+	// out[i] = a[i] / |a[i]|（長さ0の要素はそのまま）
+	static void Normalize(const Vector3Stream& a, Vector3Stream& out);
+	// out[i] = a[i]・b[i]
+	static void Dot(const Vector3Stream& a, const Vector3Stream& b, std::span<float> out);
+	// out[i] = |a[i]|
+	static void Length(const Vector3Stream& a, std::span<float> out);
+
+  private: // メンバ変数
+	FloatArray x_;
+	FloatArray y_;
+	FloatArray z_;
+};
@@ -0,0 +1,220 @@
+﻿#include "EntityWorld.h"
+#include <algorithm>
+#include <bit>
+#include <mutex>
+
+namespace EntityWorldDetail {
+
+namespace {
+
+// 登録済みのコンポーネント型（別スレッドから初めて使われる場合に備えて排他する）
+std::mutex& RegistryMutex() {
+	static std::mutex mutex;
+	return mutex;
+}
+std::vector<ComponentInfo>& Registry() {
+	static std::vector<ComponentInfo> registry;
+	return registry;
+}
+
+} // namespace
+
+uint32_t RegisterComponent(size_t size, size_t alignment) {
+	std::lock_guard<std::mutex> lock(RegistryMutex());
+	std::vector<ComponentInfo>& registry = Registry();
+	assert(registry.size() < kMaxComponentTypes);
+	registry.push_back({size, alignment});
+	return static_cast<uint32_t>(registry.size() - 1);
+}
+
+ComponentInfo GetComponentInfo(uint32_t id) {
+	std::lock_guard<std::mutex> lock(RegistryMutex());
+	return Registry()[id];
+}
+
+} // namespace EntityWorldDetail
+
+using namespace EntityWorldDetail;
+
+namespace {
+
+size_t AlignUp(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+// 1行あたり capacity 個で配置したときのチャンク内の使用量（オフセットも設定する）
+size_t Layout(EntityArchetype& archetype, uint32_t capacity) {
+	size_t offset = sizeof(Entity) * capacity;
+	for (uint32_t id : archetype.components) {
+		ComponentInfo info = GetComponentInfo(id);
+		offset = AlignUp(offset, info.alignment);
+		archetype.offsets[id] = static_cast<uint16_t>(offset);
+		offset += info.size * capacity;
+	}
+	return offset;
+}
+
+std::byte* AllocateChunk() {
+	return static_cast<std::byte*>(::operator new(
+	  EntityArchetype::kChunkSize, std::align_val_t(EntityArchetype::kChunkAlignment)));
+}
+
+void FreeChunk(std::byte* data) {
+	::operator delete(data, std::align_val_t(EntityArchetype::kChunkAlignment));
+}
+
+} // namespace
+
+EntityWorld::~EntityWorld() {
+	for (auto& [mask, archetype] : archetypes_) {
+		for (EntityArchetype::Chunk& chunk : archetype->chunks) {
+			FreeChunk(chunk.data);
+		}
+	}
+}
+
+void EntityWorld::Destroy(Entity entity) {
+	assert(IsAlive(entity) && iterationDepth_ == 0);
+	Record& record = records_[entity.index];
+	RemoveRow(record.archetype, record.chunk, record.row);
+
+	// 世代を進めて古い識別子を無効にする
+	record.archetype = nullptr;
+	record.generation++;
+	freeIndices_.push_back(entity.index);
+	entityCount_--;
+}
+
+EntityArchetype* EntityWorld::GetOrCreateArchetype(ComponentMask mask) {
+	auto it = archetypes_.find(mask);
+	if (it != archetypes_.end()) {
+		return it->second.get();
+	}
+
+	auto archetype = std::make_unique<EntityArchetype>();
+	archetype->mask = mask;
+	std::fill(std::begin(archetype->offsets), std::end(archetype->offsets), EntityArchetype::kNoColumn);
+	size_t rowSize = sizeof(Entity);
+	for (ComponentMask bits = mask; bits != 0; bits &= bits - 1) {
+		uint32_t id = static_cast<uint32_t>(std::countr_zero(bits));
+		uint32_t size = static_cast<uint32_t>(GetComponentInfo(id).size);
+		archetype->components.push_back(id);
+		archetype->componentSizes.push_back(size);
+		rowSize += size;
+	}
+
+	// 1行の大きさから収容数を見積もり、境界合わせで溢れる分だけ減らす
+	uint32_t capacity = static_cast<uint32_t>(EntityArchetype::kChunkSize / rowSize);
+	assert(capacity > 0);
+	while (Layout(*archetype, capacity) > EntityArchetype::kChunkSize) {
+		capacity--;
+	}
+	archetype->capacity = capacity;
+
+	// 作成済みのクエリのうち、該当するものに追加する
+	EntityArchetype* result = archetype.get();
+	for (auto& [queryMask, matches] : queryCache_) {
+		if ((mask & queryMask) == queryMask) {
+			matches.push_back(result);
+		}
+	}
+	archetypes_.emplace(mask, std::move(archetype));
+	return result;
+}
+
+const std::vector<EntityArchetype*>& EntityWorld::Match(ComponentMask mask) {
+	auto it = queryCache_.find(mask);
+	if (it != queryCache_.end()) {
+		return it->second;
+	}
+
+	std::vector<EntityArchetype*> matches;
+	for (auto& [archetypeMask, archetype] : archetypes_) {
+		if ((archetypeMask & mask) == mask) {
+			matches.push_back(archetype.get());
+		}
+	}
+	return queryCache_.emplace(mask, std::move(matches)).first->second;
+}
+
+Entity EntityWorld::AllocateEntity(EntityArchetype* archetype) {
+	Entity entity;
+	if (freeIndices_.empty()) {
+		entity.index = static_cast<uint32_t>(records_.size());
+		records_.emplace_back();
+	} else {
+		entity.index = freeIndices_.back();
+		freeIndices_.pop_back();
+	}
+
+	Record& record = records_[entity.index];
+	entity.generation = record.generation;
+	record.archetype = archetype;
+	AllocateRow(archetype, record.chunk, record.row);
+	archetype->GetEntities(archetype->chunks[record.chunk])[record.row] = entity;
+	entityCount_++;
+	return entity;
+}
+
+void EntityWorld::AllocateRow(EntityArchetype* archetype, uint32_t& chunk, uint32_t& row) {
+	if (archetype->chunks.empty() || archetype->chunks.back().count == archetype->capacity) {
+		archetype->chunks.push_back({AllocateChunk(), 0});
+	}
+	chunk = static_cast<uint32_t>(archetype->chunks.size() - 1);
+	row = archetype->chunks.back().count++;
+}
+
+void EntityWorld::RemoveRow(EntityArchetype* archetype, uint32_t chunk, uint32_t row) {
+	EntityArchetype::Chunk& last = archetype->chunks.back();
+	const uint32_t lastChunk = static_cast<uint32_t>(archetype->chunks.size() - 1);
+	const uint32_t lastRow = last.count - 1;
+
+	// 最後の行を穴に移して、チャンクを詰まった状態に保つ
+	if (chunk != lastChunk || row != lastRow) {
+		EntityArchetype::Chunk& target = archetype->chunks[chunk];
+		for (size_t i = 0; i < archetype->components.size(); i++) {
+			uint32_t id = archetype->components[i];
+			size_t size = archetype->componentSizes[i];
+			std::byte* column = target.data + archetype->offsets[id];
+			std::byte* lastColumn = last.data + archetype->offsets[id];
+			std::memcpy(column + size * row, lastColumn + size * lastRow, size);
+		}
+		Entity moved = archetype->GetEntities(last)[lastRow];
+		archetype->GetEntities(target)[row] = moved;
+		records_[moved.index].chunk = chunk;
+		records_[moved.index].row = row;
+	}
+
+	if (--last.count == 0) {
+		FreeChunk(last.data);
+		archetype->chunks.pop_back();
+	}
+}
+
+void EntityWorld::MoveEntity(Entity entity, EntityArchetype* target) {
+	// 走査中のチャンクの行が入れ替わるので、ForEachChunk の中からは呼べない
+	assert(iterationDepth_ == 0);
+	Record& record = records_[entity.index];
+	EntityArchetype* source = record.archetype;
+	uint32_t sourceChunk = record.chunk;
+	uint32_t sourceRow = record.row;
+
+	uint32_t chunk, row;
+	AllocateRow(target, chunk, row);
+	const EntityArchetype::Chunk& from = source->chunks[sourceChunk];
+	const EntityArchetype::Chunk& to = target->chunks[chunk];
+	for (size_t i = 0; i < target->components.size(); i++) {
+		uint32_t id = target->components[i];
+		if (source->offsets[id] == EntityArchetype::kNoColumn) {
+			continue;
+		}
+		size_t size = target->componentSizes[i];
+		std::memcpy(
+		  to.data + target->offsets[id] + size * row,
+		  from.data + source->offsets[id] + size * sourceRow, size);
+	}
+	target->GetEntities(to)[row] = entity;
+
+	RemoveRow(source, sourceChunk, sourceRow);
+	record.archetype = target;
+	record.chunk = chunk;
+	record.row = row;
+}
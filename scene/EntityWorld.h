@@ -0,0 +1,251 @@
+﻿#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// エンティティ（世代付きの識別子）
+/// </summary>
+struct Entity {
+	uint32_t index = UINT32_MAX;
+	uint32_t generation = 0;
+
+	bool operator==(const Entity& other) const {
+		return index == other.index && generation == other.generation;
+	}
+	bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+namespace EntityWorldDetail {
+
+// コンポーネントの種類の上限（ビットマスクで表す）
+const uint32_t kMaxComponentTypes = 64;
+using ComponentMask = uint64_t;
+
+// コンポーネントの型情報
+struct ComponentInfo {
+	size_t size;
+	size_t alignment;
+};
+
+// 型情報を登録して番号を得る
+uint32_t RegisterComponent(size_t size, size_t alignment);
+// 登録済みの型情報
+ComponentInfo GetComponentInfo(uint32_t id);
+
+} // namespace EntityWorldDetail
+
+/// <summary>
+/// コンポーネント型の番号（プロセス内で一意。初回呼び出し時に採番）
+/// コンポーネントは memcpy で移動するので、トリビアルにコピーできる型に限る
+/// </summary>
+template<class T> uint32_t ComponentTypeId() {
+	static_assert(std::is_trivially_copyable_v<T>, "コンポーネントはトリビアルにコピーできる型にする");
+	static const uint32_t id = EntityWorldDetail::RegisterComponent(sizeof(T), alignof(T));
+	return id;
+}
+
+/// <summary>
+/// アーキタイプ（同じコンポーネントの組み合わせを持つエンティティの集まり）
+/// 16KB のチャンクに、エンティティとコンポーネントを種類ごとの連続した配列で並べる
+/// </summary>
+struct EntityArchetype {
+	// 1チャンクの大きさ
+	static constexpr size_t kChunkSize = 16 * 1024;
+	// チャンクの先頭アドレスの境界（キャッシュライン）
+	static constexpr size_t kChunkAlignment = 64;
+	// この種類の配列を持たない
+	static constexpr uint16_t kNoColumn = UINT16_MAX;
+
+	struct Chunk {
+		std::byte* data = nullptr;
+		uint32_t count = 0;
+	};
+
+	EntityWorldDetail::ComponentMask mask = 0;
+	// 1チャンクに入るエンティティ数
+	uint32_t capacity = 0;
+	// 種類ごとの配列のチャンク内オフセット（エンティティの配列は先頭）
+	uint16_t offsets[EntityWorldDetail::kMaxComponentTypes];
+	// 持っているコンポーネントの種類と大きさ
+	std::vector<uint32_t> components;
+	std::vector<uint32_t> componentSizes;
+	// 末尾以外のチャンクは常に満杯にしておく
+	std::vector<Chunk> chunks;
+
+	// 配列の先頭
+	template<class T> T* GetColumn(const Chunk& chunk) const {
+		uint16_t offset = offsets[ComponentTypeId<T>()];
+		assert(offset != kNoColumn);
+		return std::launder(reinterpret_cast<T*>(chunk.data + offset));
+	}
+	Entity* GetEntities(const Chunk& chunk) const {
+		return std::launder(reinterpret_cast<Entity*>(chunk.data));
+	}
+};
+
+/// <summary>
+/// エンティティとコンポーネントの格納庫
+/// コンポーネントの組み合わせごとにアーキタイプを作り、クエリは該当するチャンクだけを走査する。
+/// 走査中（ForEach / ForEachChunk のコールバックの中）は、チャンクやクエリの一覧が動くので
+/// 構造の変更（Create・Destroy・コンポーネントの種類が変わる Add・Remove）をしてはならない（assert で止まる）
+/// </summary>
+class EntityWorld {
+  public:
+	EntityWorld() = default;
+	~EntityWorld();
+	EntityWorld(const EntityWorld&) = delete;
+	EntityWorld& operator=(const EntityWorld&) = delete;
+
+  public: // エンティティ
+	/// <summary>
+	/// エンティティの生成
+	/// </summary>
+	/// <param name="components">初期コンポーネント（種類は重複しないこと）</param>
+	template<class... Ts> Entity Create(const Ts&... components) {
+		assert(iterationDepth_ == 0);
+		EntityArchetype* archetype = GetOrCreateArchetype(MaskOf<Ts...>());
+		Entity entity = AllocateEntity(archetype);
+		const Record& record = records_[entity.index];
+		(Store(archetype, record, components), ...);
+		return entity;
+	}
+
+	/// <summary>
+	/// エンティティの削除
+	/// </summary>
+	void Destroy(Entity entity);
+
+	// 生きているエンティティか
+	bool IsAlive(Entity entity) const {
+		return entity.index < records_.size() && records_[entity.index].generation == entity.generation &&
+		       records_[entity.index].archetype != nullptr;
+	}
+
+	// 生きているエンティティの数
+	uint32_t GetEntityCount() const { return entityCount_; }
+
+  public: // コンポーネント
+	// コンポーネントを持っているか
+	template<class T> bool Has(Entity entity) const {
+		assert(IsAlive(entity));
+		return (records_[entity.index].archetype->mask & BitOf<T>()) != 0;
+	}
+
+	// コンポーネントの取得（持っていなければ nullptr）
+	// アーキタイプが変わると無効になるので保持しないこと
+	template<class T> T* Get(Entity entity) {
+		if (!IsAlive(entity) || !Has<T>(entity)) {
+			return nullptr;
+		}
+		const Record& record = records_[entity.index];
+		EntityArchetype* archetype = record.archetype;
+		return archetype->GetColumn<T>(archetype->chunks[record.chunk]) + record.row;
+	}
+
+	// コンポーネントの追加（既に持っていれば上書き）
+	template<class T> void Add(Entity entity, const T& component) {
+		assert(IsAlive(entity));
+		if (!Has<T>(entity)) {
+			MoveEntity(entity, GetOrCreateArchetype(records_[entity.index].archetype->mask | BitOf<T>()));
+		}
+		const Record& record = records_[entity.index];
+		Store(record.archetype, record, component);
+	}
+
+	// コンポーネントの削除
+	template<class T> void Remove(Entity entity) {
+		assert(IsAlive(entity));
+		if (Has<T>(entity)) {
+			MoveEntity(entity, GetOrCreateArchetype(records_[entity.index].archetype->mask & ~BitOf<T>()));
+		}
+	}
+
+  public: // クエリ
+	/// <summary>
+	/// Ts をすべて持つエンティティごとに function(Ts&...) を呼ぶ
+	/// （コンポーネントの値は書き換えてよいが、構造の変更はしないこと）
+	/// </summary>
+	template<class... Ts, class Function> void ForEach(Function&& function) {
+		ForEachChunk<Ts...>([&function](uint32_t count, const Entity*, Ts*... columns) {
+			for (uint32_t i = 0; i < count; i++) {
+				function(columns[i]...);
+			}
+		});
+	}
+
+	/// <summary>
+	/// Ts をすべて持つチャンクごとに function(count, entities, Ts* columns...) を呼ぶ
+	/// 配列は連続しているので、SIMD や一括処理の関数にそのまま渡せる
+	/// （構造の変更はしないこと。削除や追加は一覧に集めておき、走査の後で行う）
+	/// </summary>
+	template<class... Ts, class Function> void ForEachChunk(Function&& function) {
+		iterationDepth_++;
+		for (EntityArchetype* archetype : Match(MaskOf<Ts...>())) {
+			for (const EntityArchetype::Chunk& chunk : archetype->chunks) {
+				function(chunk.count, archetype->GetEntities(chunk), archetype->GetColumn<Ts>(chunk)...);
+			}
+		}
+		iterationDepth_--;
+	}
+
+	/// <summary>
+	/// Ts をすべて持つアーキタイプの一覧（並列処理でチャンクを分配する場合に使う）
+	/// 新しいアーキタイプができると追記されるので、使っている間は構造を変更しないこと
+	/// </summary>
+	template<class... Ts> const std::vector<EntityArchetype*>& Query() {
+		return Match(MaskOf<Ts...>());
+	}
+
+  private: // メンバ関数
+	struct Record {
+		EntityArchetype* archetype = nullptr;
+		uint32_t chunk = 0;
+		uint32_t row = 0;
+		uint32_t generation = 0;
+	};
+
+	template<class T> static EntityWorldDetail::ComponentMask BitOf() {
+		uint32_t id = ComponentTypeId<T>();
+		assert(id < EntityWorldDetail::kMaxComponentTypes);
+		return EntityWorldDetail::ComponentMask(1) << id;
+	}
+	template<class... Ts> static EntityWorldDetail::ComponentMask MaskOf() {
+		return (EntityWorldDetail::ComponentMask(0) | ... | BitOf<Ts>());
+	}
+
+	template<class T>
+	static void Store(EntityArchetype* archetype, const Record& record, const T& component) {
+		T* column = archetype->GetColumn<T>(archetype->chunks[record.chunk]);
+		std::memcpy(column + record.row, &component, sizeof(T));
+	}
+
+	EntityArchetype* GetOrCreateArchetype(EntityWorldDetail::ComponentMask mask);
+	const std::vector<EntityArchetype*>& Match(EntityWorldDetail::ComponentMask mask);
+	// アーキタイプの末尾に行を確保し、新しいエンティティを割り当てる
+	Entity AllocateEntity(EntityArchetype* archetype);
+	// 末尾に行を確保する（チャンク番号と行番号を返す）
+	void AllocateRow(EntityArchetype* archetype, uint32_t& chunk, uint32_t& row);
+	// 行を削除し、アーキタイプの最後の行で穴を埋める
+	void RemoveRow(EntityArchetype* archetype, uint32_t chunk, uint32_t row);
+	// 共通するコンポーネントをコピーして別のアーキタイプへ移す
+	void MoveEntity(Entity entity, EntityArchetype* target);
+
+  private: // メンバ変数
+	std::vector<Record> records_;
+	std::vector<uint32_t> freeIndices_;
+	uint32_t entityCount_ = 0;
+	// 入れ子になった ForEachChunk の数（0 でなければ構造の変更を禁止する）
+	uint32_t iterationDepth_ = 0;
+
+	std::unordered_map<EntityWorldDetail::ComponentMask, std::unique_ptr<EntityArchetype>> archetypes_;
+	// クエリのマスク → 該当するアーキタイプ（アーキタイプが増えたら追記する）
+	std::unordered_map<EntityWorldDetail::ComponentMask, std::vector<EntityArchetype*>> queryCache_;
+};
@@ -3,10 +3,18 @@
 #include <cassert>
 #include "Global.h"
 #include "AxisIndicator.h"
+#include "JobSystem.h"
 #include "PrimitiveDrawer.h"
 #include <random>
 #define PI 3.1415
 
+namespace {
+
+// Model::Create で作る立方体のローカル空間の境界
+const AABB kModelBounds = {{-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}};
+
+} // namespace
+
 GameScene::GameScene() {}
 
 GameScene::~GameScene() { delete model_; delete debugCamera_; }
@@ -33,35 +41,44 @@ void GameScene::Initialize() {
 	std::uniform_real_distribution<float> scaleRange(1, 2);
 	std::uniform_real_distribution<float> rotRange(0, 2 * PI);
 
-	Matrix4 matScale;
-	Matrix4 matRot;
-	Matrix4 matTrans;
 	worldTransform_.Initialize();
-	worldTransform_.scale_ = { 1.5f,1.5f,1.5f };
-	worldTransform_.rotation_ = { rotRange(engine),rotRange(engine),rotRange(engine) };
-	worldTransform_.translation_ = { 0,0,0 };
-	worldTransform_.matWorld_.Identity();
-
-	matScale.Identity();
-	matScale.Scale(worldTransform_.scale_);
-
-	matRot.Identity();
-	matRot.Rotation(worldTransform_.rotation_);
-
-	matTrans.Identity();
-	matTrans.Transform(worldTransform_.translation_);
 
-	worldTransform_.matWorld_ *= matScale;
-	worldTransform_.matWorld_ *= matRot;
-	worldTransform_.matWorld_ *= matTrans;
-
-	worldTransform_.TransferMatrix();
+	// スケール・回転・平行移動は親子関係のノードだけが持ち、行列の計算も親子関係ごとにまとめて行う
+	// worldTransform_ には描画時に補間した行列だけを書き込む
+	worldTransformNode_ = transformHierarchy_.Create();
+	transformHierarchy_.SetScale(worldTransformNode_, { 1.5f,1.5f,1.5f });
+	transformHierarchy_.SetRotation(
+	  worldTransformNode_, { rotRange(engine),rotRange(engine),rotRange(engine) });
+	transformHierarchy_.SetTranslation(worldTransformNode_, { 0,0,0 });
+	transformInterpolator_.Initialize(&transformHierarchy_);
+	transformInterpolator_.Add(worldTransformNode_, &worldTransform_);
 }
 
 void GameScene::Update() {
+	// 変更されたノードの行列だけを、独立した部分木ごとに並列で更新する
+	// （定数バッファへの転送は描画前の補間でフレームごとに1回だけ行う）
+	std::span<const TransformHierarchy::Range> ranges = transformHierarchy_.PrepareUpdate();
+	JobSystem::GetInstance()->ParallelFor(
+	  0, static_cast<uint32_t>(ranges.size()), transformHierarchy_.GetRangeGrainSize(),
+	  [&](uint32_t begin, uint32_t end) {
+		  for (uint32_t i = begin; i < end; i++) {
+			  transformHierarchy_.UpdateRange(ranges[i]);
+		  }
+	  });
+	transformHierarchy_.FinishUpdate();
+
+	// このステップの状態を描画時の補間用に記録する
+	transformInterpolator_.Capture();
+}
+
+void GameScene::UpdateCamera() {
 	debugCamera_->Update();
+	const ViewProjection& viewProjection = debugCamera_->GetViewProjection();
+	cameraCache_.Update(viewProjection.matView, viewProjection.matProjection);
 }
 
+void GameScene::Interpolate(float alpha) { transformInterpolator_.Apply(alpha); }
+
 void GameScene::Draw() {
 
 	// コマンドリストの取得
@@ -94,16 +111,20 @@ void GameScene::Draw() {
 #pragma endregion
 
 #pragma region 3Dオブジェクト描画
-	// 3Dオブジェクト描画前処理
-	Model::PreDraw(commandList);
+	// 3Dオブジェクトは描画キューに集めて、状態ごとに並べてから描画する
+	modelRenderQueue_.Clear();
 
 	/// <summary>
 	/// ここに3Dオブジェクトの描画処理を追加できる
 	/// </summary>
-	//model_->Draw(worldTransform_, viewProjection_, textureHandle_);
-	model_->Draw(worldTransform_, debugCamera_->GetViewProjection(), textureHandle_);
-	// 3Dオブジェクト描画後処理
-	Model::PostDraw();
+	// 視錐台の外にあるものはキューに積まない
+	if (MathUtility::FrustumIntersectsAABB(
+	      cameraCache_.GetFrustum(),
+	      MathUtility::AABBTransform(kModelBounds, worldTransform_.matWorld_))) {
+		modelRenderQueue_.Add(model_, worldTransform_, textureHandle_, 0);
+	}
+	modelRenderQueue_.Draw(
+	  dxCommon_->GetRenderDevice()->GetCommandList(), debugCamera_->GetViewProjection());
 #pragma endregion
 
 #pragma region 前景スプライト描画
@@ -1,13 +1,17 @@
 ﻿#pragma once
 
 #include "Audio.h"
+#include "CameraCache.h"
 #include "DirectXCommon.h"
 #include "DebugText.h"
 #include "Input.h"
 #include "Model.h"
+#include "ModelRenderQueue.h"
 #include "SafeDelete.h"
 #include "Sprite.h"
 #include "ViewProjection.h"
+#include "TransformHierarchy.h"
+#include "TransformInterpolator.h"
 #include "WorldTransform.h"
 #include "DebugCamera.h"
 
@@ -33,10 +37,23 @@ public: // メンバ関数
 	void Initialize();
 
 	/// <summary>
-	/// 毎フレーム処理
+	/// 毎フレーム処理（固定ステップごとに呼ばれる）
 	/// </summary>
 	void Update();
 
+	/// <summary>
+	/// カメラの更新（描画するフレームごとに1回、入力の更新の後に呼ぶ）
+	/// 入力はフレームごとに1回しか更新されないので、ステップの回数によらずここで動かす。
+	/// 最新の入力で動かしたカメラをそのまま描画に使うので補間はしない
+	/// </summary>
+	void UpdateCamera();
+
+	/// <summary>
+	/// 描画する状態を直前2ステップの間で補間する（Draw の前に呼ぶ）
+	/// </summary>
+	/// <param name="alpha">補間係数（0 で1つ前のステップ、1 で直前のステップ）</param>
+	void Interpolate(float alpha);
+
 	/// <summary>
 	/// 描画
 	/// </summary>
@@ -50,9 +67,18 @@ private: // メンバ変数
 
 	uint32_t textureHandle_;
 	Model* model_ = nullptr;
+	// 3Dオブジェクトの描画キュー
+	ModelRenderQueue modelRenderQueue_;
 
 	WorldTransform worldTransform_;
+	// ワールド変換の親子関係
+	TransformHierarchy transformHierarchy_;
+	TransformHierarchy::NodeId worldTransformNode_ = TransformHierarchy::kInvalidNode;
+	// 描画時のワールド変換の補間
+	TransformInterpolator transformInterpolator_;
 	ViewProjection viewProjection_;
+	// カメラの逆行列と視錐台（カメラが動いたときだけ計算し直し、描画する物のカリングに使う）
+	CameraCache cameraCache_;
 
 	DebugCamera* debugCamera_ = nullptr;
 	/// <summary>
@@ -0,0 +1,51 @@
+﻿#pragma once
+
+#include "Matrix4.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include <cstdint>
+
+class Model;
+
+// シーンのオブジェクトが持つ基本コンポーネント（EntityWorld に格納する）
+
+/// <summary>
+/// ローカル変換
+/// </summary>
+struct TransformComponent {
+	Vector3 scale = {1, 1, 1};
+	Vector3 rotation = {0, 0, 0};
+	Vector3 translation = {0, 0, 0};
+};
+
+/// <summary>
+/// ワールド行列（TransformComponent から計算する）
+/// </summary>
+struct WorldMatrixComponent {
+	Matrix4 matWorld;
+};
+
+/// <summary>
+/// 描画するモデル
+/// </summary>
+struct ModelComponent {
+	Model* model = nullptr;
+	uint32_t textureHandle = 0;
+};
+
+/// <summary>
+/// マテリアルの上書き
+/// </summary>
+struct MaterialOverrideComponent {
+	Vector4 color = {1, 1, 1, 1};
+	// 0 ならモデルのテクスチャをそのまま使う
+	uint32_t textureHandle = 0;
+};
+
+/// <summary>
+/// 境界（ローカル空間の軸平行境界ボックス）
+/// </summary>
+struct BoundsComponent {
+	Vector3 center = {0, 0, 0};
+	Vector3 extents = {0, 0, 0};
+};